@@ -20,18 +20,30 @@ int main(int argc, char **argv)
     TKIT_LOG_INFO("[TOOLKIT][PERF] Running parallel sum...");
     RecordParallelSum(settings.ThreadPoolSum);
 
+    TKIT_LOG_INFO("[TOOLKIT][PERF] Running concurrent hash map...");
+    RecordConcurrentHashMap(settings.ConcurrentHashMap);
+
     TKIT_LOG_INFO("[TOOLKIT][PERF] Running malloc/free...");
     RecordMallocFree(settings.Allocation);
 
     TKIT_LOG_INFO("[TOOLKIT][PERF] Running block allocator...");
     RecordBlockAllocator(settings.Allocation);
 
+    TKIT_LOG_INFO("[TOOLKIT][PERF] Running concurrent block allocator...");
+    RecordConcurrentBlockAllocator(settings.Allocation, settings.ThreadPoolSum);
+
     TKIT_LOG_INFO("[TOOLKIT][PERF] Running stack allocator...");
     RecordStackAllocator(settings.Allocation);
 
     TKIT_LOG_INFO("[TOOLKIT][PERF] Running arena allocator...");
     RecordArenaAllocator(settings.Allocation);
 
+    TKIT_LOG_INFO("[TOOLKIT][PERF] Running compacting allocator...");
+    RecordCompactingAllocator(settings.Allocation);
+
+    TKIT_LOG_INFO("[TOOLKIT][PERF] Running memory copy...");
+    RecordMemoryCopy(settings.Allocation);
+
     TKIT_LOG_INFO("[TOOLKIT][PERF] Running vector...");
     RecordVector(settings.Container);
 
@@ -1,10 +1,16 @@
 #include "perf/memory.hpp"
 #include "tkit/profiling/clock.hpp"
 #include "tkit/memory/block_allocator.hpp"
+#include "tkit/memory/concurrent_block_allocator.hpp"
 #include "tkit/memory/stack_allocator.hpp"
 #include "tkit/memory/arena_allocator.hpp"
+#include "tkit/memory/compacting_allocator.hpp"
 #include "tkit/container/dynamic_array.hpp"
+#include <cstring>
 #include <fstream>
+#include <thread>
+#include <mutex>
+#include <random>
 
 namespace TKit
 {
@@ -61,6 +67,87 @@ void RecordBlockAllocator(const AllocationSettings &settings)
     }
 }
 
+template <typename F> static Timespan runContended(const usize nthreads, F &&fun)
+{
+    DynamicArray<std::thread> threads{};
+    threads.Reserve(nthreads);
+    std::atomic<bool> start{false};
+
+    for (usize i = 0; i < nthreads; ++i)
+        threads.Append([&start, &fun] {
+            while (!start.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            fun();
+        });
+
+    Clock clock;
+    start.store(true, std::memory_order_release);
+    for (std::thread &thread : threads)
+        thread.join();
+    return clock.GetElapsed();
+}
+
+void RecordConcurrentBlockAllocator(const AllocationSettings &settings, const ThreadPoolSettings &tsettings)
+{
+    std::ofstream file(g_Root + "/performance/results/concurrent_block_allocator.csv");
+    file << "threads,passes,concurrent_block (ns),mutex_block (ns),malloc_free (ns)\n";
+
+    // Every thread allocates a small batch and frees it right away, so that all threads keep hammering the head of the
+    // free list at the same time
+    constexpr usize batch = 32;
+    const usize passes = settings.MaxPasses;
+    const usize capacity = tsettings.MaxThreads * batch;
+
+    ConcurrentBlockAllocator concurrent = ConcurrentBlockAllocator::CreateFromType<ExampleData>(capacity);
+    BlockAllocator block = BlockAllocator::CreateFromType<ExampleData>(capacity);
+    std::mutex mutex;
+
+    usize nthreads = 1;
+    while (nthreads <= tsettings.MaxThreads)
+    {
+        const Timespan cTime = runContended(nthreads, [&] {
+            ExampleData *allocated[batch];
+            for (usize i = 0; i < passes; i += batch)
+            {
+                for (usize j = 0; j < batch; ++j)
+                    allocated[j] = concurrent.Create<ExampleData>();
+                for (usize j = 0; j < batch; ++j)
+                    concurrent.Destroy(allocated[j]);
+            }
+        });
+        const Timespan mTime = runContended(nthreads, [&] {
+            ExampleData *allocated[batch];
+            for (usize i = 0; i < passes; i += batch)
+            {
+                for (usize j = 0; j < batch; ++j)
+                {
+                    std::scoped_lock lock{mutex};
+                    allocated[j] = block.Create<ExampleData>();
+                }
+                for (usize j = 0; j < batch; ++j)
+                {
+                    std::scoped_lock lock{mutex};
+                    block.Destroy(allocated[j]);
+                }
+            }
+        });
+        const Timespan nTime = runContended(nthreads, [&] {
+            ExampleData *allocated[batch];
+            for (usize i = 0; i < passes; i += batch)
+            {
+                for (usize j = 0; j < batch; ++j)
+                    allocated[j] = new ExampleData;
+                for (usize j = 0; j < batch; ++j)
+                    delete allocated[j];
+            }
+        });
+
+        file << nthreads << ',' << passes << ',' << cTime.AsNanoseconds() << ',' << mTime.AsNanoseconds() << ','
+             << nTime.AsNanoseconds() << '\n';
+        nthreads *= 2;
+    }
+}
+
 void RecordStackAllocator(const AllocationSettings &settings)
 {
     const char *path = "/performance/results/stack_allocator.csv";
@@ -104,4 +191,102 @@ void RecordArenaAllocator(const AllocationSettings &settings)
         file << passes << ',' << allocTime.AsNanoseconds() << '\n';
     }
 }
+
+void RecordCompactingAllocator(const AllocationSettings &settings)
+{
+    std::ofstream file(g_Root + "/performance/results/compacting_allocator.csv");
+    file << "slice,bytes moved,blocks moved,time (ns),holes,hole bytes,largest free block (bytes),fragmentation\n";
+
+    // Fill the heap with mixed sizes and free a random half of it, the typical state of a long-running heap
+    std::mt19937 rng{42};
+    CompactingAllocator allocator{64 * 1024 * 1024};
+    DynamicArray<CompactingAllocator::Handle> handles{};
+    for (;;)
+    {
+        const CompactingAllocator::Handle handle = allocator.Allocate(16 * (1 + rng() % 64));
+        if (!handle)
+            break;
+        handles.Append(handle);
+    }
+    for (usize i = 0; i < handles.GetSize(); ++i)
+        if (rng() % 2 == 0)
+        {
+            allocator.Deallocate(handles[i]);
+            handles.RemoveUnordered(handles.begin() + i--);
+        }
+
+    const auto writeRow = [&file, &allocator](const usize slice, const CompactingAllocator::CompactionResult &result,
+                                              const Timespan time) {
+        const CompactingAllocator::Metrics metrics = allocator.GetMetrics();
+        file << slice << ',' << result.BytesMoved << ',' << result.BlocksMoved << ',' << time.AsNanoseconds() << ','
+             << metrics.Holes << ',' << metrics.HoleBytes << ',' << metrics.LargestFreeBlock << ','
+             << metrics.Fragmentation << '\n';
+    };
+
+    // The first row holds the metrics before compacting. Every slice moves roughly the same amount of bytes
+    writeRow(0, CompactingAllocator::CompactionResult{}, Timespan{});
+    const usz budget = settings.MaxPasses * sizeof(ExampleData);
+    for (usize slice = 1;; ++slice)
+    {
+        const Clock clock;
+        const CompactingAllocator::CompactionResult result = allocator.Compact(budget);
+        writeRow(slice, result, clock.GetElapsed());
+        if (result.Finished)
+            break;
+    }
+
+    for (const CompactingAllocator::Handle handle : handles)
+        allocator.Deallocate(handle);
+}
+
+template <typename F> static Timespan timeKernel(const usize passes, std::byte *dst, F &&fun)
+{
+    const Clock clock;
+    for (usize i = 0; i < passes; ++i)
+        fun();
+    const Timespan time = clock.GetElapsed();
+
+    // Keep the compiler from discarding the copies
+    volatile std::byte sink = dst[0];
+    (void)sink;
+    return time;
+}
+
+void RecordMemoryCopy(const AllocationSettings &settings)
+{
+    std::ofstream file(g_Root + "/performance/results/memory_copy.csv");
+    file << "size (bytes),passes,memcpy (ns),forward_copy (ns),memmove (ns),backward_copy (ns),memset (ns),fill "
+            "(ns)\n";
+
+    // Big enough to cover the non-temporal kernels, with some extra room for the overlapping moves
+    constexpr usz maxSize = 64 * 1024 * 1024;
+    std::byte *src = scast<std::byte *>(AllocateAligned(maxSize + 64, 64));
+    std::byte *dst = scast<std::byte *>(AllocateAligned(maxSize + 64, 64));
+    std::memset(src, 1, maxSize + 64);
+    std::memset(dst, 2, maxSize + 64);
+
+    for (usz size = 8; size <= maxSize; size *= 2)
+    {
+        // Bigger copies take proportionally less passes so that every size moves roughly the same amount of bytes
+        const usize scaled = usize(settings.MaxPasses * 4096 / size);
+        const usize passes = size <= 4096 ? settings.MaxPasses : (scaled != 0 ? scaled : 1);
+        // Odd offsets, so that the kernels cannot rely on aligned pointers
+        std::byte *d = dst + 3;
+        const std::byte *s = src + 1;
+
+        const Timespan memcpyTime = timeKernel(passes, d, [&] { std::memcpy(d, s, size); });
+        const Timespan forwardTime = timeKernel(passes, d, [&] { ForwardCopy(d, s, size); });
+        const Timespan memmoveTime = timeKernel(passes, d, [&] { std::memmove(d, d + 33, size); });
+        const Timespan backwardTime = timeKernel(passes, d, [&] { BackwardCopy(d, d + 33, size); });
+        const Timespan memsetTime = timeKernel(passes, d, [&] { std::memset(d, 7, size); });
+        const Timespan fillTime = timeKernel(passes, d, [&] { Fill(d, 7, size); });
+
+        file << size << ',' << passes << ',' << memcpyTime.AsNanoseconds() << ',' << forwardTime.AsNanoseconds() << ','
+             << memmoveTime.AsNanoseconds() << ',' << backwardTime.AsNanoseconds() << ','
+             << memsetTime.AsNanoseconds() << ',' << fillTime.AsNanoseconds() << '\n';
+    }
+
+    DeallocateAligned(src);
+    DeallocateAligned(dst);
+}
 } // namespace TKit
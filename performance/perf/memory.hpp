@@ -8,6 +8,10 @@ namespace TKit
 void RecordMallocFree(const AllocationSettings &settings);
 
 void RecordBlockAllocator(const AllocationSettings &settings);
+void RecordConcurrentBlockAllocator(const AllocationSettings &settings, const ThreadPoolSettings &tsettings);
 void RecordStackAllocator(const AllocationSettings &settings);
 void RecordArenaAllocator(const AllocationSettings &settings);
+void RecordCompactingAllocator(const AllocationSettings &settings);
+
+void RecordMemoryCopy(const AllocationSettings &settings);
 } // namespace TKit
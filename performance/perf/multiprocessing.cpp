@@ -1,11 +1,15 @@
 #include "perf/settings.hpp"
 #include "tkit/multiprocessing/thread_pool.hpp"
 #include "tkit/multiprocessing/for_each.hpp"
+#include "tkit/multiprocessing/concurrent_hash_map.hpp"
+#include "tkit/container/hash_map.hpp"
 #include "tkit/container/dynamic_array.hpp"
 #include "tkit/container/static_array.hpp"
 #include "tkit/profiling/clock.hpp"
 #include "tkit/utils/literals.hpp"
 #include <fstream>
+#include <thread>
+#include <mutex>
 
 namespace TKit
 {
@@ -92,4 +96,102 @@ void RecordParallelSum(const ThreadPoolSettings &settings)
         nthreads *= 2;
     }
 }
+
+template <typename F> static Timespan runContended(const usize nthreads, F &&fun)
+{
+    DynamicArray<std::thread> threads{};
+    threads.Reserve(nthreads);
+    std::atomic<bool> start{false};
+
+    for (usize i = 0; i < nthreads; ++i)
+        threads.Append([&start, &fun, i] {
+            while (!start.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            fun(i);
+        });
+
+    Clock clock;
+    start.store(true, std::memory_order_release);
+    for (std::thread &thread : threads)
+        thread.join();
+    return clock.GetElapsed();
+}
+
+// Runs the share of operations of a thread on a map prefilled with half of the keys. Writes alternate between
+// insertions and removals so that the size of the map stays roughly constant
+template <typename Read, typename Write, typename Remove>
+static void runHashMapOperations(const ConcurrentHashMapSettings &settings, const usize nthreads,
+                                 const usize threadIndex, Read &&read, Write &&write, Remove &&remove)
+{
+    u64 state = 0x9E3779B97F4A7C15ull * (threadIndex + 1);
+    const usize operations = settings.Operations / nthreads;
+    for (usize i = 0; i < operations; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        const u32 key = u32(state % settings.Keys);
+        const usize roll = usize(state >> 40) % 100;
+        if (roll < settings.ReadPercentage)
+            read(key);
+        else if (roll % 2 == 0)
+            write(key);
+        else
+            remove(key);
+    }
+}
+
+void RecordConcurrentHashMap(const ConcurrentHashMapSettings &settings)
+{
+    std::ofstream file(g_Root + "/performance/results/concurrent_hash_map.csv");
+    file << "threads,operations,concurrent_hash_map (ns),mutex_hash_map (ns),checksum\n";
+
+    ConcurrentHashMap<u32, u32> concurrent{ConcurrentHashMapSpecs{.Buckets = settings.Keys}};
+    DynamicHashMap<u32, u32> locked(settings.Keys);
+    std::mutex mutex;
+    for (u32 i = 0; i < settings.Keys; i += 2)
+    {
+        concurrent.Insert(i, i);
+        locked.Insert(i, i);
+    }
+
+    std::atomic<u64> checksum{0};
+    usize nthreads = 1;
+    while (nthreads <= settings.MaxThreads)
+    {
+        const Timespan cTime = runContended(nthreads, [&](const usize index) {
+            u64 sum = 0;
+            runHashMapOperations(
+                settings, nthreads, index,
+                [&](const u32 key) { concurrent.Visit(key, [&sum](const u32 value) { sum += value; }); },
+                [&](const u32 key) { concurrent.InsertOrAssign(key, key); },
+                [&](const u32 key) { concurrent.Remove(key); });
+            checksum.fetch_add(sum, std::memory_order_relaxed);
+        });
+        const Timespan mTime = runContended(nthreads, [&](const usize index) {
+            u64 sum = 0;
+            runHashMapOperations(
+                settings, nthreads, index,
+                [&](const u32 key) {
+                    std::scoped_lock lock{mutex};
+                    const auto it = locked.Find(key);
+                    if (it != locked.end())
+                        sum += it->Value;
+                },
+                [&](const u32 key) {
+                    std::scoped_lock lock{mutex};
+                    locked.TryInsert(key, key) = key;
+                },
+                [&](const u32 key) {
+                    std::scoped_lock lock{mutex};
+                    locked.Remove(key);
+                });
+            checksum.fetch_add(sum, std::memory_order_relaxed);
+        });
+
+        file << nthreads << ',' << settings.Operations << ',' << cTime.AsNanoseconds() << ','
+             << mTime.AsNanoseconds() << ',' << checksum.load(std::memory_order_relaxed) << '\n';
+        nthreads *= 2;
+    }
+}
 } // namespace TKit
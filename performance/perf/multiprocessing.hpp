@@ -4,4 +4,5 @@ namespace TKit
 {
 void RecordThreadPoolSum(const ThreadPoolSettings &settings);
 void RecordParallelSum(const ThreadPoolSettings &settings);
+void RecordConcurrentHashMap(const ConcurrentHashMapSettings &settings);
 } // namespace TKit
@@ -28,6 +28,16 @@ struct ThreadPoolSettings
     usize SumCount = 1000000;
 };
 
+struct ConcurrentHashMapSettings
+{
+    TKIT_YAML_SERIALIZE_DECLARE(ConcurrentHashMapSettings)
+    TKIT_REFLECT_DECLARE(ConcurrentHashMapSettings)
+    usize MaxThreads = 64;
+    usize Keys = 100000;
+    usize Operations = 2000000;
+    usize ReadPercentage = 90;
+};
+
 struct Settings
 {
     TKIT_YAML_SERIALIZE_DECLARE(Settings)
@@ -35,6 +45,7 @@ struct Settings
     AllocationSettings Allocation{};
     ThreadPoolSettings ThreadPoolSum{};
     ContainerSettings Container{};
+    ConcurrentHashMapSettings ConcurrentHashMap{};
 };
 
 #ifdef TKIT_ENABLE_INFO_LOGS
@@ -1,5 +1,6 @@
 #include "tkit/container/arena_array.hpp"
 #include "tkit/container/dynamic_array.hpp"
+#include "tkit/container/small_array.hpp"
 #include "tkit/container/stack_array.hpp"
 #include "tkit/container/static_array.hpp"
 #include "tkit/container/tier_array.hpp"
@@ -54,11 +55,45 @@ struct Test_Tracker
     }
 };
 
+static u32 g_Moves = 0;
+
+struct Test_Relocatable
+{
+    u32 Value;
+    Test_Relocatable(const u32 value) : Value(value)
+    {
+    }
+    Test_Relocatable(const Test_Relocatable &other) : Value(other.Value)
+    {
+    }
+    Test_Relocatable(Test_Relocatable &&other) : Value(other.Value)
+    {
+        ++g_Moves;
+    }
+    ~Test_Relocatable()
+    {
+        ++g_Destructions;
+    }
+    Test_Relocatable &operator=(const Test_Relocatable &other) = default;
+    Test_Relocatable &operator=(Test_Relocatable &&other)
+    {
+        Value = other.Value;
+        ++g_Moves;
+        return *this;
+    }
+};
+
+template <> struct TKit::IsTriviallyRelocatable<Test_Relocatable> : std::true_type
+{
+};
+
 template <typename T> using StaticAlloc4 = StaticAllocation<T, 4>;
 template <typename T> using StaticAlloc5 = StaticAllocation<T, 5>;
 template <typename T> using StaticAlloc6 = StaticAllocation<T, 6>;
 template <typename T> using StaticAlloc7 = StaticAllocation<T, 7>;
 template <typename T> using StaticAlloc15 = StaticAllocation<T, 15>;
+template <typename T> using SmallAlloc2 = SmallAllocation<T, 2>;
+template <typename T> using SmallAlloc4 = SmallAllocation<T, 4>;
 
 // ---------------------------------------------------------------------------
 // Test functions
@@ -309,6 +344,7 @@ TEST_CASE("Array: basic capacity/size queries", "[Array]")
     TestBasic<StackAllocation>(&s_Stack, usize(4));
     TestBasic<StaticAlloc4>();
     TestBasic<TierAllocation>(&s_Tier, usize(4));
+    TestBasic<SmallAlloc4>();
 }
 
 TEST_CASE("Array: Append and Pop", "[Array]")
@@ -318,6 +354,7 @@ TEST_CASE("Array: Append and Pop", "[Array]")
     TestAppendPop<StackAllocation>(&s_Stack, usize(4));
     TestAppendPop<StaticAlloc4>();
     TestAppendPop<TierAllocation>(&s_Tier, usize(4));
+    TestAppendPop<SmallAlloc2>();
 }
 
 TEST_CASE("Array: constructor from size+fill args", "[Array]")
@@ -327,6 +364,7 @@ TEST_CASE("Array: constructor from size+fill args", "[Array]")
     TestSizeFillCtor<StackAllocation>(&s_Stack, usize(4));
     TestSizeFillCtor<StaticAlloc4>();
     TestSizeFillCtor<TierAllocation>(&s_Tier, usize(4));
+    TestSizeFillCtor<SmallAlloc2>();
 }
 
 TEST_CASE("Array: initializer_list & range constructors", "[Array]")
@@ -336,6 +374,7 @@ TEST_CASE("Array: initializer_list & range constructors", "[Array]")
     TestInitListRange<StackAllocation>(&s_Stack, usize(4));
     TestInitListRange<StaticAlloc4>();
     TestInitListRange<TierAllocation>(&s_Tier, usize(4));
+    TestInitListRange<SmallAlloc2>();
 }
 
 TEST_CASE("Array: copy/move ctor and assignment", "[Array]")
@@ -345,6 +384,7 @@ TEST_CASE("Array: copy/move ctor and assignment", "[Array]")
     TestCopyMove<StackAllocation>(&s_Stack, usize(4));
     TestCopyMove<StaticAlloc4>();
     TestCopyMove<TierAllocation>(&s_Tier, usize(4));
+    TestCopyMove<SmallAlloc2>();
 }
 
 TEST_CASE("Array: member Insert wrappers", "[Array]")
@@ -354,6 +394,7 @@ TEST_CASE("Array: member Insert wrappers", "[Array]")
     TestInsert<StackAllocation>(&s_Stack, usize(7));
     TestInsert<StaticAlloc7>();
     TestInsert<TierAllocation>(&s_Tier, usize(7));
+    TestInsert<SmallAlloc2>();
 }
 
 TEST_CASE("Array: member RemoveOrdered/Unordered wrappers", "[Array]")
@@ -363,6 +404,7 @@ TEST_CASE("Array: member RemoveOrdered/Unordered wrappers", "[Array]")
     TestRemove<StackAllocation>(&s_Stack, usize(6));
     TestRemove<StaticAlloc6>();
     TestRemove<TierAllocation>(&s_Tier, usize(6));
+    TestRemove<SmallAlloc2>();
 }
 
 TEST_CASE("Array: Resize", "[Array]")
@@ -372,6 +414,7 @@ TEST_CASE("Array: Resize", "[Array]")
     TestResize<StackAllocation>(&s_Stack, usize(5));
     TestResize<StaticAlloc5>();
     TestResize<TierAllocation>(&s_Tier, usize(5));
+    TestResize<SmallAlloc2>();
 }
 
 TEST_CASE("Array: Clear and iteration", "[Array]")
@@ -381,6 +424,7 @@ TEST_CASE("Array: Clear and iteration", "[Array]")
     TestClearIteration<StackAllocation>(&s_Stack, usize(4));
     TestClearIteration<StaticAlloc4>();
     TestClearIteration<TierAllocation>(&s_Tier, usize(4));
+    TestClearIteration<SmallAlloc2>();
 }
 
 TEST_CASE("Array<std::string>: basic operations", "[Array][string]")
@@ -390,7 +434,82 @@ TEST_CASE("Array<std::string>: basic operations", "[Array][string]")
     TestStringOps<StackAllocation>(&s_Stack, usize(15));
     TestStringOps<StaticAlloc15>();
     TestStringOps<TierAllocation>(&s_Tier, usize(15));
+    TestStringOps<SmallAlloc4>();
+}
+TEST_CASE("Array: tier growth reuses the slot when the tier does not change", "[Array][tier]")
+{
+    TierArray<u32> arr{&s_Tier};
+    arr.Reserve(100);
+    const u32 *data = arr.GetData();
+    if (s_Tier.IsSameTier(100 * sizeof(u32), 104 * sizeof(u32)))
+    {
+        arr.Reserve(104);
+        REQUIRE(arr.GetData() == data);
+        REQUIRE(arr.GetCapacity() == 104);
+    }
+
+    g_Constructions = g_Destructions = 0;
+    {
+        TierArray<Test_Tracker> trackers{&s_Tier};
+        trackers.Reserve(100);
+        for (u32 i = 0; i < 100; ++i)
+            trackers.Append(i);
+        const Test_Tracker *tdata = trackers.GetData();
+        if (s_Tier.IsSameTier(100 * sizeof(Test_Tracker), 104 * sizeof(Test_Tracker)))
+        {
+            trackers.Reserve(104);
+            REQUIRE(trackers.GetData() == tdata);
+            REQUIRE(g_Constructions == 100);
+        }
+        for (u32 i = 0; i < 1000; ++i)
+            trackers.Append(i);
+        for (u32 i = 0; i < 100; ++i)
+            REQUIRE(trackers[i].Value == i);
+    }
+    REQUIRE(g_Constructions == g_Destructions);
+}
+
+TEST_CASE("Array: tier arrays grow past the max allocation", "[Array][tier]")
+{
+    TierArray<u32> arr{&s_Tier};
+    const u32 count = u32(4 * s_Tier.GetMaxAllocation() / sizeof(u32));
+    for (u32 i = 0; i < count; ++i)
+        arr.Append(i);
+    REQUIRE(arr.GetSize() == count);
+    REQUIRE(!s_Tier.Belongs(arr.GetData()));
+    REQUIRE(s_Tier.GetLargeAllocationCount() == 1);
+
+    bool intact = true;
+    for (u32 i = 0; i < count; ++i)
+        intact &= arr[i] == i;
+    REQUIRE(intact);
+
+    arr.Resize(16);
+    arr.Shrink();
+    REQUIRE(s_Tier.Belongs(arr.GetData()));
+    REQUIRE(s_Tier.GetLargeAllocationCount() == 0);
+    REQUIRE(arr[15] == 15);
+}
+
+TEST_CASE("Array: big dynamic arrays keep their contents when growing", "[Array]")
+{
+    DynamicArray<u64> arr{};
+    const u64 count = 4 * PageAllocationThreshold / sizeof(u64);
+    for (u64 i = 0; i < count; ++i)
+        arr.Append(i * 3);
+    REQUIRE(arr.GetSize() == count);
+
+    bool intact = true;
+    for (u64 i = 0; i < count; ++i)
+        intact &= arr[i] == i * 3;
+    REQUIRE(intact);
+
+    arr.Resize(8);
+    arr.Shrink();
+    REQUIRE(arr.GetSize() == 8);
+    REQUIRE(arr[7] == 21);
 }
+
 TEST_CASE("Bug1: RemoveOrdered single missing null terminator", "[Array][string][bug]")
 {
     using DynStr = Array<char, DynamicAllocation<char>>;
@@ -475,3 +594,125 @@ TEST_CASE("Bug5: Insert single element from shifted range", "[Array][bug]")
     REQUIRE(arr.GetSize() == 5);
     REQUIRE(arr[0] == "C"); // FAILS: gets "B" or empty string
 }
+
+TEST_CASE("Array: trivially relocatable elements are never moved", "[Array]")
+{
+    static_assert(TriviallyRelocatable<Test_Relocatable>);
+    static_assert(TriviallyRelocatable<DynamicArray<std::string>>);
+    static_assert(!TriviallyRelocatable<Test_Tracker>);
+
+    g_Moves = 0;
+    g_Destructions = 0;
+    DynamicArray<Test_Relocatable> arr{};
+    for (u32 i = 0; i < 100; ++i)
+        arr.Append(i);
+
+    arr.Insert(arr.begin() + 10, Test_Relocatable{1000});
+    arr.Insert(arr.begin(), arr[50]);
+    REQUIRE(arr.GetSize() == 102);
+    REQUIRE(arr[0].Value == 49);
+    REQUIRE(arr[11].Value == 1000);
+
+    const u32 destructions = g_Destructions;
+    arr.RemoveOrdered(arr.begin() + 11);
+    arr.RemoveUnordered(arr.begin());
+    REQUIRE(g_Destructions == destructions + 2);
+    REQUIRE(arr.GetSize() == 100);
+    REQUIRE(arr[0].Value == 99);
+    for (u32 i = 1; i < 100; ++i)
+        REQUIRE(arr[i].Value == i - 1);
+
+    // Only the temporary passed to Insert is moved
+    REQUIRE(g_Moves == 1);
+}
+
+TEST_CASE("Array: nested arrays survive relocation", "[Array]")
+{
+    DynamicArray<DynamicArray<std::string>> arr{};
+    for (u32 i = 0; i < 64; ++i)
+    {
+        DynamicArray<std::string> &inner = arr.Append();
+        for (u32 j = 0; j <= i % 5; ++j)
+            inner.Append(std::to_string(i * 10 + j));
+    }
+
+    arr.RemoveOrdered(arr.begin() + 3);
+    arr.RemoveUnordered(arr.begin());
+    arr.Insert(arr.begin() + 1, arr[10]);
+    REQUIRE(arr.GetSize() == 63);
+    REQUIRE(arr[0].GetSize() == 4);
+    REQUIRE(arr[0][3] == "633");
+    REQUIRE(arr[1][0] == "110");
+    REQUIRE(arr[2][0] == "10");
+    REQUIRE(arr[3][0] == "20");
+    REQUIRE(arr[4][0] == "40");
+}
+
+TEST_CASE("Array: small arrays stay inline until they spill", "[Array][small]")
+{
+    const auto isInline = [](const auto &arr) {
+        const std::byte *data = rcast<const std::byte *>(arr.GetData());
+        const std::byte *self = rcast<const std::byte *>(&arr);
+        return data >= self && data < self + sizeof(arr);
+    };
+
+    g_Constructions = g_Destructions = 0;
+    {
+        SmallArray<Test_Tracker, 4> arr{};
+        REQUIRE(arr.GetCapacity() == 4);
+        for (u32 i = 0; i < 4; ++i)
+            arr.Append(i);
+        REQUIRE(isInline(arr));
+
+        // Moving an inline array moves its elements, as there is no buffer to steal
+        SmallArray<Test_Tracker, 4> moved = std::move(arr);
+        REQUIRE(arr.IsEmpty());
+        REQUIRE(isInline(moved));
+        REQUIRE(moved[3].Value == 3);
+
+        moved.Append(4u);
+        REQUIRE(!isInline(moved));
+        REQUIRE(moved.GetCapacity() > 4);
+        for (u32 i = 0; i < 5; ++i)
+            REQUIRE(moved[i].Value == i);
+
+        const Test_Tracker *data = moved.GetData();
+        arr = std::move(moved);
+        REQUIRE(arr.GetData() == data);
+        REQUIRE(isInline(moved));
+        REQUIRE(moved.GetCapacity() == 4);
+
+        arr.Pop();
+        arr.Shrink();
+        REQUIRE(isInline(arr));
+        REQUIRE(arr.GetCapacity() == 4);
+        REQUIRE(arr[3].Value == 3);
+
+        const SmallArray<Test_Tracker, 4> copy = arr;
+        REQUIRE(isInline(copy));
+        REQUIRE(copy[2].Value == 2);
+    }
+    REQUIRE(g_Constructions == g_Destructions);
+
+    SmallTierArray<u32, 2> tarr{SmallAllocation<u32, 2, TierAllocation<u32>>{&s_Tier}};
+    tarr.Append(1);
+    tarr.Append(2);
+    REQUIRE(isInline(tarr));
+    tarr.Append(3);
+    REQUIRE(s_Tier.Belongs(tarr.GetData()));
+    REQUIRE(tarr[2] == 3);
+
+    SmallArray<SmallArray<std::string, 2>, 2> nested{};
+    for (u32 i = 0; i < 16; ++i)
+    {
+        SmallArray<std::string, 2> &inner = nested.Append();
+        for (u32 j = 0; j <= i % 4; ++j)
+            inner.Append(std::to_string(i * 10 + j));
+    }
+    nested.RemoveOrdered(nested.begin() + 1);
+    REQUIRE(nested.GetSize() == 15);
+    REQUIRE(nested[1][0] == "20");
+    REQUIRE(nested[2][3] == "33");
+    REQUIRE(isInline(nested[0]));
+    REQUIRE(!isInline(nested[2]));
+}
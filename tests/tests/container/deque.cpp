@@ -0,0 +1,285 @@
+#include "tkit/container/deque.hpp"
+#include "tkit/utils/literals.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <deque>
+#include <random>
+#include <string>
+
+using namespace TKit;
+using namespace TKit::Container;
+using namespace TKit::Alias;
+
+static u32 g_Constructions = 0;
+static u32 g_Destructions = 0;
+static ArenaAllocator s_Arena{1_mib};
+static StackAllocator s_Stack{1_mib};
+static TierAllocator s_Tier{{.Allocator = &s_Arena, .MaxAllocation = 16_kib}};
+
+template <typename T> using StaticAlloc8 = StaticAllocation<T, 8>;
+
+struct Test_DequeTracker
+{
+    u32 Value;
+    Test_DequeTracker(const u32 value) : Value(value)
+    {
+        ++g_Constructions;
+    }
+    Test_DequeTracker(const Test_DequeTracker &other) : Value(other.Value)
+    {
+        ++g_Constructions;
+    }
+    Test_DequeTracker(Test_DequeTracker &&other) : Value(other.Value)
+    {
+        ++g_Constructions;
+    }
+    ~Test_DequeTracker()
+    {
+        ++g_Destructions;
+    }
+    Test_DequeTracker &operator=(const Test_DequeTracker &) = default;
+    Test_DequeTracker &operator=(Test_DequeTracker &&) = default;
+};
+
+// ---------------------------------------------------------------------------
+// Test functions
+// ---------------------------------------------------------------------------
+
+template <template <typename> typename A, typename... Args> void TestDequeBasic(Args... args)
+{
+    Deque<u32, A<u32>> dq{A<u32>{args...}};
+    REQUIRE(dq.IsEmpty());
+    REQUIRE(dq.GetCapacity() == 8);
+
+    dq.PushBack(2u);
+    dq.PushBack(3u);
+    dq.PushFront(1u);
+    dq.PushFront(0u);
+    REQUIRE(dq.GetSize() == 4);
+    REQUIRE(dq.GetFront() == 0);
+    REQUIRE(dq.GetBack() == 3);
+    for (u32 i = 0; i < 4; ++i)
+        REQUIRE(dq[i] == i);
+
+    dq.PopFront();
+    dq.PopBack();
+    REQUIRE(dq.GetSize() == 2);
+    REQUIRE(dq.GetFront() == 1);
+    REQUIRE(dq.GetBack() == 2);
+
+    dq.Clear();
+    REQUIRE(dq.IsEmpty());
+}
+
+template <template <typename> typename A, typename... Args> void TestDequeWrapAround(Args... args)
+{
+    Deque<u32, A<u32>> dq{A<u32>{args...}};
+
+    // Work like a FIFO queue so that the head walks around the buffer several times
+    u32 next = 0;
+    u32 expected = 0;
+    for (u32 i = 0; i < 6; ++i)
+        dq.PushBack(next++);
+    for (u32 round = 0; round < 20; ++round)
+    {
+        REQUIRE(dq.GetFront() == expected++);
+        dq.PopFront();
+        REQUIRE(dq.GetFront() == expected++);
+        dq.PopFront();
+        dq.PushBack(next++);
+        dq.PushBack(next++);
+    }
+    REQUIRE(dq.IsFull() == (dq.GetSize() == dq.GetCapacity()));
+    REQUIRE(dq.GetSize() == 6);
+
+    u32 value = expected;
+    for (const u32 x : dq)
+        REQUIRE(x == value++);
+}
+
+template <template <typename> typename A, typename... Args> void TestDequeSpans(Args... args)
+{
+    Deque<u32, A<u32>> dq{A<u32>{args...}};
+    for (u32 i = 0; i < 5; ++i)
+        dq.PushBack(i);
+    REQUIRE(dq.GetSecondSpan().IsEmpty());
+    REQUIRE(dq.GetFirstSpan().GetSize() == 5);
+
+    // Head at 3, elements 3..9 occupy slots 3..7 and 0..1
+    dq.PopFrontRange(3);
+    const u32 more[] = {5, 6, 7, 8, 9};
+    dq.PushBackRange(Span<const u32>{more, 5});
+    REQUIRE(dq.GetSize() == 7);
+
+    const Span<const u32> first = dq.GetFirstSpan();
+    const Span<const u32> second = dq.GetSecondSpan();
+    REQUIRE(first.GetSize() == 5);
+    REQUIRE(second.GetSize() == 2);
+    for (u32 i = 0; i < 5; ++i)
+        REQUIRE(first[i] == i + 3);
+    REQUIRE(second[0] == 8);
+    REQUIRE(second[1] == 9);
+
+    dq.PopFrontRange(7);
+    REQUIRE(dq.IsEmpty());
+}
+
+template <template <typename> typename A, typename... Args> void TestDequeDestruction(Args... args)
+{
+    g_Constructions = g_Destructions = 0;
+    {
+        Deque<Test_DequeTracker, A<Test_DequeTracker>> dq{A<Test_DequeTracker>{args...}};
+        for (u32 i = 0; i < 8; ++i)
+            dq.PushFront(i);
+        dq.PopBack();
+        dq.PopFrontRange(3);
+        dq.PushBack(100u);
+
+        Deque<Test_DequeTracker, A<Test_DequeTracker>> copy{dq};
+        REQUIRE(copy.GetSize() == dq.GetSize());
+        for (usize i = 0; i < dq.GetSize(); ++i)
+            REQUIRE(copy[i].Value == dq[i].Value);
+        copy.Clear();
+    }
+    REQUIRE(g_Constructions == g_Destructions);
+}
+
+// ---------------------------------------------------------------------------
+// TEST_CASEs
+// ---------------------------------------------------------------------------
+
+TEST_CASE("Deque: push and pop at both ends", "[Deque]")
+{
+    TestDequeBasic<ArenaAllocation>(&s_Arena, usize(8));
+    TestDequeBasic<DynamicAllocation>(usize(8));
+    TestDequeBasic<StackAllocation>(&s_Stack, usize(8));
+    TestDequeBasic<StaticAlloc8>();
+    TestDequeBasic<TierAllocation>(&s_Tier, usize(8));
+}
+
+TEST_CASE("Deque: indices wrap around the buffer", "[Deque]")
+{
+    TestDequeWrapAround<ArenaAllocation>(&s_Arena, usize(8));
+    TestDequeWrapAround<DynamicAllocation>(usize(8));
+    TestDequeWrapAround<StackAllocation>(&s_Stack, usize(8));
+    TestDequeWrapAround<StaticAlloc8>();
+    TestDequeWrapAround<TierAllocation>(&s_Tier, usize(8));
+}
+
+TEST_CASE("Deque: two span access and bulk operations", "[Deque]")
+{
+    TestDequeSpans<ArenaAllocation>(&s_Arena, usize(8));
+    TestDequeSpans<DynamicAllocation>(usize(8));
+    TestDequeSpans<StackAllocation>(&s_Stack, usize(8));
+    TestDequeSpans<StaticAlloc8>();
+    TestDequeSpans<TierAllocation>(&s_Tier, usize(8));
+}
+
+TEST_CASE("Deque: elements are destroyed exactly once", "[Deque]")
+{
+    TestDequeDestruction<ArenaAllocation>(&s_Arena, usize(8));
+    TestDequeDestruction<DynamicAllocation>(usize(8));
+    TestDequeDestruction<StackAllocation>(&s_Stack, usize(8));
+    TestDequeDestruction<StaticAlloc8>();
+    TestDequeDestruction<TierAllocation>(&s_Tier, usize(8));
+}
+
+TEST_CASE("Deque: capacity is rounded up to a power of two", "[Deque]")
+{
+    DynamicDeque<u32> dynamic{usize(5)};
+    REQUIRE(dynamic.GetCapacity() == 8);
+    ArenaDeque<u32> arena{usize(100), &s_Arena};
+    REQUIRE(arena.GetCapacity() == 128);
+    TierDeque<u32> tier{usize(3), &s_Tier};
+    REQUIRE(tier.GetCapacity() == 4);
+}
+
+TEST_CASE("Deque: growing deques keep their order", "[Deque]")
+{
+    g_Constructions = g_Destructions = 0;
+    {
+        DynamicDeque<Test_DequeTracker> dynamic{};
+        TierDeque<Test_DequeTracker> tier{usize(0), &s_Tier};
+        std::deque<u32> ref{};
+
+        std::mt19937 rng{42};
+        for (u32 i = 0; i < 5000; ++i)
+        {
+            const u32 op = rng() % 8;
+            if (op < 3)
+            {
+                dynamic.PushBack(i);
+                tier.PushBack(i);
+                ref.push_back(i);
+            }
+            else if (op < 6)
+            {
+                dynamic.PushFront(i);
+                tier.PushFront(i);
+                ref.push_front(i);
+            }
+            else if (!ref.empty() && op == 6)
+            {
+                dynamic.PopFront();
+                tier.PopFront();
+                ref.pop_front();
+            }
+            else if (!ref.empty())
+            {
+                dynamic.PopBack();
+                tier.PopBack();
+                ref.pop_back();
+            }
+        }
+
+        REQUIRE(dynamic.GetSize() == ref.size());
+        REQUIRE(tier.GetSize() == ref.size());
+        bool valid = true;
+        for (usize i = 0; i < ref.size(); ++i)
+            valid &= dynamic[i].Value == ref[i] && tier[i].Value == ref[i];
+        REQUIRE(valid);
+
+        // Pushing one of its own elements must not read from the buffer that is being released
+        while (!dynamic.IsFull())
+            dynamic.PushBack(0u);
+        const u32 front = dynamic.GetFront().Value;
+        dynamic.PushBack(dynamic.GetFront());
+        REQUIRE(dynamic.GetBack().Value == front);
+        dynamic.PushFront(dynamic.GetBack());
+        REQUIRE(dynamic.GetFront().Value == front);
+    }
+    REQUIRE(g_Constructions == g_Destructions);
+}
+
+TEST_CASE("Deque: copy and move", "[Deque]")
+{
+    DynamicDeque<std::string> dq{};
+    for (u32 i = 0; i < 10; ++i)
+        dq.PushFront(std::to_string(i));
+
+    DynamicDeque<std::string> copy{dq};
+    REQUIRE(copy.GetSize() == 10);
+    REQUIRE(copy.GetFront() == "9");
+    REQUIRE(copy.GetBack() == "0");
+
+    DynamicDeque<std::string> moved{std::move(dq)};
+    REQUIRE(dq.IsEmpty());
+    REQUIRE(moved.GetSize() == 10);
+
+    StaticDeque<std::string, 16> st{};
+    for (u32 i = 0; i < 12; ++i)
+        st.PushBack(std::to_string(i));
+    st.PopFrontRange(6);
+    for (u32 i = 12; i < 18; ++i)
+        st.PushBack(std::to_string(i));
+
+    StaticDeque<std::string, 16> stMoved{};
+    stMoved = std::move(st);
+    REQUIRE(st.IsEmpty());
+    REQUIRE(stMoved.GetSize() == 12);
+    for (usize i = 0; i < 12; ++i)
+        REQUIRE(stMoved[i] == std::to_string(i + 6));
+
+    copy = moved;
+    REQUIRE(copy.GetSize() == 10);
+    REQUIRE(copy.GetFront() == "9");
+}
@@ -0,0 +1,248 @@
+#include "tkit/container/flat_map.hpp"
+#include "tkit/container/flat_set.hpp"
+#include "tkit/utils/literals.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace TKit;
+using namespace TKit::Container;
+using namespace TKit::Alias;
+
+static ArenaAllocator s_Arena{1_mib};
+static StackAllocator s_Stack{1_mib};
+static TierAllocator s_Tier{{.Allocator = &s_Arena, .MaxAllocation = 16_kib}};
+
+template <typename T> using StaticAlloc16 = StaticAllocation<T, 16>;
+
+// ---------------------------------------------------------------------------
+// Test functions
+// ---------------------------------------------------------------------------
+
+template <template <typename> typename A, typename... Args> void TestFlatMapBasic(Args... args)
+{
+    FlatMap<u32, u32, A<u32>> map{A<u32>{args...}, A<u32>{args...}};
+    REQUIRE(map.IsEmpty());
+
+    map.Insert(5u, 50u);
+    map.Insert(1u, 10u);
+    map.Insert(3u, 30u);
+    REQUIRE(map.GetSize() == 3);
+    REQUIRE(map.At(1) == 10);
+    REQUIRE(map[3] == 30);
+    REQUIRE(map.Contains(5));
+    REQUIRE(!map.Contains(4));
+    REQUIRE(map.Find(4) == map.end());
+
+    bool existed = false;
+    REQUIRE(map.TryInsert(&existed, 3u, 0u) == 30);
+    REQUIRE(existed);
+    map[4] = 40;
+    REQUIRE(map.Find(4)->Value == 40);
+
+    u32 previous = 0;
+    for (const auto &[key, value] : map)
+    {
+        REQUIRE(key > previous);
+        REQUIRE(value == key * 10);
+        previous = key;
+    }
+
+    REQUIRE(map.Remove(1u));
+    REQUIRE(!map.Remove(1u));
+    REQUIRE(map.GetKeys()[0] == 3);
+    REQUIRE(map.GetValues()[0] == 30);
+}
+
+template <template <typename> typename A, typename... Args> void TestFlatMapBulk(Args... args)
+{
+    FlatMap<u32, u32, A<u32>> map{A<u32>{args...}, A<u32>{args...}};
+    map.Insert(8u, 0u);
+
+    // Duplicated keys keep the first value they were given, and keys already in the map keep theirs
+    const u32 keys[] = {6, 2, 8, 4, 2, 0};
+    const u32 values[] = {6, 2, 1, 4, 9, 0};
+    map.InsertBulk(Span<const u32>{keys, 6}, Span<const u32>{values, 6});
+    REQUIRE(map.GetSize() == 5);
+    for (u32 i = 0; i < 5; ++i)
+    {
+        REQUIRE(map.GetKeys()[i] == 2 * i);
+        REQUIRE(map.GetValues()[i] == (i == 4 ? 0 : 2 * i));
+    }
+
+    const auto range = map.GetRange(2u, 7u);
+    REQUIRE(range.Keys.GetSize() == 3);
+    REQUIRE(range.Keys[0] == 2);
+    REQUIRE(range.Values[2] == 6);
+    REQUIRE(map.LowerBound(3u)->Key == 4);
+    REQUIRE(map.UpperBound(4u)->Key == 6);
+    REQUIRE(map.UpperBound(8u) == map.end());
+    REQUIRE(map.GetRange(7u, 2u).Keys.IsEmpty());
+}
+
+template <template <typename> typename A, typename... Args> void TestFlatSet(Args... args)
+{
+    FlatSet<u32, A<u32>> set{A<u32>{args...}};
+    set.Insert(7u);
+    set.InsertBulk(std::initializer_list<u32>{3, 9, 1, 7, 3, 5});
+    REQUIRE(set.GetSize() == 5);
+    REQUIRE(std::is_sorted(set.begin(), set.end()));
+    REQUIRE(std::adjacent_find(set.begin(), set.end()) == set.end());
+
+    REQUIRE(set.Contains(5));
+    REQUIRE(!set.Contains(4));
+    REQUIRE(*set.LowerBound(4u) == 5);
+    REQUIRE(*set.UpperBound(5u) == 7);
+    REQUIRE(set.GetRange(3u, 8u).GetSize() == 3);
+
+    bool existed = false;
+    set.TryInsert(4u, &existed);
+    REQUIRE(!existed);
+    REQUIRE(set.Remove(3u));
+    REQUIRE(*set.Remove(set.Find(4u)) == 5);
+    REQUIRE(set.GetSize() == 4);
+}
+
+// ---------------------------------------------------------------------------
+// TEST_CASEs
+// ---------------------------------------------------------------------------
+
+TEST_CASE("FlatMap: insertion and lookup", "[FlatMap]")
+{
+    TestFlatMapBasic<ArenaAllocation>(&s_Arena, usize(16));
+    TestFlatMapBasic<DynamicAllocation>();
+    TestFlatMapBasic<StackAllocation>(&s_Stack, usize(16));
+    TestFlatMapBasic<StaticAlloc16>();
+    TestFlatMapBasic<TierAllocation>(&s_Tier);
+}
+
+TEST_CASE("FlatMap: bulk build and range queries", "[FlatMap]")
+{
+    TestFlatMapBulk<ArenaAllocation>(&s_Arena, usize(16));
+    TestFlatMapBulk<DynamicAllocation>();
+    TestFlatMapBulk<StackAllocation>(&s_Stack, usize(16));
+    TestFlatMapBulk<StaticAlloc16>();
+    TestFlatMapBulk<TierAllocation>(&s_Tier);
+}
+
+TEST_CASE("FlatSet: insertion, lookup and ranges", "[FlatSet]")
+{
+    TestFlatSet<ArenaAllocation>(&s_Arena, usize(16));
+    TestFlatSet<DynamicAllocation>();
+    TestFlatSet<StackAllocation>(&s_Stack, usize(16));
+    TestFlatSet<StaticAlloc16>();
+    TestFlatSet<TierAllocation>(&s_Tier);
+}
+
+TEST_CASE("FlatMap: branchless search matches std::map", "[FlatMap]")
+{
+    std::mt19937 rng{7};
+    std::map<u32, u32> ref{};
+    DynamicArray<KeyValuePair<u32, u32>> pairs{};
+    for (u32 i = 0; i < 3000; ++i)
+    {
+        const u32 key = rng() % 10000;
+        pairs.Append(key, i);
+        ref.emplace(key, i);
+    }
+
+    const DynamicFlatMap<u32, u32> map{pairs.begin(), pairs.end()};
+    REQUIRE(map.GetSize() == ref.size());
+
+    bool valid = true;
+    for (u32 key = 0; key < 10001; ++key)
+    {
+        const auto lower = ref.lower_bound(key);
+        const auto upper = ref.upper_bound(key);
+        const auto it = map.Find(key);
+        valid &= (lower != ref.end() && lower->first == key) ? it->Value == lower->second : it == map.end();
+        valid &= lower == ref.end() ? map.LowerBound(key) == map.end() : map.LowerBound(key)->Key == lower->first;
+        valid &= upper == ref.end() ? map.UpperBound(key) == map.end() : map.UpperBound(key)->Key == upper->first;
+    }
+    REQUIRE(valid);
+}
+
+TEST_CASE("FlatMap: bulk inserts merge with the existing entries", "[FlatMap]")
+{
+    std::mt19937 rng{11};
+    std::map<u32, std::string> ref{};
+    DynamicFlatMap<u32, std::string> map{};
+    for (u32 round = 0; round < 4; ++round)
+    {
+        DynamicArray<KeyValuePair<u32, std::string>> pairs{};
+        for (u32 i = 0; i < 500; ++i)
+        {
+            const u32 key = rng() % 1000;
+            pairs.Append(key, std::to_string(round * 500 + i));
+            ref.emplace(key, std::to_string(round * 500 + i));
+        }
+        map.InsertBulk(pairs);
+        REQUIRE(map.GetSize() == ref.size());
+    }
+
+    bool valid = true;
+    usize i = 0;
+    for (const auto &[key, value] : ref)
+    {
+        valid &= map.GetKeys()[i] == key && map.GetValues()[i] == value;
+        ++i;
+    }
+    REQUIRE(valid);
+}
+
+TEST_CASE("FlatSet: bulk inserts merge with the existing keys", "[FlatSet]")
+{
+    std::mt19937 rng{13};
+    std::set<u32> ref{};
+    StackFlatSet<u32> set{StackAllocation<u32>{&s_Stack, usize(2000)}};
+    for (u32 round = 0; round < 4; ++round)
+    {
+        DynamicArray<u32> keys{};
+        for (u32 i = 0; i < 500; ++i)
+        {
+            const u32 key = rng() % 1000;
+            keys.Append(key);
+            ref.insert(key);
+        }
+        set.InsertBulk(keys);
+        REQUIRE(set.GetSize() == ref.size());
+    }
+    REQUIRE(std::equal(set.begin(), set.end(), ref.begin()));
+}
+
+TEST_CASE("FlatMap: values are constructed with parentheses", "[FlatMap]")
+{
+    DynamicFlatMap<i32, f32> map{};
+    const f64 value = 2.5;
+    REQUIRE(map.Insert(1, value) == 2.5f);
+
+    // Braces would pick the initializer list constructor and build a single element array
+    DynamicFlatMap<u32, std::vector<u32>> vectors{};
+    REQUIRE(vectors.Insert(1u, usize(3), 7u).size() == 3);
+}
+
+TEST_CASE("FlatMap: string keys and heterogeneous lookup", "[FlatMap]")
+{
+    DynamicFlatMap<std::string, u32> map{{"delta", 4u}, {"alpha", 1u}, {"charlie", 3u}, {"bravo", 2u}};
+    REQUIRE(map.GetKeys()[0] == "alpha");
+    REQUIRE(map.GetKeys()[3] == "delta");
+
+    const std::string_view key = "charlie";
+    REQUIRE(map.At(key) == 3);
+    REQUIRE(map.Contains("bravo"));
+    REQUIRE(map.GetRange("b", "d").Keys.GetSize() == 2);
+    REQUIRE(map.Remove(std::string_view{"alpha"}));
+    REQUIRE(!map.Contains("alpha"));
+
+    DynamicFlatMap<std::string, u32> copy{map};
+    REQUIRE(copy.GetSize() == 3);
+    REQUIRE(copy.At("delta") == 4);
+
+    DynamicFlatSet<DynamicString> set{"b", "a", "c"};
+    REQUIRE(set.Contains("a"));
+    REQUIRE(*set.begin() == "a");
+}
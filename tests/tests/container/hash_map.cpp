@@ -1,6 +1,8 @@
 #include "tkit/container/hash_map.hpp"
+#include "tkit/container/dynamic_array.hpp"
 #include "tkit/utils/literals.hpp"
 #include <catch2/catch_test_macros.hpp>
+#include <cctype>
 #include <string>
 
 using namespace TKit;
@@ -341,6 +343,44 @@ template <template <typename> typename A, typename... Args> void TestMapLoadFact
     REQUIRE(map.GetLoadFactor() > lf);
 }
 
+template <template <typename> typename A, typename... Args> void TestMapManyGroups(Args... args)
+{
+    using Node = MapNode<u32, std::string>;
+    HashMap<u32, std::string, A<Node>> map{256, A<Node>{args...}};
+
+    // Enough keys to spread over several groups and force probing past full ones in every allocation state
+    for (u32 i = 0; i < 150; ++i)
+        map.Insert(i * 7919u, std::to_string(i));
+    REQUIRE(map.GetSize() == 150);
+
+    for (u32 round = 0; round < 20; ++round)
+    {
+        for (u32 i = round % 2; i < 150; i += 2)
+            REQUIRE(map.Remove(i * 7919u));
+        for (u32 i = round % 2; i < 150; i += 2)
+            map.Insert(i * 7919u, std::to_string(i + round));
+    }
+    REQUIRE(map.GetSize() == 150);
+
+    bool valid = true;
+    for (u32 i = 0; i < 150; ++i)
+    {
+        const auto it = map.Find(i * 7919u);
+        valid &= it != map.end() && it->Value == std::to_string(i + (i % 2 == 0 ? 18 : 19));
+    }
+    REQUIRE(valid);
+    REQUIRE_FALSE(map.Contains(7u));
+
+    usize count = 0;
+    for (auto it = map.begin(); it != map.end();)
+    {
+        it = it->Key % 3 == 0 ? map.Remove(it) : it.Next();
+        ++count;
+    }
+    REQUIRE(count == 150);
+    REQUIRE(map.GetSize() == 100);
+}
+
 // ---------------------------------------------------------------------------
 // TEST_CASEs
 // ---------------------------------------------------------------------------
@@ -408,5 +448,204 @@ TEST_CASE("HashMap: load factor", "[HashMap]")
 {
     MAP_TEST_ALL(TestMapLoadFactor, 16);
 }
+TEST_CASE("HashMap: churn across many groups", "[HashMap]")
+{
+    MAP_TEST_ALL(TestMapManyGroups, 16);
+}
 
 #undef MAP_TEST_ALL
+
+TEST_CASE("HashMap: rehash relocates array values", "[HashMap]")
+{
+    static_assert(TriviallyRelocatable<KeyValuePair<u32, DynamicArray<std::string>>>);
+
+    DynamicHashMap<u32, DynamicArray<std::string>> map{};
+    for (u32 i = 0; i < 200; ++i)
+    {
+        DynamicArray<std::string> &values = map.Insert(i);
+        for (u32 j = 0; j <= i % 4; ++j)
+            values.Append(std::to_string(i) + "-" + std::to_string(j));
+    }
+    for (u32 i = 0; i < 200; i += 3)
+        map.Remove(i);
+
+    for (u32 i = 0; i < 200; ++i)
+    {
+        const auto entry = map.Find(i);
+        if (i % 3 == 0)
+        {
+            REQUIRE(entry == map.end());
+            continue;
+        }
+        REQUIRE(entry != map.end());
+        REQUIRE(entry->Value.GetSize() == i % 4 + 1);
+        REQUIRE(entry->Value.GetBack() == std::to_string(i) + "-" + std::to_string(i % 4));
+    }
+}
+
+TEST_CASE("HashMap: heterogeneous lookup with string keys", "[HashMap][string]")
+{
+    DynamicHashMap<DynamicString, u32> map{};
+    map.Insert(DynamicString{"alpha"}, 1u);
+    map.Insert(DynamicString{"beta"}, 2u);
+
+    const std::string_view view = "beta";
+    REQUIRE(map.Contains("alpha"));
+    REQUIRE(map.Contains(view));
+    REQUIRE(map.Contains(std::string("alpha")));
+    REQUIRE_FALSE(map.Contains("gamma"));
+    REQUIRE(map.Find(view)->Value == 2u);
+    REQUIRE(map.At("alpha") == 1u);
+
+    const auto &cmap = map;
+    REQUIRE(cmap.At(view) == 2u);
+    REQUIRE(cmap.Find("gamma") == cmap.end());
+
+    REQUIRE(map.Remove("alpha"));
+    REQUIRE_FALSE(map.Contains(DynamicString{"alpha"}));
+    REQUIRE(map.GetSize() == 1);
+}
+
+struct Test_CaseInsensitiveHash
+{
+    usz operator()(const std::string &str) const
+    {
+        usz hash = 0;
+        for (const char c : str)
+            hash = hash * 31 + usz(std::tolower(c));
+        return hash;
+    }
+};
+struct Test_CaseInsensitiveEqual
+{
+    bool operator()(const std::string &lhs, const std::string &rhs) const
+    {
+        if (lhs.size() != rhs.size())
+            return false;
+        for (usz i = 0; i < lhs.size(); ++i)
+            if (std::tolower(lhs[i]) != std::tolower(rhs[i]))
+                return false;
+        return true;
+    }
+};
+
+TEST_CASE("HashMap: custom hasher and key equality", "[HashMap][string]")
+{
+    DynamicHashMap<std::string, u32, Test_CaseInsensitiveHash, Test_CaseInsensitiveEqual> map{};
+    map.Insert("Key", 1u);
+
+    bool existed = false;
+    map.TryInsert(&existed, "KEY", 2u);
+    REQUIRE(existed);
+    REQUIRE(map.GetSize() == 1);
+    REQUIRE(map.At("key") == 1u);
+
+    // A weak, non avalanching hasher still spreads well over the groups once the map mixes it
+    for (u32 i = 0; i < 1000; ++i)
+        map.Insert("k" + std::to_string(i), i);
+    bool valid = true;
+    for (u32 i = 0; i < 1000; ++i)
+        valid &= map.At("K" + std::to_string(i)) == i;
+    REQUIRE(valid);
+}
+
+TEST_CASE("HashMap: churn does not grow the table", "[HashMap]")
+{
+    using Node = MapNode<u32, u32>;
+    DynamicHashMap<u32, u32> dmap(256);
+    HashMap<u32, u32, ArenaAllocation<Node>> amap{256, ArenaAllocation<Node>{&s_Arena, 16}};
+    const usize buckets = dmap.GetBucketCount();
+
+    // A sliding window of live keys, as in a session table
+    for (u32 i = 0; i < 100; ++i)
+    {
+        dmap.Insert(i, i);
+        amap.Insert(i, i);
+    }
+    for (u32 i = 0; i < 50000; ++i)
+    {
+        REQUIRE(dmap.Remove(i));
+        REQUIRE(amap.Remove(i));
+        dmap.Insert(i + 100, i);
+        amap.Insert(i + 100, i);
+    }
+    REQUIRE(dmap.GetBucketCount() == buckets);
+    REQUIRE(amap.GetBucketCount() == buckets);
+    REQUIRE(dmap.GetSize() == 100);
+
+    bool valid = true;
+    for (u32 i = 50000; i < 50100; ++i)
+        valid &= dmap.At(i) == i - 100 && amap.At(i) == i - 100;
+    for (u32 i = 49000; i < 50000; ++i)
+        valid &= !dmap.Contains(i) && !amap.Contains(i);
+    REQUIRE(valid);
+}
+
+TEST_CASE("HashMap: static maps grow in place", "[HashMap][string]")
+{
+    StaticHashMap<std::string, std::string, 512> map{};
+    for (u32 i = 0; i < 300; ++i)
+        map.Insert(std::to_string(i), "value-" + std::to_string(i));
+    for (u32 i = 0; i < 300; i += 2)
+        map.Remove(std::to_string(i));
+    for (u32 i = 300; i < 400; ++i)
+        map.Insert(std::to_string(i), "value-" + std::to_string(i));
+
+    REQUIRE(map.GetSize() == 250);
+    bool valid = true;
+    for (u32 i = 0; i < 400; ++i)
+    {
+        const auto it = map.Find(std::to_string(i));
+        if (i < 300 && i % 2 == 0)
+            valid &= it == map.end();
+        else
+            valid &= it != map.end() && it->Value == "value-" + std::to_string(i);
+    }
+    REQUIRE(valid);
+}
+
+TEST_CASE("HashMap: bulk insertion and batch lookup", "[HashMap]")
+{
+    DynamicArray<KeyValuePair<u32, u32>> pairs{};
+    for (u32 i = 0; i < 5000; ++i)
+        pairs.Append(i * 3, i);
+
+    DynamicHashMap<u32, u32> map{};
+    map.InsertBulk(pairs);
+    REQUIRE(map.GetSize() == 5000);
+    // Grown once upfront instead of doubling along the way
+    REQUIRE(map.GetLoadFactor() <= TKIT_HASH_LOAD_FACTOR_THRESHOLD);
+
+    StaticHashMap<u32, u32, 64> small{};
+    small.InsertBulk(pairs.begin(), pairs.begin() + 40);
+    REQUIRE(small.GetSize() == 40);
+
+    DynamicArray<u32> keys{};
+    for (u32 i = 0; i < 1000; ++i)
+        keys.Append(i * 5);
+    DynamicArray<u32 *> values{keys.GetSize()};
+    const usize found = map.FindBatch(keys, values);
+
+    usize expected = 0;
+    bool valid = true;
+    for (usize i = 0; i < keys.GetSize(); ++i)
+    {
+        if (keys[i] % 3 == 0)
+        {
+            ++expected;
+            valid &= values[i] && *values[i] == keys[i] / 3;
+        }
+        else
+            valid &= !values[i];
+    }
+    REQUIRE(valid);
+    REQUIRE(found == expected);
+
+    DynamicArray<const u32 *> cvalues{keys.GetSize()};
+    const DynamicHashMap<u32, u32> &cmap = map;
+    REQUIRE(cmap.FindBatch(keys, cvalues) == expected);
+
+    const DynamicHashMap<u32, u32> empty{};
+    REQUIRE(empty.FindBatch(keys, cvalues) == 0);
+    REQUIRE(!cvalues[0]);
+}
@@ -253,6 +253,33 @@ template <template <typename> typename A, typename... Args> void TestSetLoadFact
     REQUIRE(set.GetLoadFactor() > lf1);
 }
 
+template <template <typename> typename A, typename... Args> void TestSetManyGroups(Args... args)
+{
+    using Node = SetNode<u32>;
+    HashSet<u32, A<Node>> set{256, A<Node>{args...}};
+
+    for (u32 i = 0; i < 150; ++i)
+        set.Insert(i * 7919u);
+    for (u32 round = 0; round < 20; ++round)
+    {
+        for (u32 i = round % 3; i < 150; i += 3)
+            REQUIRE(set.Remove(i * 7919u));
+        for (u32 i = round % 3; i < 150; i += 3)
+            set.Insert(i * 7919u);
+    }
+    REQUIRE(set.GetSize() == 150);
+
+    bool valid = true;
+    for (u32 i = 0; i < 150; ++i)
+        valid &= set.Contains(i * 7919u) && !set.Contains(i * 7919u + 1);
+    REQUIRE(valid);
+
+    u64 sum = 0;
+    for (const u32 key : set)
+        sum += key;
+    REQUIRE(sum == u64(7919) * (149 * 150 / 2));
+}
+
 // ---------------------------------------------------------------------------
 // TEST_CASEs
 // ---------------------------------------------------------------------------
@@ -308,5 +335,67 @@ TEST_CASE("HashSet: load factor", "[HashSet]")
 {
     SET_TEST_ALL(TestSetLoadFactor, 16);
 }
+TEST_CASE("HashSet: churn across many groups", "[HashSet]")
+{
+    SET_TEST_ALL(TestSetManyGroups, 16);
+}
 
 #undef SET_TEST_ALL
+
+TEST_CASE("HashSet: heterogeneous lookup with string keys", "[HashSet][string]")
+{
+    DynamicHashSet<std::string> set{};
+    set.Insert("alpha");
+    set.Insert("beta");
+
+    REQUIRE(set.Contains("alpha"));
+    REQUIRE(set.Contains(std::string_view{"beta"}));
+    REQUIRE(*set.Find(std::string_view{"beta"}) == "beta");
+    REQUIRE_FALSE(set.Contains("gamma"));
+    REQUIRE(set.Remove(std::string_view{"alpha"}));
+    REQUIRE(set.GetSize() == 1);
+}
+
+TEST_CASE("HashSet: churn does not grow the table", "[HashSet][string]")
+{
+    StaticHashSet<std::string, 256> set{};
+    set.Rehash(128);
+    for (u32 i = 0; i < 40; ++i)
+        set.Insert(std::to_string(i));
+    const usize buckets = set.GetBucketCount();
+
+    for (u32 i = 0; i < 20000; ++i)
+    {
+        REQUIRE(set.Remove(std::to_string(i)));
+        set.Insert(std::to_string(i + 40));
+    }
+    REQUIRE(set.GetBucketCount() == buckets);
+    REQUIRE(set.GetSize() == 40);
+
+    bool valid = true;
+    for (u32 i = 20000; i < 20040; ++i)
+        valid &= set.Contains(std::to_string(i)) && !set.Contains(std::to_string(i - 40));
+    REQUIRE(valid);
+}
+
+TEST_CASE("HashSet: bulk insertion and batch lookup", "[HashSet]")
+{
+    DynamicArray<u32> values{};
+    for (u32 i = 0; i < 3000; ++i)
+        values.Append(i * 2);
+
+    const DynamicHashSet<u32> set{values.begin(), values.end()};
+    REQUIRE(set.GetSize() == 3000);
+    REQUIRE(set.GetLoadFactor() <= TKIT_HASH_LOAD_FACTOR_THRESHOLD);
+
+    DynamicArray<u32> keys{};
+    for (u32 i = 0; i < 500; ++i)
+        keys.Append(i * 3);
+    DynamicArray<const u32 *> found{keys.GetSize()};
+    REQUIRE(set.FindBatch(keys, found) == 250);
+
+    bool valid = true;
+    for (usize i = 0; i < keys.GetSize(); ++i)
+        valid &= keys[i] % 2 == 0 ? found[i] && *found[i] == keys[i] : !found[i];
+    REQUIRE(valid);
+}
@@ -0,0 +1,241 @@
+#include "tkit/container/soa_array.hpp"
+#include "tkit/simd/wide.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+using namespace TKit;
+using namespace TKit::Alias;
+
+struct Test_Particle
+{
+    f32 Mass = 0.f;
+    u8 Flags = 0;
+    f64 Energy = 0.0;
+    std::string Name{};
+    static inline u32 Count = 0;
+};
+
+struct Test_SoaTracker
+{
+    static inline u32 Constructions = 0;
+    static inline u32 Destructions = 0;
+
+    Test_SoaTracker()
+    {
+        ++Constructions;
+    }
+    Test_SoaTracker(const Test_SoaTracker &)
+    {
+        ++Constructions;
+    }
+    Test_SoaTracker(Test_SoaTracker &&)
+    {
+        ++Constructions;
+    }
+    ~Test_SoaTracker()
+    {
+        ++Destructions;
+    }
+    Test_SoaTracker &operator=(const Test_SoaTracker &) = default;
+    Test_SoaTracker &operator=(Test_SoaTracker &&) = default;
+};
+
+struct Test_Tracked
+{
+    u32 Id = 0;
+    Test_SoaTracker Tracker{};
+};
+
+// A trimmed down version of what the reflection code generation emits for these types, so that the tests do not
+// depend on it being enabled
+namespace TKit
+{
+template <> class Reflect<Test_Particle>
+{
+  public:
+    static constexpr bool Implemented = true;
+    static constexpr bool HasMemberFields = true;
+
+    template <typename Ref_Type> struct MemberField
+    {
+        using Type = Ref_Type;
+        const char *Name = nullptr;
+        const char *TypeString = nullptr;
+        Ref_Type Test_Particle::* Pointer = nullptr;
+    };
+
+    template <typename... Ref_Types> static constexpr auto GetMemberFields()
+    {
+        return std::make_tuple(MemberField<f32>{"Mass", "f32", &Test_Particle::Mass},
+                               MemberField<u8>{"Flags", "u8", &Test_Particle::Flags},
+                               MemberField<f64>{"Energy", "f64", &Test_Particle::Energy},
+                               MemberField<std::string>{"Name", "std::string", &Test_Particle::Name});
+    }
+};
+
+template <> class Reflect<Test_Tracked>
+{
+  public:
+    static constexpr bool Implemented = true;
+    static constexpr bool HasMemberFields = true;
+
+    template <typename Ref_Type> struct MemberField
+    {
+        using Type = Ref_Type;
+        const char *Name = nullptr;
+        const char *TypeString = nullptr;
+        Ref_Type Test_Tracked::* Pointer = nullptr;
+    };
+
+    template <typename... Ref_Types> static constexpr auto GetMemberFields()
+    {
+        return std::make_tuple(MemberField<u32>{"Id", "u32", &Test_Tracked::Id},
+                               MemberField<Test_SoaTracker>{"Tracker", "Test_SoaTracker", &Test_Tracked::Tracker});
+    }
+};
+} // namespace TKit
+
+static Test_Particle CreateParticle(const u32 index)
+{
+    return Test_Particle{.Mass = f32(index),
+                         .Flags = u8(index % 7),
+                         .Energy = 2.0 * f64(index),
+                         .Name = "particle-" + std::to_string(index)};
+}
+
+TEST_CASE("SoaArray: field metadata", "[SoaArray]")
+{
+    using Array = SoaArray<Test_Particle>;
+    STATIC_REQUIRE(Array::FieldCount == 4);
+    STATIC_REQUIRE(Array::IndexOf<&Test_Particle::Mass> == 0);
+    STATIC_REQUIRE(Array::IndexOf<&Test_Particle::Energy> == 2);
+    STATIC_REQUIRE(Array::IndexOf<&Test_Particle::Name> == 3);
+    STATIC_REQUIRE(std::is_same_v<Array::FieldType<1>, u8>);
+}
+
+TEST_CASE("SoaArray: append, access and growth", "[SoaArray]")
+{
+    SoaArray<Test_Particle> array{};
+    REQUIRE(array.IsEmpty());
+
+    for (u32 i = 0; i < 100; ++i)
+    {
+        const auto ref = array.Append(CreateParticle(i));
+        REQUIRE(ref.GetIndex() == i);
+    }
+    REQUIRE(array.GetSize() == 100);
+    REQUIRE(array.GetCapacity() >= 100);
+
+    for (u32 i = 0; i < 100; ++i)
+    {
+        const Test_Particle particle = array[i];
+        REQUIRE(particle.Mass == f32(i));
+        REQUIRE(particle.Flags == u8(i % 7));
+        REQUIRE(particle.Energy == 2.0 * f64(i));
+        REQUIRE(particle.Name == "particle-" + std::to_string(i));
+        REQUIRE(array[i].Get<&Test_Particle::Energy>() == particle.Energy);
+        REQUIRE(array[i].Get<3>() == particle.Name);
+    }
+
+    array[5].Get<&Test_Particle::Mass>() = 42.f;
+    REQUIRE(array.GetColumn<&Test_Particle::Mass>()[5] == 42.f);
+
+    array[6] = CreateParticle(600);
+    REQUIRE(array.At(6).Load().Name == "particle-600");
+    REQUIRE(array.GetColumn<2>()[6] == 1200.0);
+
+    u32 count = 0;
+    for (const auto particle : array)
+        count += particle.Get<&Test_Particle::Flags>() == 0;
+    REQUIRE(count == 15);
+}
+
+TEST_CASE("SoaArray: aligned columns", "[SoaArray]")
+{
+    SoaArray<Test_Particle> array{};
+    for (u32 i = 0; i < 67; ++i)
+        array.Append(CreateParticle(i));
+
+    REQUIRE(IsAligned(array.GetColumn<0>().GetData(), TKIT_CACHE_LINE_SIZE));
+    REQUIRE(IsAligned(array.GetColumn<1>().GetData(), TKIT_CACHE_LINE_SIZE));
+    REQUIRE(IsAligned(array.GetColumn<2>().GetData(), TKIT_CACHE_LINE_SIZE));
+    REQUIRE(IsAligned(array.GetColumn<3>().GetData(), TKIT_CACHE_LINE_SIZE));
+
+    SoaArray<Test_Particle, 32> small{3};
+    small.Append(CreateParticle(0));
+    REQUIRE(IsAligned(small.GetColumn<&Test_Particle::Flags>().GetData(), 32));
+    REQUIRE(IsAligned(small.GetColumn<&Test_Particle::Energy>().GetData(), 32));
+
+    using Wide = Simd::Wide<f32, 4>;
+    const Span<const f32> masses = array.GetColumn<&Test_Particle::Mass>();
+    Wide sum{0.f};
+    for (usize i = 0; i + Wide::Lanes <= 64; i += Wide::Lanes)
+        sum = sum + Wide::LoadAligned(masses.GetData() + i);
+    REQUIRE(Wide::Reduce(sum) == f32(63 * 64 / 2));
+}
+
+TEST_CASE("SoaArray: unordered removal", "[SoaArray]")
+{
+    SoaArray<Test_Particle> array{};
+    for (u32 i = 0; i < 5; ++i)
+        array.Append(CreateParticle(i));
+
+    array.RemoveUnordered(1);
+    REQUIRE(array.GetSize() == 4);
+    REQUIRE(array[1].Get<&Test_Particle::Mass>() == 4.f);
+    REQUIRE(array[1].Get<&Test_Particle::Name>() == "particle-4");
+    REQUIRE(array[1].Get<&Test_Particle::Flags>() == 4);
+
+    array.RemoveUnordered(3);
+    REQUIRE(array.GetSize() == 3);
+    REQUIRE(array.GetColumn<3>()[2] == "particle-2");
+
+    array.Pop();
+    REQUIRE(array.GetSize() == 2);
+    array.Clear();
+    REQUIRE(array.IsEmpty());
+}
+
+TEST_CASE("SoaArray: copy and move semantics", "[SoaArray]")
+{
+    SoaArray<Test_Particle> array{};
+    for (u32 i = 0; i < 10; ++i)
+        array.Append(CreateParticle(i));
+
+    SoaArray<Test_Particle> copy{array};
+    REQUIRE(copy.GetSize() == 10);
+    REQUIRE(copy[9].Get<&Test_Particle::Name>() == "particle-9");
+    copy[0].Get<&Test_Particle::Name>() = "changed";
+    REQUIRE(array[0].Get<&Test_Particle::Name>() == "particle-0");
+
+    SoaArray<Test_Particle> moved{std::move(copy)};
+    REQUIRE(moved.GetSize() == 10);
+    REQUIRE(copy.IsEmpty());
+    REQUIRE(moved[0].Get<&Test_Particle::Name>() == "changed");
+
+    copy = moved;
+    REQUIRE(copy.GetSize() == 10);
+    moved = std::move(array);
+    REQUIRE(moved[0].Get<&Test_Particle::Name>() == "particle-0");
+    REQUIRE(array.GetCapacity() == 0);
+}
+
+TEST_CASE("SoaArray: element lifetimes", "[SoaArray]")
+{
+    Test_SoaTracker::Constructions = 0;
+    Test_SoaTracker::Destructions = 0;
+    {
+        SoaArray<Test_Tracked> array{};
+        for (u32 i = 0; i < 40; ++i)
+            array.Append(Test_Tracked{.Id = i});
+
+        array.RemoveUnordered(0);
+        array.Pop();
+        REQUIRE(array.GetSize() == 38);
+        REQUIRE(array[0].Get<&Test_Tracked::Id>() == 39);
+
+        SoaArray<Test_Tracked> copy{array};
+        REQUIRE(copy.GetSize() == 38);
+    }
+    REQUIRE(Test_SoaTracker::Constructions == Test_SoaTracker::Destructions);
+}
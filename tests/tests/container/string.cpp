@@ -1,11 +1,14 @@
 #include "tkit/container/arena_array.hpp"
 #include "tkit/container/dynamic_array.hpp"
+#include "tkit/container/small_array.hpp"
 #include "tkit/container/stack_array.hpp"
 #include "tkit/container/static_array.hpp"
 #include "tkit/container/tier_array.hpp"
 #include "tkit/utils/literals.hpp"
 #include <catch2/catch_test_macros.hpp>
 #include <cstring>
+#include <random>
+#include <string>
 
 using namespace TKit;
 using namespace TKit::Container;
@@ -16,6 +19,7 @@ static StackAllocator s_Stack{10_kib};
 static TierAllocator s_Tier{{.Allocator = &s_Arena, .MaxAllocation = 16_kib}};
 
 template <typename T> using StaticAlloc64 = StaticAllocation<T, 64>;
+template <typename T> using SmallAlloc8 = SmallAllocation<T, 8>;
 
 // ---------------------------------------------------------------------------
 // Test functions
@@ -465,6 +469,7 @@ template <template <typename> typename A, typename... Args> void TestNullTermina
     Fn<DynamicAllocation>(usize(__VA_ARGS__));                                                                         \
     Fn<StackAllocation>(&s_Stack, usize(__VA_ARGS__));                                                                 \
     Fn<StaticAlloc64>();                                                                                               \
+    Fn<SmallAlloc8>();                                                                                                 \
     Fn<TierAllocation>(&s_Tier, usize(__VA_ARGS__))
 
 // ─── StartsWith / EndsWith ──────────────────────────────────────────
@@ -683,3 +688,46 @@ TEST_CASE("String: null termination preserved after mutations", "[String]")
 }
 
 #undef STRING_TEST_ALL
+
+// ─── Vectorized search ──────────────────────────────────────────────
+
+TEST_CASE("String: search and comparison agree with std::string on long strings", "[String]")
+{
+    std::mt19937 rng{7};
+    const auto random = [&rng](const usize size) {
+        std::string str(size, ' ');
+        for (char &ch : str)
+            ch = char('a' + rng() % 4);
+        return str;
+    };
+
+    const auto same = [](const usize position, const usz expected) {
+        return expected == std::string::npos ? position == DynamicString::npos : position == expected;
+    };
+
+    bool valid = true;
+    for (u32 i = 0; i < 200; ++i)
+    {
+        const std::string ref = random(1 + rng() % 300);
+        const DynamicString str(ref.c_str(), ref.size());
+        const usize from = rng() % ref.size();
+
+        const std::string sub = random(1 + rng() % 6);
+        const std::string chars = random(1 + rng() % 3) + (i % 2 == 0 ? "" : "\xE9xyz");
+        const char ch = char('a' + rng() % 5);
+
+        valid &= same(str.Find(ch, from), ref.find(ch, from));
+        valid &= same(str.Find(sub.c_str(), from), ref.find(sub, from));
+        valid &= str.Contains(sub.c_str()) == (ref.find(sub) != std::string::npos);
+        valid &= same(str.FindFirstOf(chars.c_str(), from), ref.find_first_of(chars, from));
+        valid &= same(str.FindFirstNotOf(chars.c_str(), from), ref.find_first_not_of(chars, from));
+        valid &= same(str.FindLastOf(chars.c_str()), ref.find_last_of(chars));
+
+        std::string other = ref;
+        other[from] = char(u8(other[from]) + (i % 2 == 0 ? 1 : 200));
+        const DynamicString ostr(other.c_str(), other.size());
+        valid &= (str.Compare(ostr) < 0) == (ref.compare(other) < 0);
+        valid &= str.Compare(ostr) != 0 && str != ostr && str == DynamicString(ref.c_str(), ref.size());
+    }
+    REQUIRE(valid);
+}
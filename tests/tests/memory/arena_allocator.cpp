@@ -172,3 +172,29 @@ TEST_CASE("User-provided buffer constructor", "[ArenaAllocator]")
     REQUIRE(arena.Belongs(p));
     arena.Reset();
 }
+
+TEST_CASE("NUMA placement policies", "[ArenaAllocator]")
+{
+    // Binding may not be available in every system, but the memory must always be usable
+    u32 *local = scast<u32 *>(AllocateLocal(4096));
+    REQUIRE(local);
+    local[1023] = 7;
+    REQUIRE(local[1023] == 7);
+    DeallocatePages(local, 4096);
+
+    u32 *node = scast<u32 *>(AllocateOnNode(4096, 0));
+    REQUIRE(node);
+    node[0] = 3;
+    REQUIRE(node[0] == 3);
+    DeallocatePages(node, 4096);
+
+    ArenaAllocator arena(1024, alignof(std::max_align_t), {.Policy = Numa_Local});
+    REQUIRE(arena.GetCapacity() == 1024);
+    u64 *values = arena.NCreate<u64>(128, 5u);
+    REQUIRE(values);
+    REQUIRE(values[127] == 5);
+    REQUIRE(arena.IsFull());
+
+    ArenaAllocator moved = std::move(arena);
+    REQUIRE(moved.Belongs(values));
+}
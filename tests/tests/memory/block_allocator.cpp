@@ -1,5 +1,6 @@
 #include "tkit/memory/block_allocator.hpp"
 #include <catch2/catch_test_macros.hpp>
+#include <algorithm>
 #include <cstddef>
 #include <vector>
 
@@ -147,3 +148,149 @@ TEST_CASE("User-provided buffer constructor", "[BlockAllocator]")
     REQUIRE(p);
     REQUIRE(alloc.Belongs(p));
 }
+
+TEST_CASE("Growable allocator chains new slabs", "[BlockAllocator]")
+{
+    constexpr usize slabCapacity = 4;
+    auto alloc = BlockAllocator::CreateFromType<u64>(slabCapacity, BlockSlabSpecs{});
+    REQUIRE(alloc.IsGrowable());
+    REQUIRE(alloc.GetSlabCount() == 1);
+
+    std::vector<const void *> ptrs;
+    for (usize i = 0; i < 5 * slabCapacity; ++i)
+    {
+        const void *p = alloc.Allocate();
+        REQUIRE(p);
+        REQUIRE(alloc.Belongs(p));
+        ptrs.push_back(p);
+    }
+    REQUIRE(alloc.GetSlabCount() == 5);
+    REQUIRE(alloc.GetAllocationCapacityCount() == 5 * slabCapacity);
+    REQUIRE(!alloc.IsFull());
+
+    u64 dummy = 0;
+    REQUIRE(!alloc.Belongs(&dummy));
+
+    for (const void *p : ptrs)
+        alloc.Deallocate(p);
+
+    // Only the current slab and the retained one survive
+    REQUIRE(alloc.GetSlabCount() == 2);
+    for (usize i = 0; i < 5 * slabCapacity; ++i)
+        REQUIRE(alloc.Allocate());
+}
+
+TEST_CASE("Growable allocator respects the slab limit", "[BlockAllocator]")
+{
+    constexpr usize slabCapacity = 3;
+    BlockSlabSpecs specs{};
+    specs.MaxSlabs = 2;
+    auto alloc = BlockAllocator::CreateFromType<u64>(slabCapacity, specs);
+
+    for (usize i = 0; i < 2 * slabCapacity; ++i)
+        REQUIRE(alloc.Allocate());
+    REQUIRE(alloc.IsFull());
+    REQUIRE(!alloc.Allocate());
+}
+
+TEST_CASE("Growable allocator bound to a NUMA node", "[BlockAllocator]")
+{
+    constexpr usize slabCapacity = 16;
+    auto alloc = BlockAllocator::CreateFromType<u64>(slabCapacity, BlockSlabSpecs{}, {.Policy = Numa_Node, .Node = 0});
+
+    std::vector<u64 *> values;
+    for (usize i = 0; i < 3 * slabCapacity; ++i)
+    {
+        u64 *value = alloc.Create<u64>(u64(i));
+        REQUIRE(value);
+        values.push_back(value);
+    }
+    REQUIRE(alloc.GetSlabCount() == 3);
+    for (usize i = 0; i < values.size(); ++i)
+    {
+        REQUIRE(*values[i] == i);
+        alloc.Destroy(values[i]);
+    }
+}
+
+TEST_CASE("Growable allocator hysteresis", "[BlockAllocator]")
+{
+    constexpr usize slabCapacity = 2;
+    BlockSlabSpecs specs{};
+    specs.RetainedSlabs = 3;
+    auto alloc = BlockAllocator::CreateFromType<u64>(slabCapacity, specs);
+
+    std::vector<const void *> ptrs;
+    for (usize i = 0; i < 4 * slabCapacity; ++i)
+        ptrs.push_back(alloc.Allocate());
+    REQUIRE(alloc.GetSlabCount() == 4);
+
+    // The current slab is not accounted as an empty slab
+    for (const void *p : ptrs)
+        alloc.Deallocate(p);
+    REQUIRE(alloc.GetSlabCount() == 4);
+
+    // Oscillating around a slab boundary must not allocate new slabs
+    for (usize i = 0; i < 16; ++i)
+    {
+        const void *a = alloc.Allocate();
+        const void *b = alloc.Allocate();
+        const void *c = alloc.Allocate();
+        alloc.Deallocate(c);
+        alloc.Deallocate(b);
+        alloc.Deallocate(a);
+        REQUIRE(alloc.GetSlabCount() == 4);
+    }
+}
+
+TEST_CASE("Growable allocator Create<T> and Destroy<T> across slabs", "[BlockAllocator]")
+{
+    auto alloc = BlockAllocator::CreateFromType<Test_NonTrivialBA>(2, BlockSlabSpecs{});
+
+    Test_NonTrivialBA::CtorCount = 0;
+    Test_NonTrivialBA::DtorCount = 0;
+
+    std::vector<Test_NonTrivialBA *> objs;
+    for (u32 i = 0; i < 7; ++i)
+        objs.push_back(alloc.Create<Test_NonTrivialBA>(i));
+    REQUIRE(Test_NonTrivialBA::CtorCount == 7);
+    for (u32 i = 0; i < 7; ++i)
+        REQUIRE(objs[i]->value == i);
+
+    for (usize i = objs.size() - 1; i < objs.size(); --i)
+        alloc.Destroy(objs[i]);
+    REQUIRE(Test_NonTrivialBA::DtorCount == 7);
+}
+
+TEST_CASE("Growable allocator reuses free blocks scattered across slabs", "[BlockAllocator]")
+{
+    constexpr usize slabCapacity = 4;
+    constexpr usize slabs = 8;
+    BlockSlabSpecs specs{};
+    specs.RetainedSlabs = slabs;
+    auto alloc = BlockAllocator::CreateFromType<u64>(slabCapacity, specs);
+
+    std::vector<const void *> ptrs;
+    for (usize i = 0; i < slabs * slabCapacity; ++i)
+        ptrs.push_back(alloc.Allocate());
+    REQUIRE(alloc.GetSlabCount() == slabs);
+
+    // One free block per slab, plus a whole slab that becomes empty
+    std::vector<const void *> freed;
+    for (usize i = 0; i < slabs - 1; ++i)
+        freed.push_back(ptrs[i * slabCapacity]);
+    for (usize i = 1; i < slabCapacity; ++i)
+        freed.push_back(ptrs[i]);
+    for (const void *p : freed)
+        alloc.Deallocate(p);
+    REQUIRE(!alloc.IsFull());
+
+    std::vector<const void *> reused;
+    for (usize i = 0; i < freed.size(); ++i)
+        reused.push_back(alloc.Allocate());
+    REQUIRE(alloc.GetSlabCount() == slabs);
+
+    std::sort(freed.begin(), freed.end());
+    std::sort(reused.begin(), reused.end());
+    REQUIRE(freed == reused);
+}
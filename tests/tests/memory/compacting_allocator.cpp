@@ -0,0 +1,254 @@
+#include "tkit/memory/compacting_allocator.hpp"
+#include "tkit/utils/literals.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <random>
+
+using namespace TKit;
+using namespace TKit::Alias;
+using Handle = CompactingAllocator::Handle;
+
+struct Test_Allocation
+{
+    Handle Id;
+    u32 Size;
+    u32 Seed;
+};
+
+static void write(CompactingAllocator &allocator, const Test_Allocation &alloc)
+{
+    u32 *data = allocator.Get<u32>(alloc.Id);
+    for (u32 i = 0; i < alloc.Size / sizeof(u32); ++i)
+        data[i] = alloc.Seed * 31 + i;
+}
+
+static bool check(const CompactingAllocator &allocator, const Test_Allocation &alloc)
+{
+    const u32 *data = allocator.Get<u32>(alloc.Id);
+    if (!data)
+        return false;
+    bool valid = true;
+    for (u32 i = 0; i < alloc.Size / sizeof(u32); ++i)
+        valid &= data[i] == alloc.Seed * 31 + i;
+    return valid;
+}
+
+TEST_CASE("Allocate, access and deallocate through handles", "[CompactingAllocator]")
+{
+    CompactingAllocator allocator{64_kib};
+    const Handle h1 = allocator.Allocate(100);
+    const Handle h2 = allocator.Allocate(1);
+    REQUIRE(h1);
+    REQUIRE(h2);
+    REQUIRE(h1 != h2);
+    REQUIRE(allocator.GetAllocationCount() == 2);
+    REQUIRE(allocator.GetAllocationSize(h1) >= 100);
+    REQUIRE(IsAligned(allocator.Get(h1), CompactingAllocator::Alignment));
+    REQUIRE(IsAligned(allocator.Get(h2), CompactingAllocator::Alignment));
+
+    allocator.Deallocate(h1);
+    REQUIRE(!allocator.IsValid(h1));
+    REQUIRE(!allocator.Get(h1));
+    REQUIRE(allocator.IsValid(h2));
+
+    // The handle entry is reused with a new generation, so the stale handle stays invalid
+    const Handle h3 = allocator.Allocate(100);
+    REQUIRE(h3.Index == h1.Index);
+    REQUIRE(!allocator.IsValid(h1));
+    REQUIRE(allocator.IsValid(h3));
+
+    allocator.Deallocate(h2);
+    allocator.Deallocate(h3);
+    REQUIRE(allocator.GetTop() == 0);
+    REQUIRE(allocator.GetMetrics().FreeBytes == allocator.GetCapacity());
+
+    REQUIRE(!allocator.Allocate(128_kib));
+}
+
+TEST_CASE("Holes are reused and coalesced", "[CompactingAllocator]")
+{
+    CompactingAllocator allocator{64_kib};
+    Handle handles[8];
+    for (Handle &handle : handles)
+        handle = allocator.Allocate(240);
+    const usz top = allocator.GetTop();
+
+    allocator.Deallocate(handles[2]);
+    allocator.Deallocate(handles[4]);
+    allocator.Deallocate(handles[3]);
+    CompactingAllocator::Metrics metrics = allocator.GetMetrics();
+    REQUIRE(metrics.Holes == 1);
+    REQUIRE(metrics.HoleBytes == 3 * 256);
+
+    // Served from the hole, not from the top
+    const Handle big = allocator.Allocate(3 * 256 - 16);
+    REQUIRE(allocator.GetTop() == top);
+    REQUIRE(allocator.GetMetrics().Holes == 0);
+
+    // Freeing the last blocks gives their memory back to the top
+    allocator.Deallocate(handles[7]);
+    allocator.Deallocate(handles[6]);
+    REQUIRE(allocator.GetTop() == top - 2 * 256);
+    REQUIRE(allocator.GetMetrics().Holes == 0);
+
+    allocator.Deallocate(big);
+    for (const usize i : {0, 1, 5})
+        allocator.Deallocate(handles[i]);
+    REQUIRE(allocator.GetTop() == 0);
+}
+
+TEST_CASE("Full compaction removes every hole", "[CompactingAllocator]")
+{
+    CompactingAllocator allocator{1_mib};
+    DynamicArray<Test_Allocation> allocs{};
+    for (u32 i = 0; i < 1000; ++i)
+    {
+        const u32 size = 16 + (i * 37) % 500;
+        Test_Allocation alloc{allocator.Allocate(size), size & ~3u, i};
+        REQUIRE(alloc.Id);
+        write(allocator, alloc);
+        allocs.Append(alloc);
+    }
+    for (usize i = 0; i < allocs.GetSize(); i += 2)
+        allocator.Deallocate(allocs[i].Id);
+
+    const CompactingAllocator::Metrics before = allocator.GetMetrics();
+    REQUIRE(before.Holes == 500);
+    REQUIRE(before.Fragmentation > 0.f);
+
+    const CompactingAllocator::CompactionResult result = allocator.Compact();
+    REQUIRE(result.Finished);
+    REQUIRE(result.BlocksMoved == 500);
+
+    const CompactingAllocator::Metrics after = allocator.GetMetrics();
+    REQUIRE(after.Holes == 0);
+    REQUIRE(after.Fragmentation == 0.f);
+    REQUIRE(after.LiveBytes == before.LiveBytes);
+    REQUIRE(after.LargestFreeBlock == after.FreeBytes);
+    REQUIRE(allocator.GetTop() == after.LiveBytes);
+
+    bool valid = true;
+    for (usize i = 1; i < allocs.GetSize(); i += 2)
+        valid &= check(allocator, allocs[i]);
+    REQUIRE(valid);
+
+    REQUIRE(allocator.Compact().BlocksMoved == 0);
+
+    for (usize i = 1; i < allocs.GetSize(); i += 2)
+        allocator.Deallocate(allocs[i].Id);
+}
+
+TEST_CASE("Pinned allocations are not moved", "[CompactingAllocator]")
+{
+    CompactingAllocator allocator{64_kib};
+    Handle handles[6];
+    for (Handle &handle : handles)
+        handle = allocator.Allocate(100);
+
+    allocator.Pin(handles[3]);
+    const void *pinned = allocator.Get(handles[3]);
+    allocator.Deallocate(handles[0]);
+    allocator.Deallocate(handles[2]);
+    allocator.Compact();
+
+    REQUIRE(allocator.IsPinned(handles[3]));
+    REQUIRE(allocator.Get(handles[3]) == pinned);
+    REQUIRE(allocator.GetMetrics().Holes == 1);
+
+    allocator.Unpin(handles[3]);
+    REQUIRE(allocator.Compact().Finished);
+    REQUIRE(allocator.Get(handles[3]) != pinned);
+    REQUIRE(allocator.GetMetrics().Holes == 0);
+
+    for (const usize i : {1, 3, 4, 5})
+        allocator.Deallocate(handles[i]);
+}
+
+TEST_CASE("Incremental compaction interleaved with allocations", "[CompactingAllocator]")
+{
+    std::mt19937 rng{42};
+    CompactingAllocator allocator{4_mib};
+    DynamicArray<Test_Allocation> allocs{};
+    u32 seed = 0;
+
+    const auto allocate = [&] {
+        const u32 size = 4 * (1 + rng() % 256);
+        Test_Allocation alloc{allocator.Allocate(size), size, seed++};
+        if (!alloc.Id)
+            return;
+        write(allocator, alloc);
+        allocs.Append(alloc);
+    };
+
+    for (u32 i = 0; i < 4000; ++i)
+        allocate();
+
+    usize slices = 0;
+    for (u32 round = 0; round < 200; ++round)
+    {
+        for (u32 i = 0; i < 20 && !allocs.IsEmpty(); ++i)
+        {
+            const usize index = rng() % allocs.GetSize();
+            allocator.Deallocate(allocs[index].Id);
+            allocs.RemoveUnordered(allocs.begin() + index);
+        }
+        for (u32 i = 0; i < 10; ++i)
+            allocate();
+
+        const CompactingAllocator::CompactionResult result = allocator.Compact(2_kib);
+        REQUIRE(result.BytesMoved < 2_kib + 1_kib + 64);
+        ++slices;
+    }
+
+    bool valid = true;
+    for (const Test_Allocation &alloc : allocs)
+        valid &= check(allocator, alloc);
+    REQUIRE(valid);
+
+    while (!allocator.Compact(4_kib).Finished)
+        ++slices;
+    REQUIRE(slices > 200);
+    REQUIRE(allocator.GetMetrics().Holes == 0);
+
+    valid = true;
+    for (const Test_Allocation &alloc : allocs)
+        valid &= check(allocator, alloc);
+    REQUIRE(valid);
+
+    for (const Test_Allocation &alloc : allocs)
+        allocator.Deallocate(alloc.Id);
+    REQUIRE(allocator.GetTop() == 0);
+}
+
+TEST_CASE("Time sliced compaction and typed objects", "[CompactingAllocator]")
+{
+    struct Test_Object
+    {
+        u64 Values[5];
+    };
+
+    CompactingAllocator allocator{1_mib};
+    DynamicArray<Handle> handles{};
+    for (u64 i = 0; i < 2000; ++i)
+        handles.Append(allocator.Create<Test_Object>(Test_Object{{i, i + 1, i + 2, i + 3, i + 4}}));
+    for (usize i = 0; i < handles.GetSize(); i += 3)
+        allocator.Destroy<Test_Object>(handles[i]);
+
+    while (!allocator.CompactFor(std::chrono::microseconds{20}).Finished)
+        ;
+    REQUIRE(allocator.GetMetrics().Fragmentation == 0.f);
+
+    bool valid = true;
+    for (usize i = 0; i < handles.GetSize(); ++i)
+    {
+        if (i % 3 == 0)
+        {
+            valid &= !allocator.IsValid(handles[i]);
+            continue;
+        }
+        const Test_Object *object = allocator.Get<Test_Object>(handles[i]);
+        valid &= object->Values[0] == i && object->Values[4] == i + 4;
+        allocator.Destroy<Test_Object>(handles[i]);
+    }
+    REQUIRE(valid);
+    REQUIRE(allocator.GetAllocationCount() == 0);
+}
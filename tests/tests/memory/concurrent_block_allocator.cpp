@@ -0,0 +1,158 @@
+#include "tkit/memory/concurrent_block_allocator.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+#include <vector>
+
+using namespace TKit;
+
+struct Test_Message
+{
+    u32 Producer;
+    u32 Sequence;
+    u64 Payload;
+};
+
+TEST_CASE("Constructor and initial state", "[ConcurrentBlockAllocator]")
+{
+    constexpr usize bufSize = 1024;
+    constexpr usize allocSize = 64;
+    const ConcurrentBlockAllocator alloc(bufSize, allocSize);
+
+    REQUIRE(!alloc.IsFull());
+    REQUIRE(alloc.GetBufferSize() == bufSize);
+    REQUIRE(alloc.GetAllocationSize() == allocSize);
+    REQUIRE(alloc.GetAllocationCapacityCount() == bufSize / allocSize);
+
+    u32 dummy = 0;
+    REQUIRE(!alloc.Belongs(&dummy));
+}
+
+TEST_CASE("Allocate and Deallocate blocks", "[ConcurrentBlockAllocator]")
+{
+    constexpr usize capacity = 8;
+    auto alloc = ConcurrentBlockAllocator::CreateFromType<Test_Message>(capacity);
+
+    std::vector<const void *> ptrs;
+    for (usize i = 0; i < capacity; ++i)
+    {
+        const void *p = alloc.Allocate();
+        REQUIRE(p);
+        REQUIRE(alloc.Belongs(p));
+        for (const void *other : ptrs)
+            REQUIRE(other != p);
+        ptrs.push_back(p);
+    }
+    REQUIRE(alloc.IsFull());
+    REQUIRE(!alloc.Allocate());
+
+    for (const void *p : ptrs)
+        alloc.Deallocate(p);
+    REQUIRE(!alloc.IsFull());
+
+    for (usize i = 0; i < capacity; ++i)
+        REQUIRE(alloc.Allocate());
+    REQUIRE(alloc.IsFull());
+}
+
+TEST_CASE("Move constructor and move assignment", "[ConcurrentBlockAllocator]")
+{
+    auto a1 = ConcurrentBlockAllocator::CreateFromType<u64>(5);
+    const void *ptr = a1.Allocate();
+    REQUIRE(a1.Belongs(ptr));
+
+    ConcurrentBlockAllocator a2(std::move(a1));
+    REQUIRE(a1.GetBufferSize() == 0);
+    REQUIRE(a2.Belongs(ptr));
+
+    ConcurrentBlockAllocator a3 = ConcurrentBlockAllocator::CreateFromType<u64>(2);
+    a3 = std::move(a2);
+    REQUIRE(a2.GetBufferSize() == 0);
+    REQUIRE(a3.Belongs(ptr));
+    a3.Deallocate(ptr);
+}
+
+TEST_CASE("Concurrent allocation and deallocation", "[ConcurrentBlockAllocator]")
+{
+    constexpr u32 threadCount = 4;
+    constexpr u32 capacity = 64;
+    constexpr u32 iterations = 10000;
+    auto alloc = ConcurrentBlockAllocator::CreateFromType<Test_Message>(capacity);
+
+    std::vector<std::thread> threads;
+    std::atomic<u32> failures{0};
+    for (u32 t = 0; t < threadCount; ++t)
+        threads.emplace_back([&, t] {
+            Test_Message *owned[capacity / threadCount];
+            for (u32 i = 0; i < iterations; ++i)
+            {
+                for (u32 j = 0; j < capacity / threadCount; ++j)
+                {
+                    owned[j] = alloc.Create<Test_Message>(t, i, (u64(t) << 32) | j);
+                    if (!owned[j])
+                        failures.fetch_add(1, std::memory_order_relaxed);
+                }
+                for (u32 j = 0; j < capacity / threadCount; ++j)
+                    if (owned[j])
+                    {
+                        if (owned[j]->Producer != t || owned[j]->Payload != ((u64(t) << 32) | j))
+                            failures.fetch_add(1, std::memory_order_relaxed);
+                        alloc.Destroy(owned[j]);
+                    }
+            }
+        });
+
+    for (std::thread &thread : threads)
+        thread.join();
+
+    REQUIRE(failures.load() == 0);
+    for (u32 i = 0; i < capacity; ++i)
+        REQUIRE(alloc.Allocate());
+    REQUIRE(alloc.IsFull());
+}
+
+TEST_CASE("Cross-thread deallocation", "[ConcurrentBlockAllocator]")
+{
+    constexpr u32 slots = 64;
+    constexpr u32 messages = 100000;
+    auto alloc = ConcurrentBlockAllocator::CreateFromType<Test_Message>(2 * slots);
+
+    std::atomic<Test_Message *> mailbox[slots];
+    for (u32 i = 0; i < slots; ++i)
+        mailbox[i].store(nullptr, std::memory_order_relaxed);
+
+    std::thread producer([&] {
+        for (u32 i = 0; i < messages; ++i)
+        {
+            Test_Message *msg = alloc.Create<Test_Message>(0u, i, u64(i));
+            std::atomic<Test_Message *> &slot = mailbox[i % slots];
+            while (slot.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            slot.store(msg, std::memory_order_release);
+        }
+    });
+
+    u32 received = 0;
+    u32 mismatches = 0;
+    std::thread consumer([&] {
+        for (u32 i = 0; i < messages; ++i)
+        {
+            std::atomic<Test_Message *> &slot = mailbox[i % slots];
+            Test_Message *msg = nullptr;
+            while (!(msg = slot.load(std::memory_order_acquire)))
+                std::this_thread::yield();
+            slot.store(nullptr, std::memory_order_release);
+
+            if (msg->Sequence != i || msg->Payload != u64(i))
+                ++mismatches;
+            alloc.Destroy(msg);
+            ++received;
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    REQUIRE(received == messages);
+    REQUIRE(mismatches == 0);
+    REQUIRE(!alloc.IsFull());
+}
@@ -0,0 +1,103 @@
+#include "tkit/memory/frame_allocator.hpp"
+#include "tkit/container/arena_array.hpp"
+#include "tkit/multiprocessing/topology.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+#include <vector>
+
+using namespace TKit;
+
+TEST_CASE("Constructor and initial state", "[FrameAllocator]")
+{
+    FrameAllocator frame({.Capacity = 1000, .Frames = 3, .Threads = 2});
+    REQUIRE(frame.GetFrameCount() == 3);
+    REQUIRE(frame.GetThreadCount() == 2);
+    REQUIRE(frame.GetFrameIndex() == 0);
+    REQUIRE(frame.GetCapacity() >= 1000);
+    REQUIRE(frame.GetCapacity() % TKIT_CACHE_LINE_SIZE == 0);
+
+    for (usize i = 0; i < 2; ++i)
+    {
+        const ArenaAllocator *arena = frame.GetArena(i);
+        REQUIRE(arena->IsEmpty());
+        REQUIRE(arena->GetCapacity() == frame.GetCapacity());
+        REQUIRE(IsAligned(arena, TKIT_CACHE_LINE_SIZE));
+    }
+    REQUIRE(frame.GetArena(0) != frame.GetArena(1));
+}
+
+TEST_CASE("Allocations survive for the configured amount of frames", "[FrameAllocator]")
+{
+    FrameAllocator frame({.Capacity = 1024, .Frames = 2});
+    ArenaAllocator *arena = frame.GetArena(0);
+
+    u32 *first = arena->Create<u32>(1u);
+    REQUIRE(first);
+    REQUIRE(arena->Belongs(first));
+
+    frame.BeginFrame();
+    REQUIRE(frame.GetArena(0) == arena);
+    REQUIRE(arena->IsEmpty());
+    REQUIRE(!arena->Belongs(first));
+    REQUIRE(*first == 1); // still alive: it belongs to the previous frame
+
+    u32 *second = arena->Create<u32>(2u);
+    REQUIRE(second);
+    REQUIRE(second != first);
+
+    // The first frame is recycled, so its memory is handed out again
+    frame.BeginFrame();
+    REQUIRE(*second == 2);
+    u32 *third = arena->Allocate<u32>();
+    REQUIRE(third == first);
+    REQUIRE(frame.GetFrameIndex() == 2);
+}
+
+TEST_CASE("Pushed arena follows the current frame", "[FrameAllocator]")
+{
+    FrameAllocator frame({.Capacity = 4096, .Frames = 2});
+    PushArena(frame.GetArena(0));
+
+    for (u32 f = 0; f < 4; ++f)
+    {
+        frame.BeginFrame();
+        ArenaArray<u32> values{};
+        values.Reserve(16);
+        for (u32 i = 0; i < 16; ++i)
+            values.Append(i * f);
+        REQUIRE(GetArena()->GetAllocatedBytes() >= 16 * sizeof(u32));
+        REQUIRE(values[15] == 15 * f);
+    }
+    PopArena();
+}
+
+TEST_CASE("Per-thread arenas", "[FrameAllocator]")
+{
+    constexpr usize threadCount = 4;
+    constexpr u32 allocations = 64;
+    FrameAllocator frame(
+        {.Capacity = allocations * sizeof(u64), .Frames = 2, .Threads = threadCount, .Alignment = alignof(u64)});
+
+    for (u32 f = 0; f < 3; ++f)
+    {
+        frame.BeginFrame();
+        std::vector<std::thread> threads;
+        std::atomic<u32> failures{0};
+        for (usize t = 0; t < threadCount; ++t)
+            threads.emplace_back([&, t] {
+                Topology::SetThreadIndex(t);
+                for (u32 i = 0; i < allocations; ++i)
+                {
+                    u64 *value = frame.Create<u64>(u64(t));
+                    if (!value || !frame.GetArena()->Belongs(value))
+                        failures.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (!frame.GetArena()->IsFull())
+                    failures.fetch_add(1, std::memory_order_relaxed);
+            });
+        for (std::thread &thread : threads)
+            thread.join();
+        REQUIRE(failures.load() == 0);
+    }
+    Topology::SetThreadIndex(0);
+}
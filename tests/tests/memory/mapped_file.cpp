@@ -0,0 +1,88 @@
+#include "tkit/memory/mapped_file.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace TKit;
+
+static std::string getTestPath(const char *name)
+{
+    std::error_code ec;
+    return (std::filesystem::temp_directory_path(ec) / name).string();
+}
+
+TEST_CASE("Map an existing file as read-only", "[MappedFile]")
+{
+    const std::string path = getTestPath("tkit_mapped_file_read.bin");
+    {
+        std::ofstream out{path, std::ios::binary};
+        for (u32 i = 0; i < 1024; ++i)
+            out.write(rcast<const char *>(&i), sizeof(u32));
+    }
+
+    auto result = MappedFile::Open(path.c_str());
+    REQUIRE(result);
+    const MappedFile &file = result.GetValue();
+    REQUIRE(file.IsOpen());
+    REQUIRE(!file.IsWritable());
+    REQUIRE(file.GetSize() == 1024 * sizeof(u32));
+    REQUIRE(file.GetBytes().GetSize() == 1024 * sizeof(u32));
+    REQUIRE(file.Advise(MapAdvice_Sequential));
+    REQUIRE(file.Advise(MapAdvice_WillNeed, 100, 64));
+
+    const Span<const u32> values = file.As<u32>();
+    REQUIRE(values.GetSize() == 1024);
+    bool matching = true;
+    for (u32 i = 0; i < 1024; ++i)
+        matching &= values[i] == i;
+    REQUIRE(matching);
+
+    REQUIRE(!MappedFile::Open(getTestPath("tkit_mapped_file_missing.bin").c_str()));
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+}
+
+TEST_CASE("Create and grow a writable file", "[MappedFile]")
+{
+    const std::string path = getTestPath("tkit_mapped_file_write.bin");
+    {
+        auto result = MappedFile::Create(path.c_str());
+        REQUIRE(result);
+        MappedFile file = std::move(result.GetValue());
+        REQUIRE(file.IsWritable());
+        REQUIRE(file.GetSize() == 0);
+
+        for (u64 i = 0; i < 10000; ++i)
+            REQUIRE(file.Append(i));
+        REQUIRE(file.GetSize() == 10000 * sizeof(u64));
+        REQUIRE(file.GetCapacity() >= file.GetSize());
+
+        Span<u64> values = file.As<u64>();
+        values[0] = 42;
+        REQUIRE(file.Flush());
+    }
+
+    // Closing truncates the file back to its logical size
+    std::error_code ec;
+    REQUIRE(std::filesystem::file_size(path, ec) == 10000 * sizeof(u64));
+
+    auto result = MappedFile::Open(path.c_str(), Map_ReadWrite);
+    REQUIRE(result);
+    MappedFile &file = result.GetValue();
+    const Span<const u64> values = std::as_const(file).As<u64>();
+    REQUIRE(values.GetSize() == 10000);
+    REQUIRE(values[0] == 42);
+    REQUIRE(values[9999] == 9999);
+
+    REQUIRE(file.Resize(10 * sizeof(u64)));
+    REQUIRE(file.Resize(20 * sizeof(u64)));
+    REQUIRE(file.As<u64>()[9] == 9);
+    REQUIRE(file.As<u64>()[10] == 0);
+    file.Close();
+    REQUIRE(!file.IsOpen());
+    REQUIRE(std::filesystem::file_size(path, ec) == 20 * sizeof(u64));
+
+    std::filesystem::remove(path, ec);
+}
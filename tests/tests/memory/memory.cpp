@@ -0,0 +1,110 @@
+#include "tkit/memory/memory.hpp"
+#include "tkit/container/dynamic_array.hpp"
+#include "tkit/utils/limits.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <cstring>
+
+using namespace TKit;
+
+static DynamicArray<u8> createPattern(const usz size)
+{
+    DynamicArray<u8> pattern{};
+    pattern.Resize(usize(size));
+    for (usz i = 0; i < size; ++i)
+        pattern[usize(i)] = u8(i * 7 + 3);
+    return pattern;
+}
+
+// Sizes around every lane and loop boundary of the kernels, for every vector width
+static const usz s_Sizes[] = {0,   1,   2,   3,   4,   5,   7,   8,   9,   15,  16,  17,  31,  32,  33,   63,   64,
+                              65,  96,  127, 128, 129, 191, 255, 256, 257, 383, 511, 512, 513, 777, 1023, 1024, 4099};
+
+TEST_CASE("Forward copy of every size and alignment", "[Memory]")
+{
+    const DynamicArray<u8> src = createPattern(4099 + 64);
+    DynamicArray<u8> dst{};
+    dst.Resize(src.GetSize() + 64);
+
+    for (const usz size : s_Sizes)
+        for (usz srcOffset = 0; srcOffset < 64; srcOffset += 13)
+            for (usz dstOffset = 0; dstOffset < 64; dstOffset += 11)
+            {
+                std::memset(dst.GetData(), 0xAB, dst.GetSize());
+                void *result = ForwardCopy(dst.GetData() + dstOffset, src.GetData() + srcOffset, size);
+                REQUIRE(result == dst.GetData() + dstOffset);
+                REQUIRE(std::memcmp(dst.GetData() + dstOffset, src.GetData() + srcOffset, size) == 0);
+
+                // Bytes around the destination must be left untouched
+                bool untouched = true;
+                for (usz i = 0; i < dstOffset; ++i)
+                    untouched &= dst[usize(i)] == 0xAB;
+                for (usz i = dstOffset + size; i < dst.GetSize(); ++i)
+                    untouched &= dst[usize(i)] == 0xAB;
+                REQUIRE(untouched);
+            }
+}
+
+TEST_CASE("Backward copy with overlapping ranges", "[Memory]")
+{
+    const DynamicArray<u8> pattern = createPattern(4099 + 128);
+    DynamicArray<u8> buffer{};
+    DynamicArray<u8> expected{};
+
+    for (const usz size : s_Sizes)
+        for (const usz shift : {usz(1), usz(3), usz(16), usz(33), usz(64), usz(100)})
+        {
+            buffer = pattern;
+            expected = pattern;
+            std::memmove(expected.GetData() + shift, expected.GetData(), size);
+            BackwardCopy(buffer.GetData() + shift, buffer.GetData(), size);
+            REQUIRE(std::memcmp(buffer.GetData(), expected.GetData(), buffer.GetSize()) == 0);
+
+            buffer = pattern;
+            expected = pattern;
+            std::memmove(expected.GetData(), expected.GetData() + shift, size);
+            BackwardCopy(buffer.GetData(), buffer.GetData() + shift, size);
+            REQUIRE(std::memcmp(buffer.GetData(), expected.GetData(), buffer.GetSize()) == 0);
+        }
+
+    buffer = pattern;
+    BackwardCopy(buffer.GetData(), buffer.GetData(), 1000);
+    REQUIRE(std::memcmp(buffer.GetData(), pattern.GetData(), buffer.GetSize()) == 0);
+}
+
+TEST_CASE("Fill of every size and alignment", "[Memory]")
+{
+    DynamicArray<u8> dst{};
+    dst.Resize(4099 + 128);
+
+    for (const usz size : s_Sizes)
+        for (usz offset = 0; offset < 64; offset += 5)
+        {
+            std::memset(dst.GetData(), 0xAB, dst.GetSize());
+            void *result = Fill(dst.GetData() + offset, 0x5C, size);
+            REQUIRE(result == dst.GetData() + offset);
+            bool filled = true;
+            for (usz i = 0; i < dst.GetSize(); ++i)
+                filled &= dst[usize(i)] == (i >= offset && i < offset + size ? 0x5C : 0xAB);
+            REQUIRE(filled);
+        }
+}
+
+TEST_CASE("Copies and fills past the non-temporal threshold", "[Memory]")
+{
+    const usz size = NonTemporalThreshold + 77;
+    const DynamicArray<u8> src = createPattern(size + 16);
+    DynamicArray<u8> dst{};
+    dst.Resize(src.GetSize());
+
+    ForwardCopy(dst.GetData() + 3, src.GetData() + 9, size);
+    REQUIRE(std::memcmp(dst.GetData() + 3, src.GetData() + 9, size) == 0);
+
+    BackwardCopy(dst.GetData() + 5, src.GetData() + 1, size);
+    REQUIRE(std::memcmp(dst.GetData() + 5, src.GetData() + 1, size) == 0);
+
+    Fill(dst.GetData() + 1, 0x42, size);
+    bool filled = true;
+    for (usz i = 1; i < size + 1; ++i)
+        filled &= dst[usize(i)] == 0x42;
+    REQUIRE(filled);
+}
@@ -0,0 +1,158 @@
+#include "tkit/memory/pool.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+using namespace TKit;
+
+struct Test_NonTrivialPool
+{
+    static inline u32 CtorCount = 0;
+    static inline u32 DtorCount = 0;
+
+    u32 Value;
+    Test_NonTrivialPool(const u32 value) : Value(value)
+    {
+        ++CtorCount;
+    }
+    ~Test_NonTrivialPool()
+    {
+        ++DtorCount;
+    }
+};
+
+TEST_CASE("Handles are compact and validated", "[Pool]")
+{
+    Pool<u64> pool{};
+    using Handle = Pool<u64>::Handle;
+    STATIC_REQUIRE(sizeof(Handle) == sizeof(u32));
+
+    REQUIRE(pool.IsEmpty());
+    REQUIRE(!pool.IsValid(Handle{}));
+    REQUIRE(!pool.Get(Handle{}));
+
+    const Handle a = pool.Create(1u);
+    const Handle b = pool.Create(2u);
+    REQUIRE(a);
+    REQUIRE(b);
+    REQUIRE(a != b);
+    REQUIRE(pool.GetSize() == 2);
+    REQUIRE(pool[a] == 1);
+    REQUIRE(*pool.Get(b) == 2);
+
+    pool.Destroy(a);
+    REQUIRE(!pool.IsValid(a));
+    REQUIRE(!pool.Get(a));
+    REQUIRE(pool.IsValid(b));
+
+    // The slot is reused, but the stale handle does not alias the new object
+    const Handle c = pool.Create(3u);
+    REQUIRE(c.GetIndex() == a.GetIndex());
+    REQUIRE(c.GetGeneration() == a.GetGeneration() + 1);
+    REQUIRE(!pool.IsValid(a));
+    REQUIRE(pool[c] == 3);
+}
+
+TEST_CASE("Pointers are stable across growth", "[Pool]")
+{
+    Pool<u32> pool{1};
+    using Handle = Pool<u32>::Handle;
+
+    std::vector<Handle> handles;
+    std::vector<const u32 *> pointers;
+    for (u32 i = 0; i < 1000; ++i)
+    {
+        const Handle h = pool.Create(i);
+        handles.push_back(h);
+        pointers.push_back(pool.Get(h));
+    }
+    REQUIRE(pool.GetSize() == 1000);
+    REQUIRE(pool.GetCapacity() >= 1000);
+    for (u32 i = 0; i < 1000; ++i)
+    {
+        REQUIRE(pool.Get(handles[i]) == pointers[i]);
+        REQUIRE(*pointers[i] == i);
+    }
+}
+
+TEST_CASE("ForEach visits live objects in slot order", "[Pool]")
+{
+    Pool<u32> pool{};
+    using Handle = Pool<u32>::Handle;
+
+    std::vector<Handle> handles;
+    for (u32 i = 0; i < 200; ++i)
+        handles.push_back(pool.Create(i));
+    for (u32 i = 0; i < 200; i += 3)
+        pool.Destroy(handles[i]);
+
+    u32 count = 0;
+    u32 last = 0;
+    bool ordered = true;
+    pool.ForEach([&](const u32 value) {
+        ordered &= count == 0 || value > last;
+        ordered &= value % 3 != 0;
+        last = value;
+        ++count;
+    });
+    REQUIRE(ordered);
+    REQUIRE(count == pool.GetSize());
+
+    bool matching = true;
+    pool.ForEach([&](const Handle h, u32 &value) {
+        matching &= pool.IsValid(h) && &pool[h] == &value;
+        value *= 2;
+    });
+    REQUIRE(matching);
+    REQUIRE(pool[handles[1]] == 2);
+}
+
+TEST_CASE("Non-trivial objects are destroyed", "[Pool]")
+{
+    Test_NonTrivialPool::CtorCount = 0;
+    Test_NonTrivialPool::DtorCount = 0;
+    {
+        Pool<Test_NonTrivialPool> pool{};
+        using Handle = Pool<Test_NonTrivialPool>::Handle;
+
+        std::vector<Handle> handles;
+        for (u32 i = 0; i < 100; ++i)
+            handles.push_back(pool.Create(i));
+        pool.Destroy(handles[10]);
+        REQUIRE(Test_NonTrivialPool::DtorCount == 1);
+
+        pool.Clear();
+        REQUIRE(pool.IsEmpty());
+        REQUIRE(Test_NonTrivialPool::DtorCount == 100);
+        for (const Handle h : handles)
+            REQUIRE(!pool.IsValid(h));
+
+        pool.Create(7u);
+        pool.Create(8u);
+
+        Pool<Test_NonTrivialPool> moved = std::move(pool);
+        REQUIRE(moved.GetSize() == 2);
+        REQUIRE(pool.IsEmpty());
+    }
+    REQUIRE(Test_NonTrivialPool::CtorCount == 102);
+    REQUIRE(Test_NonTrivialPool::DtorCount == 102);
+}
+
+TEST_CASE("Slots are retired when their generation is exhausted", "[Pool]")
+{
+    // 26 index bits leave 6 bits for the generation
+    Pool<u32, 26> pool{};
+    using Handle = Pool<u32, 26>::Handle;
+
+    Handle h = pool.Create(0u);
+    const usize index = h.GetIndex();
+    for (u32 i = 0; i < Pool<u32, 26>::GenerationMask - 1; ++i)
+    {
+        pool.Destroy(h);
+        h = pool.Create(i);
+        REQUIRE(h.GetIndex() == index);
+    }
+    pool.Destroy(h);
+    h = pool.Create(0u);
+    REQUIRE(h.GetIndex() != index);
+    REQUIRE(!pool.IsValid(Handle{}));
+}
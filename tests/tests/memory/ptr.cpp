@@ -1,4 +1,7 @@
 #include "tkit/memory/ptr.hpp"
+#include "tkit/memory/block_allocator.hpp"
+#include "tkit/memory/tier_allocator.hpp"
+#include "tkit/utils/literals.hpp"
 #include <catch2/catch_test_macros.hpp>
 
 using namespace TKit;
@@ -73,6 +76,161 @@ TEST_CASE("Ref: hashing equal pointers", "[Ref]")
     REQUIRE(hasher(ref1) == hasher(ref2));
 }
 
+TEST_CASE("Ref: objects return to their allocator", "[Ref]")
+{
+    Test_MyRefCounted::DtorCount = 0;
+    constexpr usz size = Test_MyRefCounted::GetAllocationSize();
+    BlockAllocator block{4 * size, size, Test_MyRefCounted::GetAllocationAlignment()};
+    ArenaAllocator arena{64_kib};
+    TierAllocator tier{TierSpecs{.Allocator = &arena}};
+    const void *tierPtr;
+    {
+        const auto ref1 = Ref<Test_MyRefCounted>::Create(&block, 3);
+        REQUIRE(ref1);
+        REQUIRE(ref1->Value == 3);
+        REQUIRE(ref1->GetAllocatorKind() == RefAllocator_Block);
+        REQUIRE(block.Belongs(ref1.Get()));
+
+        const auto ref2 = Ref<Test_MyRefCounted>::Create(&tier, 4);
+        REQUIRE(ref2);
+        REQUIRE(ref2->GetAllocatorKind() == RefAllocator_Tier);
+        REQUIRE(tier.Belongs(ref2.Get()));
+        tierPtr = ref2.Get();
+
+        const auto ref3 = ref1;
+        REQUIRE(ref1->RefCount() == 2);
+    }
+    REQUIRE(Test_MyRefCounted::DtorCount == 2);
+
+    // The header sits right before the object
+    void *reused = tier.Allocate(size);
+    REQUIRE(scast<std::byte *>(reused) + Test_MyRefCounted::GetHeaderSize() == tierPtr);
+    tier.Deallocate(reused, size);
+
+    // The block is free again, so the allocator can hand out all of its blocks
+    for (u32 i = 0; i < 4; ++i)
+        REQUIRE(block.Allocate());
+    REQUIRE(block.IsFull());
+}
+
+TEST_CASE("WeakRef: expiration and locking", "[Ref]")
+{
+    Test_MyRefCounted::DtorCount = 0;
+
+    WeakRef<Test_MyRefCounted> weak1;
+    REQUIRE(weak1.IsExpired());
+    REQUIRE(!weak1.Lock());
+    {
+        const auto ref = Ref<Test_MyRefCounted>::Create(11);
+        weak1 = ref;
+        const WeakRef<Test_MyRefCounted> weak2 = weak1;
+        REQUIRE(ref->RefCount() == 1);
+        REQUIRE(ref->WeakRefCount() == 2);
+        REQUIRE(!weak1.IsExpired());
+
+        const Ref<Test_MyRefCounted> locked = weak2.Lock();
+        REQUIRE(locked == ref);
+        REQUIRE(ref->RefCount() == 2);
+    }
+    // The object is destroyed, but its memory is kept until the last weak reference is gone
+    REQUIRE(Test_MyRefCounted::DtorCount == 1);
+    REQUIRE(weak1.IsExpired());
+    REQUIRE(!weak1.Lock());
+    weak1.Reset();
+    REQUIRE(weak1.IsExpired());
+}
+
+TEST_CASE("WeakRef: outliving an allocator-backed object", "[Ref]")
+{
+    Test_MyRefCounted::DtorCount = 0;
+    constexpr usz size = Test_MyRefCounted::GetAllocationSize();
+    BlockAllocator block{size, size, Test_MyRefCounted::GetAllocationAlignment()};
+
+    WeakRef<Test_MyRefCounted> weak;
+    {
+        const auto ref = Ref<Test_MyRefCounted>::Create(&block, 8);
+        weak = ref;
+    }
+    REQUIRE(Test_MyRefCounted::DtorCount == 1);
+    REQUIRE(block.IsFull());
+
+    weak.Reset();
+    REQUIRE(!block.IsFull());
+}
+
+struct Test_MyDerivedRefCounted : public Test_MyRefCounted
+{
+    u64 Padding[16];
+    Test_MyDerivedRefCounted(const u32 value) : Test_MyRefCounted(value)
+    {
+    }
+};
+
+TEST_CASE("Ref: derived objects return their whole allocation", "[Ref]")
+{
+    Test_MyRefCounted::DtorCount = 0;
+    ArenaAllocator arena{64_kib};
+    TierAllocator tier{TierSpecs{.Allocator = &arena}};
+
+    constexpr usz size = Test_MyRefCounted::GetAllocationSize<Test_MyDerivedRefCounted>();
+    REQUIRE(!tier.IsSameTier(size, Test_MyRefCounted::GetAllocationSize()));
+    const void *ptr;
+    {
+        const Ref<Test_MyRefCounted> ref = Ref<Test_MyDerivedRefCounted>::Create(&tier, 6);
+        REQUIRE(ref->Value == 6);
+        ptr = ref.Get();
+    }
+    REQUIRE(Test_MyRefCounted::DtorCount == 1);
+
+    // The slot went back to the tier the derived object was allocated from
+    void *reused = tier.Allocate(size);
+    REQUIRE(scast<std::byte *>(reused) + Test_MyRefCounted::GetHeaderSize() == ptr);
+    tier.Deallocate(reused, size);
+}
+
+TEST_CASE("WeakRef: outliving a heap object", "[Ref]")
+{
+    Test_MyRefCounted::DtorCount = 0;
+
+    WeakRef<Test_MyDerivedRefCounted> weak;
+    {
+        const auto ref = Ref<Test_MyDerivedRefCounted>::Create(3);
+        weak = ref;
+        REQUIRE(weak.Lock()->Value == 3);
+    }
+    REQUIRE(Test_MyRefCounted::DtorCount == 1);
+    REQUIRE(weak.IsExpired());
+    REQUIRE(!weak.Lock());
+
+    const WeakRef<Test_MyDerivedRefCounted> copy = weak;
+    weak.Reset();
+    REQUIRE(copy.IsExpired());
+}
+
+struct Test_MyLocalRefCounted : public LocalRefCounted<Test_MyLocalRefCounted>
+{
+    u32 Value;
+    Test_MyLocalRefCounted(const u32 value) : Value(value)
+    {
+    }
+};
+
+TEST_CASE("Ref: non-atomic reference counting", "[Ref]")
+{
+    auto ref1 = Ref<Test_MyLocalRefCounted>::Create(5);
+    WeakRef<Test_MyLocalRefCounted> weak = ref1;
+    {
+        const auto ref2 = ref1;
+        REQUIRE(ref1->RefCount() == 2);
+        REQUIRE(ref1->WeakRefCount() == 1);
+    }
+    REQUIRE(ref1->RefCount() == 1);
+    REQUIRE(weak.Lock()->Value == 5);
+
+    ref1 = nullptr;
+    REQUIRE(weak.IsExpired());
+}
+
 //===----------------------------------------------------------------------===//
 //  Scope tests
 //===----------------------------------------------------------------------===//
@@ -1,5 +1,8 @@
 #include "tkit/memory/tier_allocator.hpp"
 #include "tkit/utils/literals.hpp"
+#ifdef TKIT_ENABLE_YAML_SERIALIZATION
+#    include "tkit/serialization/yaml/tier_allocator.hpp"
+#endif
 #include <catch2/catch_test_macros.hpp>
 #include <vector>
 
@@ -110,24 +113,26 @@ TEST_CASE("Exhaust smallest tier and recover", "[TierAllocator]")
     TierAllocator alloc(
         TierSpecs{.Allocator = &s_Alloc, .MaxAllocation = maxAlloc, .Granularity = gran, .TierSlotDecay = decay});
 
-    // Repeatedly allocate the smallest request until it returns nullptr.
-    // This validates exhaustion returns nullptr and that deallocation restores capacity.
+    // Repeatedly allocate the smallest request until the allocator falls back to a large allocation.
+    // This validates exhaustion is handled and that deallocation restores capacity.
     std::vector<const void *> ptrs;
     TKIT_LOGS_PUSH();
     TKIT_LOGS_DISABLE(TKIT_WARNING_LOGS_BIT);
     for (;;)
     {
         const void *p = alloc.Allocate(1); // should map to the smallest tier (>= minAlloc)
-        if (!p)
-            break;
-        REQUIRE(alloc.Belongs(p));
+        REQUIRE(p);
         ptrs.push_back(p);
+        if (!alloc.Belongs(p))
+            break;
     }
     TKIT_LOGS_POP();
-    REQUIRE(!ptrs.empty());
+    REQUIRE(ptrs.size() > 1);
+    REQUIRE(alloc.GetLargeAllocationCount() == 1);
 
     for (const void *p : ptrs)
         alloc.Deallocate(p, 1);
+    REQUIRE(alloc.GetLargeAllocationCount() == 0);
 
     // Should be able to allocate again after freeing all
     const void *p = alloc.Allocate(1);
@@ -231,6 +236,119 @@ TEST_CASE("Belongs() only checks buffer boundaries (not allocation state)", "[Ti
     REQUIRE(alloc.Belongs(p));
 }
 
+TEST_CASE("Reallocate in place and across tiers", "[TierAllocator]")
+{
+    TierAllocator alloc(TierSpecs{.Allocator = &s_Alloc, .MaxAllocation = 512, .Granularity = 8});
+    REQUIRE(alloc.IsSameTier(260, 310));
+    REQUIRE(!alloc.IsSameTier(310, 400));
+
+    u8 *ptr = scast<u8 *>(alloc.Allocate(260));
+    REQUIRE(ptr);
+    for (usize i = 0; i < 260; ++i)
+        ptr[i] = u8(i);
+
+    // Same tier: the slot is reused
+    u8 *same = scast<u8 *>(alloc.Reallocate(ptr, 260, 310));
+    REQUIRE(same == ptr);
+    for (usize i = 260; i < 310; ++i)
+        same[i] = u8(i);
+
+    // Different tier: the contents are carried over
+    u8 *moved = scast<u8 *>(alloc.Reallocate(same, 310, 400));
+    REQUIRE(moved);
+    REQUIRE(moved != same);
+    REQUIRE(alloc.Belongs(moved));
+    for (usize i = 0; i < 310; ++i)
+        REQUIRE(moved[i] == u8(i));
+
+    // Shrinking to a smaller tier keeps the leading bytes
+    u32 *typed = alloc.Reallocate(rcast<u32 *>(moved), 100, 4);
+    REQUIRE(typed);
+    REQUIRE(rcast<u8 *>(typed)[3] == 3);
+    alloc.Deallocate(typed, 4);
+}
+
+TEST_CASE("Large allocations bypass the tiers", "[TierAllocator]")
+{
+    TierAllocator alloc(TierSpecs{.Allocator = &s_Alloc, .MaxAllocation = 512, .Granularity = 8});
+
+    u8 *big = scast<u8 *>(alloc.Allocate(64_kib));
+    REQUIRE(big);
+    REQUIRE(!alloc.Belongs(big));
+    REQUIRE(alloc.GetLargeAllocationCount() == 1);
+    REQUIRE(alloc.GetLargeAllocationSize() == 64_kib);
+    for (usize i = 0; i < 64_kib; ++i)
+        big[i] = u8(i);
+
+    big = scast<u8 *>(alloc.Reallocate(big, 64_kib, 1_mib));
+    REQUIRE(big);
+    REQUIRE(alloc.GetLargeAllocationSize() == 1_mib);
+    bool intact = true;
+    for (usize i = 0; i < 64_kib; ++i)
+        intact &= big[i] == u8(i);
+    REQUIRE(intact);
+
+    // Shrinking below the max allocation moves it back into the tiers
+    u8 *small = scast<u8 *>(alloc.Reallocate(big, 1_mib, 100));
+    REQUIRE(small);
+    REQUIRE(alloc.Belongs(small));
+    REQUIRE(alloc.GetLargeAllocationCount() == 0);
+    REQUIRE(small[99] == 99);
+    alloc.Deallocate(small, 100);
+
+    u64 *values = alloc.NCreate<u64>(10000, u64(7));
+    REQUIRE(values);
+    REQUIRE(values[9999] == 7);
+    alloc.NDestroy(values, 10000);
+    REQUIRE(alloc.GetLargeAllocationCount() == 0);
+}
+
+TEST_CASE("Recording balances large allocations across reallocations", "[TierAllocator]")
+{
+    TierAllocator alloc(TierSpecs{.Allocator = &s_Alloc, .MaxAllocation = 512, .Granularity = 8});
+    TierRecording recording;
+    alloc.SetRecording(&recording);
+
+    void *ptr = alloc.Allocate(64_kib);
+    ptr = alloc.Reallocate(ptr, 64_kib, 256_kib);
+    REQUIRE(ptr);
+    REQUIRE(recording.GetLargeAllocations().Live == 1);
+    REQUIRE(recording.GetLargeAllocations().Requests == 2);
+
+    ptr = alloc.Reallocate(ptr, 256_kib, 100);
+    REQUIRE(recording.GetLargeAllocations().Live == 0);
+    REQUIRE(recording.GetSizes()[100].Live == 1);
+
+    ptr = alloc.Reallocate(ptr, 100, 1_kib);
+    REQUIRE(recording.GetSizes()[100].Live == 0);
+    REQUIRE(recording.GetLargeAllocations().Live == 1);
+    alloc.Deallocate(ptr, 1_kib);
+    REQUIRE(recording.GetLargeAllocations().Live == 0);
+    REQUIRE(recording.GetLargeAllocations().PeakLive == 1);
+    REQUIRE(alloc.GetLargeAllocationCount() == 0);
+    alloc.SetRecording(nullptr);
+}
+
+TEST_CASE("NUMA local tier allocator", "[TierAllocator]")
+{
+    TierAllocator alloc(TierSpecs{.Allocator = &s_Alloc, .MaxAllocation = 512, .Granularity = 8},
+                        alignof(std::max_align_t), alignof(std::max_align_t), {.Policy = Numa_Local});
+
+    u64 *small = alloc.NCreate<u64>(16, u64(1));
+    REQUIRE(small);
+    REQUIRE(alloc.Belongs(small));
+    REQUIRE(small[15] == 1);
+
+    u64 *large = alloc.NCreate<u64>(4096, u64(2));
+    REQUIRE(large);
+    REQUIRE(!alloc.Belongs(large));
+    REQUIRE(large[4095] == 2);
+
+    alloc.NDestroy(small, 16);
+    alloc.NDestroy(large, 4096);
+    REQUIRE(alloc.GetLargeAllocationCount() == 0);
+}
+
 TEST_CASE("Description::GetTierIndex sanity for min allocation", "[TierAllocator]")
 {
     constexpr usize maxAlloc = 512;
@@ -244,3 +362,138 @@ TEST_CASE("Description::GetTierIndex sanity for min allocation", "[TierAllocator
     const usize idxMin = desc.GetTierIndex(desc.GetMinAllocation());
     REQUIRE(idxMin + 1 == desc.GetTiers().GetSize());
 }
+
+static void runRecordedWorkload(TierAllocator &alloc, std::vector<std::pair<void *, usz>> &live)
+{
+    // A workload with a few hot sizes and one occasional big allocation
+    for (usize round = 0; round < 4; ++round)
+    {
+        for (usz i = 0; i < 24; ++i)
+            live.emplace_back(alloc.Allocate(24), 24);
+        for (usz i = 0; i < 10; ++i)
+            live.emplace_back(alloc.Allocate(100), 100);
+        live.emplace_back(alloc.Allocate(400), 400);
+        for (const auto &[ptr, size] : live)
+            alloc.Deallocate(ptr, size);
+        live.clear();
+    }
+}
+
+TEST_CASE("Recording tracks sizes, peaks and steals", "[TierAllocator]")
+{
+    TierAllocator alloc(TierSpecs{.Allocator = &s_Alloc, .MaxAllocation = 512, .Granularity = 4});
+    TierRecording recording;
+    alloc.SetRecording(&recording);
+
+    std::vector<std::pair<void *, usz>> live;
+    TKIT_LOGS_PUSH();
+    TKIT_LOGS_DISABLE(TKIT_WARNING_LOGS_BIT);
+    runRecordedWorkload(alloc, live);
+    TKIT_LOGS_POP();
+    alloc.SetRecording(nullptr);
+
+    const auto &sizes = recording.GetSizes();
+    REQUIRE(sizes.GetSize() == 401);
+    REQUIRE(sizes[24].Requests == 4 * 24);
+    REQUIRE(sizes[24].PeakLive == 24);
+    REQUIRE(sizes[24].Live == 0);
+    REQUIRE(sizes[100].PeakLive == 10);
+    REQUIRE(sizes[400].PeakLive == 1);
+    REQUIRE(sizes[50].Requests == 0);
+
+    // The default layout does not have enough slots for this workload
+    u64 requests = 0;
+    u64 steals = 0;
+    for (const auto &tier : recording.GetTiers())
+    {
+        requests += tier.Allocations.Requests;
+        steals += tier.Steals;
+    }
+    REQUIRE(requests == 4 * 35);
+    REQUIRE(steals > 0);
+}
+
+TEST_CASE("Solved tier descriptions fit the recorded workload", "[TierAllocator]")
+{
+    TierRecording recording;
+    std::vector<std::pair<void *, usz>> live;
+    {
+        TierAllocator alloc(TierSpecs{.Allocator = &s_Alloc, .MaxAllocation = 1024, .Granularity = 8});
+        alloc.SetRecording(&recording);
+        TKIT_LOGS_PUSH();
+        TKIT_LOGS_DISABLE(TKIT_WARNING_LOGS_BIT);
+        runRecordedWorkload(alloc, live);
+        TKIT_LOGS_POP();
+    }
+
+    const TierDescriptions solved = recording.Solve(TierSpecs{.Allocator = &s_Alloc});
+    REQUIRE(solved.GetMaxAllocation() == 512);
+    REQUIRE(solved.GetBufferSize() < TierDescriptions(TierSpecs{.Allocator = &s_Alloc}).GetBufferSize());
+
+    TierAllocator alloc(solved);
+    TierRecording replay;
+    alloc.SetRecording(&replay);
+    runRecordedWorkload(alloc, live);
+
+    for (const auto &tier : replay.GetTiers())
+        REQUIRE(tier.Steals == 0);
+}
+
+TEST_CASE("Description layout validation", "[TierAllocator]")
+{
+    const TierDescriptions desc(TierSpecs{.Allocator = &s_Alloc, .MaxTiers = 16});
+    REQUIRE(desc.IsValidLayout(1_kib, 16, 4));
+    REQUIRE(desc.IsValidLayout(512, 512, 2));
+
+    REQUIRE(!desc.IsValidLayout(1000, 16, 4));
+    REQUIRE(!desc.IsValidLayout(1_kib, 24, 4));
+    REQUIRE(!desc.IsValidLayout(1_kib, 16, 3));
+    REQUIRE(!desc.IsValidLayout(1_kib, 0, 4));
+    REQUIRE(!desc.IsValidLayout(16, 1_kib, 4));
+    REQUIRE(!desc.IsValidLayout(1_kib, 16, 1));
+    REQUIRE(!desc.IsValidLayout(1_kib, 16, 32));
+    REQUIRE(!desc.IsValidLayout(1_kib, 4, 4));
+
+    // Valid on its own, but needs more tiers than the description can hold
+    REQUIRE(!desc.IsValidLayout(1_mib, 64, 4));
+}
+
+#ifdef TKIT_ENABLE_YAML_SERIALIZATION
+TEST_CASE("Description YAML round trip", "[TierAllocator]")
+{
+    TierDescriptions desc(TierSpecs{.Allocator = &s_Alloc, .MaxAllocation = 2_kib, .Granularity = 8});
+    desc.SetMinSlotsForIndex(3, 40);
+    const Yaml::Node node = Yaml::Node{desc};
+
+    TierDescriptions decoded(TierSpecs{.Allocator = &s_Alloc});
+    REQUIRE(Yaml::Codec<TierDescriptions>::Decode(node, decoded));
+    REQUIRE(decoded.GetMaxAllocation() == desc.GetMaxAllocation());
+    REQUIRE(decoded.GetMinAllocation() == desc.GetMinAllocation());
+    REQUIRE(decoded.GetGranularity() == desc.GetGranularity());
+    REQUIRE(decoded.GetBufferSize() == desc.GetBufferSize());
+    REQUIRE(decoded.GetTiers().GetSize() == desc.GetTiers().GetSize());
+    for (usize i = 0; i < desc.GetTiers().GetSize(); ++i)
+        REQUIRE(decoded.GetTiers()[i].Slots == desc.GetTiers()[i].Slots);
+}
+
+TEST_CASE("Description YAML rejects malformed layouts", "[TierAllocator]")
+{
+    const TierDescriptions desc(TierSpecs{.Allocator = &s_Alloc});
+    const Yaml::Node valid = Yaml::Node{desc};
+
+    const auto decode = [&](const char *key, const usz value) {
+        Yaml::Node node = YAML::Clone(valid);
+        node[key] = value;
+        TierDescriptions decoded(TierSpecs{.Allocator = &s_Alloc});
+        return Yaml::Codec<TierDescriptions>::Decode(node, decoded);
+    };
+
+    REQUIRE(decode("MaxAllocation", 1000) == false);
+    REQUIRE(decode("MaxAllocation", 8) == false);
+    REQUIRE(decode("MinAllocation", 0) == false);
+    REQUIRE(decode("MinAllocation", 24) == false);
+    REQUIRE(decode("Granularity", 3) == false);
+    REQUIRE(decode("Granularity", 1) == false);
+    REQUIRE(decode("Granularity", 1_kib) == false);
+}
+#endif
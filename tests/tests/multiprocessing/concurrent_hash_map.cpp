@@ -0,0 +1,162 @@
+#include "tkit/multiprocessing/concurrent_hash_map.hpp"
+#include "tkit/memory/tier_allocator.hpp"
+#include "tkit/utils/literals.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <thread>
+
+using namespace TKit;
+using namespace TKit::Alias;
+
+static ArenaAllocator s_Arena{1_mib};
+
+TEST_CASE("ConcurrentHashMap: single thread operations", "[ConcurrentHashMap]")
+{
+    ConcurrentHashMap<u32, std::string> map{ConcurrentHashMapSpecs{.Shards = 4}};
+    REQUIRE(map.GetShardCount() == 4);
+    REQUIRE(map.IsEmpty());
+
+    REQUIRE(map.Insert(1, "one"));
+    REQUIRE(!map.Insert(1, "uno"));
+    REQUIRE(map.Find(1).GetValue() == "one");
+    REQUIRE(!map.InsertOrAssign(1, "uno"));
+    REQUIRE(map.Find(1).GetValue() == "uno");
+    REQUIRE(map.InsertOrAssign(2, "two"));
+    REQUIRE(map.GetSize() == 2);
+
+    REQUIRE(!map.Find(3).IsSome());
+    REQUIRE(!map.Contains(3));
+    REQUIRE(map.Contains(2));
+
+    REQUIRE(map.Update(2, [](std::string &value) { value += "!"; }));
+    REQUIRE(!map.Update(3, [](std::string &) {}));
+    usize length = 0;
+    REQUIRE(map.Visit(2, [&length](const std::string &value) { length = value.size(); }));
+    REQUIRE(length == 4);
+
+    REQUIRE(map.Upsert(3, [](std::string &value) { value = "unreachable"; }, "three"));
+    REQUIRE(!map.Upsert(3, [](std::string &value) { value += "!"; }, "unused"));
+    REQUIRE(map.Find(3).GetValue() == "three!");
+
+    REQUIRE(map.Remove(1));
+    REQUIRE(!map.Remove(1));
+    REQUIRE(map.GetSize() == 2);
+
+    usize visited = 0;
+    map.ForEach([&visited](const u32 key, const std::string &) { visited += key; });
+    REQUIRE(visited == 5);
+
+    map.Clear();
+    REQUIRE(map.IsEmpty());
+    REQUIRE(!map.Contains(2));
+}
+
+TEST_CASE("ConcurrentHashMap: incremental growth keeps every element reachable", "[ConcurrentHashMap]")
+{
+    ConcurrentHashMap<u32, u32> map{ConcurrentHashMapSpecs{.Shards = 2}};
+    const usize buckets = map.GetBucketCount();
+
+    // Lookups in between insertions hit shards with half migrated tables
+    bool valid = true;
+    for (u32 i = 0; i < 20000; ++i)
+    {
+        map.Insert(i, 2 * i);
+        if (i % 7 == 0)
+            valid &= map.Find(i / 2).GetValue() == 2 * (i / 2);
+    }
+    REQUIRE(valid);
+    REQUIRE(map.GetSize() == 20000);
+    REQUIRE(map.GetBucketCount() > buckets);
+
+    for (u32 i = 0; i < 20000; i += 2)
+        REQUIRE(map.Remove(i));
+
+    usize count = 0;
+    map.ForEach([&](const u32 key, const u32 value) {
+        valid &= key % 2 == 1 && value == 2 * key;
+        ++count;
+    });
+    REQUIRE(valid);
+    REQUIRE(count == 10000);
+}
+
+TEST_CASE("ConcurrentHashMap: heterogeneous lookup with string keys", "[ConcurrentHashMap]")
+{
+    ConcurrentHashMap<DynamicString, u32> map{};
+    map.Insert("alpha", 1u);
+    map.Insert("beta", 2u);
+
+    const std::string_view key = "beta";
+    REQUIRE(map.Find(key).GetValue() == 2);
+    REQUIRE(map.Contains("alpha"));
+    REQUIRE(map.Remove("alpha"));
+    REQUIRE(!map.Contains(std::string_view{"alpha"}));
+}
+
+TEST_CASE("ConcurrentHashMap: concurrent readers and writers", "[ConcurrentHashMap]")
+{
+    constexpr u32 threads = 8;
+    constexpr u32 keys = 4000;
+    ConcurrentHashMap<u32, u32> map{ConcurrentHashMapSpecs{.Shards = 4}};
+
+    std::atomic<u32> errors{0};
+    DynamicArray<std::thread> workers{};
+    for (u32 t = 0; t < threads; ++t)
+        workers.Append([&, t] {
+            // Every thread owns a range of keys, but reads the ranges of the others while they grow the map
+            const u32 begin = t * keys;
+            for (u32 i = begin; i < begin + keys; ++i)
+            {
+                map.Insert(i, i + 1);
+                const u32 other = ((t + 1) % threads) * keys + (i - begin);
+                const Optional<u32> value = map.Find(other);
+                if (value.IsSome() && value.GetValue() != other + 1)
+                    errors.fetch_add(1, std::memory_order_relaxed);
+            }
+            for (u32 i = begin; i < begin + keys; i += 2)
+                if (!map.Remove(i))
+                    errors.fetch_add(1, std::memory_order_relaxed);
+        });
+    for (std::thread &worker : workers)
+        worker.join();
+
+    REQUIRE(errors.load() == 0);
+    REQUIRE(map.GetSize() == threads * keys / 2);
+    bool valid = true;
+    for (u32 i = 0; i < threads * keys; ++i)
+        valid &= i % 2 == 0 ? !map.Contains(i) : map.Find(i).GetValue() == i + 1;
+    REQUIRE(valid);
+}
+
+TEST_CASE("ConcurrentHashMap: concurrent upserts are atomic", "[ConcurrentHashMap]")
+{
+    constexpr u32 threads = 8;
+    constexpr u32 keys = 1000;
+    using Map = ConcurrentHashMap<u32, u32>;
+
+    TierDescriptions tiers{TierSpecs{.Allocator = &s_Arena}};
+    tiers.SetMinSlotsForSize(sizeof(Map::Node), keys);
+    TierAllocator *allocators[4];
+    for (TierAllocator *&allocator : allocators)
+        allocator = new TierAllocator{tiers};
+
+    {
+        Map map{ConcurrentHashMapSpecs{.Shards = 4, .Allocators = {allocators, 4}}};
+        DynamicArray<std::thread> workers{};
+        for (u32 t = 0; t < threads; ++t)
+            workers.Append([&map] {
+                for (u32 i = 0; i < keys; ++i)
+                    map.Upsert(i, [](u32 &count) { ++count; }, 1u);
+            });
+        for (std::thread &worker : workers)
+            worker.join();
+
+        REQUIRE(map.GetSize() == keys);
+        bool valid = true;
+        map.ForEach([&valid](const u32, const u32 count) { valid &= count == threads; });
+        REQUIRE(valid);
+    }
+
+    for (TierAllocator *allocator : allocators)
+        delete allocator;
+}
@@ -0,0 +1,125 @@
+#include "tkit/multiprocessing/epoch_manager.hpp"
+#include "tkit/multiprocessing/topology.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+#include <vector>
+
+using namespace TKit;
+
+static std::atomic<u32> s_Deletions{0};
+struct Test_EpochNode
+{
+    u32 Value;
+    Test_EpochNode *Next = nullptr;
+
+    Test_EpochNode(const u32 value) : Value(value)
+    {
+    }
+    ~Test_EpochNode()
+    {
+        s_Deletions.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+// A minimal Treiber stack whose popped nodes are retired instead of recycled
+struct Test_EpochStack
+{
+    void Push(Test_EpochNode *node)
+    {
+        Test_EpochNode *head = Head.load(std::memory_order_relaxed);
+        do
+        {
+            node->Next = head;
+        } while (!Head.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    bool Pop(EpochManager &epochs, u32 &value)
+    {
+        const EpochManager::Guard guard{epochs};
+        Test_EpochNode *head = Head.load(std::memory_order_acquire);
+        while (head && !Head.compare_exchange_weak(head, head->Next, std::memory_order_acquire,
+                                                   std::memory_order_acquire))
+            ;
+        if (!head)
+            return false;
+        value = head->Value;
+        epochs.Retire(head);
+        return true;
+    }
+
+    std::atomic<Test_EpochNode *> Head{nullptr};
+};
+
+TEST_CASE("Retired nodes are reclaimed after two epochs", "[EpochManager]")
+{
+    s_Deletions = 0;
+    EpochManager epochs{1000};
+    Topology::SetThreadIndex(0);
+
+    {
+        const EpochManager::Guard guard{epochs};
+        epochs.Retire(new Test_EpochNode{1});
+        REQUIRE(epochs.GetPendingCount() == 1);
+
+        // The epoch can advance once, as this thread has observed it, but not twice while it stays inside
+        epochs.Collect();
+        epochs.Collect();
+        REQUIRE(epochs.GetEpoch() == 1);
+        REQUIRE(s_Deletions == 0);
+    }
+
+    epochs.Collect();
+    REQUIRE(epochs.GetEpoch() == 2);
+    REQUIRE(s_Deletions == 1);
+    REQUIRE(epochs.GetPendingCount() == 0);
+}
+
+TEST_CASE("Retirements are reclaimed in batches", "[EpochManager]")
+{
+    s_Deletions = 0;
+    {
+        EpochManager epochs{8};
+        Topology::SetThreadIndex(0);
+        for (u32 i = 0; i < 100; ++i)
+            epochs.Retire(new Test_EpochNode{i});
+        REQUIRE(s_Deletions > 0);
+        REQUIRE(epochs.GetPendingCount() < 100);
+        REQUIRE(epochs.GetPendingCount() + s_Deletions == 100);
+
+        epochs.Retire(scast<void *>(new u32{5}), [](void *ptr) { delete scast<u32 *>(ptr); });
+    }
+    // The destructor takes care of whatever is left
+    REQUIRE(s_Deletions == 100);
+}
+
+TEST_CASE("Concurrent pops retire nodes safely", "[EpochManager]")
+{
+    constexpr usize threadCount = 4;
+    constexpr u32 nodes = 20000;
+    s_Deletions = 0;
+    {
+        EpochManager epochs{};
+        Test_EpochStack stack{};
+        for (u32 i = 0; i < nodes; ++i)
+            stack.Push(new Test_EpochNode{i});
+
+        std::atomic<u64> sum{0};
+        std::vector<std::thread> threads;
+        for (usize t = 0; t < threadCount; ++t)
+            threads.emplace_back([&, t] {
+                Topology::SetThreadIndex(t + 1);
+                u32 value;
+                u64 local = 0;
+                while (stack.Pop(epochs, value))
+                    local += value;
+                sum.fetch_add(local, std::memory_order_relaxed);
+            });
+        for (std::thread &thread : threads)
+            thread.join();
+
+        REQUIRE(sum.load() == u64(nodes) * (nodes - 1) / 2);
+        REQUIRE(s_Deletions <= nodes);
+    }
+    REQUIRE(s_Deletions == nodes);
+    Topology::SetThreadIndex(0);
+}
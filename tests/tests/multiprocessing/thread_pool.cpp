@@ -1,5 +1,7 @@
 #include "tkit/multiprocessing/task.hpp"
 #include "tkit/multiprocessing/thread_pool.hpp"
+#include "tkit/multiprocessing/topology.hpp"
+#include "tkit/container/stack_array.hpp"
 #include "tkit/utils/literals.hpp"
 #include <catch2/catch_test_macros.hpp>
 #include <atomic>
@@ -56,3 +58,56 @@ TEST_CASE("ThreadPool executes Task<usize>s and preserves results", "[ThreadPool
         REQUIRE(res % 10 <= threadCount); // valid thread index
     }
 }
+
+TEST_CASE("ThreadPool workers provide scratch allocators", "[ThreadPool]")
+{
+    constexpr usize threadCount = 4;
+    constexpr usize taskCount = 32;
+    ThreadPool pool(&s_Alloc, threadCount, 32, {.ArenaCapacity = 16_kib, .StackCapacity = 4_kib});
+
+    std::array<Task<u32>, taskCount> tasks;
+    for (usize i = 0; i < taskCount; ++i)
+    {
+        tasks[i] = [i] {
+            if (!GetArena() || !GetStack())
+                return u32(0);
+
+            ArenaArray<u32> arena{};
+            arena.Reserve(64);
+            StackArray<u32> stack{};
+            stack.Reserve(64);
+            for (u32 j = 0; j < 64; ++j)
+            {
+                arena.Append(u32(i));
+                stack.Append(j);
+            }
+            return arena[63] + stack[63];
+        };
+        pool.SubmitTask(&tasks[i]);
+    }
+
+    for (usize i = 0; i < taskCount; ++i)
+        REQUIRE(tasks[i].WaitForResult() == u32(i) + 63);
+}
+
+TEST_CASE("Topology handles share a single topology", "[ThreadPool]")
+{
+    constexpr usz size = 64_kib;
+    void *pages = AllocatePages(size);
+    REQUIRE(pages);
+
+    const Topology::Handle *first = Topology::Initialize();
+    const Topology::Handle *second = Topology::Initialize();
+    const usize nodes = Topology::GetNumaNodeCount();
+    const bool bound = Topology::BindMemory(pages, size, 0);
+
+    // Terminating the most recent handle must not affect the other one
+    Topology::Terminate(second);
+    REQUIRE(Topology::GetNumaNodeCount() == nodes);
+    REQUIRE(Topology::BindMemory(pages, size, 0) == bound);
+
+    Topology::Terminate(first);
+    REQUIRE(Topology::GetNumaNodeCount() == 1);
+    REQUIRE(!Topology::BindMemory(pages, size, 0));
+    DeallocatePages(pages, size);
+}
@@ -1,6 +1,7 @@
 #include "tkit/utils/hash.hpp"
 #include "tkit/container/fixed_array.hpp"
 #include <catch2/catch_test_macros.hpp>
+#include <bit>
 #include <string>
 
 using namespace TKit;
@@ -108,3 +109,50 @@ TEST_CASE("Hash of different types in range", "[HashRange]")
         HashCombine(seed, s);
     REQUIRE(hr == seed);
 }
+
+TEST_CASE("HashBytes covers every input size", "[Hash][HashBytes]")
+{
+    char buffer[200];
+    for (usz i = 0; i < sizeof(buffer); ++i)
+        buffer[i] = char('a' + i % 26);
+
+    // Every prefix must hash differently, and changing the last byte must change the hash
+    FixedArray<usz, 200> hashes{};
+    for (usz size = 0; size < sizeof(buffer); ++size)
+    {
+        hashes[size] = HashBytes(buffer, size);
+        REQUIRE(HashBytes(buffer, size) == hashes[size]);
+        if (size != 0)
+        {
+            buffer[size - 1] ^= 1;
+            REQUIRE(HashBytes(buffer, size) != hashes[size]);
+            buffer[size - 1] ^= 1;
+        }
+    }
+    bool unique = true;
+    for (usz i = 0; i < sizeof(buffer); ++i)
+        for (usz j = i + 1; j < sizeof(buffer); ++j)
+            unique &= hashes[i] != hashes[j];
+    REQUIRE(unique);
+
+    REQUIRE(HashBytes(buffer, 10, 1) != HashBytes(buffer, 10, 2));
+}
+
+TEST_CASE("Fast hashes avalanche", "[Hash][HashBytes]")
+{
+    // Flipping a single input bit should flip about half of the output bits
+    u64 flipped = 0;
+    u64 samples = 0;
+    for (u64 value = 0; value < 64; ++value)
+        for (u32 bit = 0; bit < 64; ++bit)
+        {
+            flipped += u64(std::popcount(u64(HashInteger(value) ^ HashInteger(value ^ (u64(1) << bit)))));
+            ++samples;
+        }
+    const f64 average = f64(flipped) / f64(samples);
+    REQUIRE(average > 28.0);
+    REQUIRE(average < 36.0);
+
+    REQUIRE(DefaultHasher<std::string>{}("hello") == HashBytes("hello", 5));
+    REQUIRE(DefaultHasher<std::string>{}(std::string("hello")) == DefaultHasher<std::string_view>{}("hello"));
+}
@@ -79,4 +79,8 @@ template <typename T> struct ArenaAllocation
 };
 template <typename T> using ArenaArray = Array<T, ArenaAllocation<T>>;
 using ArenaString = Array<char, ArenaAllocation<char>>;
+
+template <typename T> struct IsTriviallyRelocatable<Array<T, ArenaAllocation<T>>> : std::true_type
+{
+};
 } // namespace TKit
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "tkit/container/container.hpp"
+#include "tkit/container/string_search.hpp"
 #include <ostream>
 
 namespace TKit
@@ -11,7 +12,8 @@ enum ArrayType : u8
     Array_Dynamic,
     Array_Arena,
     Array_Stack,
-    Array_Tier
+    Array_Tier,
+    Array_Small
 };
 
 template <typename T, typename AllocState> class Array
@@ -36,7 +38,7 @@ template <typename T, typename AllocState> class Array
     constexpr explicit Array(const U psize, Args &&...args) : m_State(std::forward<Args>(args)...)
     {
         const usize size = addOneIfString(usize(psize));
-        if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+        if constexpr (Type == Array_Dynamic || Type == Array_Tier || Type == Array_Small)
             m_State.GrowCapacityIf(size != 0, size);
         else
         {
@@ -60,7 +62,7 @@ template <typename T, typename AllocState> class Array
         : m_State(std::forward<Args>(args)...)
     {
         const usize size = addOneIfString(usize(psize));
-        if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+        if constexpr (Type == Array_Dynamic || Type == Array_Tier || Type == Array_Small)
             m_State.GrowCapacity(size);
         else
         {
@@ -99,7 +101,7 @@ template <typename T, typename AllocState> class Array
     constexpr Array(const It pbegin, const It pend, Args &&...args) : m_State(std::forward<Args>(args)...)
     {
         const usize size = addOneIfString(usize(std::distance(pbegin, pend)));
-        if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+        if constexpr (Type == Array_Dynamic || Type == Array_Tier || Type == Array_Small)
             m_State.GrowCapacityIf(size != 0, size);
         else
         {
@@ -120,7 +122,7 @@ template <typename T, typename AllocState> class Array
     constexpr Array(const std::initializer_list<T> list, Args &&...args) : m_State(std::forward<Args>(args)...)
     {
         const usize size = addOneIfString(usize(list.size()));
-        if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+        if constexpr (Type == Array_Dynamic || Type == Array_Tier || Type == Array_Small)
             m_State.GrowCapacityIf(size != 0, size);
         else
         {
@@ -140,7 +142,7 @@ template <typename T, typename AllocState> class Array
     constexpr Array(const Array &other)
     {
         const usize otherSize = other.m_State.Size;
-        if constexpr (Type == Array_Dynamic)
+        if constexpr (Type == Array_Dynamic || Type == Array_Small)
             m_State.GrowCapacityIf(otherSize != 0, otherSize);
         else if constexpr (Type == Array_Arena || Type == Array_Stack || Type == Array_Tier)
         {
@@ -166,7 +168,7 @@ template <typename T, typename AllocState> class Array
         TKIT_ASSERT(!IsString || other.m_State.Size != 0,
                     "[TOOLKIT][ARRAY] All string arrays must have allocated at least a null terminator");
         const usize otherSize = other.m_State.Size;
-        if constexpr (Type == Array_Dynamic)
+        if constexpr (Type == Array_Dynamic || Type == Array_Small)
             m_State.GrowCapacityIf(otherSize != 0, otherSize);
         else if constexpr (Type == Array_Arena || Type == Array_Stack || Type == Array_Tier)
         {
@@ -201,7 +203,7 @@ template <typename T, typename AllocState> class Array
     ~Array()
     {
         Clear();
-        if constexpr (Type == Array_Dynamic || Type == Array_Stack || Type == Array_Tier)
+        if constexpr (Type == Array_Dynamic || Type == Array_Stack || Type == Array_Tier || Type == Array_Small)
             m_State.Deallocate();
     }
 
@@ -211,7 +213,7 @@ template <typename T, typename AllocState> class Array
             return *this;
 
         const usize otherSize = other.m_State.Size;
-        if constexpr (Type == Array_Dynamic)
+        if constexpr (Type == Array_Dynamic || Type == Array_Small)
             m_State.GrowCapacityIf(otherSize > m_State.Capacity, otherSize);
         else
         {
@@ -248,7 +250,7 @@ template <typename T, typename AllocState> class Array
     template <typename OtherAlloc> constexpr Array &operator=(const Array<T, OtherAlloc> &other)
     {
         const usize otherSize = other.m_State.Size;
-        if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+        if constexpr (Type == Array_Dynamic || Type == Array_Tier || Type == Array_Small)
             m_State.GrowCapacityIf(otherSize > m_State.Capacity, otherSize);
         else
         {
@@ -297,7 +299,7 @@ template <typename T, typename AllocState> class Array
             if (mustAddTwo())
                 ++newSize;
 
-        if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+        if constexpr (Type == Array_Dynamic || Type == Array_Tier || Type == Array_Small)
             m_State.GrowCapacityIf(newSize > m_State.GetCapacity(), newSize);
         else
         {
@@ -315,7 +317,7 @@ template <typename T, typename AllocState> class Array
             if (mustAddTwo())
                 ++newSize;
 
-        if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+        if constexpr (Type == Array_Dynamic || Type == Array_Tier || Type == Array_Small)
         {
             if constexpr (std::is_same_v<T, std::remove_cvref_t<U>> && std::is_reference_v<U>)
             {
@@ -360,7 +362,7 @@ template <typename T, typename AllocState> class Array
         if constexpr (IsString)
             if (mustAddTwo())
                 ++newSize;
-        if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+        if constexpr (Type == Array_Dynamic || Type == Array_Tier || Type == Array_Small)
         {
             if (newSize > m_State.GetCapacity())
             {
@@ -392,7 +394,7 @@ template <typename T, typename AllocState> class Array
             if (mustAddTwo())
                 ++newSize;
 
-        if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+        if constexpr (Type == Array_Dynamic || Type == Array_Tier || Type == Array_Small)
         {
             if (newSize > m_State.GetCapacity())
             {
@@ -550,7 +552,7 @@ template <typename T, typename AllocState> class Array
     template <typename... Args> constexpr void Resize(const usize size, const Args &...args)
     {
         const usize rsize = addOneIfString(size);
-        if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+        if constexpr (Type == Array_Dynamic || Type == Array_Tier || Type == Array_Small)
             m_State.GrowCapacityIf(rsize > m_State.GetCapacity(), rsize);
         else
         {
@@ -581,7 +583,7 @@ template <typename T, typename AllocState> class Array
         requires(Type != Array_Static)
     {
         const usize c = addOneIfString(capacity);
-        if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+        if constexpr (Type == Array_Dynamic || Type == Array_Tier || Type == Array_Small)
         {
             if (c > m_State.Capacity)
                 m_State.ModifyCapacity(c);
@@ -593,7 +595,7 @@ template <typename T, typename AllocState> class Array
     // nullptr will grab the current pushed allocator on next Allocate()
     template <typename Allocator>
     constexpr void ResetAllocator(Allocator *allocator = nullptr)
-        requires(Type != Array_Dynamic && Type != Array_Static)
+        requires(Type != Array_Dynamic && Type != Array_Static && Type != Array_Small)
     {
         if constexpr (Type != Array_Arena)
         {
@@ -624,7 +626,7 @@ template <typename T, typename AllocState> class Array
     }
     template <typename Allocator>
     constexpr void Allocate(Allocator *allocator, const usize capacity)
-        requires(Type != Array_Static && Type != Array_Dynamic)
+        requires(Type != Array_Static && Type != Array_Dynamic && Type != Array_Small)
     {
         // TKIT_ASSERT(!m_State.Allocator, "[TOOLKIT][ARRAY] Array state has already an active allocator and cannot be "
         //                                 "replaced. Use the Allocate() overload that does not accept an allocator");
@@ -635,7 +637,7 @@ template <typename T, typename AllocState> class Array
     }
     template <typename Allocator, typename... Args>
     constexpr void Create(Allocator *allocator, const usize size, Args &&...args)
-        requires(Type != Array_Static && Type != Array_Dynamic)
+        requires(Type != Array_Static && Type != Array_Dynamic && Type != Array_Small)
     {
         // TKIT_ASSERT(!m_State.Allocator, "[TOOLKIT][ARRAY] Array state has already an active allocator and cannot be "
         //                                 "replaced. Use the Allocate() overload that does not accept an allocator");
@@ -650,7 +652,7 @@ template <typename T, typename AllocState> class Array
     }
 
     constexpr void Shrink()
-        requires(Type == Array_Dynamic || Type == Array_Tier)
+        requires(Type == Array_Dynamic || Type == Array_Tier || Type == Array_Small)
     {
         if (m_State.Size == 0)
             m_State.Deallocate();
@@ -665,7 +667,7 @@ template <typename T, typename AllocState> class Array
     }
 
     constexpr auto GetAllocator() const
-        requires(Type != Array_Static && Type != Array_Dynamic)
+        requires(Type != Array_Static && Type != Array_Dynamic && Type != Array_Small)
     {
         return m_State.Allocator;
     }
@@ -807,24 +809,13 @@ template <typename T, typename AllocState> class Array
     constexpr usize Find(const T ch, const usize from = 0) const
         requires(IsString)
     {
-        for (usize i = from; i < GetSize(); ++i)
-            if (*(begin() + i) == ch)
-                return i;
-        return npos;
+        return Container::FindChar(begin(), GetSize(), ch, from);
     }
 
     constexpr usize Find(const T *str, const usize from = 0) const
         requires(IsString)
     {
-        const usize len = usize(std::char_traits<T>::length(str));
-        if (len == 0)
-            return from <= GetSize() ? from : npos;
-        if (len > GetSize())
-            return npos;
-        for (usize i = from; i <= GetSize() - len; ++i)
-            if (std::char_traits<T>::compare(begin() + i, str, len) == 0)
-                return i;
-        return npos;
+        return Container::FindString(begin(), GetSize(), str, usize(std::char_traits<T>::length(str)), from);
     }
 
     constexpr usize FindLast(const T ch) const
@@ -853,42 +844,19 @@ template <typename T, typename AllocState> class Array
     constexpr usize FindFirstOf(const T *chars, const usize from = 0) const
         requires(IsString)
     {
-        const usize len = usize(std::char_traits<T>::length(chars));
-        for (usize i = from; i < GetSize(); ++i)
-            for (usize j = 0; j < len; ++j)
-                if (*(begin() + i) == chars[j])
-                    return i;
-        return npos;
+        return Container::FindFirstOf(begin(), GetSize(), chars, usize(std::char_traits<T>::length(chars)), from);
     }
 
     constexpr usize FindLastOf(const T *chars) const
         requires(IsString)
     {
-        const usize len = usize(std::char_traits<T>::length(chars));
-        for (usize i = GetSize(); i > 0; --i)
-            for (usize j = 0; j < len; ++j)
-                if (*(begin() + i - 1) == chars[j])
-                    return i - 1;
-        return npos;
+        return Container::FindLastOf(begin(), GetSize(), chars, usize(std::char_traits<T>::length(chars)));
     }
 
     constexpr usize FindFirstNotOf(const T *chars, const usize from = 0) const
         requires(IsString)
     {
-        const usize len = usize(std::char_traits<T>::length(chars));
-        for (usize i = from; i < GetSize(); ++i)
-        {
-            bool found = false;
-            for (usize j = 0; j < len; ++j)
-                if (*(begin() + i) == chars[j])
-                {
-                    found = true;
-                    break;
-                }
-            if (!found)
-                return i;
-        }
-        return npos;
+        return Container::FindFirstNotOf(begin(), GetSize(), chars, usize(std::char_traits<T>::length(chars)), from);
     }
 
     // === Substrings / Slicing ===
@@ -939,7 +907,7 @@ template <typename T, typename AllocState> class Array
     constexpr bool operator==(const Array &other) const
         requires(IsString)
     {
-        return Compare(other) == 0;
+        return GetSize() == other.GetSize() && std::char_traits<T>::compare(begin(), other.begin(), GetSize()) == 0;
     }
     constexpr bool operator!=(const T *str) const
         requires(IsString)
@@ -949,7 +917,7 @@ template <typename T, typename AllocState> class Array
     constexpr bool operator!=(const Array &other) const
         requires(IsString)
     {
-        return Compare(other) != 0;
+        return !(*this == other);
     }
 
     // === Trimming ===
@@ -975,22 +943,9 @@ template <typename T, typename AllocState> class Array
     constexpr Array &TrimRight(const T *chars = " \t\n\r")
         requires(IsString)
     {
-        usize i = GetSize();
-        const usize len = usize(std::char_traits<T>::length(chars));
-        while (i > 0)
-        {
-            bool isWhitespace = false;
-            for (usize j = 0; j < len; ++j)
-                if (*(begin() + i - 1) == chars[j])
-                {
-                    isWhitespace = true;
-                    break;
-                }
-            if (!isWhitespace)
-                break;
-            --i;
-        }
-        Resize(i);
+        const usize pos =
+            Container::FindLastNotOf(begin(), GetSize(), chars, usize(std::char_traits<T>::length(chars)));
+        Resize(pos == npos ? 0 : pos + 1);
         return *this;
     }
 
@@ -1150,19 +1105,17 @@ template <typename T, typename AllocState> class Array
         requires(IsString)
     {
         Array<Array, typename AllocState::template Rebind<Array>> parts;
-        if constexpr (Type != Array_Static && Type != Array_Dynamic)
+        if constexpr (Type != Array_Static && Type != Array_Dynamic && Type != Array_Small)
             parts.ResetAllocator(m_State.Allocator);
-        if constexpr (Type != Array_Static)
+        if constexpr (Type != Array_Static && Type != Array_Small)
             parts.Reserve(GetSize() + 1);
         usize start = 0;
-
-        for (usize i = 0; i < GetSize(); ++i)
+        usize pos = Find(delimiter, 0);
+        while (pos != npos)
         {
-            if (*(begin() + i) == delimiter)
-            {
-                parts.Append(SubString(start, i - start));
-                start = i + 1;
-            }
+            parts.Append(SubString(start, pos - start));
+            start = pos + 1;
+            pos = Find(delimiter, start);
         }
         parts.Append(SubString(start, GetSize() - start));
         return parts;
@@ -1173,9 +1126,9 @@ template <typename T, typename AllocState> class Array
     {
         const usize delimLen = usize(std::char_traits<T>::length(delimiter));
         Array<Array, typename AllocState::template Rebind<Array>> parts;
-        if constexpr (Type != Array_Static && Type != Array_Dynamic)
+        if constexpr (Type != Array_Static && Type != Array_Dynamic && Type != Array_Small)
             parts.ResetAllocator(m_State.Allocator);
-        if constexpr (Type != Array_Static)
+        if constexpr (Type != Array_Static && Type != Array_Small)
             parts.Reserve(GetSize());
 
         if (delimLen == 0)
@@ -1304,7 +1257,7 @@ template <typename T, typename AllocState> class Array
 
     template <typename... Args> constexpr Array createWithAllocator(Args &&...args) const
     {
-        if constexpr (Type == Array_Static || Type == Array_Dynamic)
+        if constexpr (Type == Array_Static || Type == Array_Dynamic || Type == Array_Small)
             return Array{std::forward<Args>(args)...};
         else
             return Array{std::forward<Args>(args)..., m_State.Allocator};
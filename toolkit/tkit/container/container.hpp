@@ -99,6 +99,22 @@ template <typename T> struct ArrayTools
             return;
         }
 
+        if constexpr (TriviallyRelocatable<T>)
+        {
+            // The value may live in the shifted range, in which case it ends up one position to the right
+            const T *src = nullptr;
+            if constexpr (std::is_same_v<T, std::remove_cvref_t<U>>)
+                if (const T *ptr = &value; ptr >= pos && ptr < end)
+                    src = ptr + 1;
+
+            BackwardCopy(pos + 1, pos, usz(end - pos) * sizeof(T));
+            if (src)
+                ConstructFromIterator(pos, std::forward<U>(*ccast<T *>(src)));
+            else
+                ConstructFromIterator(pos, std::forward<U>(value));
+            return;
+        }
+
         if constexpr (std::is_same_v<T, std::remove_cvref_t<U>> && std::is_lvalue_reference_v<U>)
         {
             const T *ptr = &value;
@@ -136,6 +152,13 @@ template <typename T> struct ArrayTools
             CopyConstructFromRange(pos, srcBegin, srcEnd);
             return usize(std::distance(srcBegin, srcEnd));
         }
+        if constexpr (TriviallyRelocatable<T>)
+        {
+            const usize count = usize(std::distance(srcBegin, srcEnd));
+            BackwardCopy(pos + count, pos, usz(end - pos) * sizeof(T));
+            CopyConstructFromRange(pos, srcBegin, srcEnd);
+            return count;
+        }
         const usize tail = usize(std::distance(pos, end));
         const usize count = usize(std::distance(srcBegin, srcEnd));
         if (tail > count)
@@ -180,32 +203,59 @@ template <typename T> struct ArrayTools
 
     static constexpr void RemoveOrdered(T *end, T *pos)
     {
-        // Copy/move the elements after the erased one
-        ForwardMove(pos, pos + 1, end);
-        // And destroy the last element
-        if constexpr (!std::is_trivially_destructible_v<T>)
-            DestructFromIterator(end - 1);
+        if constexpr (TriviallyRelocatable<T>)
+        {
+            // Destroy the erased element and slide the rest over its bytes
+            if constexpr (!std::is_trivially_destructible_v<T>)
+                DestructFromIterator(pos);
+            BackwardCopy(pos, pos + 1, usz(end - pos - 1) * sizeof(T));
+        }
+        else
+        {
+            // Copy/move the elements after the erased one
+            ForwardMove(pos, pos + 1, end);
+            // And destroy the last element
+            if constexpr (!std::is_trivially_destructible_v<T>)
+                DestructFromIterator(end - 1);
+        }
     }
 
     static constexpr usize RemoveOrdered(T *end, T *remBegin, T *remEnd)
     {
         TKIT_ASSERT(remBegin <= remEnd, "[TOOLKIT][CONTAINER] Begin iterator is greater than end iterator");
-        // Copy/move the elements after the erased ones
-        ForwardMove(remBegin, remEnd, end);
-
         const usize count = usize(std::distance(remBegin, remEnd));
-        // And destroy the last elements
-        if constexpr (!std::is_trivially_destructible_v<T>)
-            DestructRange(end - count, end);
+        if constexpr (TriviallyRelocatable<T>)
+        {
+            DestructRange(remBegin, remEnd);
+            BackwardCopy(remBegin, remEnd, usz(end - remEnd) * sizeof(T));
+        }
+        else
+        {
+            // Copy/move the elements after the erased ones
+            ForwardMove(remBegin, remEnd, end);
+            // And destroy the last elements
+            if constexpr (!std::is_trivially_destructible_v<T>)
+                DestructRange(end - count, end);
+        }
         return count;
     }
 
     static constexpr void RemoveUnordered(T *end, T *pos)
     {
         T *last = end - 1;
-        *pos = std::move(*last);
-        if constexpr (!std::is_trivially_destructible_v<T>)
-            DestructFromIterator(last);
+        if constexpr (TriviallyRelocatable<T>)
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>)
+                DestructFromIterator(pos);
+            if (pos != last)
+                ForwardCopy(scast<void *>(pos), scast<const void *>(last), sizeof(T));
+        }
+        else
+        {
+            *pos = std::move(*last);
+            if constexpr (!std::is_trivially_destructible_v<T>)
+                DestructFromIterator(last);
+        }
     }
 };
 
@@ -0,0 +1,564 @@
+#pragma once
+
+#include "tkit/container/arena_array.hpp"
+#include "tkit/container/dynamic_array.hpp"
+#include "tkit/container/stack_array.hpp"
+#include "tkit/container/static_array.hpp"
+#include "tkit/container/tier_array.hpp"
+#include "tkit/container/span.hpp"
+#include "tkit/utils/bit.hpp"
+#include <iterator>
+
+namespace TKit
+{
+/**
+ * @brief A double ended queue stored as a ring buffer over a single contiguous allocation.
+ *
+ * Elements can be pushed and popped from both ends in constant time. The capacity is always a power of two, so that
+ * wrapping an index around the buffer is a single mask operation. Because the buffer wraps around, its elements are
+ * split in at most two contiguous spans, which can be accessed through `GetFirstSpan()` and `GetSecondSpan()` for bulk
+ * copies.
+ *
+ * Dynamic and tier deques grow on demand, doubling their capacity. Arena and stack deques allocate once, rounding the
+ * requested capacity up to the next power of two. Static deques must have a power of two capacity.
+ *
+ * @tparam T The type of the elements.
+ * @tparam AllocState The allocation state of the underlying buffer. Small allocations are not supported.
+ */
+template <typename T, typename AllocState> class Deque
+{
+  public:
+    static constexpr ArrayType Type = AllocState::Type;
+    using ValueType = T;
+
+    static_assert(Type != Array_Small, "[TOOLKIT][DEQUE] Small allocations are not supported by deques");
+    static_assert(Type != Array_Static || IsPowerOfTwo(AllocState{}.GetCapacity()),
+                  "[TOOLKIT][DEQUE] Static deques must have a power of two capacity");
+
+    template <typename Pointer, typename Reference> class Iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Pointer;
+        using reference = Reference;
+
+        constexpr Iterator() = default;
+        constexpr Iterator(const Pointer data, const usize mask, const usize index)
+            : m_Data(data), m_Mask(mask), m_Index(index)
+        {
+        }
+
+        constexpr Reference operator*() const
+        {
+            return m_Data[m_Index & m_Mask];
+        }
+        constexpr Pointer operator->() const
+        {
+            return &m_Data[m_Index & m_Mask];
+        }
+
+        constexpr Iterator &operator++()
+        {
+            ++m_Index;
+            return *this;
+        }
+        constexpr Iterator operator++(int)
+        {
+            const Iterator it = *this;
+            ++m_Index;
+            return it;
+        }
+
+        constexpr bool operator==(const Iterator &other) const
+        {
+            return m_Index == other.m_Index;
+        }
+
+      private:
+        Pointer m_Data = nullptr;
+        usize m_Mask = 0;
+        usize m_Index = 0;
+    };
+
+    constexpr Deque() = default;
+    constexpr explicit Deque(AllocState &&state) : m_State(std::move(state))
+    {
+        TKIT_ASSERT(m_State.Size == 0, "[TOOLKIT][DEQUE] The allocation state of a deque must not hold any elements");
+        TKIT_ASSERT(m_State.GetCapacity() == 0 || IsPowerOfTwo(m_State.GetCapacity()),
+                    "[TOOLKIT][DEQUE] The capacity of a deque must be a power of two, but it is {}",
+                    m_State.GetCapacity());
+    }
+
+    /**
+     * @brief Construct a deque with room for at least `capacity` elements.
+     *
+     * @param capacity The minimum capacity of the deque. It is rounded up to the next power of two.
+     * @param args The arguments to pass to the constructor of the allocation state.
+     */
+    template <typename... Args>
+        requires(Type != Array_Static)
+    constexpr explicit Deque(const usize capacity, Args &&...args) : m_State(std::forward<Args>(args)...)
+    {
+        Reserve(capacity);
+    }
+
+    constexpr Deque(const Deque &other)
+    {
+        if constexpr (Type == Array_Arena || Type == Array_Stack || Type == Array_Tier)
+            m_State.Allocator = other.m_State.Allocator;
+        if constexpr (Type == Array_Arena || Type == Array_Stack)
+            m_State.Allocate(other.GetCapacity());
+        else if constexpr (Type != Array_Static)
+            m_State.Allocate(other.m_Size == 0 ? 0 : NextPowerOfTwo(other.m_Size));
+        copyFrom(other);
+    }
+
+    constexpr Deque(Deque &&other) : m_Size(other.m_Size)
+    {
+        if constexpr (Type == Array_Static)
+        {
+            ConstructRangeMove(getData(), other.begin(), other.end());
+            other.Clear();
+        }
+        else
+        {
+            m_State = std::move(other.m_State);
+            m_Head = other.m_Head;
+            other.m_Head = 0;
+            other.m_Size = 0;
+        }
+    }
+
+    ~Deque()
+    {
+        Clear();
+        if constexpr (Type == Array_Dynamic || Type == Array_Stack || Type == Array_Tier)
+            m_State.Deallocate();
+    }
+
+    constexpr Deque &operator=(const Deque &other)
+    {
+        if (this == &other)
+            return *this;
+
+        Clear();
+        if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+        {
+            if (other.m_Size > GetCapacity())
+            {
+                m_State.Deallocate();
+                m_State.Allocate(NextPowerOfTwo(other.m_Size));
+            }
+        }
+        else if constexpr (Type == Array_Arena || Type == Array_Stack)
+        {
+            if (!m_State.Data)
+            {
+                if (!m_State.Allocator)
+                    m_State.Allocator = other.m_State.Allocator;
+                m_State.Allocate(other.GetCapacity());
+            }
+        }
+        copyFrom(other);
+        return *this;
+    }
+
+    constexpr Deque &operator=(Deque &&other)
+    {
+        if (this == &other)
+            return *this;
+
+        Clear();
+        if constexpr (Type == Array_Static)
+        {
+            m_Size = other.m_Size;
+            ConstructRangeMove(getData(), other.begin(), other.end());
+            other.Clear();
+        }
+        else
+        {
+            if constexpr (Type != Array_Arena)
+                m_State.Deallocate();
+            m_State = std::move(other.m_State);
+            m_Head = other.m_Head;
+            m_Size = other.m_Size;
+            other.m_Head = 0;
+            other.m_Size = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Construct a new element at the back of the deque.
+     *
+     * @param args The arguments to pass to the constructor of `T`.
+     * @return A reference to the new element.
+     */
+    template <typename... Args>
+        requires std::constructible_from<T, Args...>
+    constexpr T &PushBack(Args &&...args)
+    {
+        if (IsFull())
+        {
+            if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+                return growAndConstruct<false>(std::forward<Args>(args)...);
+            else
+            {
+                TKIT_ASSERT(false, "[TOOLKIT][DEQUE] Cannot PushBack(). Container is already at capacity of {}",
+                            GetCapacity());
+            }
+        }
+        T *element = ConstructFromIterator(getData() + ((m_Head + m_Size) & getMask()), std::forward<Args>(args)...);
+        ++m_Size;
+        return *element;
+    }
+
+    /**
+     * @brief Construct a new element at the front of the deque.
+     *
+     * @param args The arguments to pass to the constructor of `T`.
+     * @return A reference to the new element.
+     */
+    template <typename... Args>
+        requires std::constructible_from<T, Args...>
+    constexpr T &PushFront(Args &&...args)
+    {
+        if (IsFull())
+        {
+            if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+                return growAndConstruct<true>(std::forward<Args>(args)...);
+            else
+            {
+                TKIT_ASSERT(false, "[TOOLKIT][DEQUE] Cannot PushFront(). Container is already at capacity of {}",
+                            GetCapacity());
+            }
+        }
+        const usize head = (m_Head - 1) & getMask();
+        T *element = ConstructFromIterator(getData() + head, std::forward<Args>(args)...);
+        m_Head = head;
+        ++m_Size;
+        return *element;
+    }
+
+    /**
+     * @brief Copy a range of elements to the back of the deque.
+     *
+     * The elements are copied in at most two contiguous blocks, one for each side of the wrap point.
+     *
+     * @param elements The elements to copy.
+     */
+    constexpr void PushBackRange(const Span<const T> elements)
+    {
+        const usize count = elements.GetSize();
+        const usize size = m_Size + count;
+        if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+        {
+            if (size > GetCapacity())
+                reallocate(NextPowerOfTwo(Container::GrowthFactor(size)));
+        }
+        else
+        {
+            TKIT_ASSERT(size <= GetCapacity(),
+                        "[TOOLKIT][DEQUE] Cannot PushBackRange(). Size ({}) would exceed capacity ({})", size,
+                        GetCapacity());
+        }
+        if (count == 0)
+            return;
+
+        T *data = getData();
+        const usize tail = (m_Head + m_Size) & getMask();
+        const usize first = std::min(count, GetCapacity() - tail);
+        ConstructRangeCopy(data + tail, elements.begin(), elements.begin() + first);
+        ConstructRangeCopy(data, elements.begin() + first, elements.end());
+        m_Size = size;
+    }
+
+    constexpr void PopBack()
+    {
+        TKIT_ASSERT(!IsEmpty(), "[TOOLKIT][DEQUE] Cannot PopBack(). Container is already empty");
+        --m_Size;
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            DestructFromIterator(getData() + ((m_Head + m_Size) & getMask()));
+    }
+    constexpr void PopFront()
+    {
+        TKIT_ASSERT(!IsEmpty(), "[TOOLKIT][DEQUE] Cannot PopFront(). Container is already empty");
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            DestructFromIterator(getData() + m_Head);
+        m_Head = (m_Head + 1) & getMask();
+        --m_Size;
+    }
+
+    /**
+     * @brief Remove the first `count` elements of the deque.
+     *
+     * Meant to be used after consuming the front of the deque through `GetFirstSpan()` and `GetSecondSpan()`.
+     *
+     * @param count The amount of elements to remove.
+     */
+    constexpr void PopFrontRange(const usize count)
+    {
+        TKIT_ASSERT(count <= m_Size, "[TOOLKIT][DEQUE] Cannot pop {} elements from a deque of size {}", count, m_Size);
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            T *data = getData();
+            const usize first = std::min(count, GetCapacity() - m_Head);
+            DestructRange(data + m_Head, data + m_Head + first);
+            DestructRange(data, data + count - first);
+        }
+        m_Head = (m_Head + count) & getMask();
+        m_Size -= count;
+    }
+
+    constexpr const T &At(const usize index) const
+    {
+        TKIT_ASSERT(index < m_Size, "[TOOLKIT][DEQUE] Index is out of bounds: {} >= {}", index, m_Size);
+        return getData()[(m_Head + index) & getMask()];
+    }
+    constexpr T &At(const usize index)
+    {
+        TKIT_ASSERT(index < m_Size, "[TOOLKIT][DEQUE] Index is out of bounds: {} >= {}", index, m_Size);
+        return getData()[(m_Head + index) & getMask()];
+    }
+
+    constexpr const T &operator[](const usize index) const
+    {
+        return At(index);
+    }
+    constexpr T &operator[](const usize index)
+    {
+        return At(index);
+    }
+
+    constexpr const T &GetFront() const
+    {
+        return At(0);
+    }
+    constexpr T &GetFront()
+    {
+        return At(0);
+    }
+
+    constexpr const T &GetBack() const
+    {
+        return At(m_Size - 1);
+    }
+    constexpr T &GetBack()
+    {
+        return At(m_Size - 1);
+    }
+
+    /**
+     * @brief Get the elements that go from the front of the deque to the end of the buffer, or to the back of the deque
+     * if it does not wrap around.
+     */
+    constexpr Span<const T> GetFirstSpan() const
+    {
+        return Span<const T>{getData() + m_Head, getFirstSize()};
+    }
+    constexpr Span<T> GetFirstSpan()
+    {
+        return Span<T>{getData() + m_Head, getFirstSize()};
+    }
+
+    /**
+     * @brief Get the elements that wrapped around to the beginning of the buffer. Empty if the deque does not wrap
+     * around.
+     */
+    constexpr Span<const T> GetSecondSpan() const
+    {
+        return Span<const T>{getData(), m_Size - getFirstSize()};
+    }
+    constexpr Span<T> GetSecondSpan()
+    {
+        return Span<T>{getData(), m_Size - getFirstSize()};
+    }
+
+    constexpr void Clear()
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            if (m_Size != 0)
+            {
+                T *data = getData();
+                const usize first = getFirstSize();
+                DestructRange(data + m_Head, data + m_Head + first);
+                DestructRange(data, data + m_Size - first);
+            }
+        m_Head = 0;
+        m_Size = 0;
+    }
+
+    /**
+     * @brief Make sure the deque can hold at least `capacity` elements.
+     *
+     * Arena and stack deques can only reserve once, as they cannot grow.
+     *
+     * @param capacity The minimum capacity of the deque. It is rounded up to the next power of two.
+     */
+    constexpr void Reserve(const usize capacity)
+        requires(Type != Array_Static)
+    {
+        if (capacity <= GetCapacity())
+            return;
+        if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+            reallocate(NextPowerOfTwo(capacity));
+        else
+        {
+            TKIT_ASSERT(!m_State.Data, "[TOOLKIT][DEQUE] Arena and stack deques cannot grow past their capacity ({})",
+                        GetCapacity());
+            m_State.Allocate(NextPowerOfTwo(capacity));
+        }
+    }
+
+    constexpr auto begin()
+    {
+        return Iterator<T *, T &>{getData(), getMask(), m_Head};
+    }
+    constexpr auto end()
+    {
+        return Iterator<T *, T &>{getData(), getMask(), m_Head + m_Size};
+    }
+
+    constexpr auto begin() const
+    {
+        return Iterator<const T *, const T &>{getData(), getMask(), m_Head};
+    }
+    constexpr auto end() const
+    {
+        return Iterator<const T *, const T &>{getData(), getMask(), m_Head + m_Size};
+    }
+
+    constexpr usize GetSize() const
+    {
+        return m_Size;
+    }
+    constexpr usize GetCapacity() const
+    {
+        return m_State.GetCapacity();
+    }
+    constexpr usz GetBytes() const
+    {
+        return m_Size * sizeof(T);
+    }
+
+    constexpr bool IsEmpty() const
+    {
+        return m_Size == 0;
+    }
+    constexpr bool IsFull() const
+    {
+        return m_Size == GetCapacity();
+    }
+
+  private:
+    constexpr const T *getData() const
+    {
+        if constexpr (Type == Array_Static)
+            return rcast<const T *>(m_State.Data.GetData());
+        else
+            return m_State.Data;
+    }
+    constexpr T *getData()
+    {
+        if constexpr (Type == Array_Static)
+            return rcast<T *>(m_State.Data.GetData());
+        else
+            return m_State.Data;
+    }
+    constexpr usize getMask() const
+    {
+        return GetCapacity() - 1;
+    }
+    constexpr usize getFirstSize() const
+    {
+        return std::min(m_Size, GetCapacity() - m_Head);
+    }
+
+    // Leaves the elements in the same order, starting at index 0 of `dst`
+    constexpr void relocateTo(T *dst)
+    {
+        T *data = getData();
+        const usize first = getFirstSize();
+        RelocateRange(dst, data + m_Head, data + m_Head + first);
+        RelocateRange(dst + first, data, data + m_Size - first);
+    }
+
+    constexpr AllocState createState() const
+    {
+        if constexpr (Type == Array_Tier)
+            return AllocState{m_State.Allocator};
+        else
+            return AllocState{};
+    }
+
+    constexpr void reallocate(const usize capacity)
+    {
+        AllocState state = createState();
+        state.Allocate(capacity);
+        relocateTo(state.Data);
+        m_State.Deallocate();
+        m_State = std::move(state);
+        m_Head = 0;
+    }
+
+    // The new element is constructed before the old buffer is released, as the arguments may reference one of its
+    // elements
+    template <bool Front, typename... Args> constexpr T &growAndConstruct(Args &&...args)
+    {
+        const usize capacity = NextPowerOfTwo(Container::GrowthFactor(m_Size));
+        AllocState state = createState();
+        state.Allocate(capacity);
+
+        const usize index = Front ? capacity - 1 : m_Size;
+        T *element = ConstructFromIterator(state.Data + index, std::forward<Args>(args)...);
+        relocateTo(state.Data);
+        m_State.Deallocate();
+        m_State = std::move(state);
+        m_Head = Front ? index : 0;
+        ++m_Size;
+        return *element;
+    }
+
+    constexpr void copyFrom(const Deque &other)
+    {
+        TKIT_ASSERT(other.m_Size <= GetCapacity(), "[TOOLKIT][DEQUE] Size ({}) is bigger than capacity ({})",
+                    other.m_Size, GetCapacity());
+        const Span<const T> first = other.GetFirstSpan();
+        const Span<const T> second = other.GetSecondSpan();
+        T *data = getData();
+        ConstructRangeCopy(data, first.begin(), first.end());
+        ConstructRangeCopy(data + first.GetSize(), second.begin(), second.end());
+        m_Head = 0;
+        m_Size = other.m_Size;
+    }
+
+    AllocState m_State{};
+    usize m_Head = 0;
+    usize m_Size = 0;
+};
+
+template <typename T> using ArenaDeque = Deque<T, ArenaAllocation<T>>;
+template <typename T> using DynamicDeque = Deque<T, DynamicAllocation<T>>;
+template <typename T> using StackDeque = Deque<T, StackAllocation<T>>;
+template <typename T> using TierDeque = Deque<T, TierAllocation<T>>;
+
+template <typename T, usize Capacity> using StaticDeque = Deque<T, StaticAllocation<T, Capacity>>;
+template <typename T> using StaticDeque4 = StaticDeque<T, 4>;
+template <typename T> using StaticDeque8 = StaticDeque<T, 8>;
+template <typename T> using StaticDeque16 = StaticDeque<T, 16>;
+template <typename T> using StaticDeque32 = StaticDeque<T, 32>;
+template <typename T> using StaticDeque64 = StaticDeque<T, 64>;
+template <typename T> using StaticDeque128 = StaticDeque<T, 128>;
+template <typename T> using StaticDeque256 = StaticDeque<T, 256>;
+template <typename T> using StaticDeque512 = StaticDeque<T, 512>;
+template <typename T> using StaticDeque1024 = StaticDeque<T, 1024>;
+
+// Queues are deques that are only pushed to the back and popped from the front
+template <typename T> using ArenaQueue = ArenaDeque<T>;
+template <typename T> using DynamicQueue = DynamicDeque<T>;
+template <typename T> using StackQueue = StackDeque<T>;
+template <typename T> using TierQueue = TierDeque<T>;
+template <typename T, usize Capacity> using StaticQueue = StaticDeque<T, Capacity>;
+} // namespace TKit
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "tkit/container/array.hpp"
+#include "tkit/utils/limits.hpp"
 
 namespace TKit
 {
@@ -48,7 +49,7 @@ template <typename T> struct DynamicAllocation
                     "cannot exist if capacity is 0. Capacity: {}",
                     Capacity);
 
-        Data = scast<T *>(AllocateAligned(capacity * sizeof(T), alignof(T)));
+        Data = allocateBuffer(capacity);
         TKIT_ASSERT(Data, "[TOOLKIT][DYN-ARRAY] Failed to allocate {:L} bytes of memory aligned to {:L} bytes",
                     capacity * sizeof(T), alignof(T));
         Capacity = capacity;
@@ -61,7 +62,7 @@ template <typename T> struct DynamicAllocation
         {
             TKIT_ASSERT(Capacity != 0,
                         "[TOOLKIT][DYN-ARRAY] Capacity cannot be zero if buffer is about to be deallocated");
-            DeallocateAligned(Data);
+            deallocateBuffer(Data, Capacity);
             Data = nullptr;
             Capacity = 0;
         }
@@ -78,19 +79,27 @@ template <typename T> struct DynamicAllocation
     }
     void ModifyCapacity(const usize capacity)
     {
-        using Tools = Container::ArrayTools<T>;
         TKIT_ASSERT(capacity != 0, "[TOOLKIT][DYN-ARRAY] Capacity must be greater than 0");
         TKIT_ASSERT(capacity >= Size, "[TOOLKIT][DYN-ARRAY] Capacity ({}) is smaller than size ({})", capacity, Size);
-        T *newData = scast<T *>(AllocateAligned(capacity * sizeof(T), alignof(T)));
+        if constexpr (TriviallyRelocatable<T>)
+            if (Data && isPaged(Capacity) && isPaged(capacity))
+            {
+                T *newData = scast<T *>(ReallocatePages(Data, Capacity * sizeof(T), capacity * sizeof(T)));
+                TKIT_ASSERT(newData, "[TOOLKIT][DYN-ARRAY] Failed to reallocate {:L} bytes of memory",
+                            capacity * sizeof(T));
+                Data = newData;
+                Capacity = capacity;
+                return;
+            }
+
+        T *newData = allocateBuffer(capacity);
         TKIT_ASSERT(newData, "[TOOLKIT][DYN-ARRAY] Failed to allocate {:L} bytes of memory aligned to {:L} bytes",
                     capacity * sizeof(T), alignof(T));
 
         if (Data)
         {
-            Tools::MoveConstructFromRange(newData, Data, Data + Size);
-            if constexpr (!std::is_trivially_destructible_v<T>)
-                DestructRange(Data, Data + Size);
-            DeallocateAligned(Data);
+            RelocateRange(newData, Data, Data + Size);
+            deallocateBuffer(Data, Capacity);
         }
         Data = newData;
         Capacity = capacity;
@@ -104,7 +113,33 @@ template <typename T> struct DynamicAllocation
     T *Data = nullptr;
     usize Size = 0;
     usize Capacity = 0;
+
+  private:
+    // Big buffers are requested directly from the OS so that trivially relocatable arrays can grow with `mremap()` (or
+    // equivalent) instead of copying their contents. Whether a buffer is paged only depends on its capacity
+    static constexpr bool isPaged(const usize capacity)
+    {
+        return alignof(T) <= 4096 && capacity * sizeof(T) >= PageAllocationThreshold;
+    }
+    static T *allocateBuffer(const usize capacity)
+    {
+        if (isPaged(capacity))
+            return scast<T *>(AllocatePages(capacity * sizeof(T)));
+        return scast<T *>(AllocateAligned(capacity * sizeof(T), alignof(T)));
+    }
+    static void deallocateBuffer(T *data, const usize capacity)
+    {
+        if (isPaged(capacity))
+            DeallocatePages(data, capacity * sizeof(T));
+        else
+            DeallocateAligned(data);
+    }
 };
 template <typename T> using DynamicArray = Array<T, DynamicAllocation<T>>;
 using DynamicString = Array<char, DynamicAllocation<char>>;
+
+// The array only holds a pointer to its buffer, so it can be relocated with its elements in place
+template <typename T> struct IsTriviallyRelocatable<Array<T, DynamicAllocation<T>>> : std::true_type
+{
+};
 } // namespace TKit
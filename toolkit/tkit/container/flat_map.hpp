@@ -0,0 +1,571 @@
+#pragma once
+
+#include "tkit/container/arena_array.hpp"
+#include "tkit/container/dynamic_array.hpp"
+#include "tkit/container/stack_array.hpp"
+#include "tkit/container/static_array.hpp"
+#include "tkit/container/tier_array.hpp"
+#include "tkit/container/flat_search.hpp"
+#include "tkit/container/hash_map.hpp"
+#include "tkit/container/span.hpp"
+#include <algorithm>
+#include <ranges>
+
+namespace TKit
+{
+/**
+ * @brief A map that keeps its keys sorted in one array and its values in another, so that the value of the key at
+ * index `i` is the value at index `i`.
+ *
+ * Lookups are branchless binary searches over the keys alone, which pack far more keys in a cache line than an array
+ * of pairs would, and iteration visits the entries in key order. The map takes no more memory than its keys and values
+ * themselves, which makes it a better fit than `HashMap` for small or read-mostly tables. Insertions and removals are
+ * linear in the size of the map, so maps should be built in bulk with `InsertBulk()` whenever possible.
+ *
+ * The allocation state is given for the keys, and is rebound to `V` for the values.
+ *
+ * When `Less` is transparent, `Find()`, `Contains()`, `At()`, `LowerBound()`, `UpperBound()`, `GetRange()` and
+ * `Remove()` also accept any type it can be invoked with, such as a `std::string_view` or a `const char *` for string
+ * keys.
+ */
+template <typename K, typename V, typename AllocState, typename Less = DefaultLess<K>> class FlatMap
+{
+  public:
+    static constexpr ArrayType Type = AllocState::Type;
+    using KeyType = K;
+    using ValueType = V;
+    using ValueState = typename AllocState::template Rebind<V>;
+    using Pair = KeyValuePair<K, V>;
+
+    template <typename Q>
+    static constexpr bool IsLookupKey = TransparentComparator<Less> &&
+                                        std::predicate<const Less &, const Q &, const K &> &&
+                                        std::predicate<const Less &, const K &, const Q &>;
+
+    template <typename T> struct EntryImpl
+    {
+        const K &Key;
+        T &Value;
+    };
+    using Entry = EntryImpl<V>;
+    using ConstEntry = EntryImpl<const V>;
+
+    /**
+     * @brief The keys and values of a contiguous run of entries.
+     */
+    template <typename T> struct RangeImpl
+    {
+        Span<const K> Keys;
+        Span<T> Values;
+    };
+    using Range = RangeImpl<V>;
+    using ConstRange = RangeImpl<const V>;
+
+    template <typename T> class IteratorImpl
+    {
+      public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = EntryImpl<T>;
+        using difference_type = std::ptrdiff_t;
+        using reference = EntryImpl<T>;
+
+        struct Arrow
+        {
+            EntryImpl<T> Entry;
+            constexpr const EntryImpl<T> *operator->() const
+            {
+                return &Entry;
+            }
+        };
+
+        constexpr IteratorImpl() = default;
+        constexpr IteratorImpl(const K *keys, T *values, const usize idx)
+            : m_Keys(keys), m_Values(values), m_Index(idx)
+        {
+        }
+        constexpr IteratorImpl(const IteratorImpl<std::remove_const_t<T>> &it)
+            requires(std::is_const_v<T>)
+            : m_Keys(it.m_Keys), m_Values(it.m_Values), m_Index(it.m_Index)
+        {
+        }
+
+        constexpr EntryImpl<T> operator*() const
+        {
+            return EntryImpl<T>{m_Keys[m_Index], m_Values[m_Index]};
+        }
+        constexpr Arrow operator->() const
+        {
+            return Arrow{**this};
+        }
+
+        constexpr IteratorImpl &operator++()
+        {
+            ++m_Index;
+            return *this;
+        }
+        constexpr IteratorImpl operator++(int)
+        {
+            const IteratorImpl cpy = *this;
+            ++m_Index;
+            return cpy;
+        }
+        constexpr IteratorImpl &operator--()
+        {
+            --m_Index;
+            return *this;
+        }
+        constexpr IteratorImpl operator--(int)
+        {
+            const IteratorImpl cpy = *this;
+            --m_Index;
+            return cpy;
+        }
+
+        constexpr bool operator==(const IteratorImpl &other) const
+        {
+            return m_Index == other.m_Index && m_Keys == other.m_Keys;
+        }
+
+        constexpr usize GetIndex() const
+        {
+            return m_Index;
+        }
+
+      private:
+        const K *m_Keys = nullptr;
+        T *m_Values = nullptr;
+        usize m_Index = 0;
+
+        template <typename U> friend class IteratorImpl;
+    };
+
+    using Iterator = IteratorImpl<V>;
+    using ConstIterator = IteratorImpl<const V>;
+
+    constexpr FlatMap() = default;
+    constexpr FlatMap(AllocState &&keys, ValueState &&values) : m_Keys(std::move(keys)), m_Values(std::move(values))
+    {
+    }
+    constexpr FlatMap(AllocState &&keys, ValueState &&values, const Less &less)
+        : m_Keys(std::move(keys)), m_Values(std::move(values)), m_Less(less)
+    {
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> S> constexpr FlatMap(const It pbegin, const S pend)
+    {
+        InsertBulk(pbegin, pend);
+    }
+    constexpr FlatMap(const std::initializer_list<Pair> list)
+    {
+        InsertBulk(list.begin(), list.end());
+    }
+
+    template <typename... Args>
+        requires std::constructible_from<V, Args...>
+    constexpr V &Insert(const K &key, Args &&...args)
+    {
+        const usize idx = lowerBound(key);
+        TKIT_ASSERT(idx == m_Keys.GetSize() || m_Less(key, m_Keys[idx]),
+                    "[TOOLKIT][FLAT-MAP] Cannot insert a key that is already in the map");
+        return insert(idx, key, std::forward<Args>(args)...);
+    }
+    constexpr V &Insert(const Pair &pair)
+    {
+        return Insert(pair.Key, pair.Value);
+    }
+
+    template <typename... Args>
+        requires std::constructible_from<V, Args...>
+    constexpr V &TryInsert(bool *didExist, const K &key, Args &&...args)
+    {
+        const usize idx = lowerBound(key);
+        const bool exists = idx != m_Keys.GetSize() && !m_Less(key, m_Keys[idx]);
+        if (didExist)
+            *didExist = exists;
+
+        if (exists)
+            return m_Values[idx];
+        return insert(idx, key, std::forward<Args>(args)...);
+    }
+    template <typename... Args>
+        requires std::constructible_from<V, Args...>
+    constexpr V &TryInsert(const K &key, Args &&...args)
+    {
+        return TryInsert(nullptr, key, std::forward<Args>(args)...);
+    }
+    constexpr V &TryInsert(const Pair &pair, bool *didExist = nullptr)
+    {
+        return TryInsert(didExist, pair.Key, pair.Value);
+    }
+
+    /**
+     * @brief Insert a range of key-value pairs in any order.
+     *
+     * The pairs are appended and all entries are sorted once by key. If a key is already in the map or appears more
+     * than once in the range, its first value is kept.
+     */
+    template <std::input_iterator It, std::sentinel_for<It> S> constexpr void InsertBulk(const It pbegin, const S pend)
+    {
+        const usize size = m_Keys.GetSize();
+        if constexpr ((Type == Array_Dynamic || Type == Array_Tier) && std::forward_iterator<It>)
+            Reserve(size + usize(std::ranges::distance(pbegin, pend)));
+        for (It it = pbegin; it != pend; ++it)
+        {
+            const Pair &pair = *it;
+            m_Keys.Append(pair.Key);
+            m_Values.Append(pair.Value);
+        }
+        sortUnique(size);
+    }
+    template <std::ranges::input_range R> constexpr void InsertBulk(R &&range)
+    {
+        InsertBulk(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    /**
+     * @brief Insert keys and values given as separate arrays in any order, as if by calling `InsertBulk()` with the
+     * pairs they form.
+     */
+    constexpr void InsertBulk(const Span<const K> keys, const Span<const V> values)
+    {
+        TKIT_ASSERT(keys.GetSize() == values.GetSize(),
+                    "[TOOLKIT][FLAT-MAP] Key count ({}) and value count ({}) must match", keys.GetSize(),
+                    values.GetSize());
+        const usize size = m_Keys.GetSize();
+        if constexpr (Type == Array_Dynamic || Type == Array_Tier)
+            Reserve(size + keys.GetSize());
+        m_Keys.Insert(m_Keys.end(), keys.begin(), keys.end());
+        m_Values.Insert(m_Values.end(), values.begin(), values.end());
+        sortUnique(size);
+    }
+
+    constexpr ConstIterator Find(const K &key) const
+    {
+        return iterator(find(key));
+    }
+    constexpr Iterator Find(const K &key)
+    {
+        return iterator(find(key));
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr ConstIterator Find(const Q &key) const
+    {
+        return iterator(find(key));
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr Iterator Find(const Q &key)
+    {
+        return iterator(find(key));
+    }
+
+    constexpr bool Contains(const K &key) const
+    {
+        return find(key) != m_Keys.GetSize();
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr bool Contains(const Q &key) const
+    {
+        return find(key) != m_Keys.GetSize();
+    }
+
+    constexpr const V &At(const K &key) const
+    {
+        return m_Values[findExisting(key)];
+    }
+    constexpr V &At(const K &key)
+    {
+        return m_Values[findExisting(key)];
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr const V &At(const Q &key) const
+    {
+        return m_Values[findExisting(key)];
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr V &At(const Q &key)
+    {
+        return m_Values[findExisting(key)];
+    }
+
+    constexpr const V &operator[](const K &key) const
+    {
+        return At(key);
+    }
+    constexpr V &operator[](const K &key)
+    {
+        return TryInsert(key);
+    }
+
+    /**
+     * @brief Get an iterator to the first entry whose key is not less than `key`.
+     */
+    constexpr ConstIterator LowerBound(const K &key) const
+    {
+        return iterator(lowerBound(key));
+    }
+    constexpr Iterator LowerBound(const K &key)
+    {
+        return iterator(lowerBound(key));
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr ConstIterator LowerBound(const Q &key) const
+    {
+        return iterator(lowerBound(key));
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr Iterator LowerBound(const Q &key)
+    {
+        return iterator(lowerBound(key));
+    }
+
+    /**
+     * @brief Get an iterator to the first entry whose key is greater than `key`.
+     */
+    constexpr ConstIterator UpperBound(const K &key) const
+    {
+        return iterator(upperBound(key));
+    }
+    constexpr Iterator UpperBound(const K &key)
+    {
+        return iterator(upperBound(key));
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr ConstIterator UpperBound(const Q &key) const
+    {
+        return iterator(upperBound(key));
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr Iterator UpperBound(const Q &key)
+    {
+        return iterator(upperBound(key));
+    }
+
+    /**
+     * @brief Get the entries whose keys fall in the half open range `[low, high)`, in order.
+     */
+    constexpr ConstRange GetRange(const K &low, const K &high) const
+    {
+        return getRange(*this, low, high);
+    }
+    constexpr Range GetRange(const K &low, const K &high)
+    {
+        return getRange(*this, low, high);
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr ConstRange GetRange(const Q &low, const Q &high) const
+    {
+        return getRange(*this, low, high);
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr Range GetRange(const Q &low, const Q &high)
+    {
+        return getRange(*this, low, high);
+    }
+
+    constexpr Iterator Remove(const Iterator iter)
+    {
+        const usize idx = iter.GetIndex();
+        TKIT_ASSERT(idx < m_Keys.GetSize(), "[TOOLKIT][FLAT-MAP] Iterator is out of bounds");
+        erase(idx);
+        return iterator(idx);
+    }
+    constexpr bool Remove(const K &key)
+    {
+        return remove(key);
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr bool Remove(const Q &key)
+    {
+        return remove(key);
+    }
+
+    constexpr void Clear()
+    {
+        m_Keys.Clear();
+        m_Values.Clear();
+    }
+    constexpr void Reserve(const usize capacity)
+        requires(Type != Array_Static)
+    {
+        m_Keys.Reserve(capacity);
+        m_Values.Reserve(capacity);
+    }
+
+    constexpr Span<const K> GetKeys() const
+    {
+        return Span<const K>{m_Keys.GetData(), m_Keys.GetSize()};
+    }
+    constexpr Span<const V> GetValues() const
+    {
+        return Span<const V>{m_Values.GetData(), m_Values.GetSize()};
+    }
+    constexpr Span<V> GetValues()
+    {
+        return Span<V>{m_Values.GetData(), m_Values.GetSize()};
+    }
+
+    constexpr ConstIterator begin() const
+    {
+        return iterator(0);
+    }
+    constexpr ConstIterator end() const
+    {
+        return iterator(m_Keys.GetSize());
+    }
+    constexpr Iterator begin()
+    {
+        return iterator(0);
+    }
+    constexpr Iterator end()
+    {
+        return iterator(m_Keys.GetSize());
+    }
+
+    constexpr usize GetSize() const
+    {
+        return m_Keys.GetSize();
+    }
+    constexpr usize GetCapacity() const
+    {
+        return m_Keys.GetCapacity();
+    }
+    constexpr bool IsEmpty() const
+    {
+        return m_Keys.IsEmpty();
+    }
+    constexpr const Less &GetLess() const
+    {
+        return m_Less;
+    }
+
+  private:
+    constexpr ConstIterator iterator(const usize idx) const
+    {
+        return ConstIterator{m_Keys.GetData(), m_Values.GetData(), idx};
+    }
+    constexpr Iterator iterator(const usize idx)
+    {
+        return Iterator{m_Keys.GetData(), m_Values.GetData(), idx};
+    }
+
+    template <typename Q> constexpr usize lowerBound(const Q &key) const
+    {
+        return Container::LowerBound(m_Keys.GetData(), m_Keys.GetSize(), key, m_Less);
+    }
+    template <typename Q> constexpr usize upperBound(const Q &key) const
+    {
+        return Container::UpperBound(m_Keys.GetData(), m_Keys.GetSize(), key, m_Less);
+    }
+    // Returns the size of the map if the key is not found, so that it maps to `end()`
+    template <typename Q> constexpr usize find(const Q &key) const
+    {
+        const usize idx = lowerBound(key);
+        return idx != m_Keys.GetSize() && !m_Less(key, m_Keys[idx]) ? idx : m_Keys.GetSize();
+    }
+    template <typename Q> constexpr usize findExisting(const Q &key) const
+    {
+        const usize idx = find(key);
+        TKIT_ASSERT(idx != m_Keys.GetSize(), "[TOOLKIT][FLAT-MAP] Key not found");
+        return idx;
+    }
+
+    template <typename Self, typename Q> static constexpr auto getRange(Self &self, const Q &low, const Q &high)
+    {
+        const usize first = self.lowerBound(low);
+        const usize last = std::max(first, self.lowerBound(high));
+        using Value = std::conditional_t<std::is_const_v<Self>, const V, V>;
+        return RangeImpl<Value>{Span<const K>{self.m_Keys.GetData() + first, last - first},
+                                Span<Value>{self.m_Values.GetData() + first, last - first}};
+    }
+
+    template <typename... Args> constexpr V &insert(const usize idx, const K &key, Args &&...args)
+    {
+        m_Keys.Insert(m_Keys.begin() + idx, key);
+        return m_Values.Insert(m_Values.begin() + idx, V(std::forward<Args>(args)...));
+    }
+    constexpr void erase(const usize idx)
+    {
+        m_Keys.RemoveOrdered(m_Keys.begin() + idx);
+        m_Values.RemoveOrdered(m_Values.begin() + idx);
+    }
+    template <typename Q> constexpr bool remove(const Q &key)
+    {
+        const usize idx = find(key);
+        if (idx == m_Keys.GetSize())
+            return false;
+        erase(idx);
+        return true;
+    }
+
+    // Sorts the entries by key after new ones were appended from `from` onwards, keeping the first entry of every key.
+    // Keys and values are rotated alike, so that no scratch memory is needed
+    constexpr void sortUnique(const usize from)
+    {
+        const usize size = m_Keys.GetSize();
+        if (size == from)
+            return;
+
+        Container::SortAppended(m_Keys.GetData(), from, size, m_Less,
+                                [this](const usize first, const usize middle, const usize last) {
+                                    std::rotate(m_Keys.begin() + first, m_Keys.begin() + middle,
+                                                m_Keys.begin() + last);
+                                    std::rotate(m_Values.begin() + first, m_Values.begin() + middle,
+                                                m_Values.begin() + last);
+                                });
+
+        usize unique = 1;
+        for (usize i = 1; i < size; ++i)
+        {
+            if (!m_Less(m_Keys[unique - 1], m_Keys[i]))
+                continue;
+            if (unique != i)
+            {
+                m_Keys[unique] = std::move(m_Keys[i]);
+                m_Values[unique] = std::move(m_Values[i]);
+            }
+            ++unique;
+        }
+        m_Keys.RemoveOrdered(m_Keys.begin() + unique, m_Keys.end());
+        m_Values.RemoveOrdered(m_Values.begin() + unique, m_Values.end());
+    }
+
+    Array<K, AllocState> m_Keys{};
+    Array<V, ValueState> m_Values{};
+    TKIT_NO_UNIQUE_ADDRESS Less m_Less{};
+
+    template <typename, typename, typename, typename> friend class FlatMap;
+};
+
+template <typename K, typename V, typename Less = DefaultLess<K>>
+using ArenaFlatMap = FlatMap<K, V, ArenaAllocation<K>, Less>;
+template <typename K, typename V, typename Less = DefaultLess<K>>
+using DynamicFlatMap = FlatMap<K, V, DynamicAllocation<K>, Less>;
+template <typename K, typename V, typename Less = DefaultLess<K>>
+using StackFlatMap = FlatMap<K, V, StackAllocation<K>, Less>;
+template <typename K, typename V, typename Less = DefaultLess<K>>
+using TierFlatMap = FlatMap<K, V, TierAllocation<K>, Less>;
+
+template <typename K, typename V, usize Capacity, typename Less = DefaultLess<K>>
+using StaticFlatMap = FlatMap<K, V, StaticAllocation<K, Capacity>, Less>;
+template <typename K, typename V> using StaticFlatMap4 = StaticFlatMap<K, V, 4>;
+template <typename K, typename V> using StaticFlatMap8 = StaticFlatMap<K, V, 8>;
+template <typename K, typename V> using StaticFlatMap16 = StaticFlatMap<K, V, 16>;
+template <typename K, typename V> using StaticFlatMap32 = StaticFlatMap<K, V, 32>;
+template <typename K, typename V> using StaticFlatMap64 = StaticFlatMap<K, V, 64>;
+template <typename K, typename V> using StaticFlatMap128 = StaticFlatMap<K, V, 128>;
+template <typename K, typename V> using StaticFlatMap256 = StaticFlatMap<K, V, 256>;
+template <typename K, typename V> using StaticFlatMap512 = StaticFlatMap<K, V, 512>;
+template <typename K, typename V> using StaticFlatMap1024 = StaticFlatMap<K, V, 1024>;
+} // namespace TKit
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "tkit/preprocessor/system.hpp"
+#include "tkit/utils/alias.hpp"
+#include "tkit/utils/hash.hpp"
+#include <string_view>
+
+namespace TKit
+{
+/**
+ * @brief An ordering that accepts other types than the key itself, so that flat containers can be queried without
+ * building a key.
+ */
+template <typename L>
+concept TransparentComparator = requires { typename L::is_transparent; };
+
+/**
+ * @brief The default ordering of flat containers.
+ */
+template <typename T> struct DefaultLess
+{
+    constexpr bool operator()(const T &lhs, const T &rhs) const
+    {
+        return lhs < rhs;
+    }
+};
+
+// Strings are compared as views, so that looking up a string key never builds a temporary
+template <StringLike T> struct DefaultLess<T>
+{
+    using is_transparent = void;
+
+    constexpr bool operator()(const std::string_view lhs, const std::string_view rhs) const
+    {
+        return lhs < rhs;
+    }
+};
+
+namespace Container
+{
+/**
+ * @brief Find the index of the first element of the sorted range `[data, data + size)` that is not less than `key`.
+ *
+ * The range is halved without branching on the comparison, which lets the compiler select the next half with a
+ * conditional move, so that the cost of a lookup does not depend on how predictable its comparisons are. Both possible
+ * midpoints of the next step are prefetched while the current one is compared.
+ *
+ * @return The index of the element, or `size` if all elements are less than `key`.
+ */
+template <typename T, typename Q, typename Less>
+constexpr usize LowerBound(const T *data, usize size, const Q &key, const Less &less)
+{
+    if (size == 0)
+        return 0;
+    const T *base = data;
+    while (size > 1)
+    {
+        const usize half = size / 2;
+        TKIT_PREFETCH(base + half / 2);
+        TKIT_PREFETCH(base + half + half / 2);
+        base = less(base[half], key) ? base + half : base;
+        size -= half;
+    }
+    return usize(base - data) + usize(less(*base, key));
+}
+
+/**
+ * @brief Find the index of the first element of the sorted range `[data, data + size)` that is greater than `key`.
+ *
+ * Works like `LowerBound()`.
+ *
+ * @return The index of the element, or `size` if no element is greater than `key`.
+ */
+template <typename T, typename Q, typename Less>
+constexpr usize UpperBound(const T *data, usize size, const Q &key, const Less &less)
+{
+    if (size == 0)
+        return 0;
+    const T *base = data;
+    while (size > 1)
+    {
+        const usize half = size / 2;
+        TKIT_PREFETCH(base + half / 2);
+        TKIT_PREFETCH(base + half + half / 2);
+        base = less(key, base[half]) ? base : base + half;
+        size -= half;
+    }
+    return usize(base - data) + usize(!less(key, *base));
+}
+
+/**
+ * @brief Merge the sorted ranges `[data + first, data + middle)` and `[data + middle, data + last)` in place, keeping
+ * equal elements in their original order.
+ *
+ * No scratch memory is used. The ranges are split around the median of the longest one, the inner halves are swapped
+ * with `rotate(first, middle, last)` and both sides are merged recursively. Elements are only ever moved through
+ * `rotate`, so that the caller can move other arrays along with `data`.
+ */
+template <typename T, typename Less, typename Rotate>
+constexpr void MergeInPlace(const T *data, const usize first, const usize middle, const usize last, const Less &less,
+                            const Rotate &rotate)
+{
+    if (first == middle || middle == last)
+        return;
+    if (last - first == 2)
+    {
+        if (less(data[middle], data[first]))
+            rotate(first, middle, last);
+        return;
+    }
+
+    usize cut1;
+    usize cut2;
+    if (middle - first > last - middle)
+    {
+        cut1 = first + (middle - first) / 2;
+        cut2 = middle + LowerBound(data + middle, last - middle, data[cut1], less);
+    }
+    else
+    {
+        cut2 = middle + (last - middle) / 2;
+        cut1 = first + UpperBound(data + first, middle - first, data[cut2], less);
+    }
+    if (cut1 != middle && middle != cut2)
+        rotate(cut1, middle, cut2);
+
+    const usize split = cut1 + (cut2 - middle);
+    MergeInPlace(data, first, cut1, split, less, rotate);
+    MergeInPlace(data, split, cut2, last, less, rotate);
+}
+
+/**
+ * @brief Sort the elements appended to `[data + from, data + size)` and merge them with the already sorted
+ * `[data, data + from)`, keeping equal elements in their original order.
+ *
+ * No scratch memory is used. Short runs are sorted with a binary insertion sort and then merged with `MergeInPlace()`
+ * in passes of doubling width, so elements are only ever moved through `rotate(first, middle, last)`.
+ */
+template <typename T, typename Less, typename Rotate>
+constexpr void SortAppended(const T *data, const usize from, const usize size, const Less &less,
+                            const Rotate &rotate)
+{
+    constexpr usize run = 16;
+    for (usize first = from; first < size; first += run)
+    {
+        const usize last = first + run < size ? first + run : size;
+        for (usize i = first + 1; i < last; ++i)
+        {
+            const usize idx = first + UpperBound(data + first, i - first, data[i], less);
+            if (idx != i)
+                rotate(idx, i, i + 1);
+        }
+    }
+    for (usize width = run; width < size - from; width *= 2)
+        for (usize first = from; first + width < size; first += 2 * width)
+            MergeInPlace(data, first, first + width, first + 2 * width < size ? first + 2 * width : size, less, rotate);
+    MergeInPlace(data, 0, from, size, less, rotate);
+}
+} // namespace Container
+} // namespace TKit
@@ -0,0 +1,274 @@
+#pragma once
+
+#include "tkit/container/arena_array.hpp"
+#include "tkit/container/dynamic_array.hpp"
+#include "tkit/container/stack_array.hpp"
+#include "tkit/container/static_array.hpp"
+#include "tkit/container/tier_array.hpp"
+#include "tkit/container/flat_search.hpp"
+#include "tkit/container/span.hpp"
+#include <algorithm>
+#include <ranges>
+
+namespace TKit
+{
+/**
+ * @brief A set that keeps its keys sorted in a single array.
+ *
+ * Lookups are branchless binary searches over the keys, and iteration visits them in order. It takes no more memory
+ * than the keys themselves, which makes it a better fit than `HashSet` for small or read-mostly sets. Insertions and
+ * removals are linear in the size of the set, so sets should be built in bulk with `InsertBulk()` whenever possible.
+ *
+ * When `Less` is transparent, `Find()`, `Contains()`, `LowerBound()`, `UpperBound()` and `Remove()` also accept any
+ * type it can be invoked with, such as a `std::string_view` or a `const char *` for string keys.
+ */
+template <typename K, typename AllocState, typename Less = DefaultLess<K>> class FlatSet
+{
+  public:
+    static constexpr ArrayType Type = AllocState::Type;
+    using KeyType = K;
+    using Iterator = const K *;
+
+    template <typename Q>
+    static constexpr bool IsLookupKey = TransparentComparator<Less> &&
+                                        std::predicate<const Less &, const Q &, const K &> &&
+                                        std::predicate<const Less &, const K &, const Q &>;
+
+    constexpr FlatSet() = default;
+    constexpr FlatSet(AllocState &&state) : m_Keys(std::move(state))
+    {
+    }
+    constexpr FlatSet(AllocState &&state, const Less &less) : m_Keys(std::move(state)), m_Less(less)
+    {
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> S> constexpr FlatSet(const It pbegin, const S pend)
+    {
+        InsertBulk(pbegin, pend);
+    }
+    constexpr FlatSet(const std::initializer_list<K> list)
+    {
+        InsertBulk(list.begin(), list.end());
+    }
+
+    constexpr const K &Insert(const K &key)
+    {
+        const usize idx = lowerBound(key);
+        TKIT_ASSERT(idx == m_Keys.GetSize() || m_Less(key, m_Keys[idx]),
+                    "[TOOLKIT][FLAT-SET] Cannot insert a key that is already in the set");
+        return m_Keys.Insert(m_Keys.begin() + idx, key);
+    }
+    constexpr const K &TryInsert(const K &key, bool *didExist = nullptr)
+    {
+        const usize idx = lowerBound(key);
+        const bool exists = idx != m_Keys.GetSize() && !m_Less(key, m_Keys[idx]);
+        if (didExist)
+            *didExist = exists;
+
+        if (exists)
+            return m_Keys[idx];
+        return m_Keys.Insert(m_Keys.begin() + idx, key);
+    }
+
+    /**
+     * @brief Insert a range of keys in any order.
+     *
+     * The keys are appended and sorted once, then merged with the ones already in the set. Keys that are already in the
+     * set, or that appear more than once in the range, are only inserted once.
+     */
+    template <std::input_iterator It, std::sentinel_for<It> S> constexpr void InsertBulk(const It pbegin, const S pend)
+    {
+        const usize size = m_Keys.GetSize();
+        if constexpr ((Type == Array_Dynamic || Type == Array_Tier) && std::forward_iterator<It>)
+            Reserve(size + usize(std::ranges::distance(pbegin, pend)));
+        for (It it = pbegin; it != pend; ++it)
+            m_Keys.Append(*it);
+
+        // Sorted and merged without scratch memory, so that the set never allocates outside of its own array
+        Container::SortAppended(m_Keys.GetData(), size, m_Keys.GetSize(), m_Less,
+                                [this](const usize first, const usize middle, const usize last) {
+                                    std::rotate(m_Keys.begin() + first, m_Keys.begin() + middle,
+                                                m_Keys.begin() + last);
+                                });
+        const auto equal = [this](const K &lhs, const K &rhs) { return !m_Less(lhs, rhs); };
+        m_Keys.RemoveOrdered(std::unique(m_Keys.begin(), m_Keys.end(), equal), m_Keys.end());
+    }
+    template <std::ranges::input_range R> constexpr void InsertBulk(R &&range)
+    {
+        InsertBulk(std::ranges::begin(range), std::ranges::end(range));
+    }
+
+    constexpr Iterator Find(const K &key) const
+    {
+        return begin() + find(key);
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr Iterator Find(const Q &key) const
+    {
+        return begin() + find(key);
+    }
+
+    constexpr bool Contains(const K &key) const
+    {
+        return find(key) != m_Keys.GetSize();
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr bool Contains(const Q &key) const
+    {
+        return find(key) != m_Keys.GetSize();
+    }
+
+    /**
+     * @brief Get an iterator to the first key that is not less than `key`.
+     */
+    constexpr Iterator LowerBound(const K &key) const
+    {
+        return begin() + lowerBound(key);
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr Iterator LowerBound(const Q &key) const
+    {
+        return begin() + lowerBound(key);
+    }
+
+    /**
+     * @brief Get an iterator to the first key that is greater than `key`.
+     */
+    constexpr Iterator UpperBound(const K &key) const
+    {
+        return begin() + upperBound(key);
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr Iterator UpperBound(const Q &key) const
+    {
+        return begin() + upperBound(key);
+    }
+
+    /**
+     * @brief Get the keys that fall in the half open range `[low, high)`, in order.
+     */
+    constexpr Span<const K> GetRange(const K &low, const K &high) const
+    {
+        return getRange(low, high);
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr Span<const K> GetRange(const Q &low, const Q &high) const
+    {
+        return getRange(low, high);
+    }
+
+    constexpr Iterator Remove(const Iterator iter)
+    {
+        TKIT_ASSERT(iter >= begin() && iter < end(), "[TOOLKIT][FLAT-SET] Iterator is out of bounds");
+        const usize idx = usize(iter - begin());
+        m_Keys.RemoveOrdered(m_Keys.begin() + idx);
+        return begin() + idx;
+    }
+    constexpr bool Remove(const K &key)
+    {
+        return remove(key);
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr bool Remove(const Q &key)
+    {
+        return remove(key);
+    }
+
+    constexpr void Clear()
+    {
+        m_Keys.Clear();
+    }
+    constexpr void Reserve(const usize capacity)
+        requires(Type != Array_Static)
+    {
+        m_Keys.Reserve(capacity);
+    }
+
+    constexpr Span<const K> GetKeys() const
+    {
+        return Span<const K>{m_Keys.GetData(), m_Keys.GetSize()};
+    }
+
+    constexpr Iterator begin() const
+    {
+        return m_Keys.begin();
+    }
+    constexpr Iterator end() const
+    {
+        return m_Keys.end();
+    }
+
+    constexpr usize GetSize() const
+    {
+        return m_Keys.GetSize();
+    }
+    constexpr usize GetCapacity() const
+    {
+        return m_Keys.GetCapacity();
+    }
+    constexpr bool IsEmpty() const
+    {
+        return m_Keys.IsEmpty();
+    }
+    constexpr const Less &GetLess() const
+    {
+        return m_Less;
+    }
+
+  private:
+    template <typename Q> constexpr usize lowerBound(const Q &key) const
+    {
+        return Container::LowerBound(m_Keys.GetData(), m_Keys.GetSize(), key, m_Less);
+    }
+    template <typename Q> constexpr usize upperBound(const Q &key) const
+    {
+        return Container::UpperBound(m_Keys.GetData(), m_Keys.GetSize(), key, m_Less);
+    }
+    // Returns the size of the set if the key is not found, so that it maps to `end()`
+    template <typename Q> constexpr usize find(const Q &key) const
+    {
+        const usize idx = lowerBound(key);
+        return idx != m_Keys.GetSize() && !m_Less(key, m_Keys[idx]) ? idx : m_Keys.GetSize();
+    }
+    template <typename Q> constexpr Span<const K> getRange(const Q &low, const Q &high) const
+    {
+        const usize first = lowerBound(low);
+        const usize last = std::max(first, lowerBound(high));
+        return Span<const K>{m_Keys.GetData() + first, last - first};
+    }
+    template <typename Q> constexpr bool remove(const Q &key)
+    {
+        const usize idx = find(key);
+        if (idx == m_Keys.GetSize())
+            return false;
+        m_Keys.RemoveOrdered(m_Keys.begin() + idx);
+        return true;
+    }
+
+    Array<K, AllocState> m_Keys{};
+    TKIT_NO_UNIQUE_ADDRESS Less m_Less{};
+};
+
+template <typename K, typename Less = DefaultLess<K>> using ArenaFlatSet = FlatSet<K, ArenaAllocation<K>, Less>;
+template <typename K, typename Less = DefaultLess<K>> using DynamicFlatSet = FlatSet<K, DynamicAllocation<K>, Less>;
+template <typename K, typename Less = DefaultLess<K>> using StackFlatSet = FlatSet<K, StackAllocation<K>, Less>;
+template <typename K, typename Less = DefaultLess<K>> using TierFlatSet = FlatSet<K, TierAllocation<K>, Less>;
+
+template <typename K, usize Capacity, typename Less = DefaultLess<K>>
+using StaticFlatSet = FlatSet<K, StaticAllocation<K, Capacity>, Less>;
+template <typename K> using StaticFlatSet4 = StaticFlatSet<K, 4>;
+template <typename K> using StaticFlatSet8 = StaticFlatSet<K, 8>;
+template <typename K> using StaticFlatSet16 = StaticFlatSet<K, 16>;
+template <typename K> using StaticFlatSet32 = StaticFlatSet<K, 32>;
+template <typename K> using StaticFlatSet64 = StaticFlatSet<K, 64>;
+template <typename K> using StaticFlatSet128 = StaticFlatSet<K, 128>;
+template <typename K> using StaticFlatSet256 = StaticFlatSet<K, 256>;
+template <typename K> using StaticFlatSet512 = StaticFlatSet<K, 512>;
+template <typename K> using StaticFlatSet1024 = StaticFlatSet<K, 1024>;
+} // namespace TKit
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "tkit/preprocessor/system.hpp"
+#include "tkit/utils/alias.hpp"
+#if defined(TKIT_SIMD_AVX2)
+#    include "tkit/simd/wide_avx.hpp"
+#elif defined(TKIT_SIMD_SSE2)
+#    include "tkit/simd/wide_sse.hpp"
+#elif defined(TKIT_SIMD_NEON)
+#    include "tkit/simd/wide_neon.hpp"
+#else
+#    include "tkit/simd/wide.hpp"
+#endif
+#include <bit>
+
+namespace TKit
+{
+namespace Detail
+{
+#if defined(TKIT_SIMD_AVX2)
+using HashControlWide = Simd::AVX::Wide<u8>;
+#elif defined(TKIT_SIMD_SSE2)
+using HashControlWide = Simd::SSE::Wide<u8>;
+#elif defined(TKIT_SIMD_NEON)
+using HashControlWide = Simd::NEON::Wide<u8>;
+#else
+using HashControlWide = Simd::Wide<u8, 16>;
+#endif
+} // namespace Detail
+
+/**
+ * @brief Amount of slots in a hash table group. All control bytes of a group are matched at once, so it is the width
+ * of the widest integer vector available: 32 with AVX2, 16 otherwise.
+ */
+constexpr usize HashGroupSize = Detail::HashControlWide::Lanes;
+
+/**
+ * @brief Control byte values of hash table slots.
+ *
+ * Full slots store the 7 lowest bits of the hash of their key instead, so that the high bit tells apart full slots
+ * from empty or deleted ones.
+ */
+enum HashControl : u8
+{
+    HashControl_Empty = 0x80,
+    HashControl_Deleted = 0xFE
+};
+
+// Selects the group where probing starts
+constexpr usz GetHashH1(const usz hash)
+{
+    return hash >> 7;
+}
+// Fingerprint stored in the control byte of the slot
+constexpr u8 GetHashH2(const usz hash)
+{
+    return u8(hash & 0x7F);
+}
+
+constexpr bool IsHashControlFull(const u8 control)
+{
+    return control < HashControl_Empty;
+}
+
+/**
+ * @brief Get the amount of groups needed to hold at least `slots` slots. Group counts are always a power of 2.
+ */
+constexpr usize GetHashGroupCount(const usize slots)
+{
+    const usize groups = (slots + HashGroupSize - 1) / HashGroupSize;
+    return groups <= 1 ? 1 : usize(std::bit_ceil(groups));
+}
+
+/**
+ * @brief A bitmask with one bit per slot of a group, iterated from the lowest set bit.
+ */
+class HashGroupMask
+{
+  public:
+    using BitMask = Detail::HashControlWide::BitMask;
+
+    constexpr HashGroupMask(const BitMask mask) : m_Mask(mask)
+    {
+    }
+
+    constexpr explicit operator bool() const
+    {
+        return m_Mask != 0;
+    }
+
+    constexpr usize GetLowest() const
+    {
+        return usize(std::countr_zero(m_Mask));
+    }
+    constexpr void ClearLowest()
+    {
+        m_Mask &= BitMask(m_Mask - 1);
+    }
+
+    constexpr BitMask GetBits() const
+    {
+        return m_Mask;
+    }
+
+  private:
+    BitMask m_Mask;
+};
+
+/**
+ * @brief The control bytes of a group, loaded into a vector register to be matched all at once.
+ */
+class HashGroup
+{
+    using Wide = Detail::HashControlWide;
+
+  public:
+    explicit HashGroup(const u8 *control) : m_Control(Wide::LoadUnaligned(control))
+    {
+    }
+
+    HashGroupMask Match(const u8 h2) const
+    {
+        return Wide::PackMask(m_Control == Wide{h2});
+    }
+    HashGroupMask MatchEmpty() const
+    {
+        return Wide::PackMask(m_Control == Wide{u8(HashControl_Empty)});
+    }
+    HashGroupMask MatchEmptyOrDeleted() const
+    {
+        return HashGroupMask::BitMask(MatchEmpty().GetBits() |
+                                      Wide::PackMask(m_Control == Wide{u8(HashControl_Deleted)}));
+    }
+    HashGroupMask MatchFull() const
+    {
+        return HashGroupMask::BitMask(~MatchEmptyOrDeleted().GetBits());
+    }
+
+  private:
+    Wide m_Control;
+};
+
+/**
+ * @brief Triangular probe sequence over the groups of a table. Visits every group exactly once as long as the group
+ * count is a power of 2.
+ */
+class HashProbe
+{
+  public:
+    constexpr HashProbe(const usz hash, const usize groups)
+        : m_Mask(groups - 1), m_Group(usize(GetHashH1(hash)) & m_Mask)
+    {
+    }
+
+    constexpr usize GetGroup() const
+    {
+        return m_Group;
+    }
+    constexpr void Next()
+    {
+        ++m_Step;
+        m_Group = (m_Group + m_Step) & m_Mask;
+    }
+
+  private:
+    usize m_Mask;
+    usize m_Group;
+    usize m_Step = 0;
+};
+} // namespace TKit
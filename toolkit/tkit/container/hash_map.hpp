@@ -5,9 +5,12 @@
 #include "tkit/container/stack_array.hpp"
 #include "tkit/container/static_array.hpp"
 #include "tkit/container/tier_array.hpp"
+#include "tkit/container/hash_group.hpp"
+#include "tkit/container/span.hpp"
 #include "tkit/utils/hash.hpp"
 #include "tkit/utils/bit.hpp"
 #include "tkit/utils/limits.hpp"
+#include <ranges>
 
 namespace TKit
 {
@@ -21,27 +24,53 @@ template <typename K, typename V> struct KeyValuePair
     V Value;
 };
 
-// NOTE(Isma): This is missing some features like custom comparison/hasher and heterogeneous lookup
-// NOTE(Isma): Consider implementing a SwissTable
+template <typename K, typename V>
+struct IsTriviallyRelocatable<KeyValuePair<K, V>>
+    : std::bool_constant<TriviallyRelocatable<K> && TriviallyRelocatable<V>>
+{
+};
+
+/**
+ * @brief A group of `HashGroupSize` hash map slots.
+ *
+ * The control bytes of the group come first so that all of them can be matched against a fingerprint with a single
+ * vector load, followed by the storage of the slots themselves. Keeping the control bytes inside of the groups instead
+ * of in a separate array lets the map live in a single allocation of its allocation state.
+ */
 template <typename K, typename V> struct MapNode
 {
     using Entry = KeyValuePair<const K, V>;
 
-    usz Hash;
-    alignas(Entry) std::byte Data[sizeof(Entry)];
-    HashNodeState State = HashNode_Free;
+    u8 Control[HashGroupSize];
+    alignas(Entry) std::byte Data[HashGroupSize][sizeof(Entry)];
 
-    constexpr const Entry *GetEntry() const
+    constexpr const Entry *GetEntry(const usize slot) const
     {
-        return rcast<const Entry *>(Data);
+        return rcast<const Entry *>(Data[slot]);
     }
-    constexpr Entry *GetEntry()
+    constexpr Entry *GetEntry(const usize slot)
     {
-        return rcast<Entry *>(Data);
+        return rcast<Entry *>(Data[slot]);
     }
 };
 
-template <typename K, typename V, typename AllocState> class HashMap
+/**
+ * @brief An open addressing hash map in the style of a SwissTable.
+ *
+ * Slots are grouped in `MapNode` groups, and every slot has a control byte that is either empty, deleted or a 7 bit
+ * fingerprint of the hash of its key. Lookups probe whole groups at a time, comparing the fingerprint against all
+ * control bytes of a group with SIMD instructions and only comparing keys on a fingerprint match.
+ *
+ * The allocation state holds groups, so its capacity is given in groups, while sizes and bucket counts passed to or
+ * returned by the map are given in slots.
+ *
+ * When both `Hasher` and `KeyEqual` are transparent, `Find()`, `Contains()`, `At()` and `Remove()` also accept any
+ * type they can be invoked with, such as a `std::string_view` or a `const char *` for string keys. Hashers that are
+ * not avalanching have their results scrambled with `MixHash()`.
+ */
+template <typename K, typename V, typename AllocState, typename Hasher = DefaultHasher<K>,
+          typename KeyEqual = DefaultKeyEqual<K>>
+class HashMap
 {
   public:
     static constexpr ArrayType Type = AllocState::Type;
@@ -52,6 +81,11 @@ template <typename K, typename V, typename AllocState> class HashMap
     using Pair = KeyValuePair<K, V>;
     using Entry = typename Node::Entry;
 
+    template <typename Q>
+    static constexpr bool IsLookupKey =
+        TransparentHasher<Hasher> && TransparentHasher<KeyEqual> && std::invocable<const Hasher &, const Q &> &&
+        std::predicate<const KeyEqual &, const Q &, const K &>;
+
     template <typename T> class IteratorImpl
     {
       public:
@@ -60,10 +94,7 @@ template <typename K, typename V, typename AllocState> class HashMap
 
         IteratorImpl(BucketArray *buckets) : m_Buckets(buckets), m_Index(0)
         {
-            if (m_Buckets->IsEmpty())
-                m_Index = TKIT_U32_MAX;
-            else if (m_Buckets->At(m_Index).State != HashNode_Occupied)
-                ++(*this);
+            seek(0);
         }
         IteratorImpl(BucketArray *buckets, const usize idx) : m_Buckets(buckets), m_Index(idx)
         {
@@ -93,22 +124,16 @@ template <typename K, typename V, typename AllocState> class HashMap
 
         auto &operator*() const
         {
-            return *m_Buckets->At(m_Index).GetEntry();
+            return *m_Buckets->At(m_Index / HashGroupSize).GetEntry(m_Index % HashGroupSize);
         }
         auto *operator->() const
         {
-            return m_Buckets->At(m_Index).GetEntry();
+            return m_Buckets->At(m_Index / HashGroupSize).GetEntry(m_Index % HashGroupSize);
         }
 
         IteratorImpl &operator++()
         {
-            for (u32 i = m_Index + 1; i < m_Buckets->GetSize(); ++i)
-                if (m_Buckets->At(i).State == HashNode_Occupied)
-                {
-                    m_Index = i;
-                    return *this;
-                }
-            m_Index = TKIT_USIZE_MAX;
+            seek(m_Index + 1);
             return *this;
         }
 
@@ -138,6 +163,24 @@ template <typename K, typename V, typename AllocState> class HashMap
         }
 
       private:
+        // Point to the first full slot at or after `idx`
+        void seek(const usize idx)
+        {
+            using BitMask = HashGroupMask::BitMask;
+            usize offset = idx % HashGroupSize;
+            for (usize group = idx / HashGroupSize; group < m_Buckets->GetSize(); ++group, offset = 0)
+            {
+                const BitMask full = HashGroup{m_Buckets->At(group).Control}.MatchFull().GetBits();
+                const HashGroupMask mask = BitMask(full & BitMask(~BitMask(0) << offset));
+                if (mask)
+                {
+                    m_Index = group * HashGroupSize + mask.GetLowest();
+                    return;
+                }
+            }
+            m_Index = TKIT_USIZE_MAX;
+        }
+
         BucketArray *m_Buckets;
         usize m_Index;
 
@@ -149,57 +192,75 @@ template <typename K, typename V, typename AllocState> class HashMap
     using ConstIterator = IteratorImpl<const Entry>;
 
     constexpr HashMap() = default;
-    constexpr HashMap(const usize buckets) : m_Buckets(NextPowerOfTwo(buckets))
+    constexpr HashMap(const usize buckets) : m_Buckets(GetHashGroupCount(buckets))
     {
         setEmpty();
     }
     constexpr HashMap(AllocState &&state) : m_Buckets(std::move(state))
     {
     }
-    constexpr HashMap(const usize capacity, AllocState &&state) : m_Buckets(NextPowerOfTwo(capacity), std::move(state))
+    constexpr HashMap(const usize capacity, AllocState &&state)
+        : m_Buckets(GetHashGroupCount(capacity), std::move(state))
+    {
+        setEmpty();
+    }
+    constexpr HashMap(const usize buckets, const Hasher &hasher, const KeyEqual &equal = KeyEqual{})
+        : m_Buckets(GetHashGroupCount(buckets)), m_Hasher(hasher), m_KeyEqual(equal)
+    {
+        setEmpty();
+    }
+    constexpr HashMap(const usize capacity, AllocState &&state, const Hasher &hasher,
+                      const KeyEqual &equal = KeyEqual{})
+        : m_Buckets(GetHashGroupCount(capacity), std::move(state)), m_Hasher(hasher), m_KeyEqual(equal)
     {
         setEmpty();
     }
 
     template <std::input_iterator It> constexpr HashMap(const It pbegin, const It pend)
     {
-        for (const It it = pbegin; it != pend; ++it)
-            Insert(*it);
+        InsertBulk(pbegin, pend);
     }
 
     constexpr HashMap(const std::initializer_list<Pair> list)
     {
-        for (const Pair &pair : list)
-            Insert(pair);
+        InsertBulk(list.begin(), list.end());
     }
 
-    constexpr HashMap(const HashMap &other)
+    constexpr HashMap(const HashMap &other) : m_Hasher(other.m_Hasher), m_KeyEqual(other.m_KeyEqual)
     {
         copyOp(other.m_Buckets);
     }
-    constexpr HashMap(HashMap &&other)
+    constexpr HashMap(HashMap &&other) : m_Hasher(other.m_Hasher), m_KeyEqual(other.m_KeyEqual)
     {
         if constexpr (Type == Array_Static)
         {
             moveOp(other.m_Buckets);
             other.m_Size = 0;
+            other.m_Deleted = 0;
         }
         else
         {
             m_Buckets = std::move(other.m_Buckets);
             m_Size = other.m_Size;
+            m_Deleted = other.m_Deleted;
             other.m_Size = 0;
+            other.m_Deleted = 0;
         }
     }
 
-    template <typename OtherAlloc> constexpr HashMap(const HashMap<K, V, OtherAlloc> &other)
+    template <typename OtherAlloc>
+    constexpr HashMap(const HashMap<K, V, OtherAlloc, Hasher, KeyEqual> &other)
+        : m_Hasher(other.m_Hasher), m_KeyEqual(other.m_KeyEqual)
     {
         copyOp(other.m_Buckets);
     }
-    template <typename OtherAlloc> constexpr HashMap(HashMap<K, V, OtherAlloc> &&other)
+    template <typename OtherAlloc>
+    constexpr HashMap(HashMap<K, V, OtherAlloc, Hasher, KeyEqual> &&other)
+        : m_Hasher(other.m_Hasher), m_KeyEqual(other.m_KeyEqual)
     {
         moveOp(other.m_Buckets);
         other.m_Size = 0;
+        other.m_Deleted = 0;
     }
 
     ~HashMap()
@@ -210,60 +271,73 @@ template <typename K, typename V, typename AllocState> class HashMap
     constexpr HashMap &operator=(const HashMap &other)
     {
         Clear();
+        m_Hasher = other.m_Hasher;
+        m_KeyEqual = other.m_KeyEqual;
         copyOp(other.m_Buckets);
         return *this;
     }
     constexpr HashMap &operator=(HashMap &&other)
     {
         Clear();
+        m_Hasher = other.m_Hasher;
+        m_KeyEqual = other.m_KeyEqual;
         if constexpr (Type == Array_Static)
         {
             moveOp(other.m_Buckets);
             other.m_Size = 0;
+            other.m_Deleted = 0;
         }
         else
         {
             m_Buckets = std::move(other.m_Buckets);
             m_Size = other.m_Size;
+            m_Deleted = other.m_Deleted;
             other.m_Size = 0;
+            other.m_Deleted = 0;
         }
         return *this;
     }
-    template <typename OtherAlloc> constexpr HashMap &operator=(const HashMap<K, V, OtherAlloc> &other)
+    template <typename OtherAlloc>
+    constexpr HashMap &operator=(const HashMap<K, V, OtherAlloc, Hasher, KeyEqual> &other)
     {
         Clear();
+        m_Hasher = other.m_Hasher;
+        m_KeyEqual = other.m_KeyEqual;
         copyOp(other.m_Buckets);
         return *this;
     }
-    template <typename OtherAlloc> constexpr HashMap &operator=(HashMap<K, V, OtherAlloc> &&other)
+    template <typename OtherAlloc>
+    constexpr HashMap &operator=(HashMap<K, V, OtherAlloc, Hasher, KeyEqual> &&other)
     {
         Clear();
+        m_Hasher = other.m_Hasher;
+        m_KeyEqual = other.m_KeyEqual;
         moveOp(other.m_Buckets);
         other.m_Size = 0;
+        other.m_Deleted = 0;
         return *this;
     }
 
     constexpr void Clear()
     {
-        if (m_Size == 0)
+        if (m_Size == 0 && m_Deleted == 0)
             return;
         for (Node &n : m_Buckets)
         {
-            if (n.State == HashNode_Occupied)
-            {
-                if constexpr (!std::is_trivially_destructible_v<K> || !std::is_trivially_destructible_v<V>)
-                    Destruct(n.GetEntry());
-            }
-            n.State = HashNode_Free;
+            if constexpr (!std::is_trivially_destructible_v<K> || !std::is_trivially_destructible_v<V>)
+                for (HashGroupMask mask = HashGroup{n.Control}.MatchFull(); mask; mask.ClearLowest())
+                    Destruct(n.GetEntry(mask.GetLowest()));
+            setEmpty(n);
         }
         m_Size = 0;
+        m_Deleted = 0;
     }
 
     template <typename... Args>
         requires std::constructible_from<V, Args...>
     constexpr V &Insert(const K &key, Args &&...args)
     {
-        return *insert<true>(Hash(key), key, std::forward<Args>(args)...);
+        return *insert<true>(hashKey(key), key, std::forward<Args>(args)...);
     }
     constexpr V &Insert(const Pair &pair)
     {
@@ -274,22 +348,16 @@ template <typename K, typename V, typename AllocState> class HashMap
         requires std::constructible_from<V, Args...>
     constexpr V &TryInsert(bool *didExist, const K &key, Args &&...args)
     {
-        maybeRehash();
-        const usz hash = Hash(key);
-        const usize idx = find<true>(key, hash);
+        const usz hash = hashKey(key);
+        const usize idx = find(key, hash);
 
-        Node &node = m_Buckets[idx];
-        const bool occupied = node.State == HashNode_Occupied;
+        const bool exists = idx != TKIT_USIZE_MAX;
         if (didExist)
-            *didExist = occupied;
-
-        if (occupied)
-            return node.GetEntry()->Value;
+            *didExist = exists;
 
-        ++m_Size;
-        node.Hash = hash;
-        node.State = HashNode_Occupied;
-        return Construct(node.GetEntry(), key, std::forward<Args>(args)...)->Value;
+        if (exists)
+            return getEntry(idx)->Value;
+        return *insert<true>(hash, key, std::forward<Args>(args)...);
     }
     template <typename... Args>
         requires std::constructible_from<V, Args...>
@@ -302,31 +370,134 @@ template <typename K, typename V, typename AllocState> class HashMap
         return TryInsert(didExist, pair.Key, pair.Value);
     }
 
+    /**
+     * @brief Insert a range of key-value pairs, as if by calling `Insert()` with each one of them.
+     *
+     * Keys must not be in the map already. If the range can be traversed more than once, the map grows to fit all of
+     * its elements before inserting any of them, and keys are hashed in batches ahead of their insertion so that the
+     * groups they land in can be prefetched.
+     */
+    template <std::input_iterator It, std::sentinel_for<It> S> constexpr void InsertBulk(const It pbegin, const S pend)
+    {
+        if constexpr (!std::forward_iterator<It>)
+        {
+            for (It it = pbegin; it != pend; ++it)
+                Insert(*it);
+        }
+        else
+        {
+            const bool fits = reserve(m_Size + usize(std::ranges::distance(pbegin, pend)));
+            usz hashes[BatchSize];
+            for (It it = pbegin; it != pend;)
+            {
+                It batch = it;
+                usize count = 0;
+                for (; count < BatchSize && it != pend; ++it, ++count)
+                {
+                    const Pair &pair = *it;
+                    hashes[count] = hashKey(pair.Key);
+                }
+                for (usize i = 0; i < count; ++i, ++batch)
+                {
+                    const Pair &pair = *batch;
+                    if (!fits)
+                    {
+                        insert<true>(hashes[i], pair.Key, pair.Value);
+                        continue;
+                    }
+                    if (i + PrefetchDistance < count)
+                        prefetch(hashes[i + PrefetchDistance]);
+                    insert<false>(hashes[i], pair.Key, pair.Value);
+                }
+            }
+        }
+    }
+    template <std::ranges::input_range R> constexpr void InsertBulk(R &&range)
+    {
+        InsertBulk(std::ranges::begin(range), std::ranges::end(range));
+    }
+
     constexpr ConstIterator Find(const K &key) const
     {
-        return ConstIterator{&m_Buckets, find(key, Hash(key))};
+        return ConstIterator{&m_Buckets, find(key, hashKey(key))};
     }
     constexpr Iterator Find(const K &key)
     {
-        return Iterator{&m_Buckets, find(key, Hash(key))};
+        return Iterator{&m_Buckets, find(key, hashKey(key))};
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr ConstIterator Find(const Q &key) const
+    {
+        return ConstIterator{&m_Buckets, find(key, hashKey(key))};
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr Iterator Find(const Q &key)
+    {
+        return Iterator{&m_Buckets, find(key, hashKey(key))};
     }
 
     constexpr bool Contains(const K &key) const
     {
-        return Find(key) != end();
+        return find(key, hashKey(key)) != TKIT_USIZE_MAX;
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr bool Contains(const Q &key) const
+    {
+        return find(key, hashKey(key)) != TKIT_USIZE_MAX;
     }
 
     constexpr const V &At(const K &key) const
     {
-        const auto it = Find(key);
-        TKIT_ASSERT(it != end(), "[TOOLKIT][HASH-MAP] The key was not found");
-        return it->Value;
+        return getEntry(findExisting(key))->Value;
     }
     constexpr V &At(const K &key)
     {
-        const auto it = Find(key);
-        TKIT_ASSERT(it != end(), "[TOOLKIT][HASH-MAP] The key was not found");
-        return it->Value;
+        return getEntry(findExisting(key))->Value;
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr const V &At(const Q &key) const
+    {
+        return getEntry(findExisting(key))->Value;
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr V &At(const Q &key)
+    {
+        return getEntry(findExisting(key))->Value;
+    }
+
+    /**
+     * @brief Look up several keys at once, writing a pointer to the value of each key (or `nullptr` if it is not in the
+     * map) to the corresponding position of `out`.
+     *
+     * Keys are hashed in batches, and the groups of upcoming keys are prefetched while the current one is resolved,
+     * which hides most of the memory latency when the map does not fit in cache.
+     *
+     * @return The amount of keys found.
+     */
+    constexpr usize FindBatch(const Span<const K> keys, const Span<const V *> out) const
+    {
+        return findBatch(*this, keys, out);
+    }
+    constexpr usize FindBatch(const Span<const K> keys, const Span<V *> out)
+    {
+        return findBatch(*this, keys, out);
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr usize FindBatch(const Span<const Q> keys, const Span<const V *> out) const
+    {
+        return findBatch(*this, keys, out);
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr usize FindBatch(const Span<const Q> keys, const Span<V *> out)
+    {
+        return findBatch(*this, keys, out);
     }
 
     constexpr const V &operator[](const K &key) const
@@ -342,39 +513,31 @@ template <typename K, typename V, typename AllocState> class HashMap
     {
         TKIT_ASSERT(m_Size != 0, "[TOOLKIT][HASH-MAP] Cannot remove an element when the size is 0");
         const Iterator next = iter.Next();
-
-        Node &node = iter.m_Buckets->At(iter.m_Index);
-        TKIT_ASSERT(node.State == HashNode_Occupied,
-                    "[TOOLKIT][HASH-MAP] Iterator must point to an occupied slot to be removed");
-
-        node.State = HashNode_Tombstone;
-        Destruct(node.GetEntry());
-        --m_Size;
+        erase(iter.m_Index);
         return next;
     }
 
     constexpr bool Remove(const K &key)
     {
-        const usize idx = find(key, Hash(key));
-        if (idx == TKIT_USIZE_MAX)
-            return false;
-
-        Node &node = m_Buckets[idx];
-        node.State = HashNode_Tombstone;
-        Destruct(node.GetEntry());
-        --m_Size;
-        return true;
+        return remove(key);
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr bool Remove(const Q &key)
+    {
+        return remove(key);
     }
 
     constexpr f32 GetLoadFactor() const
     {
-        return f32(m_Size) / f32(m_Buckets.GetSize());
+        return f32(m_Size) / f32(GetBucketCount());
     }
 
     constexpr void Rehash(const usize buckets)
     {
-        if (buckets > m_Buckets.GetSize())
-            rehash(NextPowerOfTwo(buckets));
+        const usize groups = GetHashGroupCount(buckets);
+        if (groups > m_Buckets.GetSize())
+            rehash(groups);
     }
 
     constexpr usize GetSize() const
@@ -383,7 +546,7 @@ template <typename K, typename V, typename AllocState> class HashMap
     }
     constexpr usize GetBucketCount() const
     {
-        return m_Buckets.GetSize();
+        return m_Buckets.GetSize() * HashGroupSize;
     }
 
     constexpr ConstIterator begin() const
@@ -409,160 +572,388 @@ template <typename K, typename V, typename AllocState> class HashMap
         return m_Size == 0;
     }
 
+    constexpr const Hasher &GetHasher() const
+    {
+        return m_Hasher;
+    }
+    constexpr const KeyEqual &GetKeyEqual() const
+    {
+        return m_KeyEqual;
+    }
+
   private:
-    void setEmpty()
+    // Keys hashed ahead by bulk operations, and how far ahead of the current key their groups are prefetched
+    static constexpr usize BatchSize = 64;
+    static constexpr usize PrefetchDistance = 8;
+
+    template <typename Q> constexpr usz hashKey(const Q &key) const
+    {
+        if constexpr (AvalanchingHasher<Hasher>)
+            return usz(m_Hasher(key));
+        else
+            return MixHash(usz(m_Hasher(key)));
+    }
+
+    static constexpr void setEmpty(Node &node)
+    {
+        for (usize i = 0; i < HashGroupSize; ++i)
+            node.Control[i] = HashControl_Empty;
+    }
+    constexpr void setEmpty()
     {
         for (Node &n : m_Buckets)
-            n.State = HashNode_Free;
+            setEmpty(n);
+    }
+
+    constexpr Entry *getEntry(const usize idx)
+    {
+        return m_Buckets[idx / HashGroupSize].GetEntry(idx % HashGroupSize);
     }
-    template <bool GetInsertSpot = false> usize find(const K &key, const usz hash) const
+    constexpr const Entry *getEntry(const usize idx) const
     {
-        const usize buckets = m_Buckets.GetSize();
-        if (buckets == 0)
-            return TKIT_USIZE_MAX;
+        return m_Buckets[idx / HashGroupSize].GetEntry(idx % HashGroupSize);
+    }
 
-        const usize idx = usize(hash & (buckets - 1));
+    template <typename Q> constexpr usize find(const Q &key, const usz hash) const
+    {
+        const usize groups = m_Buckets.GetSize();
+        if (groups == 0)
+            return TKIT_USIZE_MAX;
 
-        usize found = TKIT_USIZE_MAX;
-        const auto tryFind = [&](const usize i) {
-            const Node &node = m_Buckets[i];
-            if (node.State == HashNode_Free)
+        const u8 h2 = GetHashH2(hash);
+        HashProbe probe{hash, groups};
+        for (usize i = 0; i < groups; ++i, probe.Next())
+        {
+            const Node &node = m_Buckets[probe.GetGroup()];
+            const HashGroup group{node.Control};
+            for (HashGroupMask mask = group.Match(h2); mask; mask.ClearLowest())
             {
-                if constexpr (GetInsertSpot)
-                    if (found == TKIT_USIZE_MAX)
-                        found = i;
-                return true;
+                const usize slot = mask.GetLowest();
+                if (m_KeyEqual(key, node.GetEntry(slot)->Key))
+                    return probe.GetGroup() * HashGroupSize + slot;
             }
-            if constexpr (GetInsertSpot)
-                if (node.State == HashNode_Tombstone && found == TKIT_USIZE_MAX)
-                    found = i;
+            // Insertions only skip past full groups, so the key cannot be further along
+            if (group.MatchEmpty())
+                return TKIT_USIZE_MAX;
+        }
+        return TKIT_USIZE_MAX;
+    }
 
-            if (node.State == HashNode_Tombstone || node.Hash != hash || key != node.GetEntry()->Key)
-                return false;
+    // Only the control bytes are prefetched, as they are all a probe needs to rule out a group
+    void prefetch(const usz hash) const
+    {
+        const HashProbe probe{hash, m_Buckets.GetSize()};
+        TKIT_PREFETCH(m_Buckets.GetData() + probe.GetGroup());
+    }
 
-            found = i;
-            return true;
-        };
+    // Shared by the const and non-const overloads, which write pointers with the constness of the map
+    template <typename Self, typename Q, typename Out>
+    static constexpr usize findBatch(Self &self, const Span<const Q> keys, const Span<Out> out)
+    {
+        TKIT_ASSERT(out.GetSize() >= keys.GetSize(),
+                    "[TOOLKIT][HASH-MAP] The output span ({}) must be at least as big as the key span ({})",
+                    out.GetSize(), keys.GetSize());
+        if (self.m_Size == 0)
+        {
+            for (usize i = 0; i < keys.GetSize(); ++i)
+                out[i] = nullptr;
+            return 0;
+        }
 
-        for (u32 i = idx; i < buckets; ++i)
-            if (tryFind(i))
-                return found;
-        for (u32 i = 0; i < idx; ++i)
-            if (tryFind(i))
-                return found;
+        usz hashes[BatchSize];
+        usize found = 0;
+        for (usize begin = 0; begin < keys.GetSize(); begin += BatchSize)
+        {
+            const usize count = keys.GetSize() - begin < BatchSize ? keys.GetSize() - begin : BatchSize;
+            for (usize i = 0; i < count; ++i)
+                hashes[i] = self.hashKey(keys[begin + i]);
+            for (usize i = 0; i < count && i < PrefetchDistance; ++i)
+                self.prefetch(hashes[i]);
 
+            for (usize i = 0; i < count; ++i)
+            {
+                if (i + PrefetchDistance < count)
+                    self.prefetch(hashes[i + PrefetchDistance]);
+                const usize idx = self.find(keys[begin + i], hashes[i]);
+                if (idx == TKIT_USIZE_MAX)
+                    out[begin + i] = nullptr;
+                else
+                {
+                    out[begin + i] = &self.getEntry(idx)->Value;
+                    ++found;
+                }
+            }
+        }
         return found;
     }
 
+    template <typename Q> constexpr usize findExisting(const Q &key) const
+    {
+        const usize idx = find(key, hashKey(key));
+        TKIT_ASSERT(idx != TKIT_USIZE_MAX, "[TOOLKIT][HASH-MAP] The key was not found");
+        return idx;
+    }
+
+    template <typename Q> constexpr bool remove(const Q &key)
+    {
+        const usize idx = find(key, hashKey(key));
+        if (idx == TKIT_USIZE_MAX)
+            return false;
+
+        erase(idx);
+        return true;
+    }
+
     template <bool Rehash, typename... Args>
         requires std::constructible_from<V, Args...>
     constexpr V *insert(const usz hash, const K &key, Args &&...args)
     {
-        const usize buckets = Rehash ? maybeRehash() : m_Buckets.GetSize();
-        const usize idx = usize(hash & (buckets - 1));
-        ++m_Size;
-        TKIT_ASSERT(m_Size <= buckets,
-                    "[TOOLKIT][HASH-MAP] The size of the hash map ({}) exceeds the bucket count ({})", m_Size, buckets);
+        const usize groups = Rehash ? maybeRehash() : m_Buckets.GetSize();
+        return &Construct(claimSlot(hash, groups), key, std::forward<Args>(args)...)->Value;
+    }
 
-        const auto tryInsert = [&](const usize i) -> V * {
-            Node &node = m_Buckets[i];
-            if (node.State == HashNode_Occupied)
-                return nullptr;
+    // Find the first slot in the probe sequence of `hash` that is not full
+    constexpr usize findFree(const usz hash, const usize groups) const
+    {
+        HashProbe probe{hash, groups};
+        for (usize i = 0; i < groups; ++i, probe.Next())
+        {
+            const HashGroupMask mask = HashGroup{m_Buckets[probe.GetGroup()].Control}.MatchEmptyOrDeleted();
+            if (mask)
+                return probe.GetGroup() * HashGroupSize + mask.GetLowest();
+        }
+        return TKIT_USIZE_MAX;
+    }
+
+    // Mark the first slot that is not full as full. The key must not be in the map already
+    constexpr Entry *claimSlot(const usz hash, const usize groups)
+    {
+        ++m_Size;
+        TKIT_ASSERT(m_Size <= groups * HashGroupSize,
+                    "[TOOLKIT][HASH-MAP] The size of the hash map ({}) exceeds the bucket count ({})", m_Size,
+                    groups * HashGroupSize);
 
-            node.Hash = hash;
-            node.State = HashNode_Occupied;
-            return &Construct(node.GetEntry(), key, std::forward<Args>(args)...)->Value;
-        };
+        const usize idx = findFree(hash, groups);
+        TKIT_ASSERT(idx != TKIT_USIZE_MAX,
+                    "[TOOLKIT][HASH-MAP] Failed to insert element (this should not be possible)");
 
-        for (u32 i = idx; i < buckets; ++i)
-            if (V *elm = tryInsert(i))
-                return elm;
+        Node &node = m_Buckets[idx / HashGroupSize];
+        const usize slot = idx % HashGroupSize;
+        if (node.Control[slot] == HashControl_Deleted)
+            --m_Deleted;
+        node.Control[slot] = GetHashH2(hash);
+        return node.GetEntry(slot);
+    }
 
-        for (u32 i = 0; i < idx; ++i)
-            if (V *elm = tryInsert(i))
-                return elm;
+    constexpr void erase(const usize idx)
+    {
+        Node &node = m_Buckets[idx / HashGroupSize];
+        const usize slot = idx % HashGroupSize;
+        TKIT_ASSERT(IsHashControlFull(node.Control[slot]),
+                    "[TOOLKIT][HASH-MAP] Iterator must point to an occupied slot to be removed");
 
-        TKIT_FATAL("[TOOLKIT][HASH-MAP] Failed to insert element (this should not be possible)");
-        return nullptr;
+        // Probe sequences only continue past groups without empty slots. If this group still has one, no sequence
+        // goes through it and the slot can be emptied instead of leaving a deleted marker behind
+        if (HashGroup{node.Control}.MatchEmpty())
+            node.Control[slot] = HashControl_Empty;
+        else
+        {
+            node.Control[slot] = HashControl_Deleted;
+            ++m_Deleted;
+        }
+        Destruct(node.GetEntry(slot));
+        --m_Size;
     }
 
-    constexpr usize rehash()
+    static constexpr void relocate(Entry *dst, Entry *src)
     {
-        const usize size = m_Buckets.GetSize();
-        return rehash(size == 0 ? 16 : (2 * size));
+        if constexpr (TriviallyRelocatable<Entry>)
+            ForwardCopy(dst, src, sizeof(Entry));
+        else
+        {
+            Construct(dst, std::move(*src));
+            Destruct(src);
+        }
     }
 
-    constexpr usize rehash(const usize nbuckets)
-        requires(Type != Array_Arena && Type != Array_Stack)
+    // Put every element back where a fresh insertion would, without allocating. Deleted slots are dropped, and the
+    // bucket array may have grown since the elements were placed
+    constexpr void rehashInPlace()
     {
-        TKIT_ASSERT(nbuckets != 0, "[TOOLKIT][HASH-MAP] The bucket count must not be zero");
-        HashMap old = std::move(*this);
+        const usize groups = m_Buckets.GetSize();
+        // Full slots are marked as deleted to flag them as pending, and actual deleted slots become empty
+        for (Node &n : m_Buckets)
+            for (usize i = 0; i < HashGroupSize; ++i)
+                n.Control[i] = IsHashControlFull(n.Control[i]) ? u8(HashControl_Deleted) : u8(HashControl_Empty);
 
-        TKIT_ASSERT(IsPowerOfTwo(nbuckets), "[TOOLKIT][HASH-MAP] The bucket count must be a power of 2, but is {}",
-                    nbuckets);
+        alignas(Entry) std::byte buffer[sizeof(Entry)];
+        Entry *tmp = rcast<Entry *>(buffer);
+        for (usize group = 0; group < groups; ++group)
+        {
+            Node &node = m_Buckets[group];
+            for (usize slot = 0; slot < HashGroupSize; ++slot)
+            {
+                if (node.Control[slot] != HashControl_Deleted)
+                    continue;
+
+                Entry *element = node.GetEntry(slot);
+                const usz hash = hashKey(element->Key);
+                const usize target = findFree(hash, groups);
+                const usize tgroup = target / HashGroupSize;
+                const usize tslot = target % HashGroupSize;
+                if (tgroup == group)
+                {
+                    node.Control[slot] = GetHashH2(hash);
+                    continue;
+                }
 
-        m_Buckets.Resize(nbuckets);
+                Node &tnode = m_Buckets[tgroup];
+                if (tnode.Control[tslot] == HashControl_Empty)
+                {
+                    relocate(tnode.GetEntry(tslot), element);
+                    node.Control[slot] = HashControl_Empty;
+                }
+                else
+                {
+                    // The target holds another pending element. Swap them and process the one brought here next
+                    relocate(tmp, tnode.GetEntry(tslot));
+                    relocate(tnode.GetEntry(tslot), element);
+                    relocate(element, tmp);
+                    --slot;
+                }
+                tnode.Control[tslot] = GetHashH2(hash);
+            }
+        }
+        m_Deleted = 0;
+    }
 
+    constexpr usize rehash(const usize groups)
+        requires(Type != Array_Arena && Type != Array_Stack)
+    {
+        TKIT_ASSERT(IsPowerOfTwo(groups), "[TOOLKIT][HASH-MAP] The group count must be a power of 2, but is {}",
+                    groups);
+        TKIT_ASSERT(groups >= m_Buckets.GetSize(), "[TOOLKIT][HASH-MAP] The group count ({}) cannot shrink below {}",
+                    groups, m_Buckets.GetSize());
         if constexpr (Type == Array_Static)
-            Clear();
+        {
+            // Static storage stays where it is, so the new groups are appended and the elements spread over them
+            const usize old = m_Buckets.GetSize();
+            m_Buckets.Resize(groups);
+            for (usize i = old; i < groups; ++i)
+                setEmpty(m_Buckets[i]);
+            rehashInPlace();
+        }
         else
+        {
+            Array<Node, AllocState> old = std::move(m_Buckets);
+            m_Buckets.Resize(groups);
             setEmpty();
+            m_Size = 0;
+            m_Deleted = 0;
 
-        for (Node &n : old.m_Buckets)
-            if (n.State == HashNode_Occupied)
-            {
-                const Entry *e = n.GetEntry();
-                insert<false>(n.Hash, e->Key, std::move(e->Value));
-            }
+            for (Node &n : old)
+                for (HashGroupMask mask = HashGroup{n.Control}.MatchFull(); mask; mask.ClearLowest())
+                {
+                    Entry *element = n.GetEntry(mask.GetLowest());
+                    relocate(claimSlot(hashKey(element->Key), groups), element);
+                }
+        }
+        return groups;
+    }
 
-        return nbuckets;
+    // Grow so that `size` elements fit under the load factor threshold, if the allocation state allows it. Returns
+    // whether they fit, in which case they can be inserted without checking for rehashes
+    constexpr bool reserve(const usize size)
+    {
+        usize groups = GetHashGroupCount(usize(f32(size) / TKIT_HASH_LOAD_FACTOR_THRESHOLD) + 1);
+        if constexpr (Type == Array_Static)
+            if (groups > m_Buckets.GetCapacity())
+                groups = m_Buckets.GetCapacity();
+        if constexpr (Type != Array_Arena && Type != Array_Stack)
+            if (groups > m_Buckets.GetSize())
+                rehash(groups);
+
+        const f32 threshold = TKIT_HASH_LOAD_FACTOR_THRESHOLD * f32(m_Buckets.GetSize() * HashGroupSize);
+        return f32(size + m_Deleted) < threshold;
     }
 
     constexpr usize maybeRehash()
     {
+        const usize groups = m_Buckets.GetSize();
+        // Deleted slots lengthen probe sequences just like full ones do
+        const f32 threshold = TKIT_HASH_LOAD_FACTOR_THRESHOLD * f32(groups * HashGroupSize);
+        if (groups == 0 || f32(m_Size + m_Deleted) < threshold)
+        {
+            if constexpr (Type != Array_Arena && Type != Array_Stack)
+                if (groups == 0)
+                    return rehash(1);
+            return groups;
+        }
+
+        // When deleted slots make most of the load, dropping them is enough and needs no memory
+        if (f32(m_Size) < 0.5f * threshold)
+        {
+            rehashInPlace();
+            return groups;
+        }
+
         if constexpr (Type == Array_Arena || Type == Array_Stack)
-            return m_Buckets.GetSize();
+            return groups;
         else
         {
-            if (!m_Buckets.IsEmpty() && GetLoadFactor() < TKIT_HASH_LOAD_FACTOR_THRESHOLD)
-                return m_Buckets.GetSize();
-            return rehash();
+            if constexpr (Type == Array_Static)
+                if (2 * groups > m_Buckets.GetCapacity())
+                    return groups;
+            return rehash(2 * groups);
         }
     }
 
     template <typename OtherAlloc> constexpr void copyOp(const Array<Node, OtherAlloc> &buckets)
     {
         for (const Node &n : buckets)
-            if (n.State == HashNode_Occupied)
+            for (HashGroupMask mask = HashGroup{n.Control}.MatchFull(); mask; mask.ClearLowest())
             {
-                const Entry *entry = n.GetEntry();
-                insert<true>(n.Hash, entry->Key, entry->Value);
+                const Entry *entry = n.GetEntry(mask.GetLowest());
+                insert<true>(hashKey(entry->Key), entry->Key, entry->Value);
             }
     }
     template <typename OtherAlloc> constexpr void moveOp(Array<Node, OtherAlloc> &buckets)
     {
         for (Node &n : buckets)
         {
-            if (n.State == HashNode_Occupied)
+            for (HashGroupMask mask = HashGroup{n.Control}.MatchFull(); mask; mask.ClearLowest())
             {
-                Entry *entry = n.GetEntry();
-                insert<true>(n.Hash, entry->Key, std::move(entry->Value));
+                Entry *entry = n.GetEntry(mask.GetLowest());
+                insert<true>(hashKey(entry->Key), entry->Key, std::move(entry->Value));
+                Destruct(entry);
             }
-            n.State = HashNode_Free;
+            setEmpty(n);
         }
     }
 
     Array<Node, AllocState> m_Buckets{};
     usize m_Size = 0;
-};
+    // Slots left behind by removals. They can be reused by insertions but do not end probe sequences
+    usize m_Deleted = 0;
+    TKIT_NO_UNIQUE_ADDRESS Hasher m_Hasher{};
+    TKIT_NO_UNIQUE_ADDRESS KeyEqual m_KeyEqual{};
 
-template <typename K, typename V> using ArenaHashMap = HashMap<K, V, ArenaAllocation<MapNode<K, V>>>;
-template <typename K, typename V> using DynamicHashMap = HashMap<K, V, DynamicAllocation<MapNode<K, V>>>;
-template <typename K, typename V> using StackHashMap = HashMap<K, V, StackAllocation<MapNode<K, V>>>;
-template <typename K, typename V> using TierHashMap = HashMap<K, V, TierAllocation<MapNode<K, V>>>;
+    template <typename, typename, typename, typename, typename> friend class HashMap;
+};
 
-template <typename K, typename V, usize Capacity>
-using StaticHashMap = HashMap<K, V, StaticAllocation<MapNode<K, V>, Capacity>>;
+template <typename K, typename V, typename Hasher = DefaultHasher<K>, typename KeyEqual = DefaultKeyEqual<K>>
+using ArenaHashMap = HashMap<K, V, ArenaAllocation<MapNode<K, V>>, Hasher, KeyEqual>;
+template <typename K, typename V, typename Hasher = DefaultHasher<K>, typename KeyEqual = DefaultKeyEqual<K>>
+using DynamicHashMap = HashMap<K, V, DynamicAllocation<MapNode<K, V>>, Hasher, KeyEqual>;
+template <typename K, typename V, typename Hasher = DefaultHasher<K>, typename KeyEqual = DefaultKeyEqual<K>>
+using StackHashMap = HashMap<K, V, StackAllocation<MapNode<K, V>>, Hasher, KeyEqual>;
+template <typename K, typename V, typename Hasher = DefaultHasher<K>, typename KeyEqual = DefaultKeyEqual<K>>
+using TierHashMap = HashMap<K, V, TierAllocation<MapNode<K, V>>, Hasher, KeyEqual>;
+
+// Capacity is given in slots and rounded up to a power of 2 amount of groups
+template <typename K, typename V, usize Capacity, typename Hasher = DefaultHasher<K>,
+          typename KeyEqual = DefaultKeyEqual<K>>
+using StaticHashMap = HashMap<K, V, StaticAllocation<MapNode<K, V>, GetHashGroupCount(Capacity)>, Hasher, KeyEqual>;
 template <typename K, typename V> using StaticHashMap4 = StaticHashMap<K, V, 4>;
 template <typename K, typename V> using StaticHashMap8 = StaticHashMap<K, V, 8>;
 template <typename K, typename V> using StaticHashMap16 = StaticHashMap<K, V, 16>;
@@ -5,31 +5,38 @@
 #include "tkit/container/stack_array.hpp"
 #include "tkit/container/static_array.hpp"
 #include "tkit/container/tier_array.hpp"
+#include "tkit/container/hash_group.hpp"
+#include "tkit/container/span.hpp"
 #include "tkit/utils/hash.hpp"
 #include "tkit/utils/bit.hpp"
 #include "tkit/utils/limits.hpp"
+#include <ranges>
 
 namespace TKit
 {
-// NOTE(Isma): This is missing some features like custom comparison/hasher and heterogeneous lookup
-// NOTE(Isma): Consider implementing a SwissTable
+/**
+ * @brief A group of `HashGroupSize` hash set slots, laid out like `MapNode`.
+ */
 template <typename K> struct SetNode
 {
-    usz Hash;
-    alignas(K) std::byte Data[sizeof(K)];
-    HashNodeState State = HashNode_Free;
+    u8 Control[HashGroupSize];
+    alignas(K) std::byte Data[HashGroupSize][sizeof(K)];
 
-    constexpr const K *GetKey() const
+    constexpr const K *GetKey(const usize slot) const
     {
-        return rcast<const K *>(Data);
+        return rcast<const K *>(Data[slot]);
     }
-    constexpr K *GetKey()
+    constexpr K *GetKey(const usize slot)
     {
-        return rcast<K *>(Data);
+        return rcast<K *>(Data[slot]);
     }
 };
 
-template <typename K, typename AllocState> class HashSet
+/**
+ * @brief An open addressing hash set in the style of a SwissTable. See `HashMap` for details.
+ */
+template <typename K, typename AllocState, typename Hasher = DefaultHasher<K>, typename KeyEqual = DefaultKeyEqual<K>>
+class HashSet
 {
   public:
     static constexpr ArrayType Type = AllocState::Type;
@@ -37,6 +44,11 @@ template <typename K, typename AllocState> class HashSet
     using KeyType = K;
     using Node = SetNode<K>;
 
+    template <typename Q>
+    static constexpr bool IsLookupKey =
+        TransparentHasher<Hasher> && TransparentHasher<KeyEqual> && std::invocable<const Hasher &, const Q &> &&
+        std::predicate<const KeyEqual &, const Q &, const K &>;
+
     template <typename T> class IteratorImpl
     {
       public:
@@ -45,10 +57,7 @@ template <typename K, typename AllocState> class HashSet
 
         IteratorImpl(BucketArray *buckets) : m_Buckets(buckets), m_Index(0)
         {
-            if (m_Buckets->IsEmpty())
-                m_Index = TKIT_U32_MAX;
-            else if (m_Buckets->At(m_Index).State != HashNode_Occupied)
-                ++(*this);
+            seek(0);
         }
         IteratorImpl(BucketArray *buckets, const usize idx) : m_Buckets(buckets), m_Index(idx)
         {
@@ -78,18 +87,12 @@ template <typename K, typename AllocState> class HashSet
 
         const K &operator*() const
         {
-            return *m_Buckets->At(m_Index).GetKey();
+            return *m_Buckets->At(m_Index / HashGroupSize).GetKey(m_Index % HashGroupSize);
         }
 
         IteratorImpl &operator++()
         {
-            for (u32 i = m_Index + 1; i < m_Buckets->GetSize(); ++i)
-                if (m_Buckets->At(i).State == HashNode_Occupied)
-                {
-                    m_Index = i;
-                    return *this;
-                }
-            m_Index = TKIT_USIZE_MAX;
+            seek(m_Index + 1);
             return *this;
         }
 
@@ -119,6 +122,24 @@ template <typename K, typename AllocState> class HashSet
         }
 
       private:
+        // Point to the first full slot at or after `idx`
+        void seek(const usize idx)
+        {
+            using BitMask = HashGroupMask::BitMask;
+            usize offset = idx % HashGroupSize;
+            for (usize group = idx / HashGroupSize; group < m_Buckets->GetSize(); ++group, offset = 0)
+            {
+                const BitMask full = HashGroup{m_Buckets->At(group).Control}.MatchFull().GetBits();
+                const HashGroupMask mask = BitMask(full & BitMask(~BitMask(0) << offset));
+                if (mask)
+                {
+                    m_Index = group * HashGroupSize + mask.GetLowest();
+                    return;
+                }
+            }
+            m_Index = TKIT_USIZE_MAX;
+        }
+
         BucketArray *m_Buckets;
         usize m_Index;
 
@@ -130,35 +151,45 @@ template <typename K, typename AllocState> class HashSet
     using ConstIterator = IteratorImpl<const K>;
 
     constexpr HashSet() = default;
-    constexpr HashSet(const usize buckets) : m_Buckets(NextPowerOfTwo(buckets))
+    constexpr HashSet(const usize buckets) : m_Buckets(GetHashGroupCount(buckets))
     {
         setEmpty();
     }
     constexpr HashSet(AllocState &&state) : m_Buckets(std::move(state))
     {
     }
-    constexpr HashSet(const usize buckets, AllocState &&state) : m_Buckets(NextPowerOfTwo(buckets), std::move(state))
+    constexpr HashSet(const usize buckets, AllocState &&state)
+        : m_Buckets(GetHashGroupCount(buckets), std::move(state))
+    {
+        setEmpty();
+    }
+    constexpr HashSet(const usize buckets, const Hasher &hasher, const KeyEqual &equal = KeyEqual{})
+        : m_Buckets(GetHashGroupCount(buckets)), m_Hasher(hasher), m_KeyEqual(equal)
+    {
+        setEmpty();
+    }
+    constexpr HashSet(const usize buckets, AllocState &&state, const Hasher &hasher,
+                      const KeyEqual &equal = KeyEqual{})
+        : m_Buckets(GetHashGroupCount(buckets), std::move(state)), m_Hasher(hasher), m_KeyEqual(equal)
     {
         setEmpty();
     }
 
     template <std::input_iterator It> constexpr HashSet(const It pbegin, const It pend)
     {
-        for (const It it = pbegin; it != pend; ++it)
-            Insert(*it);
+        InsertBulk(pbegin, pend);
     }
 
     constexpr HashSet(const std::initializer_list<K> list)
     {
-        for (const K &pair : list)
-            Insert(pair);
+        InsertBulk(list.begin(), list.end());
     }
 
-    constexpr HashSet(const HashSet &other)
+    constexpr HashSet(const HashSet &other) : m_Hasher(other.m_Hasher), m_KeyEqual(other.m_KeyEqual)
     {
         copyOp(other.m_Buckets);
     }
-    constexpr HashSet(HashSet &&other)
+    constexpr HashSet(HashSet &&other) : m_Hasher(other.m_Hasher), m_KeyEqual(other.m_KeyEqual)
     {
         if constexpr (Type == Array_Static)
             copyOp(other.m_Buckets);
@@ -166,15 +197,21 @@ template <typename K, typename AllocState> class HashSet
         {
             m_Buckets = std::move(other.m_Buckets);
             m_Size = other.m_Size;
+            m_Deleted = other.m_Deleted;
             other.m_Size = 0;
+            other.m_Deleted = 0;
         }
     }
 
-    template <typename OtherAlloc> constexpr HashSet(const HashSet<K, OtherAlloc> &other)
+    template <typename OtherAlloc>
+    constexpr HashSet(const HashSet<K, OtherAlloc, Hasher, KeyEqual> &other)
+        : m_Hasher(other.m_Hasher), m_KeyEqual(other.m_KeyEqual)
     {
         copyOp(other.m_Buckets);
     }
-    template <typename OtherAlloc> constexpr HashSet(HashSet<K, OtherAlloc> &&other)
+    template <typename OtherAlloc>
+    constexpr HashSet(HashSet<K, OtherAlloc, Hasher, KeyEqual> &&other)
+        : m_Hasher(other.m_Hasher), m_KeyEqual(other.m_KeyEqual)
     {
         copyOp(other.m_Buckets);
     }
@@ -187,127 +224,209 @@ template <typename K, typename AllocState> class HashSet
     constexpr HashSet &operator=(const HashSet &other)
     {
         Clear();
+        m_Hasher = other.m_Hasher;
+        m_KeyEqual = other.m_KeyEqual;
         copyOp(other.m_Buckets);
         return *this;
     }
     constexpr HashSet &operator=(HashSet &&other)
     {
         Clear();
+        m_Hasher = other.m_Hasher;
+        m_KeyEqual = other.m_KeyEqual;
         if constexpr (Type == Array_Static)
             copyOp(other.m_Buckets);
         else
         {
             m_Buckets = std::move(other.m_Buckets);
             m_Size = other.m_Size;
+            m_Deleted = other.m_Deleted;
             other.m_Size = 0;
+            other.m_Deleted = 0;
         }
         return *this;
     }
-    template <typename OtherAlloc> constexpr HashSet &operator=(const HashSet<K, OtherAlloc> &other)
+    template <typename OtherAlloc>
+    constexpr HashSet &operator=(const HashSet<K, OtherAlloc, Hasher, KeyEqual> &other)
     {
         Clear();
+        m_Hasher = other.m_Hasher;
+        m_KeyEqual = other.m_KeyEqual;
         copyOp(other.m_Buckets);
         return *this;
     }
-    template <typename OtherAlloc> constexpr HashSet &operator=(HashSet<K, OtherAlloc> &&other)
+    template <typename OtherAlloc>
+    constexpr HashSet &operator=(HashSet<K, OtherAlloc, Hasher, KeyEqual> &&other)
     {
         Clear();
+        m_Hasher = other.m_Hasher;
+        m_KeyEqual = other.m_KeyEqual;
         copyOp(other.m_Buckets);
         return *this;
     }
 
     constexpr void Clear()
     {
-        if (m_Size == 0)
+        if (m_Size == 0 && m_Deleted == 0)
             return;
         for (Node &n : m_Buckets)
         {
-            if (n.State == HashNode_Occupied)
-            {
-                if constexpr (!std::is_trivially_destructible_v<K>)
-                    Destruct(n.GetKey());
-            }
-            n.State = HashNode_Free;
+            if constexpr (!std::is_trivially_destructible_v<K>)
+                for (HashGroupMask mask = HashGroup{n.Control}.MatchFull(); mask; mask.ClearLowest())
+                    Destruct(n.GetKey(mask.GetLowest()));
+            setEmpty(n);
         }
         m_Size = 0;
+        m_Deleted = 0;
     }
 
     constexpr const K &Insert(const K &key)
     {
-        return *insert(Hash(key), key);
+        return *insert(hashKey(key), key);
     }
 
     template <typename... Args> constexpr const K &TryInsert(const K &key, bool *didExist = nullptr)
     {
-        const usz hash = Hash(key);
-        const usize idx = find<true>(key, hash);
+        const usz hash = hashKey(key);
+        const usize idx = find(key, hash);
 
-        Node &node = m_Buckets[idx];
-        const bool occupied = node.State == HashNode_Occupied;
+        const bool exists = idx != TKIT_USIZE_MAX;
         if (didExist)
-            *didExist = occupied;
+            *didExist = exists;
 
-        if (occupied)
-            return *node.GetKey();
+        if (exists)
+            return *getKey(idx);
+        return *insert(hash, key);
+    }
 
-        maybeRehash();
-        ++m_Size;
-        node.Hash = hash;
-        node.State = HashNode_Occupied;
-        return *Construct(node.GetKey(), key);
+    /**
+     * @brief Insert a range of keys, as if by calling `Insert()` with each one of them.
+     *
+     * Keys must not be in the set already. If the range can be traversed more than once, the set grows to fit all of
+     * its elements before inserting any of them, and keys are hashed in batches ahead of their insertion so that the
+     * groups they land in can be prefetched.
+     */
+    template <std::input_iterator It, std::sentinel_for<It> S> constexpr void InsertBulk(const It pbegin, const S pend)
+    {
+        if constexpr (!std::forward_iterator<It>)
+        {
+            for (It it = pbegin; it != pend; ++it)
+                Insert(*it);
+        }
+        else
+        {
+            const bool fits = reserve(m_Size + usize(std::ranges::distance(pbegin, pend)));
+            usz hashes[BatchSize];
+            for (It it = pbegin; it != pend;)
+            {
+                It batch = it;
+                usize count = 0;
+                for (; count < BatchSize && it != pend; ++it, ++count)
+                {
+                    const K &key = *it;
+                    hashes[count] = hashKey(key);
+                }
+                for (usize i = 0; i < count; ++i, ++batch)
+                {
+                    if (!fits)
+                    {
+                        insert<true>(hashes[i], *batch);
+                        continue;
+                    }
+                    if (i + PrefetchDistance < count)
+                        prefetch(hashes[i + PrefetchDistance]);
+                    insert<false>(hashes[i], *batch);
+                }
+            }
+        }
+    }
+    template <std::ranges::input_range R> constexpr void InsertBulk(R &&range)
+    {
+        InsertBulk(std::ranges::begin(range), std::ranges::end(range));
     }
 
     constexpr ConstIterator Find(const K &key) const
     {
-        return ConstIterator{&m_Buckets, find(key, Hash(key))};
+        return ConstIterator{&m_Buckets, find(key, hashKey(key))};
     }
     constexpr Iterator Find(const K &key)
     {
-        return Iterator{&m_Buckets, find(key, Hash(key))};
+        return Iterator{&m_Buckets, find(key, hashKey(key))};
+    }
+
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr ConstIterator Find(const Q &key) const
+    {
+        return ConstIterator{&m_Buckets, find(key, hashKey(key))};
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr Iterator Find(const Q &key)
+    {
+        return Iterator{&m_Buckets, find(key, hashKey(key))};
     }
 
     constexpr bool Contains(const K &key) const
     {
-        return Find(key) != end();
+        return find(key, hashKey(key)) != TKIT_USIZE_MAX;
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr bool Contains(const Q &key) const
+    {
+        return find(key, hashKey(key)) != TKIT_USIZE_MAX;
+    }
+
+    /**
+     * @brief Look up several keys at once, writing a pointer to the stored key (or `nullptr` if it is not in the set)
+     * to the corresponding position of `out`.
+     *
+     * Keys are hashed in batches, and the groups of upcoming keys are prefetched while the current one is resolved,
+     * which hides most of the memory latency when the set does not fit in cache.
+     *
+     * @return The amount of keys found.
+     */
+    constexpr usize FindBatch(const Span<const K> keys, const Span<const K *> out) const
+    {
+        return findBatch(keys, out);
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr usize FindBatch(const Span<const Q> keys, const Span<const K *> out) const
+    {
+        return findBatch(keys, out);
     }
 
     constexpr Iterator Remove(const Iterator iter)
     {
         TKIT_ASSERT(m_Size != 0, "[TOOLKIT][HASH-SET] Cannot remove an element when the size is 0");
         const Iterator next = iter.Next();
-
-        Node &node = iter.m_Buckets->At(iter.m_Index);
-        TKIT_ASSERT(node.State == HashNode_Occupied,
-                    "[TOOLKIT][HASH-SET] Iterator must point to an occupied slot to be removed");
-
-        node.State = HashNode_Tombstone;
-        Destruct(node.GetKey());
-        --m_Size;
+        erase(iter.m_Index);
         return next;
     }
 
     constexpr bool Remove(const K &key)
     {
-        const usize idx = find(key, Hash(key));
-        if (idx == TKIT_USIZE_MAX)
-            return false;
-
-        Node &node = m_Buckets[idx];
-        node.State = HashNode_Tombstone;
-        Destruct(node.GetKey());
-        --m_Size;
-        return true;
+        return remove(key);
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    constexpr bool Remove(const Q &key)
+    {
+        return remove(key);
     }
 
     constexpr f32 GetLoadFactor() const
     {
-        return f32(m_Size) / f32(m_Buckets.GetSize());
+        return f32(m_Size) / f32(GetBucketCount());
     }
 
     constexpr void Rehash(const usize buckets)
     {
-        if (buckets > m_Buckets.GetSize())
-            rehash(NextPowerOfTwo(buckets));
+        const usize groups = GetHashGroupCount(buckets);
+        if (groups > m_Buckets.GetSize())
+            rehash(groups);
     }
 
     constexpr usize GetSize() const
@@ -316,7 +435,7 @@ template <typename K, typename AllocState> class HashSet
     }
     constexpr usize GetBucketCount() const
     {
-        return m_Buckets.GetSize();
+        return m_Buckets.GetSize() * HashGroupSize;
     }
 
     constexpr ConstIterator begin() const
@@ -342,144 +461,352 @@ template <typename K, typename AllocState> class HashSet
         return m_Size == 0;
     }
 
+    constexpr const Hasher &GetHasher() const
+    {
+        return m_Hasher;
+    }
+    constexpr const KeyEqual &GetKeyEqual() const
+    {
+        return m_KeyEqual;
+    }
+
   private:
-    void setEmpty()
+    // Keys hashed ahead by bulk operations, and how far ahead of the current key their groups are prefetched
+    static constexpr usize BatchSize = 64;
+    static constexpr usize PrefetchDistance = 8;
+
+    template <typename Q> constexpr usz hashKey(const Q &key) const
+    {
+        if constexpr (AvalanchingHasher<Hasher>)
+            return usz(m_Hasher(key));
+        else
+            return MixHash(usz(m_Hasher(key)));
+    }
+
+    static constexpr void setEmpty(Node &node)
+    {
+        for (usize i = 0; i < HashGroupSize; ++i)
+            node.Control[i] = HashControl_Empty;
+    }
+    constexpr void setEmpty()
     {
         for (Node &n : m_Buckets)
-            n.State = HashNode_Free;
+            setEmpty(n);
     }
-    template <bool GetInsertSpot = false> usize find(const K &key, const usz hash) const
+
+    constexpr const K *getKey(const usize idx) const
     {
-        const usize buckets = m_Buckets.GetSize();
-        if (buckets == 0)
-            return TKIT_USIZE_MAX;
+        return m_Buckets[idx / HashGroupSize].GetKey(idx % HashGroupSize);
+    }
 
-        const usize idx = usize(hash & (buckets - 1));
+    template <typename Q> constexpr usize find(const Q &key, const usz hash) const
+    {
+        const usize groups = m_Buckets.GetSize();
+        if (groups == 0)
+            return TKIT_USIZE_MAX;
 
-        usize found = TKIT_USIZE_MAX;
-        const auto tryFind = [&](const usize i) {
-            const Node &node = m_Buckets[i];
-            if (node.State == HashNode_Free)
+        const u8 h2 = GetHashH2(hash);
+        HashProbe probe{hash, groups};
+        for (usize i = 0; i < groups; ++i, probe.Next())
+        {
+            const Node &node = m_Buckets[probe.GetGroup()];
+            const HashGroup group{node.Control};
+            for (HashGroupMask mask = group.Match(h2); mask; mask.ClearLowest())
             {
-                if constexpr (GetInsertSpot)
-                    if (found == TKIT_USIZE_MAX)
-                        found = i;
-                return true;
+                const usize slot = mask.GetLowest();
+                if (m_KeyEqual(key, *node.GetKey(slot)))
+                    return probe.GetGroup() * HashGroupSize + slot;
             }
-            if constexpr (GetInsertSpot)
-                if (node.State == HashNode_Tombstone && found == TKIT_USIZE_MAX)
-                    found = i;
+            if (group.MatchEmpty())
+                return TKIT_USIZE_MAX;
+        }
+        return TKIT_USIZE_MAX;
+    }
 
-            if (node.State == HashNode_Tombstone || node.Hash != hash || key != *node.GetKey())
-                return false;
+    // Only the control bytes are prefetched, as they are all a probe needs to rule out a group
+    void prefetch(const usz hash) const
+    {
+        const HashProbe probe{hash, m_Buckets.GetSize()};
+        TKIT_PREFETCH(m_Buckets.GetData() + probe.GetGroup());
+    }
 
-            found = i;
-            return true;
-        };
+    template <typename Q> constexpr usize findBatch(const Span<const Q> keys, const Span<const K *> out) const
+    {
+        TKIT_ASSERT(out.GetSize() >= keys.GetSize(),
+                    "[TOOLKIT][HASH-SET] The output span ({}) must be at least as big as the key span ({})",
+                    out.GetSize(), keys.GetSize());
+        if (m_Size == 0)
+        {
+            for (usize i = 0; i < keys.GetSize(); ++i)
+                out[i] = nullptr;
+            return 0;
+        }
 
-        for (u32 i = idx; i < buckets; ++i)
-            if (tryFind(i))
-                return found;
-        for (u32 i = 0; i < idx; ++i)
-            if (tryFind(i))
-                return found;
+        usz hashes[BatchSize];
+        usize found = 0;
+        for (usize begin = 0; begin < keys.GetSize(); begin += BatchSize)
+        {
+            const usize count = keys.GetSize() - begin < BatchSize ? keys.GetSize() - begin : BatchSize;
+            for (usize i = 0; i < count; ++i)
+                hashes[i] = hashKey(keys[begin + i]);
+            for (usize i = 0; i < count && i < PrefetchDistance; ++i)
+                prefetch(hashes[i]);
 
+            for (usize i = 0; i < count; ++i)
+            {
+                if (i + PrefetchDistance < count)
+                    prefetch(hashes[i + PrefetchDistance]);
+                const usize idx = find(keys[begin + i], hashes[i]);
+                out[begin + i] = idx == TKIT_USIZE_MAX ? nullptr : getKey(idx);
+                found += idx != TKIT_USIZE_MAX;
+            }
+        }
         return found;
     }
 
+    template <typename Q> constexpr bool remove(const Q &key)
+    {
+        const usize idx = find(key, hashKey(key));
+        if (idx == TKIT_USIZE_MAX)
+            return false;
+
+        erase(idx);
+        return true;
+    }
+
     template <bool Rehash = true> constexpr const K *insert(const usz hash, const K &key)
     {
-        const usize buckets = Rehash ? maybeRehash() : m_Buckets.GetSize();
-        const usize idx = usize(hash & (buckets - 1));
-        ++m_Size;
-        TKIT_ASSERT(
-            m_Size <= buckets,
-            "[TOOLKIT][HASH-SET] The size of the hash map ({}) exceeds the buckets of the underlying array ({})",
-            m_Size, buckets);
+        const usize groups = Rehash ? maybeRehash() : m_Buckets.GetSize();
+        return Construct(claimSlot(hash, groups), key);
+    }
 
-        const auto tryInsert = [&](const usize i) -> const K * {
-            Node &node = m_Buckets[i];
-            if (node.State == HashNode_Occupied)
-                return nullptr;
+    // Find the first slot in the probe sequence of `hash` that is not full
+    constexpr usize findFree(const usz hash, const usize groups) const
+    {
+        HashProbe probe{hash, groups};
+        for (usize i = 0; i < groups; ++i, probe.Next())
+        {
+            const HashGroupMask mask = HashGroup{m_Buckets[probe.GetGroup()].Control}.MatchEmptyOrDeleted();
+            if (mask)
+                return probe.GetGroup() * HashGroupSize + mask.GetLowest();
+        }
+        return TKIT_USIZE_MAX;
+    }
 
-            node.Hash = hash;
-            node.State = HashNode_Occupied;
-            return Construct(node.GetKey(), key);
-        };
+    // Mark the first slot that is not full as full. The key must not be in the set already
+    constexpr K *claimSlot(const usz hash, const usize groups)
+    {
+        ++m_Size;
+        TKIT_ASSERT(m_Size <= groups * HashGroupSize,
+                    "[TOOLKIT][HASH-SET] The size of the hash set ({}) exceeds the bucket count ({})", m_Size,
+                    groups * HashGroupSize);
 
-        for (u32 i = idx; i < buckets; ++i)
-            if (const K *elm = tryInsert(i))
-                return elm;
+        const usize idx = findFree(hash, groups);
+        TKIT_ASSERT(idx != TKIT_USIZE_MAX,
+                    "[TOOLKIT][HASH-SET] Failed to insert element (this should not be possible)");
 
-        for (u32 i = 0; i < idx; ++i)
-            if (const K *elm = tryInsert(i))
-                return elm;
+        Node &node = m_Buckets[idx / HashGroupSize];
+        const usize slot = idx % HashGroupSize;
+        if (node.Control[slot] == HashControl_Deleted)
+            --m_Deleted;
+        node.Control[slot] = GetHashH2(hash);
+        return node.GetKey(slot);
+    }
 
-        TKIT_FATAL("[TOOLKIT][HASH-SET] Failed to insert element (this should not be possible)");
-        return nullptr;
+    constexpr void erase(const usize idx)
+    {
+        Node &node = m_Buckets[idx / HashGroupSize];
+        const usize slot = idx % HashGroupSize;
+        TKIT_ASSERT(IsHashControlFull(node.Control[slot]),
+                    "[TOOLKIT][HASH-SET] Iterator must point to an occupied slot to be removed");
+
+        // Probe sequences only continue past groups without empty slots. If this group still has one, no sequence
+        // goes through it and the slot can be emptied instead of leaving a deleted marker behind
+        if (HashGroup{node.Control}.MatchEmpty())
+            node.Control[slot] = HashControl_Empty;
+        else
+        {
+            node.Control[slot] = HashControl_Deleted;
+            ++m_Deleted;
+        }
+        Destruct(node.GetKey(slot));
+        --m_Size;
     }
 
-    constexpr usize rehash()
+    static constexpr void relocate(K *dst, K *src)
     {
-        const usize size = m_Buckets.GetSize();
-        return rehash(size == 0 ? 16 : (2 * size));
+        if constexpr (TriviallyRelocatable<K>)
+            ForwardCopy(dst, src, sizeof(K));
+        else
+        {
+            Construct(dst, std::move(*src));
+            Destruct(src);
+        }
     }
 
-    constexpr usize rehash(const usize nbuckets)
-        requires(Type != Array_Arena && Type != Array_Stack)
+    // Put every element back where a fresh insertion would, without allocating. Deleted slots are dropped, and the
+    // bucket array may have grown since the elements were placed
+    constexpr void rehashInPlace()
     {
-        TKIT_ASSERT(nbuckets != 0, "[TOOLKIT][HASH-MAP] The bucket count must not be zero");
-        HashSet old = std::move(*this);
+        const usize groups = m_Buckets.GetSize();
+        // Full slots are marked as deleted to flag them as pending, and actual deleted slots become empty
+        for (Node &n : m_Buckets)
+            for (usize i = 0; i < HashGroupSize; ++i)
+                n.Control[i] = IsHashControlFull(n.Control[i]) ? u8(HashControl_Deleted) : u8(HashControl_Empty);
 
-        TKIT_ASSERT(IsPowerOfTwo(nbuckets), "[TOOLKIT][HASH-SET] The bucket count must be a power of 2, but is {}",
-                    nbuckets);
-        m_Buckets.Resize(nbuckets);
+        alignas(K) std::byte buffer[sizeof(K)];
+        K *tmp = rcast<K *>(buffer);
+        for (usize group = 0; group < groups; ++group)
+        {
+            Node &node = m_Buckets[group];
+            for (usize slot = 0; slot < HashGroupSize; ++slot)
+            {
+                if (node.Control[slot] != HashControl_Deleted)
+                    continue;
+
+                K *element = node.GetKey(slot);
+                const usz hash = hashKey(*element);
+                const usize target = findFree(hash, groups);
+                const usize tgroup = target / HashGroupSize;
+                const usize tslot = target % HashGroupSize;
+                if (tgroup == group)
+                {
+                    node.Control[slot] = GetHashH2(hash);
+                    continue;
+                }
 
+                Node &tnode = m_Buckets[tgroup];
+                if (tnode.Control[tslot] == HashControl_Empty)
+                {
+                    relocate(tnode.GetKey(tslot), element);
+                    node.Control[slot] = HashControl_Empty;
+                }
+                else
+                {
+                    // The target holds another pending element. Swap them and process the one brought here next
+                    relocate(tmp, tnode.GetKey(tslot));
+                    relocate(tnode.GetKey(tslot), element);
+                    relocate(element, tmp);
+                    --slot;
+                }
+                tnode.Control[tslot] = GetHashH2(hash);
+            }
+        }
+        m_Deleted = 0;
+    }
+
+    constexpr usize rehash(const usize groups)
+        requires(Type != Array_Arena && Type != Array_Stack)
+    {
+        TKIT_ASSERT(IsPowerOfTwo(groups), "[TOOLKIT][HASH-SET] The group count must be a power of 2, but is {}",
+                    groups);
+        TKIT_ASSERT(groups >= m_Buckets.GetSize(), "[TOOLKIT][HASH-SET] The group count ({}) cannot shrink below {}",
+                    groups, m_Buckets.GetSize());
         if constexpr (Type == Array_Static)
-            Clear();
+        {
+            // Static storage stays where it is, so the new groups are appended and the elements spread over them
+            const usize old = m_Buckets.GetSize();
+            m_Buckets.Resize(groups);
+            for (usize i = old; i < groups; ++i)
+                setEmpty(m_Buckets[i]);
+            rehashInPlace();
+        }
         else
+        {
+            Array<Node, AllocState> old = std::move(m_Buckets);
+            m_Buckets.Resize(groups);
             setEmpty();
-        for (Node &n : old.m_Buckets)
-            if (n.State == HashNode_Occupied)
-            {
-                const K *key = n.GetKey();
-                insert<false>(n.Hash, *key);
-            }
-        return nbuckets;
+            m_Size = 0;
+            m_Deleted = 0;
+
+            for (Node &n : old)
+                for (HashGroupMask mask = HashGroup{n.Control}.MatchFull(); mask; mask.ClearLowest())
+                {
+                    K *element = n.GetKey(mask.GetLowest());
+                    relocate(claimSlot(hashKey(*element), groups), element);
+                }
+        }
+        return groups;
+    }
+
+    // Grow so that `size` elements fit under the load factor threshold, if the allocation state allows it. Returns
+    // whether they fit, in which case they can be inserted without checking for rehashes
+    constexpr bool reserve(const usize size)
+    {
+        usize groups = GetHashGroupCount(usize(f32(size) / TKIT_HASH_LOAD_FACTOR_THRESHOLD) + 1);
+        if constexpr (Type == Array_Static)
+            if (groups > m_Buckets.GetCapacity())
+                groups = m_Buckets.GetCapacity();
+        if constexpr (Type != Array_Arena && Type != Array_Stack)
+            if (groups > m_Buckets.GetSize())
+                rehash(groups);
+
+        const f32 threshold = TKIT_HASH_LOAD_FACTOR_THRESHOLD * f32(m_Buckets.GetSize() * HashGroupSize);
+        return f32(size + m_Deleted) < threshold;
     }
 
     constexpr usize maybeRehash()
     {
+        const usize groups = m_Buckets.GetSize();
+        // Deleted slots lengthen probe sequences just like full ones do
+        const f32 threshold = TKIT_HASH_LOAD_FACTOR_THRESHOLD * f32(groups * HashGroupSize);
+        if (groups == 0 || f32(m_Size + m_Deleted) < threshold)
+        {
+            if constexpr (Type != Array_Arena && Type != Array_Stack)
+                if (groups == 0)
+                    return rehash(1);
+            return groups;
+        }
+
+        // When deleted slots make most of the load, dropping them is enough and needs no memory
+        if (f32(m_Size) < 0.5f * threshold)
+        {
+            rehashInPlace();
+            return groups;
+        }
+
         if constexpr (Type == Array_Arena || Type == Array_Stack)
-            return m_Buckets.GetSize();
+            return groups;
         else
         {
-            if (!m_Buckets.IsEmpty() && GetLoadFactor() < TKIT_HASH_LOAD_FACTOR_THRESHOLD)
-                return m_Buckets.GetSize();
-            return rehash();
+            if constexpr (Type == Array_Static)
+                if (2 * groups > m_Buckets.GetCapacity())
+                    return groups;
+            return rehash(2 * groups);
         }
     }
 
     template <typename OtherAlloc> constexpr void copyOp(const Array<Node, OtherAlloc> &buckets)
     {
         for (const Node &n : buckets)
-            if (n.State == HashNode_Occupied)
+            for (HashGroupMask mask = HashGroup{n.Control}.MatchFull(); mask; mask.ClearLowest())
             {
-                const K *key = n.GetKey();
-                insert(n.Hash, *key);
+                const K *key = n.GetKey(mask.GetLowest());
+                insert(hashKey(*key), *key);
             }
     }
 
     Array<Node, AllocState> m_Buckets{};
     usize m_Size = 0;
-};
+    usize m_Deleted = 0;
+    TKIT_NO_UNIQUE_ADDRESS Hasher m_Hasher{};
+    TKIT_NO_UNIQUE_ADDRESS KeyEqual m_KeyEqual{};
 
-template <typename K> using ArenaHashSet = HashSet<K, ArenaAllocation<SetNode<K>>>;
-template <typename K> using DynamicHashSet = HashSet<K, DynamicAllocation<SetNode<K>>>;
-template <typename K> using StackHashSet = HashSet<K, StackAllocation<SetNode<K>>>;
-template <typename K> using TierHashSet = HashSet<K, TierAllocation<SetNode<K>>>;
+    template <typename, typename, typename, typename> friend class HashSet;
+};
 
-template <typename K, usize Capacity> using StaticHashSet = HashSet<K, StaticAllocation<SetNode<K>, Capacity>>;
+template <typename K, typename Hasher = DefaultHasher<K>, typename KeyEqual = DefaultKeyEqual<K>>
+using ArenaHashSet = HashSet<K, ArenaAllocation<SetNode<K>>, Hasher, KeyEqual>;
+template <typename K, typename Hasher = DefaultHasher<K>, typename KeyEqual = DefaultKeyEqual<K>>
+using DynamicHashSet = HashSet<K, DynamicAllocation<SetNode<K>>, Hasher, KeyEqual>;
+template <typename K, typename Hasher = DefaultHasher<K>, typename KeyEqual = DefaultKeyEqual<K>>
+using StackHashSet = HashSet<K, StackAllocation<SetNode<K>>, Hasher, KeyEqual>;
+template <typename K, typename Hasher = DefaultHasher<K>, typename KeyEqual = DefaultKeyEqual<K>>
+using TierHashSet = HashSet<K, TierAllocation<SetNode<K>>, Hasher, KeyEqual>;
+
+// Capacity is given in slots and rounded up to a power of 2 amount of groups
+template <typename K, usize Capacity, typename Hasher = DefaultHasher<K>, typename KeyEqual = DefaultKeyEqual<K>>
+using StaticHashSet = HashSet<K, StaticAllocation<SetNode<K>, GetHashGroupCount(Capacity)>, Hasher, KeyEqual>;
 template <typename K> using StaticHashSet4 = StaticHashSet<K, 4>;
 template <typename K> using StaticHashSet8 = StaticHashSet<K, 8>;
 template <typename K> using StaticHashSet16 = StaticHashSet<K, 16>;
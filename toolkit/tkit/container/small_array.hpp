@@ -0,0 +1,185 @@
+#pragma once
+
+#include "tkit/container/dynamic_array.hpp"
+#include "tkit/container/tier_array.hpp"
+
+namespace TKit
+{
+/**
+ * @brief An allocation state that keeps up to `N` elements inside of the array itself, and only falls back to the
+ * allocation state `Spill` (the heap by default) once it needs more room.
+ *
+ * `Data` always points to the active buffer, which is the inline one while the array is not spilled. Because of this,
+ * arrays using this state are not trivially relocatable.
+ *
+ * @tparam T The type of the elements.
+ * @tparam N The amount of elements that fit inline.
+ * @tparam Spill The allocation state used for buffers that do not fit inline. Must be `DynamicAllocation<T>` or
+ * `TierAllocation<T>`.
+ */
+template <typename T, usize N, typename Spill = DynamicAllocation<T>> struct SmallAllocation
+{
+    static_assert(N != 0, "[TOOLKIT][SMALL-ARRAY] The inline capacity must be greater than 0");
+    static_assert(Spill::Type == Array_Dynamic || Spill::Type == Array_Tier,
+                  "[TOOLKIT][SMALL-ARRAY] Small arrays can only spill to dynamic or tier allocations");
+
+    static constexpr ArrayType Type = Array_Small;
+    template <typename U> using Rebind = SmallAllocation<U, N, typename Spill::template Rebind<U>>;
+
+    struct alignas(T) Element
+    {
+        std::byte Data[sizeof(T)];
+    };
+
+    SmallAllocation() = default;
+    SmallAllocation(const usize capacity)
+    {
+        Allocate(capacity);
+    }
+    SmallAllocation(TierAllocator *allocator)
+        requires(Spill::Type == Array_Tier)
+        : Heap(allocator)
+    {
+    }
+
+    SmallAllocation(const SmallAllocation &) = delete;
+    SmallAllocation(SmallAllocation &&other)
+    {
+        *this = std::move(other);
+    }
+
+    SmallAllocation &operator=(const SmallAllocation &) = delete;
+    SmallAllocation &operator=(SmallAllocation &&other)
+    {
+        TKIT_ASSERT(Size == 0 && !IsSpilled(),
+                    "[TOOLKIT][SMALL-ARRAY] Cannot move into an array state that still holds elements or memory");
+        // The spill state is taken even if unused, as it may carry an allocator
+        Heap = std::move(other.Heap);
+        if (other.IsSpilled())
+        {
+            Data = other.Data;
+            Capacity = other.Capacity;
+            other.Data = other.getInline();
+            other.Capacity = N;
+        }
+        else
+            RelocateRange(getInline(), other.Data, other.Data + other.Size);
+
+        Size = other.Size;
+        other.Size = 0;
+        return *this;
+    }
+
+    void Allocate(const usize capacity)
+    {
+        TKIT_ASSERT(
+            Size == 0,
+            "[TOOLKIT][SMALL-ARRAY] Cannot allocate while the array has {} active allocations. Call Clear() first",
+            Size);
+        TKIT_ASSERT(!IsSpilled(), "[TOOLKIT][SMALL-ARRAY] Cannot allocate with an active allocation of capacity {}",
+                    Capacity);
+        if (capacity > N)
+            spill(capacity);
+    }
+
+    void Deallocate()
+    {
+        TKIT_ASSERT(Size == 0, "[TOOLKIT][SMALL-ARRAY] Cannot deallocate buffer while it is not empty. Size is {}",
+                    Size);
+        if (IsSpilled())
+        {
+            Heap.Deallocate();
+            Data = getInline();
+            Capacity = N;
+        }
+    }
+    constexpr usize GetCapacity() const
+    {
+        return Capacity;
+    }
+    constexpr bool IsSpilled() const
+    {
+        return Data != getInline();
+    }
+
+    void GrowCapacityIf(const bool shouldGrow, const usize size)
+    {
+        if (shouldGrow)
+            GrowCapacity(size);
+    }
+    // Shrinking to `N` elements or less moves them back into the inline buffer
+    void ModifyCapacity(const usize capacity)
+    {
+        TKIT_ASSERT(capacity != 0, "[TOOLKIT][SMALL-ARRAY] Capacity must be greater than 0");
+        TKIT_ASSERT(capacity >= Size, "[TOOLKIT][SMALL-ARRAY] Capacity ({}) is smaller than size ({})", capacity,
+                    Size);
+        if (!IsSpilled())
+        {
+            if (capacity > N)
+                spill(capacity);
+            return;
+        }
+        if (capacity <= N)
+        {
+            RelocateRange(getInline(), Data, Data + Size);
+            Heap.Deallocate();
+            Data = getInline();
+            Capacity = N;
+            return;
+        }
+
+        // The spill state relocates its own elements, so it is briefly told how many there are
+        Heap.Size = Size;
+        Heap.ModifyCapacity(capacity);
+        Heap.Size = 0;
+        Data = Heap.Data;
+        Capacity = capacity;
+    }
+    // Unlike other states, growing is a no-op when the inline buffer can already hold `size` elements, as it is always
+    // there
+    void GrowCapacity(const usize size)
+    {
+        if (size > Capacity)
+            ModifyCapacity(Container::GrowthFactor(size));
+    }
+
+    Element Buffer[N];
+    Spill Heap{};
+    T *Data = getInline();
+    usize Size = 0;
+    usize Capacity = N;
+
+  private:
+    T *getInline()
+    {
+        return rcast<T *>(Buffer);
+    }
+    const T *getInline() const
+    {
+        return rcast<const T *>(Buffer);
+    }
+
+    void spill(const usize capacity)
+    {
+        Heap.Allocate(capacity);
+        RelocateRange(Heap.Data, Data, Data + Size);
+        Data = Heap.Data;
+        Capacity = capacity;
+    }
+};
+
+template <typename T, usize N> using SmallArray = Array<T, SmallAllocation<T, N>>;
+template <usize N> using SmallString = Array<char, SmallAllocation<char, N + 1>>;
+
+// Spilled buffers come from the tier allocator the array was created with or, if none, the pushed one at the time of
+// the first spill
+template <typename T, usize N> using SmallTierArray = Array<T, SmallAllocation<T, N, TierAllocation<T>>>;
+template <usize N> using SmallTierString = Array<char, SmallAllocation<char, N + 1, TierAllocation<char>>>;
+
+template <typename T> using SmallArray4 = SmallArray<T, 4>;
+template <typename T> using SmallArray8 = SmallArray<T, 8>;
+template <typename T> using SmallArray16 = SmallArray<T, 16>;
+
+using SmallString16 = SmallString<16>;
+using SmallString32 = SmallString<32>;
+} // namespace TKit
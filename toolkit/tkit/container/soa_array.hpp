@@ -0,0 +1,464 @@
+#pragma once
+
+#include "tkit/container/container.hpp"
+#include "tkit/container/fixed_array.hpp"
+#include "tkit/container/span.hpp"
+#include "tkit/memory/memory.hpp"
+#include "tkit/reflection/reflect.hpp"
+#include "tkit/utils/bit.hpp"
+#include <tuple>
+#include <utility>
+
+namespace TKit
+{
+/**
+ * @brief A dynamic array that stores every member field of `T` in its own column, so that loops that only touch a
+ * few fields of each element only load those fields into cache.
+ *
+ * The fields are taken from the reflection metadata of `T`, so the code generated by the reflection system for `T` must
+ * be included before the array is instantiated. Static fields are ignored.
+ *
+ * All columns share a single allocation. Each one starts at an `Alignment` boundary and is padded to a multiple of
+ * `Alignment` bytes, so that columns can be processed with aligned SIMD loads (such as `Simd::Wide::LoadAligned()`),
+ * and the last load of a column may read past its last element without leaving the allocation.
+ *
+ * Elements are accessed through proxies that read and write the fields in their columns. `At()` and `operator[]`
+ * return such a proxy, and converting it to `T` gathers a copy of the element.
+ *
+ * @tparam T The reflected type of the elements.
+ * @tparam Alignment The alignment of every column in bytes. Must be a power of two.
+ */
+template <typename T, usize Alignment = TKIT_CACHE_LINE_SIZE> class SoaArray
+{
+    static_assert(Reflect<T>::Implemented,
+                  "[TOOLKIT][SOA-ARRAY] Reflection is not implemented for this type. Make sure the type is marked with "
+                  "TKIT_REFLECT_DECLARE and that its generated reflection code is included");
+    static_assert(Reflect<T>::HasMemberFields, "[TOOLKIT][SOA-ARRAY] The type must have at least one member field");
+    static_assert(IsPowerOfTwo(Alignment), "[TOOLKIT][SOA-ARRAY] Column alignment must be a power of two");
+
+    using Fields = decltype(Reflect<T>::GetMemberFields());
+    static constexpr Fields s_Fields = Reflect<T>::GetMemberFields();
+    static constexpr usize s_FieldCount = usize(std::tuple_size_v<Fields>);
+
+    template <typename F> static constexpr void forEachIndex(F &&fun)
+    {
+        [&]<usize... I>(std::integer_sequence<usize, I...>) {
+            (fun(std::integral_constant<usize, I>{}), ...);
+        }(std::make_integer_sequence<usize, s_FieldCount>{});
+    }
+
+    // Evaluates to the field count if `Member` is not a reflected field
+    template <auto Member> static constexpr usize indexOf()
+    {
+        usize index = s_FieldCount;
+        forEachIndex([&](const auto I) {
+            if constexpr (std::is_same_v<decltype(std::get<I>(s_Fields).Pointer), decltype(Member)>)
+                if (std::get<I>(s_Fields).Pointer == Member)
+                    index = I;
+        });
+        return index;
+    }
+
+  public:
+    using ValueType = T;
+
+    static constexpr usize FieldCount = s_FieldCount;
+    template <usize I> using FieldType = typename std::tuple_element_t<I, Fields>::Type;
+
+    template <bool Const> class ReferenceImpl
+    {
+      public:
+        using Array = std::conditional_t<Const, const SoaArray, SoaArray>;
+
+        constexpr ReferenceImpl(Array *array, const usize index) : m_Array(array), m_Index(index)
+        {
+        }
+        constexpr ReferenceImpl(const ReferenceImpl<false> &other)
+            requires(Const)
+            : m_Array(other.m_Array), m_Index(other.m_Index)
+        {
+        }
+
+        /**
+         * @brief Access a field of the element given its index in the reflected field list.
+         */
+        template <usize I> constexpr auto &Get() const
+        {
+            return m_Array->template getColumn<I>()[m_Index];
+        }
+        /**
+         * @brief Access a field of the element given its member pointer, as in `Get<&Particle::Position>()`.
+         */
+        template <auto Member>
+            requires std::is_member_object_pointer_v<decltype(Member)>
+        constexpr auto &Get() const
+        {
+            static_assert(IndexOf<Member> != FieldCount, "[TOOLKIT][SOA-ARRAY] The member is not a reflected field");
+            return Get<IndexOf<Member>>();
+        }
+
+        constexpr T Load() const
+        {
+            return m_Array->load(m_Index);
+        }
+        constexpr operator T() const
+        {
+            return Load();
+        }
+
+        constexpr void Store(const T &value) const
+            requires(!Const)
+        {
+            m_Array->store(m_Index, value);
+        }
+        constexpr const ReferenceImpl &operator=(const T &value) const
+            requires(!Const)
+        {
+            Store(value);
+            return *this;
+        }
+
+        constexpr usize GetIndex() const
+        {
+            return m_Index;
+        }
+
+      private:
+        Array *m_Array;
+        usize m_Index;
+
+        template <bool> friend class ReferenceImpl;
+    };
+
+    using Reference = ReferenceImpl<false>;
+    using ConstReference = ReferenceImpl<true>;
+
+    template <bool Const> class IteratorImpl
+    {
+      public:
+        using Array = std::conditional_t<Const, const SoaArray, SoaArray>;
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = ReferenceImpl<Const>;
+
+        constexpr IteratorImpl() = default;
+        constexpr IteratorImpl(Array *array, const usize index) : m_Array(array), m_Index(index)
+        {
+        }
+
+        constexpr ReferenceImpl<Const> operator*() const
+        {
+            return ReferenceImpl<Const>{m_Array, m_Index};
+        }
+
+        constexpr IteratorImpl &operator++()
+        {
+            ++m_Index;
+            return *this;
+        }
+        constexpr IteratorImpl operator++(int)
+        {
+            const IteratorImpl cpy = *this;
+            ++m_Index;
+            return cpy;
+        }
+
+        constexpr bool operator==(const IteratorImpl &other) const
+        {
+            return m_Index == other.m_Index && m_Array == other.m_Array;
+        }
+
+      private:
+        Array *m_Array = nullptr;
+        usize m_Index = 0;
+    };
+
+    using Iterator = IteratorImpl<false>;
+    using ConstIterator = IteratorImpl<true>;
+
+    /**
+     * @brief The index of the field that `Member` points to in the reflected field list, or `FieldCount` if it is not
+     * a reflected field.
+     */
+    template <auto Member>
+        requires std::is_member_object_pointer_v<decltype(Member)>
+    static constexpr usize IndexOf = indexOf<Member>();
+
+    constexpr SoaArray() = default;
+    constexpr explicit SoaArray(const usize capacity)
+    {
+        Reserve(capacity);
+    }
+
+    constexpr SoaArray(const SoaArray &other)
+    {
+        Reserve(other.m_Size);
+        forEachIndex([&](const auto I) {
+            const auto *src = other.template getColumn<I>();
+            ConstructRangeCopy(getColumn<I>(), src, src + other.m_Size);
+        });
+        m_Size = other.m_Size;
+    }
+    constexpr SoaArray(SoaArray &&other)
+        : m_Columns(other.m_Columns), m_Data(other.m_Data), m_Size(other.m_Size), m_Capacity(other.m_Capacity)
+    {
+        other.m_Data = nullptr;
+        other.m_Size = 0;
+        other.m_Capacity = 0;
+    }
+
+    ~SoaArray()
+    {
+        Clear();
+        deallocate();
+    }
+
+    constexpr SoaArray &operator=(const SoaArray &other)
+    {
+        if (this == &other)
+            return *this;
+
+        Clear();
+        Reserve(other.m_Size);
+        forEachIndex([&](const auto I) {
+            const auto *src = other.template getColumn<I>();
+            ConstructRangeCopy(getColumn<I>(), src, src + other.m_Size);
+        });
+        m_Size = other.m_Size;
+        return *this;
+    }
+    constexpr SoaArray &operator=(SoaArray &&other)
+    {
+        if (this == &other)
+            return *this;
+
+        Clear();
+        deallocate();
+        m_Columns = other.m_Columns;
+        m_Data = other.m_Data;
+        m_Size = other.m_Size;
+        m_Capacity = other.m_Capacity;
+        other.m_Data = nullptr;
+        other.m_Size = 0;
+        other.m_Capacity = 0;
+        return *this;
+    }
+
+    /**
+     * @brief Append an element, scattering its fields to their columns.
+     */
+    constexpr Reference Append(const T &value)
+    {
+        if (m_Size == m_Capacity)
+            modifyCapacity(Container::GrowthFactor(m_Size + 1));
+        forEachIndex([&](const auto I) {
+            ConstructFromIterator(getColumn<I>() + m_Size, value.*std::get<I>(s_Fields).Pointer);
+        });
+        return Reference{this, m_Size++};
+    }
+    constexpr Reference Append(T &&value)
+    {
+        if (m_Size == m_Capacity)
+            modifyCapacity(Container::GrowthFactor(m_Size + 1));
+        forEachIndex([&](const auto I) {
+            ConstructFromIterator(getColumn<I>() + m_Size, std::move(value.*std::get<I>(s_Fields).Pointer));
+        });
+        return Reference{this, m_Size++};
+    }
+
+    constexpr void Pop()
+    {
+        TKIT_ASSERT(m_Size != 0, "[TOOLKIT][SOA-ARRAY] Cannot Pop(). Container is already empty");
+        --m_Size;
+        forEachIndex([&](const auto I) { DestructFromIterator(getColumn<I>() + m_Size); });
+    }
+
+    /**
+     * @brief Remove the element at `index` by moving the last element of every column into its place. The order is not
+     * preserved.
+     */
+    constexpr void RemoveUnordered(const usize index)
+    {
+        TKIT_ASSERT(index < m_Size, "[TOOLKIT][SOA-ARRAY] Index is out of bounds: {} >= {}", index, m_Size);
+        const usize last = m_Size - 1;
+        if (index != last)
+            forEachIndex([&](const auto I) {
+                auto *column = getColumn<I>();
+                column[index] = std::move(column[last]);
+            });
+        Pop();
+    }
+
+    constexpr ConstReference At(const usize index) const
+    {
+        TKIT_ASSERT(index < m_Size, "[TOOLKIT][SOA-ARRAY] Index is out of bounds: {} >= {}", index, m_Size);
+        return ConstReference{this, index};
+    }
+    constexpr Reference At(const usize index)
+    {
+        TKIT_ASSERT(index < m_Size, "[TOOLKIT][SOA-ARRAY] Index is out of bounds: {} >= {}", index, m_Size);
+        return Reference{this, index};
+    }
+
+    constexpr ConstReference operator[](const usize index) const
+    {
+        return At(index);
+    }
+    constexpr Reference operator[](const usize index)
+    {
+        return At(index);
+    }
+
+    /**
+     * @brief Get the column of a field given its index in the reflected field list.
+     *
+     * The first element of the column is aligned to `Alignment` bytes.
+     */
+    template <usize I> constexpr Span<const FieldType<I>> GetColumn() const
+    {
+        return Span<const FieldType<I>>{getColumn<I>(), m_Size};
+    }
+    template <usize I> constexpr Span<FieldType<I>> GetColumn()
+    {
+        return Span<FieldType<I>>{getColumn<I>(), m_Size};
+    }
+
+    /**
+     * @brief Get the column of a field given its member pointer, as in `GetColumn<&Particle::Position>()`.
+     *
+     * The first element of the column is aligned to `Alignment` bytes.
+     */
+    template <auto Member>
+        requires std::is_member_object_pointer_v<decltype(Member)>
+    constexpr auto GetColumn() const
+    {
+        static_assert(IndexOf<Member> != FieldCount, "[TOOLKIT][SOA-ARRAY] The member is not a reflected field");
+        return GetColumn<IndexOf<Member>>();
+    }
+    template <auto Member>
+        requires std::is_member_object_pointer_v<decltype(Member)>
+    constexpr auto GetColumn()
+    {
+        static_assert(IndexOf<Member> != FieldCount, "[TOOLKIT][SOA-ARRAY] The member is not a reflected field");
+        return GetColumn<IndexOf<Member>>();
+    }
+
+    constexpr void Clear()
+    {
+        forEachIndex([&](const auto I) {
+            auto *column = getColumn<I>();
+            DestructRange(column, column + m_Size);
+        });
+        m_Size = 0;
+    }
+    constexpr void Reserve(const usize capacity)
+    {
+        if (capacity > m_Capacity)
+            modifyCapacity(capacity);
+    }
+
+    constexpr ConstIterator begin() const
+    {
+        return ConstIterator{this, 0};
+    }
+    constexpr ConstIterator end() const
+    {
+        return ConstIterator{this, m_Size};
+    }
+    constexpr Iterator begin()
+    {
+        return Iterator{this, 0};
+    }
+    constexpr Iterator end()
+    {
+        return Iterator{this, m_Size};
+    }
+
+    constexpr usize GetSize() const
+    {
+        return m_Size;
+    }
+    constexpr usize GetCapacity() const
+    {
+        return m_Capacity;
+    }
+    constexpr bool IsEmpty() const
+    {
+        return m_Size == 0;
+    }
+    constexpr bool IsFull() const
+    {
+        return m_Size == m_Capacity;
+    }
+
+  private:
+    template <usize I> constexpr const FieldType<I> *getColumn() const
+    {
+        return scast<const FieldType<I> *>(m_Columns[I]);
+    }
+    template <usize I> constexpr FieldType<I> *getColumn()
+    {
+        return scast<FieldType<I> *>(m_Columns[I]);
+    }
+
+    constexpr T load(const usize index) const
+        requires std::default_initializable<T>
+    {
+        T value{};
+        forEachIndex([&](const auto I) { value.*std::get<I>(s_Fields).Pointer = getColumn<I>()[index]; });
+        return value;
+    }
+    constexpr void store(const usize index, const T &value)
+    {
+        forEachIndex([&](const auto I) { getColumn<I>()[index] = value.*std::get<I>(s_Fields).Pointer; });
+    }
+
+    // Columns are laid out one after the other in field order, each one starting at an `Alignment` boundary
+    static constexpr usz getAllocationSize(const usize capacity)
+    {
+        usz size = 0;
+        forEachIndex([&](const auto I) {
+            static_assert(alignof(FieldType<I>) <= Alignment,
+                          "[TOOLKIT][SOA-ARRAY] Column alignment is smaller than the alignment of one of the fields");
+            size += NextAlignedSize(capacity * sizeof(FieldType<I>), Alignment);
+        });
+        return size;
+    }
+
+    constexpr void modifyCapacity(const usize capacity)
+    {
+        TKIT_ASSERT(capacity >= m_Size, "[TOOLKIT][SOA-ARRAY] Capacity ({}) is smaller than size ({})", capacity,
+                    m_Size);
+        std::byte *data = scast<std::byte *>(AllocateAligned(getAllocationSize(capacity), Alignment));
+        TKIT_ASSERT(data, "[TOOLKIT][SOA-ARRAY] Failed to allocate {:L} bytes of memory aligned to {:L} bytes",
+                    getAllocationSize(capacity), Alignment);
+
+        usz offset = 0;
+        forEachIndex([&](const auto I) {
+            auto *column = rcast<FieldType<I> *>(data + offset);
+            RelocateRange(column, getColumn<I>(), getColumn<I>() + m_Size);
+            m_Columns[I] = column;
+            offset += NextAlignedSize(capacity * sizeof(FieldType<I>), Alignment);
+        });
+        deallocate();
+        m_Data = data;
+        m_Capacity = capacity;
+    }
+
+    constexpr void deallocate()
+    {
+        if (m_Data)
+        {
+            DeallocateAligned(m_Data);
+            m_Data = nullptr;
+            m_Capacity = 0;
+        }
+    }
+
+    FixedArray<void *, FieldCount> m_Columns{};
+    std::byte *m_Data = nullptr;
+    usize m_Size = 0;
+    usize m_Capacity = 0;
+};
+} // namespace TKit
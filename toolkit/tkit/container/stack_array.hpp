@@ -89,4 +89,8 @@ template <typename T> struct StackAllocation
 };
 template <typename T> using StackArray = Array<T, StackAllocation<T>>;
 using StackString = Array<char, StackAllocation<char>>;
+
+template <typename T> struct IsTriviallyRelocatable<Array<T, StackAllocation<T>>> : std::true_type
+{
+};
 } // namespace TKit
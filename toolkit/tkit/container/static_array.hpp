@@ -55,4 +55,10 @@ using StaticString384 = StaticString<384>;
 using StaticString512 = StaticString<512>;
 using StaticString768 = StaticString<768>;
 using StaticString1024 = StaticString<1024>;
+
+// The elements live inside of the array, so it is as relocatable as they are
+template <typename T, usize Capacity>
+struct IsTriviallyRelocatable<Array<T, StaticAllocation<T, Capacity>>> : std::bool_constant<TriviallyRelocatable<T>>
+{
+};
 } // namespace TKit
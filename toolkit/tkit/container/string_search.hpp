@@ -0,0 +1,201 @@
+#pragma once
+
+#include "tkit/preprocessor/system.hpp"
+#include "tkit/utils/alias.hpp"
+#include "tkit/utils/limits.hpp"
+#if defined(TKIT_SIMD_AVX2)
+#    include "tkit/simd/wide_avx.hpp"
+#elif defined(TKIT_SIMD_SSE2)
+#    include "tkit/simd/wide_sse.hpp"
+#elif defined(TKIT_SIMD_NEON)
+#    include "tkit/simd/wide_neon.hpp"
+#else
+#    include "tkit/simd/wide.hpp"
+#endif
+#include <bit>
+#include <cstring>
+
+namespace TKit::Container
+{
+namespace Detail
+{
+#if defined(TKIT_SIMD_AVX2)
+using StringWide = Simd::AVX::Wide<u8>;
+#elif defined(TKIT_SIMD_SSE2)
+using StringWide = Simd::SSE::Wide<u8>;
+#elif defined(TKIT_SIMD_NEON)
+using StringWide = Simd::NEON::Wide<u8>;
+#else
+using StringWide = Simd::Wide<u8, 16>;
+#endif
+
+inline StringWide LoadChars(const char *str)
+{
+    return StringWide::LoadUnaligned(rcast<const u8 *>(str));
+}
+inline StringWide::BitMask MatchChar(const StringWide &chars, const char ch)
+{
+    return StringWide::PackMask(chars == StringWide{u8(ch)});
+}
+} // namespace Detail
+
+/**
+ * @brief A set of bytes stored as a 256 bit lookup table, so that checking if a character belongs to it costs the same
+ * no matter how many characters the set has.
+ */
+class CharSet
+{
+  public:
+    CharSet(const char *chars, const usize count)
+    {
+        for (usize i = 0; i < count; ++i)
+        {
+            const u8 ch = u8(chars[i]);
+            m_Bits[ch >> 6] |= u64(1) << (ch & 63);
+        }
+    }
+
+    bool Contains(const char ch) const
+    {
+        const u8 c = u8(ch);
+        return (m_Bits[c >> 6] >> (c & 63)) & 1;
+    }
+
+  private:
+    u64 m_Bits[4]{};
+};
+
+/**
+ * @brief Find the first occurrence of `ch` in `str`, starting at `from`.
+ *
+ * @return The position of the character or `TKIT_USIZE_MAX` if not found.
+ */
+inline usize FindChar(const char *str, const usize size, const char ch, usize from = 0)
+{
+    using Wide = Detail::StringWide;
+    for (; from + Wide::Lanes <= size; from += Wide::Lanes)
+    {
+        const Wide::BitMask mask = Detail::MatchChar(Detail::LoadChars(str + from), ch);
+        if (mask != 0)
+            return from + usize(std::countr_zero(mask));
+    }
+    for (; from < size; ++from)
+        if (str[from] == ch)
+            return from;
+    return TKIT_USIZE_MAX;
+}
+
+/**
+ * @brief Find the first occurrence of the substring `sub` in `str`, starting at `from`.
+ *
+ * Candidate positions are those where both the first and the last character of `sub` match, which are found a whole
+ * vector at a time. Only those are compared in full, so that mismatches are discarded without ever leaving the vector
+ * registers.
+ *
+ * @return The position of the substring or `TKIT_USIZE_MAX` if not found.
+ */
+inline usize FindString(const char *str, const usize size, const char *sub, const usize length, usize from = 0)
+{
+    if (length == 0)
+        return from <= size ? from : TKIT_USIZE_MAX;
+    if (length > size || from > size - length)
+        return TKIT_USIZE_MAX;
+    if (length == 1)
+        return FindChar(str, size, sub[0], from);
+
+    using Wide = Detail::StringWide;
+    const Wide first{u8(sub[0])};
+    const Wide last{u8(sub[length - 1])};
+    for (; from + length - 1 + Wide::Lanes <= size; from += Wide::Lanes)
+    {
+        Wide::BitMask mask = Wide::PackMask(Detail::LoadChars(str + from) == first) &
+                             Wide::PackMask(Detail::LoadChars(str + from + length - 1) == last);
+        for (; mask != 0; mask &= Wide::BitMask(mask - 1))
+        {
+            const usize pos = from + usize(std::countr_zero(mask));
+            if (std::memcmp(str + pos + 1, sub + 1, length - 2) == 0)
+                return pos;
+        }
+    }
+    for (; from + length <= size; ++from)
+        if (str[from] == sub[0] && std::memcmp(str + from + 1, sub + 1, length - 1) == 0)
+            return from;
+    return TKIT_USIZE_MAX;
+}
+
+/**
+ * @brief Find the first character of `str` that is also in `chars`, starting at `from`.
+ *
+ * Sets of up to 4 characters are matched a whole vector at a time. Bigger sets are looked up in a `CharSet`.
+ *
+ * @return The position of the character or `TKIT_USIZE_MAX` if not found.
+ */
+inline usize FindFirstOf(const char *str, const usize size, const char *chars, const usize count, usize from = 0)
+{
+    if (count == 0)
+        return TKIT_USIZE_MAX;
+    if (count == 1)
+        return FindChar(str, size, chars[0], from);
+    if (count <= 4)
+    {
+        using Wide = Detail::StringWide;
+        for (; from + Wide::Lanes <= size; from += Wide::Lanes)
+        {
+            const Wide block = Detail::LoadChars(str + from);
+            Wide::BitMask mask = 0;
+            for (usize i = 0; i < count; ++i)
+                mask |= Detail::MatchChar(block, chars[i]);
+            if (mask != 0)
+                return from + usize(std::countr_zero(mask));
+        }
+    }
+
+    const CharSet set{chars, count};
+    for (; from < size; ++from)
+        if (set.Contains(str[from]))
+            return from;
+    return TKIT_USIZE_MAX;
+}
+
+/**
+ * @brief Find the last character of `str` that is also in `chars`.
+ *
+ * @return The position of the character or `TKIT_USIZE_MAX` if not found.
+ */
+inline usize FindLastOf(const char *str, const usize size, const char *chars, const usize count)
+{
+    const CharSet set{chars, count};
+    for (usize i = size; i > 0; --i)
+        if (set.Contains(str[i - 1]))
+            return i - 1;
+    return TKIT_USIZE_MAX;
+}
+
+/**
+ * @brief Find the first character of `str` that is not in `chars`, starting at `from`.
+ *
+ * @return The position of the character or `TKIT_USIZE_MAX` if not found.
+ */
+inline usize FindFirstNotOf(const char *str, const usize size, const char *chars, const usize count, usize from = 0)
+{
+    const CharSet set{chars, count};
+    for (; from < size; ++from)
+        if (!set.Contains(str[from]))
+            return from;
+    return TKIT_USIZE_MAX;
+}
+
+/**
+ * @brief Find the last character of `str` that is not in `chars`.
+ *
+ * @return The position of the character or `TKIT_USIZE_MAX` if not found.
+ */
+inline usize FindLastNotOf(const char *str, const usize size, const char *chars, const usize count)
+{
+    const CharSet set{chars, count};
+    for (usize i = size; i > 0; --i)
+        if (!set.Contains(str[i - 1]))
+            return i - 1;
+    return TKIT_USIZE_MAX;
+}
+} // namespace TKit::Container
@@ -89,7 +89,6 @@ template <typename T> struct TierAllocation
     }
     void ModifyCapacity(const usize capacity)
     {
-        using Tools = Container::ArrayTools<T>;
         if (!Data)
         {
             Allocate(capacity);
@@ -98,11 +97,27 @@ template <typename T> struct TierAllocation
         TKIT_ASSERT(Allocator, "[TOOLKIT][TIER-ARRAY] Array must have a valid allocator to allocate memory");
         TKIT_ASSERT(capacity != 0, "[TOOLKIT][TIER-ARRAY] Capacity must be greater than 0");
         TKIT_ASSERT(capacity >= Size, "[TOOLKIT][TIER-ARRAY] Capacity ({}) is smaller than size ({})", capacity, Size);
+        if constexpr (TriviallyRelocatable<T>)
+        {
+            T *newData = Allocator->Reallocate(Data, Capacity, capacity);
+            TKIT_ASSERT(newData, "[TOOLKIT][TIER-ARRAY] Failed to reallocate {:L} bytes of memory",
+                        capacity * sizeof(T));
+            Data = newData;
+            Capacity = capacity;
+            return;
+        }
+        else if (Allocator->IsSameTier(Capacity * sizeof(T), capacity * sizeof(T)))
+        {
+            // The current slot can already hold the new capacity, so the allocator resizes it in place without moving
+            // anything
+            Data = Allocator->Reallocate(Data, Capacity, capacity);
+            Capacity = capacity;
+            return;
+        }
+
         T *newData = Allocator->Allocate<T>(capacity);
         TKIT_ASSERT(newData, "[TOOLKIT][TIER-ARRAY] Failed to allocate {:L} bytes of memory", capacity * sizeof(T));
-        Tools::MoveConstructFromRange(newData, Data, Data + Size);
-        if constexpr (!std::is_trivially_destructible_v<T>)
-            DestructRange(Data, Data + Size);
+        RelocateRange(newData, Data, Data + Size);
         Allocator->Deallocate(Data, Capacity);
         Data = newData;
         Capacity = capacity;
@@ -121,4 +136,8 @@ template <typename T> struct TierAllocation
 
 template <typename T> using TierArray = Array<T, TierAllocation<T>>;
 using TierString = Array<char, TierAllocation<char>>;
+
+template <typename T> struct IsTriviallyRelocatable<Array<T, TierAllocation<T>>> : std::true_type
+{
+};
 } // namespace TKit
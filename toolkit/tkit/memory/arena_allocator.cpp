@@ -15,12 +15,12 @@ ArenaAllocator::ArenaAllocator(void *buffer, const usz capacity, const usize ali
                 "[TOOLKIT][ARENA-ALLOC] Provided buffer must be aligned to the given alignment of {}", alignment);
     TKIT_POISON_MEMORY_REGION(buffer, capacity);
 }
-ArenaAllocator::ArenaAllocator(const usz capacity, const usize alignment)
-    : m_Capacity(capacity), m_Alignment(alignment), m_Provided(false)
+ArenaAllocator::ArenaAllocator(const usz capacity, const usize alignment, const NumaSpecs &numa)
+    : m_Capacity(capacity), m_Alignment(alignment), m_Numa(numa), m_Provided(false)
 {
     TKIT_ASSERT(IsPowerOfTwo(alignment), "[TOOLKIT][ARENA-ALLOC] Alignment must be a power of 2, but the value is {}",
                 alignment);
-    m_Buffer = scast<std::byte *>(AllocateAligned(capacity, alignment));
+    m_Buffer = scast<std::byte *>(AllocateAligned(capacity, alignment, numa));
     TKIT_ASSERT(m_Buffer, "[TOOLKIT][ARENA-ALLOC] Failed to allocate memory");
     TKIT_POISON_MEMORY_REGION(m_Buffer, capacity);
 }
@@ -31,7 +31,7 @@ ArenaAllocator::~ArenaAllocator()
 
 ArenaAllocator::ArenaAllocator(ArenaAllocator &&other)
     : m_Buffer(other.m_Buffer), m_Top(other.m_Top), m_Capacity(other.m_Capacity), m_Alignment(other.m_Alignment),
-      m_Provided(other.m_Provided)
+      m_Numa(other.m_Numa), m_Provided(other.m_Provided)
 {
     other.m_Buffer = nullptr;
     other.m_Top = 0;
@@ -49,6 +49,7 @@ ArenaAllocator &ArenaAllocator::operator=(ArenaAllocator &&other)
         m_Top = other.m_Top;
         m_Capacity = other.m_Capacity;
         m_Alignment = other.m_Alignment;
+        m_Numa = other.m_Numa;
         m_Provided = other.m_Provided;
 
         other.m_Buffer = nullptr;
@@ -91,6 +92,6 @@ void ArenaAllocator::deallocateBuffer()
     //     "[TOOLKIT][ARENA-ALLOC] Deallocating an arena allocator with active allocations. If the elements are not "
     //     "trivially destructible, you will have to call "
     //     "Destroy() for each element to avoid undefined behaviour (this deallocation will not call the destructor)");
-    DeallocateAligned(m_Buffer);
+    DeallocateAligned(m_Buffer, m_Capacity, m_Numa);
 }
 } // namespace TKit
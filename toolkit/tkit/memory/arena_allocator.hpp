@@ -29,7 +29,8 @@ class alignas(TKIT_CACHE_LINE_SIZE) ArenaAllocator
 {
     TKIT_NON_COPYABLE(ArenaAllocator)
   public:
-    explicit ArenaAllocator(usz capacity, usize alignment = alignof(std::max_align_t));
+    // A NUMA policy other than the default one allocates the buffer with page granularity
+    explicit ArenaAllocator(usz capacity, usize alignment = alignof(std::max_align_t), const NumaSpecs &numa = {});
 
     // This constructor is NOT owning the buffer, so it will not deallocate it. Up to the user to manage the memory
     ArenaAllocator(void *buffer, usz capacity, usize alignment = alignof(std::max_align_t));
@@ -152,6 +153,7 @@ class alignas(TKIT_CACHE_LINE_SIZE) ArenaAllocator
     usz m_Top = 0;
     usz m_Capacity = 0;
     usz m_Alignment = 0;
+    NumaSpecs m_Numa{};
     bool m_Provided;
 };
 } // namespace TKit
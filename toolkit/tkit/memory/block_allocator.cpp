@@ -5,8 +5,9 @@
 
 namespace TKit
 {
-BlockAllocator::BlockAllocator(const usz bufferSize, const usz allocationSize, const usize alignment)
-    : m_BufferSize(bufferSize), m_AllocationSize(allocationSize), m_Provided(false)
+BlockAllocator::BlockAllocator(const usz bufferSize, const usz allocationSize, const usize alignment,
+                               const NumaSpecs &numa)
+    : m_BufferSize(bufferSize), m_AllocationSize(allocationSize), m_Numa(numa), m_Provided(false)
 {
     TKIT_ASSERT(allocationSize >= sizeof(Allocation),
                 "[TOOLKIT][BLOCK-ALLOC] The allocation size must be at least {:L} bytes", sizeof(Allocation));
@@ -21,10 +22,28 @@ BlockAllocator::BlockAllocator(const usz bufferSize, const usz allocationSize, c
                 "the alignment to ensure every block of memory is aligned to it, but got {:L}",
                 allocationSize);
 
-    m_Buffer = scast<std::byte *>(AllocateAligned(bufferSize, alignment));
+    m_Buffer = scast<std::byte *>(AllocateAligned(bufferSize, alignment, numa));
     TKIT_ASSERT(m_Buffer, "[TOOLKIT][BLOCK-ALLOC] Failed to allocate {:L} bytes of memory aligned to {:L} bytes",
                 bufferSize, alignment);
-    setupMemoryLayout();
+    m_FreeList = setupMemoryLayout(m_Buffer);
+}
+
+BlockAllocator::BlockAllocator(const usz bufferSize, const usz allocationSize, const BlockSlabSpecs &specs,
+                               const usize alignment, const NumaSpecs &numa)
+    : BlockAllocator(bufferSize, allocationSize, alignment, numa)
+{
+    m_Alignment = alignment;
+    m_Specs = specs;
+
+    // The buffer allocated by the main constructor becomes the first slab
+    m_SlabCapacity = 4;
+    m_Slabs = scast<Slab *>(TKit::Allocate(m_SlabCapacity * sizeof(Slab)));
+    TKIT_ASSERT(m_Slabs, "[TOOLKIT][BLOCK-ALLOC] Failed to allocate the slab index");
+    m_Slabs[0] = Slab{m_Buffer, nullptr, 0, NoSlab, NoSlab};
+    m_SlabCount = 1;
+    m_Current = 0;
+    m_EmptySlabs = 0;
+    m_Buffer = nullptr;
 }
 
 BlockAllocator::BlockAllocator(void *buffer, const usz bufferSize, const usz allocationSize)
@@ -34,7 +53,7 @@ BlockAllocator::BlockAllocator(void *buffer, const usz bufferSize, const usz all
                 "[TOOLKIT][BLOCK-ALLOC] The buffer size ({:L}) must be a multiple of the allocation size to guarantee "
                 "a tight fit",
                 bufferSize);
-    setupMemoryLayout();
+    m_FreeList = setupMemoryLayout(m_Buffer);
 }
 
 BlockAllocator::~BlockAllocator()
@@ -44,13 +63,19 @@ BlockAllocator::~BlockAllocator()
 
 BlockAllocator::BlockAllocator(BlockAllocator &&other)
     : m_Buffer(other.m_Buffer), m_FreeList(other.m_FreeList), m_BufferSize(other.m_BufferSize),
-      m_AllocationSize(other.m_AllocationSize), m_Provided(other.m_Provided)
+      m_AllocationSize(other.m_AllocationSize), m_Slabs(other.m_Slabs), m_SlabCount(other.m_SlabCount),
+      m_SlabCapacity(other.m_SlabCapacity), m_Current(other.m_Current), m_EmptySlabs(other.m_EmptySlabs),
+      m_Available(other.m_Available), m_LastAvailable(other.m_LastAvailable), m_Alignment(other.m_Alignment),
+      m_Specs(other.m_Specs), m_Numa(other.m_Numa), m_Provided(other.m_Provided)
 {
     other.m_Buffer = nullptr;
     other.m_FreeList = nullptr;
     other.m_BufferSize = 0;
     other.m_AllocationSize = 0;
-    m_Provided = false;
+    other.m_Slabs = nullptr;
+    other.m_SlabCount = 0;
+    other.m_SlabCapacity = 0;
+    other.m_Provided = false;
 }
 
 BlockAllocator &BlockAllocator::operator=(BlockAllocator &&other)
@@ -62,13 +87,26 @@ BlockAllocator &BlockAllocator::operator=(BlockAllocator &&other)
         m_FreeList = other.m_FreeList;
         m_BufferSize = other.m_BufferSize;
         m_AllocationSize = other.m_AllocationSize;
+        m_Slabs = other.m_Slabs;
+        m_SlabCount = other.m_SlabCount;
+        m_SlabCapacity = other.m_SlabCapacity;
+        m_Current = other.m_Current;
+        m_EmptySlabs = other.m_EmptySlabs;
+        m_Available = other.m_Available;
+        m_LastAvailable = other.m_LastAvailable;
+        m_Alignment = other.m_Alignment;
+        m_Specs = other.m_Specs;
+        m_Numa = other.m_Numa;
         m_Provided = other.m_Provided;
 
         other.m_Buffer = nullptr;
         other.m_FreeList = nullptr;
         other.m_BufferSize = 0;
         other.m_AllocationSize = 0;
-        m_Provided = false;
+        other.m_Slabs = nullptr;
+        other.m_SlabCount = 0;
+        other.m_SlabCapacity = 0;
+        other.m_Provided = false;
     }
     return *this;
 }
@@ -76,7 +114,7 @@ BlockAllocator &BlockAllocator::operator=(BlockAllocator &&other)
 void *BlockAllocator::Allocate()
 {
     // TKIT_ASSERT(m_FreeList, "The allocator is full");
-    if (!m_FreeList)
+    if (!m_FreeList && (!m_Slabs || !switchSlab()))
     {
         TKIT_LOG_WARNING("[TOOLKIT][BLOCK-ALLOC] Allocator ran out of slots when trying to perform an allocation");
         return nullptr;
@@ -85,6 +123,8 @@ void *BlockAllocator::Allocate()
     Allocation *alloc = m_FreeList;
     TKIT_UNPOISON_MEMORY_REGION(alloc, m_AllocationSize);
     m_FreeList = m_FreeList->Next;
+    if (m_Slabs)
+        ++m_Slabs[m_Current].Allocations;
     return alloc;
 }
 
@@ -95,28 +135,231 @@ void BlockAllocator::Deallocate(const void *ptr)
                 "[TOOLKIT][BLOCK-ALLOC] Cannot deallocate a pointer that does not belong to the allocator");
 
     Allocation *alloc = scast<Allocation *>(ccast<void *>(ptr));
+    if (m_Slabs)
+    {
+        deallocateFromSlab(alloc);
+        return;
+    }
     alloc->Next = m_FreeList;
     TKIT_POISON_MEMORY_REGION(alloc, m_AllocationSize);
     m_FreeList = alloc;
 }
 
-void BlockAllocator::setupMemoryLayout()
+void BlockAllocator::deallocateFromSlab(Allocation *alloc)
+{
+    const usize index = findSlab(alloc);
+    Slab &slab = m_Slabs[index];
+    --slab.Allocations;
+
+    // The current slab is never released nor accounted as empty, as it is the one that will serve the next allocations
+    if (index == m_Current)
+    {
+        alloc->Next = m_FreeList;
+        TKIT_POISON_MEMORY_REGION(alloc, m_AllocationSize);
+        m_FreeList = alloc;
+        return;
+    }
+
+    const bool available = slab.FreeList != nullptr;
+    alloc->Next = slab.FreeList;
+    TKIT_POISON_MEMORY_REGION(alloc, m_AllocationSize);
+    slab.FreeList = alloc;
+
+    // A slab becomes available with its first free block, and moves behind the partially used ones once empty
+    if (slab.Allocations != 0)
+    {
+        if (!available)
+            linkSlab(index);
+        return;
+    }
+    if (available)
+        unlinkSlab(index);
+    if (++m_EmptySlabs > m_Specs.RetainedSlabs)
+        removeSlab(index);
+    else
+        linkSlab(index);
+}
+
+usize BlockAllocator::findSlab(const void *ptr) const
+{
+    const std::byte *bptr = scast<const std::byte *>(ptr);
+    usize lo = 0;
+    usize hi = m_SlabCount;
+    while (lo < hi)
+    {
+        const usize mid = lo + (hi - lo) / 2;
+        if (m_Slabs[mid].Buffer <= bptr)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == 0 || bptr >= m_Slabs[lo - 1].Buffer + m_BufferSize)
+        return m_SlabCount;
+    return lo - 1;
+}
+
+bool BlockAllocator::switchSlab()
+{
+    // Partially used slabs sit in front of the list, so they are preferred over empty ones, which then get a chance to
+    // be released
+    usize candidate = m_Available;
+    if (candidate == NoSlab)
+    {
+        candidate = addSlab();
+        if (candidate == m_SlabCount)
+            return false;
+    }
+    else
+    {
+        unlinkSlab(candidate);
+        if (m_Slabs[candidate].Allocations == 0)
+            --m_EmptySlabs;
+    }
+
+    m_Slabs[m_Current].FreeList = nullptr;
+    m_Current = candidate;
+    m_FreeList = m_Slabs[candidate].FreeList;
+    m_Slabs[candidate].FreeList = nullptr;
+    return true;
+}
+
+usize BlockAllocator::addSlab()
 {
-    const usize count = GetAllocationCapacityCount();
-    m_FreeList = rcast<Allocation *>(m_Buffer);
+    if (m_Specs.MaxSlabs != 0 && m_SlabCount >= m_Specs.MaxSlabs)
+        return m_SlabCount;
+
+    std::byte *buffer = scast<std::byte *>(AllocateAligned(m_BufferSize, m_Alignment, m_Numa));
+    if (!buffer)
+    {
+        TKIT_LOG_WARNING("[TOOLKIT][BLOCK-ALLOC] Failed to allocate a new slab of {:L} bytes", m_BufferSize);
+        return m_SlabCount;
+    }
+
+    if (m_SlabCount == m_SlabCapacity)
+    {
+        const usize capacity = 2 * m_SlabCapacity;
+        Slab *slabs = scast<Slab *>(TKit::Allocate(capacity * sizeof(Slab)));
+        TKIT_ASSERT(slabs, "[TOOLKIT][BLOCK-ALLOC] Failed to grow the slab index");
+        ForwardCopy(slabs, m_Slabs, m_SlabCount * sizeof(Slab));
+        TKit::Deallocate(m_Slabs);
+        m_Slabs = slabs;
+        m_SlabCapacity = capacity;
+    }
+
+    usize index = 0;
+    while (index < m_SlabCount && m_Slabs[index].Buffer < buffer)
+        ++index;
+
+    shiftSlabLinks(index, true);
+    BackwardCopy(m_Slabs + index + 1, m_Slabs + index, (m_SlabCount - index) * sizeof(Slab));
+    m_Slabs[index] = Slab{buffer, setupMemoryLayout(buffer), 0, NoSlab, NoSlab};
+    if (m_Current >= index)
+        ++m_Current;
+
+    ++m_SlabCount;
+    return index;
+}
+
+// The slab must not be in the list of available slabs
+void BlockAllocator::removeSlab(const usize index)
+{
+    TKIT_UNPOISON_MEMORY_REGION(m_Slabs[index].Buffer, m_BufferSize);
+    DeallocateAligned(m_Slabs[index].Buffer, m_BufferSize, m_Numa);
+
+    BackwardCopy(m_Slabs + index, m_Slabs + index + 1, (m_SlabCount - index - 1) * sizeof(Slab));
+    if (m_Current > index)
+        --m_Current;
+
+    --m_SlabCount;
+    --m_EmptySlabs;
+    shiftSlabLinks(index, false);
+}
+
+void BlockAllocator::linkSlab(const usize index)
+{
+    Slab &slab = m_Slabs[index];
+    if (m_Available == NoSlab)
+    {
+        slab.Previous = NoSlab;
+        slab.Next = NoSlab;
+        m_Available = index;
+        m_LastAvailable = index;
+    }
+    else if (slab.Allocations != 0)
+    {
+        slab.Previous = NoSlab;
+        slab.Next = m_Available;
+        m_Slabs[m_Available].Previous = index;
+        m_Available = index;
+    }
+    else
+    {
+        slab.Previous = m_LastAvailable;
+        slab.Next = NoSlab;
+        m_Slabs[m_LastAvailable].Next = index;
+        m_LastAvailable = index;
+    }
+}
+
+void BlockAllocator::unlinkSlab(const usize index)
+{
+    const Slab &slab = m_Slabs[index];
+    if (slab.Previous == NoSlab)
+        m_Available = slab.Next;
+    else
+        m_Slabs[slab.Previous].Next = slab.Next;
+
+    if (slab.Next == NoSlab)
+        m_LastAvailable = slab.Previous;
+    else
+        m_Slabs[slab.Next].Previous = slab.Previous;
+}
+
+// Slabs from `index` onwards move one position when a slab is inserted or removed there, and so must the links to them.
+// Adding and removing slabs is already linear in the amount of slabs, so this does not change their cost
+void BlockAllocator::shiftSlabLinks(const usize index, const bool inserted)
+{
+    const auto shift = [index, inserted](usize &link) {
+        if (link != NoSlab && link >= index)
+            link = inserted ? link + 1 : link - 1;
+    };
+    for (usize i = 0; i < m_SlabCount; ++i)
+    {
+        shift(m_Slabs[i].Previous);
+        shift(m_Slabs[i].Next);
+    }
+    shift(m_Available);
+    shift(m_LastAvailable);
+}
+
+BlockAllocator::Allocation *BlockAllocator::setupMemoryLayout(std::byte *buffer) const
+{
+    const usize count = usize(m_BufferSize / m_AllocationSize);
 
     Allocation *next = nullptr;
     for (usize i = count - 1; i < count; --i)
     {
-        Allocation *alloc = rcast<Allocation *>(m_Buffer + i * m_AllocationSize);
+        Allocation *alloc = rcast<Allocation *>(buffer + i * m_AllocationSize);
         alloc->Next = next;
         next = alloc;
     }
-    TKIT_POISON_MEMORY_REGION(m_Buffer, m_BufferSize);
+    TKIT_POISON_MEMORY_REGION(buffer, m_BufferSize);
+    return rcast<Allocation *>(buffer);
 }
 
 void BlockAllocator::deallocateBuffer()
 {
+    if (m_Slabs)
+    {
+        for (usize i = 0; i < m_SlabCount; ++i)
+        {
+            TKIT_UNPOISON_MEMORY_REGION(m_Slabs[i].Buffer, m_BufferSize);
+            DeallocateAligned(m_Slabs[i].Buffer, m_BufferSize, m_Numa);
+        }
+        TKit::Deallocate(m_Slabs);
+        m_Slabs = nullptr;
+        return;
+    }
     if (!m_Buffer || m_Provided)
         return;
     // TKIT_LOG_WARNING_IF(
@@ -125,7 +368,7 @@ void BlockAllocator::deallocateBuffer()
     //     "trivially destructible, you will have to call "
     //     "Destroy() for each element to avoid undefined behaviour (this deallocation will not call the destructor)");
 
-    DeallocateAligned(m_Buffer);
+    DeallocateAligned(m_Buffer, m_BufferSize, m_Numa);
 }
 
 } // namespace TKit
@@ -0,0 +1,391 @@
+#include "tkit/core/pch.hpp"
+#include "tkit/memory/compacting_allocator.hpp"
+#include <bit>
+
+namespace TKit
+{
+static usize getBinIndex(const u64 size)
+{
+    const u32 msb = u32(std::bit_width(size)) - 1;
+    return usize(msb * 4 + ((size >> (msb - 2)) & 3));
+}
+
+CompactingAllocator::CompactingAllocator(const usz capacity)
+    : m_Capacity(capacity & ~(Alignment - 1))
+{
+    TKIT_ASSERT(m_Capacity >= MinBlockSize, "[TOOLKIT][COMPACT-ALLOC] The capacity must be at least {} bytes",
+                MinBlockSize);
+    TKIT_ASSERT(m_Capacity < NullOffset, "[TOOLKIT][COMPACT-ALLOC] The capacity must be smaller than 4 GiB");
+    m_Buffer = scast<std::byte *>(AllocatePages(m_Capacity));
+    TKIT_ASSERT(m_Buffer, "[TOOLKIT][COMPACT-ALLOC] Failed to allocate {} bytes", m_Capacity);
+    for (u32 &bin : m_Bins)
+        bin = NullOffset;
+}
+
+CompactingAllocator::~CompactingAllocator()
+{
+    deallocateBuffer();
+}
+
+CompactingAllocator::CompactingAllocator(CompactingAllocator &&other)
+    : m_Buffer(other.m_Buffer), m_Capacity(other.m_Capacity), m_Top(other.m_Top), m_LastSize(other.m_LastSize),
+      m_Cursor(other.m_Cursor), m_Entries(std::move(other.m_Entries)), m_FreeEntry(other.m_FreeEntry),
+      m_LiveBytes(other.m_LiveBytes), m_LiveBlocks(other.m_LiveBlocks), m_HoleBytes(other.m_HoleBytes),
+      m_Holes(other.m_Holes)
+{
+    ForwardCopy(m_Bins, other.m_Bins, sizeof(m_Bins));
+    ForwardCopy(m_BinMask, other.m_BinMask, sizeof(m_BinMask));
+    other.m_Buffer = nullptr;
+    other.m_Capacity = 0;
+}
+
+CompactingAllocator &CompactingAllocator::operator=(CompactingAllocator &&other)
+{
+    if (this != &other)
+    {
+        deallocateBuffer();
+        m_Buffer = other.m_Buffer;
+        m_Capacity = other.m_Capacity;
+        m_Top = other.m_Top;
+        m_LastSize = other.m_LastSize;
+        m_Cursor = other.m_Cursor;
+        m_Entries = std::move(other.m_Entries);
+        m_FreeEntry = other.m_FreeEntry;
+        ForwardCopy(m_Bins, other.m_Bins, sizeof(m_Bins));
+        ForwardCopy(m_BinMask, other.m_BinMask, sizeof(m_BinMask));
+        m_LiveBytes = other.m_LiveBytes;
+        m_LiveBlocks = other.m_LiveBlocks;
+        m_HoleBytes = other.m_HoleBytes;
+        m_Holes = other.m_Holes;
+
+        other.m_Buffer = nullptr;
+        other.m_Capacity = 0;
+    }
+    return *this;
+}
+
+CompactingAllocator::Handle CompactingAllocator::Allocate(const usz size)
+{
+    const usz needed = NextAlignedSize(size + sizeof(Block), Alignment);
+    if (needed > m_Capacity)
+        return Handle{};
+    const u32 blockSize = needed < MinBlockSize ? MinBlockSize : u32(needed);
+
+    u32 offset = findFree(blockSize);
+    Block *block;
+    if (offset != NullOffset)
+    {
+        removeFree(offset);
+        block = getBlock(offset);
+
+        // Give the remainder back if it is big enough to be a block on its own. It cannot have a free neighbor
+        const u32 remainder = block->Size - blockSize;
+        if (remainder >= MinBlockSize)
+        {
+            block->Size = blockSize;
+            const u32 roffset = offset + blockSize;
+            Block *rblock = getBlock(roffset);
+            rblock->Size = remainder;
+            rblock->PrevSize = blockSize;
+            rblock->EntryIndex = FreeMarker;
+            rblock->Pins = 0;
+            getBlock(roffset + remainder)->PrevSize = remainder;
+            insertFree(roffset);
+        }
+    }
+    else
+    {
+        if (m_Capacity - m_Top < blockSize)
+            return Handle{};
+        offset = m_Top;
+        block = getBlock(offset);
+        block->Size = blockSize;
+        block->PrevSize = m_LastSize;
+        m_Top += blockSize;
+        m_LastSize = blockSize;
+    }
+
+    u32 index = m_FreeEntry;
+    if (index != NullOffset)
+        m_FreeEntry = m_Entries[index].Offset;
+    else
+    {
+        index = u32(m_Entries.GetSize());
+        m_Entries.Append(Entry{0, 0, false});
+    }
+
+    Entry &entry = m_Entries[index];
+    entry.Offset = offset;
+    entry.Live = true;
+    block->EntryIndex = index;
+    block->Pins = 0;
+
+    m_LiveBytes += block->Size;
+    ++m_LiveBlocks;
+    return Handle{index, entry.Generation};
+}
+
+void CompactingAllocator::Deallocate(const Handle handle)
+{
+    TKIT_ASSERT(IsValid(handle), "[TOOLKIT][COMPACT-ALLOC] Cannot deallocate through an invalid or stale handle");
+    Entry &entry = m_Entries[handle.Index];
+    const u32 offset = entry.Offset;
+    Block *block = getBlock(offset);
+    TKIT_ASSERT(block->Pins == 0, "[TOOLKIT][COMPACT-ALLOC] Cannot deallocate a pinned allocation");
+
+    entry.Offset = m_FreeEntry;
+    entry.Live = false;
+    ++entry.Generation;
+    m_FreeEntry = handle.Index;
+
+    m_LiveBytes -= block->Size;
+    --m_LiveBlocks;
+    block->EntryIndex = FreeMarker;
+    release(offset);
+}
+
+usz CompactingAllocator::GetAllocationSize(const Handle handle) const
+{
+    TKIT_ASSERT(IsValid(handle), "[TOOLKIT][COMPACT-ALLOC] Cannot query an invalid or stale handle");
+    return getBlock(m_Entries[handle.Index].Offset)->Size - sizeof(Block);
+}
+
+void CompactingAllocator::Pin(const Handle handle)
+{
+    TKIT_ASSERT(IsValid(handle), "[TOOLKIT][COMPACT-ALLOC] Cannot pin an invalid or stale handle");
+    ++getBlock(m_Entries[handle.Index].Offset)->Pins;
+}
+void CompactingAllocator::Unpin(const Handle handle)
+{
+    TKIT_ASSERT(IsValid(handle), "[TOOLKIT][COMPACT-ALLOC] Cannot unpin an invalid or stale handle");
+    Block *block = getBlock(m_Entries[handle.Index].Offset);
+    TKIT_ASSERT(block->Pins != 0, "[TOOLKIT][COMPACT-ALLOC] Unpinning an allocation that is not pinned");
+    if (--block->Pins != 0)
+        return;
+
+    // The compaction may have skipped a hole right before the block while it was pinned
+    const u32 offset = m_Entries[handle.Index].Offset;
+    const u32 poffset = offset - block->PrevSize;
+    if (offset != 0 && poffset < m_Cursor && getBlock(poffset)->EntryIndex == FreeMarker)
+        m_Cursor = poffset;
+}
+bool CompactingAllocator::IsPinned(const Handle handle) const
+{
+    TKIT_ASSERT(IsValid(handle), "[TOOLKIT][COMPACT-ALLOC] Cannot query an invalid or stale handle");
+    return getBlock(m_Entries[handle.Index].Offset)->Pins != 0;
+}
+
+CompactingAllocator::CompactionResult CompactingAllocator::Compact(const usz maxBytes)
+{
+    CompactionResult result{};
+    while (result.BytesMoved < maxBytes)
+    {
+        const u32 moved = compactStep();
+        if (moved == 0)
+            break;
+        result.BytesMoved += moved;
+        ++result.BlocksMoved;
+    }
+    result.Finished = m_Cursor == m_Top;
+    return result;
+}
+
+CompactingAllocator::CompactionResult CompactingAllocator::CompactFor(const std::chrono::nanoseconds budget)
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+
+    CompactionResult result{};
+    do
+    {
+        const u32 moved = compactStep();
+        if (moved == 0)
+            break;
+        result.BytesMoved += moved;
+        ++result.BlocksMoved;
+    } while (Clock::now() - start < budget);
+
+    result.Finished = m_Cursor == m_Top;
+    return result;
+}
+
+CompactingAllocator::Metrics CompactingAllocator::GetMetrics() const
+{
+    Metrics metrics{};
+    metrics.Capacity = m_Capacity;
+    metrics.LiveBytes = m_LiveBytes;
+    metrics.LiveBlocks = m_LiveBlocks;
+    metrics.HoleBytes = m_HoleBytes;
+    metrics.Holes = m_Holes;
+    metrics.FreeBytes = m_HoleBytes + (m_Capacity - m_Top);
+    metrics.LargestFreeBlock = m_Capacity - m_Top;
+
+    // The largest hole can only be in the highest non-empty bin
+    for (usize word = BinCount / 64 - 1; word < BinCount / 64; --word)
+    {
+        if (m_BinMask[word] == 0)
+            continue;
+        const usize bin = word * 64 + 63 - usize(std::countl_zero(m_BinMask[word]));
+        for (u32 offset = m_Bins[bin]; offset != NullOffset; offset = getLinks(offset)->Next)
+            if (getBlock(offset)->Size > metrics.LargestFreeBlock)
+                metrics.LargestFreeBlock = getBlock(offset)->Size;
+        break;
+    }
+
+    if (metrics.FreeBytes != 0)
+        metrics.Fragmentation = 1.f - f32(metrics.LargestFreeBlock) / f32(metrics.FreeBytes);
+    return metrics;
+}
+
+u32 CompactingAllocator::findFree(const u32 size) const
+{
+    // Round the size up to the next bin boundary so that any block of the resulting bin fits
+    const u32 msb = u32(std::bit_width(size)) - 1;
+    const usize first = getBinIndex(u64(size) + (u64(1) << (msb - 2)) - 1);
+
+    for (usize word = first / 64; word < BinCount / 64; ++word)
+    {
+        u64 mask = m_BinMask[word];
+        if (word == first / 64)
+            mask &= ~u64(0) << (first % 64);
+        if (mask != 0)
+            return m_Bins[word * 64 + usize(std::countr_zero(mask))];
+    }
+    return NullOffset;
+}
+
+void CompactingAllocator::insertFree(const u32 offset)
+{
+    const u32 size = getBlock(offset)->Size;
+    const usize bin = getBinIndex(size);
+
+    FreeLinks *links = getLinks(offset);
+    links->Prev = NullOffset;
+    links->Next = m_Bins[bin];
+    if (m_Bins[bin] != NullOffset)
+        getLinks(m_Bins[bin])->Prev = offset;
+    m_Bins[bin] = offset;
+    m_BinMask[bin / 64] |= u64(1) << (bin % 64);
+
+    m_HoleBytes += size;
+    ++m_Holes;
+}
+
+void CompactingAllocator::removeFree(const u32 offset)
+{
+    const u32 size = getBlock(offset)->Size;
+    const usize bin = getBinIndex(size);
+
+    const FreeLinks *links = getLinks(offset);
+    if (links->Prev != NullOffset)
+        getLinks(links->Prev)->Next = links->Next;
+    else
+        m_Bins[bin] = links->Next;
+    if (links->Next != NullOffset)
+        getLinks(links->Next)->Prev = links->Prev;
+
+    if (m_Bins[bin] == NullOffset)
+        m_BinMask[bin / 64] &= ~(u64(1) << (bin % 64));
+
+    m_HoleBytes -= size;
+    --m_Holes;
+}
+
+void CompactingAllocator::release(u32 offset)
+{
+    Block *block = getBlock(offset);
+    u32 end = offset + block->Size;
+    if (end != m_Top)
+    {
+        const Block *next = getBlock(end);
+        if (next->EntryIndex == FreeMarker)
+        {
+            removeFree(end);
+            block->Size += next->Size;
+            end = offset + block->Size;
+        }
+    }
+    if (offset != 0)
+    {
+        const u32 poffset = offset - block->PrevSize;
+        Block *prev = getBlock(poffset);
+        if (prev->EntryIndex == FreeMarker)
+        {
+            removeFree(poffset);
+            prev->Size += block->Size;
+            offset = poffset;
+            block = prev;
+        }
+    }
+
+    // Free blocks never touch the top, they just give the memory back to the unused region
+    if (end == m_Top)
+    {
+        m_Top = offset;
+        m_LastSize = block->PrevSize;
+    }
+    else
+    {
+        getBlock(end)->PrevSize = block->Size;
+        insertFree(offset);
+    }
+    if (offset < m_Cursor)
+        m_Cursor = offset;
+}
+
+u32 CompactingAllocator::compactStep()
+{
+    while (m_Cursor < m_Top)
+    {
+        const Block *hole = getBlock(m_Cursor);
+        if (hole->EntryIndex != FreeMarker)
+        {
+            m_Cursor += hole->Size;
+            continue;
+        }
+
+        // Holes are coalesced and never touch the top, so the next block is always live
+        const u32 next = m_Cursor + hole->Size;
+        const Block *live = getBlock(next);
+        if (live->Pins != 0)
+        {
+            m_Cursor = next + live->Size;
+            continue;
+        }
+
+        const u32 holeSize = hole->Size;
+        const u32 prevSize = hole->PrevSize;
+        const u32 liveSize = live->Size;
+        removeFree(m_Cursor);
+
+        // Swap the hole and the live block, which may overlap if the block is bigger than the hole
+        BackwardCopy(m_Buffer + m_Cursor, m_Buffer + next, liveSize);
+        Block *moved = getBlock(m_Cursor);
+        moved->PrevSize = prevSize;
+        m_Entries[moved->EntryIndex].Offset = m_Cursor;
+
+        const u32 offset = m_Cursor + liveSize;
+        Block *freed = getBlock(offset);
+        freed->Size = holeSize;
+        freed->PrevSize = liveSize;
+        freed->EntryIndex = FreeMarker;
+        freed->Pins = 0;
+
+        m_Cursor = offset;
+        release(offset);
+        return liveSize;
+    }
+    return 0;
+}
+
+void CompactingAllocator::deallocateBuffer()
+{
+    if (!m_Buffer)
+        return;
+    TKIT_LOG_WARNING_IF(m_LiveBlocks != 0,
+                        "[TOOLKIT][COMPACT-ALLOC] Destroying a compacting allocator with {} live allocations",
+                        m_LiveBlocks);
+    DeallocatePages(m_Buffer, m_Capacity);
+    m_Buffer = nullptr;
+}
+} // namespace TKit
@@ -0,0 +1,268 @@
+#pragma once
+
+#include "tkit/container/dynamic_array.hpp"
+#include "tkit/memory/memory.hpp"
+#include "tkit/utils/non_copyable.hpp"
+#include "tkit/utils/limits.hpp"
+#include "tkit/utils/debug.hpp"
+#include <chrono>
+
+namespace TKit
+{
+/**
+ * @brief A heap whose allocations are addressed through handles instead of pointers, so that they can be moved to
+ * defragment it.
+ *
+ * The allocator owns a single contiguous buffer. Allocations are blocks laid out one after another, each one preceded
+ * by a small header. Freed blocks are coalesced with their free neighbors and kept in segregated free lists, from
+ * which new allocations are served first. When no free block is big enough, the allocation is bumped from the unused
+ * region at the end of the buffer.
+ *
+ * Long-running workloads with mixed allocation sizes still end up with free space scattered in many small holes.
+ * `Compact()` and `CompactFor()` slide live blocks towards the beginning of the buffer, merging the holes into the
+ * unused region at the end. Both are incremental: they stop once their budget runs out and the next call resumes where
+ * the previous one left off, so a heap can be defragmented a little bit every frame or tick without pausing. The heap
+ * stays fully usable in between calls.
+ *
+ * Compaction moves allocations with a bytewise copy, so their contents must be trivially relocatable, and raw
+ * pointers obtained from `Get()` are only valid until the next compaction call. A block can be pinned with `Pin()` to
+ * keep it in place while a pointer to it is being held, at the cost of leaving a hole behind it.
+ *
+ * Handles are generational: once an allocation is deallocated, its handles become stale and are rejected by
+ * `IsValid()` and `Get()`.
+ */
+class CompactingAllocator
+{
+    TKIT_NON_COPYABLE(CompactingAllocator)
+  public:
+    static constexpr usz Alignment = 16;
+
+    struct Handle
+    {
+        static constexpr u32 NullIndex = ~u32(0);
+
+        bool IsNull() const
+        {
+            return Index == NullIndex;
+        }
+        explicit operator bool() const
+        {
+            return !IsNull();
+        }
+
+        bool operator==(const Handle &other) const = default;
+
+        u32 Index = NullIndex;
+        u32 Generation = 0;
+    };
+
+    /**
+     * @brief A snapshot of the state of the heap. All sizes include block headers.
+     */
+    struct Metrics
+    {
+        usz Capacity = 0;
+        usz LiveBytes = 0;
+        // Free bytes in holes between live blocks plus the unused region at the end of the buffer
+        usz FreeBytes = 0;
+        usz HoleBytes = 0;
+        usz LargestFreeBlock = 0;
+        usize LiveBlocks = 0;
+        usize Holes = 0;
+        // 1 - LargestFreeBlock / FreeBytes. 0 means all free memory is contiguous
+        f32 Fragmentation = 0.f;
+    };
+
+    struct CompactionResult
+    {
+        usz BytesMoved = 0;
+        usize BlocksMoved = 0;
+        // Whether the heap had no movable blocks left after a hole when the call returned
+        bool Finished = false;
+    };
+
+    /**
+     * @param capacity The size of the buffer, in bytes. It must be smaller than 4 GiB, as blocks are addressed with
+     * 32-bit offsets.
+     */
+    explicit CompactingAllocator(usz capacity);
+    ~CompactingAllocator();
+
+    CompactingAllocator(CompactingAllocator &&other);
+    CompactingAllocator &operator=(CompactingAllocator &&other);
+
+    /**
+     * @brief Allocate a block of memory aligned to `Alignment`.
+     *
+     * @return A handle to the allocation, or a null handle if no free region is big enough. Compacting the heap may
+     * make room for it.
+     */
+    Handle Allocate(usz size);
+    void Deallocate(Handle handle);
+
+    bool IsValid(const Handle handle) const
+    {
+        return handle.Index < m_Entries.GetSize() && m_Entries[handle.Index].Generation == handle.Generation &&
+               m_Entries[handle.Index].Live;
+    }
+
+    /**
+     * @brief Get the memory of an allocation.
+     *
+     * @return A pointer to the allocation, valid until the next compaction unless the allocation is pinned, or
+     * `nullptr` if the handle is invalid or stale.
+     */
+    void *Get(const Handle handle)
+    {
+        return IsValid(handle) ? m_Buffer + m_Entries[handle.Index].Offset + sizeof(Block) : nullptr;
+    }
+    const void *Get(const Handle handle) const
+    {
+        return IsValid(handle) ? m_Buffer + m_Entries[handle.Index].Offset + sizeof(Block) : nullptr;
+    }
+
+    /**
+     * @brief Get the usable size of an allocation, which may be bigger than the requested one.
+     */
+    usz GetAllocationSize(Handle handle) const;
+
+    /**
+     * @brief Prevent an allocation from being moved by compaction. Pins are counted, so every `Pin()` must be matched
+     * by an `Unpin()`.
+     */
+    void Pin(Handle handle);
+    void Unpin(Handle handle);
+    bool IsPinned(Handle handle) const;
+
+    /**
+     * @brief Run the compaction until at least `maxBytes` bytes have been moved or there is nothing left to move.
+     *
+     * A block is never moved partially, so a call may move slightly more than `maxBytes`.
+     */
+    CompactionResult Compact(usz maxBytes = Limits<usz>::Max());
+
+    /**
+     * @brief Run the compaction until the time budget runs out or there is nothing left to move.
+     *
+     * The clock is checked after every moved block, so a call may exceed the budget by the time it takes to move one.
+     */
+    CompactionResult CompactFor(std::chrono::nanoseconds budget);
+
+    /**
+     * @brief Gather the current fragmentation metrics of the heap.
+     *
+     * It is linear in the amount of holes of the biggest size class, and meant for monitoring rather than hot paths.
+     */
+    Metrics GetMetrics() const;
+
+    template <typename T, typename... Args> Handle Create(Args &&...args)
+    {
+        static_assert(TriviallyRelocatable<T>,
+                      "[TOOLKIT][COMPACT-ALLOC] Only trivially relocatable types can live in a compacting allocator");
+        static_assert(alignof(T) <= Alignment,
+                      "[TOOLKIT][COMPACT-ALLOC] Type T has stronger memory alignment requirements than supported");
+        const Handle handle = Allocate(sizeof(T));
+        if (handle)
+            Construct(scast<T *>(Get(handle)), std::forward<Args>(args)...);
+        return handle;
+    }
+
+    template <typename T> void Destroy(const Handle handle)
+    {
+        TKIT_ASSERT(IsValid(handle), "[TOOLKIT][COMPACT-ALLOC] Cannot destroy an object through an invalid handle");
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            Destruct(scast<T *>(Get(handle)));
+        Deallocate(handle);
+    }
+
+    template <typename T> T *Get(const Handle handle)
+    {
+        return scast<T *>(Get(handle));
+    }
+    template <typename T> const T *Get(const Handle handle) const
+    {
+        return scast<const T *>(Get(handle));
+    }
+
+    usz GetCapacity() const
+    {
+        return m_Capacity;
+    }
+    // End of the last block, after which all memory is unused
+    usz GetTop() const
+    {
+        return m_Top;
+    }
+    usize GetAllocationCount() const
+    {
+        return m_LiveBlocks;
+    }
+
+  private:
+    static constexpr u32 FreeMarker = ~u32(0);
+    static constexpr u32 NullOffset = ~u32(0);
+    // Four bins per power of two
+    static constexpr usize BinCount = 128;
+
+    struct Block
+    {
+        u32 Size;
+        // Size of the block right before this one, so that it can be reached to coalesce. 0 for the first block
+        u32 PrevSize;
+        // Index of the handle entry, or `FreeMarker` if the block is free
+        u32 EntryIndex;
+        u32 Pins;
+    };
+    static_assert(sizeof(Block) == Alignment);
+
+    // Stored in the payload of free blocks
+    struct FreeLinks
+    {
+        u32 Prev;
+        u32 Next;
+    };
+    static constexpr u32 MinBlockSize = 32;
+
+    struct Entry
+    {
+        // Offset of the block while live, next free entry otherwise
+        u32 Offset;
+        u32 Generation;
+        bool Live;
+    };
+
+    Block *getBlock(const u32 offset) const
+    {
+        return rcast<Block *>(m_Buffer + offset);
+    }
+    FreeLinks *getLinks(const u32 offset) const
+    {
+        return rcast<FreeLinks *>(m_Buffer + offset + sizeof(Block));
+    }
+
+    u32 findFree(u32 size) const;
+    void insertFree(u32 offset);
+    void removeFree(u32 offset);
+    void release(u32 offset);
+    u32 compactStep();
+    void deallocateBuffer();
+
+    std::byte *m_Buffer = nullptr;
+    usz m_Capacity = 0;
+    u32 m_Top = 0;
+    u32 m_LastSize = 0;
+    // Blocks below the cursor are known not to be followed by a hole, unless a deallocation moves it back
+    u32 m_Cursor = 0;
+
+    DynamicArray<Entry> m_Entries{};
+    u32 m_FreeEntry = NullOffset;
+
+    u32 m_Bins[BinCount];
+    u64 m_BinMask[BinCount / 64] = {};
+
+    usz m_LiveBytes = 0;
+    usize m_LiveBlocks = 0;
+    usz m_HoleBytes = 0;
+    usize m_Holes = 0;
+};
+} // namespace TKit
@@ -0,0 +1,168 @@
+#include "tkit/core/pch.hpp"
+#include "tkit/memory/concurrent_block_allocator.hpp"
+#include "tkit/utils/debug.hpp"
+
+namespace TKit
+{
+#ifdef TKIT_ASAN_ENABLED
+// The first bytes of a free block hold the index to the next one, and other threads may read them while racing for the
+// head of the free list. Those are never poisoned
+static constexpr usz s_PoisonOffset = 8;
+
+static void poisonBlock(std::byte *ptr, const usz size)
+{
+    if (size > s_PoisonOffset)
+        TKIT_POISON_MEMORY_REGION(ptr + s_PoisonOffset, size - s_PoisonOffset);
+}
+#    define TKIT_POISON_BLOCK(ptr, size) poisonBlock(ptr, size)
+#else
+#    define TKIT_POISON_BLOCK(ptr, size)
+#endif
+
+ConcurrentBlockAllocator::ConcurrentBlockAllocator(const usz bufferSize, const usz allocationSize,
+                                                   const usize alignment)
+    : m_BufferSize(bufferSize), m_AllocationSize(allocationSize), m_Provided(false)
+{
+    TKIT_ASSERT(allocationSize >= sizeof(Allocation),
+                "[TOOLKIT][BLOCK-ALLOC] The allocation size must be at least {:L} bytes", sizeof(Allocation));
+    TKIT_ASSERT(alignment >= alignof(Allocation), "[TOOLKIT][BLOCK-ALLOC] The alignment must be at least {:L} bytes",
+                alignof(Allocation));
+    TKIT_ASSERT(bufferSize % alignment == 0, "[TOOLKIT][BLOCK-ALLOC] The buffer size must be a multiple of the "
+                                             "alignment to ensure every block of memory is aligned to it");
+    TKIT_ASSERT(bufferSize % allocationSize == 0,
+                "[TOOLKIT][BLOCK-ALLOC] The buffer size must be a multiple of the allocation size to guarantee a tight "
+                "fit, but got {:L}",
+                bufferSize);
+    TKIT_ASSERT(allocationSize % alignment == 0,
+                "[TOOLKIT][BLOCK-ALLOC] The allocation size must be a multiple of "
+                "the alignment to ensure every block of memory is aligned to it, but got {:L}",
+                allocationSize);
+
+    m_Buffer = scast<std::byte *>(AllocateAligned(bufferSize, alignment));
+    TKIT_ASSERT(m_Buffer, "[TOOLKIT][BLOCK-ALLOC] Failed to allocate {:L} bytes of memory aligned to {:L} bytes",
+                bufferSize, alignment);
+    setupMemoryLayout();
+}
+
+ConcurrentBlockAllocator::ConcurrentBlockAllocator(void *buffer, const usz bufferSize, const usz allocationSize)
+    : m_Buffer(scast<std::byte *>(buffer)), m_BufferSize(bufferSize), m_AllocationSize(allocationSize), m_Provided(true)
+{
+    TKIT_ASSERT(bufferSize % allocationSize == 0,
+                "[TOOLKIT][BLOCK-ALLOC] The buffer size ({:L}) must be a multiple of the allocation size to guarantee "
+                "a tight fit",
+                bufferSize);
+    TKIT_ASSERT(IsAligned(buffer, alignof(Allocation)) && allocationSize % alignof(Allocation) == 0,
+                "[TOOLKIT][BLOCK-ALLOC] The provided buffer and allocation size must be aligned to at least {:L} bytes",
+                alignof(Allocation));
+    setupMemoryLayout();
+}
+
+ConcurrentBlockAllocator::~ConcurrentBlockAllocator()
+{
+    deallocateBuffer();
+}
+
+ConcurrentBlockAllocator::ConcurrentBlockAllocator(ConcurrentBlockAllocator &&other)
+    : m_FreeList(other.m_FreeList.load(std::memory_order_relaxed)), m_Buffer(other.m_Buffer),
+      m_BufferSize(other.m_BufferSize), m_AllocationSize(other.m_AllocationSize), m_Provided(other.m_Provided)
+{
+    other.m_Buffer = nullptr;
+    other.m_FreeList.store(s_Null, std::memory_order_relaxed);
+    other.m_BufferSize = 0;
+    other.m_AllocationSize = 0;
+    other.m_Provided = false;
+}
+
+ConcurrentBlockAllocator &ConcurrentBlockAllocator::operator=(ConcurrentBlockAllocator &&other)
+{
+    if (this != &other)
+    {
+        deallocateBuffer();
+        m_Buffer = other.m_Buffer;
+        m_FreeList.store(other.m_FreeList.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m_BufferSize = other.m_BufferSize;
+        m_AllocationSize = other.m_AllocationSize;
+        m_Provided = other.m_Provided;
+
+        other.m_Buffer = nullptr;
+        other.m_FreeList.store(s_Null, std::memory_order_relaxed);
+        other.m_BufferSize = 0;
+        other.m_AllocationSize = 0;
+        other.m_Provided = false;
+    }
+    return *this;
+}
+
+void *ConcurrentBlockAllocator::Allocate()
+{
+    u64 head = m_FreeList.load(std::memory_order_acquire);
+    for (;;)
+    {
+        const u32 index = getIndex(head);
+        if (index == s_Null)
+        {
+            TKIT_LOG_WARNING("[TOOLKIT][BLOCK-ALLOC] Allocator ran out of slots when trying to perform an allocation");
+            return nullptr;
+        }
+
+        // If another thread pops this block before us, the value read here may be garbage, but the tag will have
+        // changed and the exchange will fail
+        Allocation *alloc = getAllocation(index);
+        const u32 next = alloc->Next.load(std::memory_order_relaxed);
+        if (m_FreeList.compare_exchange_weak(head, makeHead(next, head), std::memory_order_acquire,
+                                             std::memory_order_acquire))
+        {
+            TKIT_UNPOISON_MEMORY_REGION(alloc, m_AllocationSize);
+            return alloc;
+        }
+    }
+}
+
+void ConcurrentBlockAllocator::Deallocate(const void *ptr)
+{
+    TKIT_ASSERT(ptr, "[TOOLKIT][BLOCK-ALLOC] Cannot deallocate a null pointer");
+    TKIT_ASSERT(Belongs(ptr),
+                "[TOOLKIT][BLOCK-ALLOC] Cannot deallocate a pointer that does not belong to the allocator");
+
+    std::byte *bptr = scast<std::byte *>(ccast<void *>(ptr));
+    const u32 index = u32(usz(bptr - m_Buffer) / m_AllocationSize);
+    TKIT_ASSERT(bptr == rcast<std::byte *>(getAllocation(index)),
+                "[TOOLKIT][BLOCK-ALLOC] The pointer to deallocate must point to the beginning of a block");
+
+    // The link was constructed once in setupMemoryLayout(). A thread that read a stale head may still be loading it, so
+    // it is only ever written atomically
+    Allocation *alloc = getAllocation(index);
+    TKIT_POISON_BLOCK(bptr, m_AllocationSize);
+
+    u64 head = m_FreeList.load(std::memory_order_relaxed);
+    do
+    {
+        alloc->Next.store(getIndex(head), std::memory_order_relaxed);
+    } while (!m_FreeList.compare_exchange_weak(head, makeHead(index, head), std::memory_order_release,
+                                               std::memory_order_relaxed));
+}
+
+void ConcurrentBlockAllocator::setupMemoryLayout()
+{
+    const usize count = GetAllocationCapacityCount();
+    TKIT_ASSERT(count < s_Null, "[TOOLKIT][BLOCK-ALLOC] The allocator can hold at most {:L} blocks, but got {:L}",
+                s_Null - 1, count);
+
+    for (usize i = 0; i < count; ++i)
+    {
+        Allocation *alloc = Construct(getAllocation(u32(i)));
+        alloc->Next.store(i + 1 < count ? u32(i + 1) : s_Null, std::memory_order_relaxed);
+        TKIT_POISON_BLOCK(rcast<std::byte *>(alloc), m_AllocationSize);
+    }
+    m_FreeList.store(count > 0 ? 0 : s_Null, std::memory_order_release);
+}
+
+void ConcurrentBlockAllocator::deallocateBuffer()
+{
+    if (!m_Buffer || m_Provided)
+        return;
+    TKIT_UNPOISON_MEMORY_REGION(m_Buffer, m_BufferSize);
+    DeallocateAligned(m_Buffer);
+}
+
+} // namespace TKit
@@ -0,0 +1,208 @@
+#pragma once
+
+#ifndef TKIT_ENABLE_BLOCK_ALLOCATOR
+#    error                                                                                                             \
+        "[TOOLKIT][BLOCK-ALLOC] To include this file, the corresponding feature must be enabled in CMake with TOOLKIT_ENABLE_BLOCK_ALLOCATOR"
+#endif
+
+#include "tkit/utils/non_copyable.hpp"
+#include "tkit/preprocessor/system.hpp"
+#include "tkit/memory/memory.hpp"
+#include "tkit/utils/debug.hpp"
+#include "tkit/utils/limits.hpp"
+#include <atomic>
+
+namespace TKit
+{
+/**
+ * @brief A thread-safe, lock-free version of the `BlockAllocator`.
+ *
+ * Every allocation (block) this allocator provides has always the same size, specified at construction. Any thread may
+ * allocate a block and any thread may deallocate it, regardless of which thread allocated it in the first place. This
+ * makes it suitable to recycle fixed-size objects (messages, nodes, etc) that are produced in one thread and consumed
+ * in another.
+ *
+ * The free list is a Treiber stack whose head is a tagged index: the lower 32 bits hold the index of the first free
+ * block and the upper 32 bits hold a tag that is bumped on every successful update. Packing both in a single 64-bit
+ * word avoids the ABA problem without requiring double-width compare-and-swap instructions. Blocks are referenced by
+ * index, so the allocator can hold at most 2^32 - 1 blocks.
+ *
+ * Like the `BlockAllocator`, it holds a single memory buffer whose size is provided at construction and cannot be
+ * modified afterwards. Construction, destruction and move operations are NOT thread-safe.
+ */
+class alignas(TKIT_CACHE_LINE_SIZE) ConcurrentBlockAllocator
+{
+    TKIT_NON_COPYABLE(ConcurrentBlockAllocator)
+  public:
+    // The alignment parameter specifies the alignment of all consecuent allocations. Thus, the buffer size must be a
+    // multiple of the alignment
+
+    ConcurrentBlockAllocator(usz bufferSize, usz allocationSize, usize alignment = alignof(std::max_align_t));
+
+    // This constructor is NOT owning the buffer, so it will not deallocate it. Up to the user to manage the memory
+    ConcurrentBlockAllocator(void *buffer, usz bufferSize, usz allocationSize);
+    ~ConcurrentBlockAllocator();
+
+    ConcurrentBlockAllocator(ConcurrentBlockAllocator &&other);
+    ConcurrentBlockAllocator &operator=(ConcurrentBlockAllocator &&other);
+
+    /**
+     * @brief Create a concurrent block allocator suited to allocate elements from type `T`.
+     *
+     * @tparam T The type the allocator will be suited for.
+     * @param count The capacity of the allocator, measured in how many objects of type `T` will be able to allocate.
+     * @return A `ConcurrentBlockAllocator` instance.
+     */
+    template <typename T> static ConcurrentBlockAllocator CreateFromType(const usize count)
+    {
+        const usz size = sizeof(T) > sizeof(Allocation) ? sizeof(T) : sizeof(Allocation);
+        const usz alignment = alignof(T) > alignof(Allocation) ? alignof(T) : alignof(Allocation);
+        const usz asize = NextAlignedSize(size, alignment);
+        return ConcurrentBlockAllocator{count * asize, asize, usize(alignment)};
+    }
+
+    /**
+     * @brief Allocate a new block of memory from the allocator.
+     *
+     * This method may be accessed concurrently by any thread.
+     *
+     * @return A pointer to the allocated block. If the allocation fails, `nullptr` will be returned.
+     */
+    void *Allocate();
+
+    /**
+     * @brief Allocate a new block of memory from the allocator.
+     *
+     * This method may be accessed concurrently by any thread.
+     *
+     * @tparam T The type of object to allocate.
+     * @return A pointer to the allocated block. If the allocation fails, `nullptr` will be returned.
+     */
+    template <typename T> T *Allocate()
+    {
+        TKIT_ASSERT(
+            sizeof(T) <= m_AllocationSize,
+            "[TOOLKIT][BLOCK-ALLOC] Block allocator allocation size is {:L}, but sizeof(T) is {:L} bytes, which "
+            "does not fit into an allocation",
+            m_AllocationSize, sizeof(T));
+        T *ptr = scast<T *>(Allocate());
+        TKIT_ASSERT(!ptr || IsAligned(ptr, alignof(T)),
+                    "[TOOLKIT][BLOCK-ALLOC] Type T has stronger memory alignment requirements than specified. Bump the "
+                    "alignment of the allocator or prevent using it to allocate objects of such type");
+        return ptr;
+    }
+
+    /**
+     * @brief Deallocate a block of memory from the allocator.
+     *
+     * This method may be accessed concurrently by any thread. The block does not need to be deallocated by the same
+     * thread that allocated it.
+     *
+     * @param ptr A pointer to the block to deallocate.
+     */
+    void Deallocate(const void *ptr);
+
+    /**
+     * @brief Allocate a new block of memory and create a new object of type `T` out of it.
+     *
+     * This method may be accessed concurrently by any thread.
+     *
+     * @tparam T The type of object to allocate.
+     * @return A pointer to the allocated block. If the allocation fails, `nullptr` will be returned and the object will
+     * not be constructed.
+     */
+    template <typename T, typename... Args> T *Create(Args &&...args)
+    {
+        T *ptr = Allocate<T>();
+        return ptr ? Construct(ptr, std::forward<Args>(args)...) : nullptr;
+    }
+
+    /**
+     * @brief Deallocate a block of memory and destroy the object of type `T` created from it.
+     *
+     * This method may be accessed concurrently by any thread.
+     *
+     * @tparam T The type of object to deallocate.
+     * @param ptr The pointer to the block to deallocate.
+     */
+    template <typename T> void Destroy(const T *ptr)
+    {
+        TKIT_ASSERT(ptr, "[TOOLKIT][BLOCK-ALLOC] Cannot deallocate a null pointer");
+        TKIT_ASSERT(Belongs(ptr),
+                    "[TOOLKIT][BLOCK-ALLOC] Cannot deallocate a pointer that does not belong to the allocator");
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            ptr->~T();
+        Deallocate(ptr);
+    }
+
+    /**
+     * @brief Check if a pointer belongs to the allocator.
+     *
+     * @note This is a simple check to see if the provided pointer lies within the boundaries of the buffer. It will not
+     * be able to determine if the pointer is currently allocated or free.
+     *
+     * @param ptr The pointer to check.
+     * @return Whether the pointer belongs to the allocator.
+     */
+    bool Belongs(const void *ptr) const
+    {
+        const std::byte *bptr = scast<const std::byte *>(ptr);
+        return bptr >= m_Buffer && bptr < m_Buffer + m_BufferSize;
+    }
+
+    /**
+     * @brief Check if the allocator has run out of blocks.
+     *
+     * @note The result may be outdated by the time it is returned if other threads are operating on the allocator.
+     */
+    bool IsFull() const
+    {
+        return getIndex(m_FreeList.load(std::memory_order_relaxed)) == s_Null;
+    }
+
+    usz GetBufferSize() const
+    {
+        return m_BufferSize;
+    }
+    usz GetAllocationSize() const
+    {
+        return m_AllocationSize;
+    }
+
+    usize GetAllocationCapacityCount() const
+    {
+        return usize(m_BufferSize / m_AllocationSize);
+    }
+
+  private:
+    struct Allocation
+    {
+        std::atomic<u32> Next;
+    };
+
+    static constexpr u32 s_Null = Limits<u32>::Max();
+
+    static u32 getIndex(const u64 head)
+    {
+        return u32(head);
+    }
+    static u64 makeHead(const u32 index, const u64 oldHead)
+    {
+        return (((oldHead >> 32) + 1) << 32) | u64(index);
+    }
+
+    Allocation *getAllocation(const u32 index) const
+    {
+        return rcast<Allocation *>(m_Buffer + usz(index) * m_AllocationSize);
+    }
+
+    void setupMemoryLayout();
+    void deallocateBuffer();
+
+    alignas(TKIT_CACHE_LINE_SIZE) std::atomic<u64> m_FreeList{0};
+    alignas(TKIT_CACHE_LINE_SIZE) std::byte *m_Buffer;
+    usz m_BufferSize;
+    usz m_AllocationSize;
+    bool m_Provided;
+};
+} // namespace TKit
@@ -0,0 +1,102 @@
+#include "tkit/core/pch.hpp"
+#include "tkit/memory/frame_allocator.hpp"
+#include "tkit/utils/bit.hpp"
+#ifdef TKIT_ENABLE_MULTIPROCESSING
+#    include "tkit/multiprocessing/topology.hpp"
+#endif
+
+namespace TKit
+{
+FrameAllocator::FrameAllocator(const FrameSpecs &specs) : m_Frames(specs.Frames), m_Threads(specs.Threads)
+{
+    TKIT_ASSERT(specs.Capacity != 0, "[TOOLKIT][FRAME-ALLOC] The capacity of the arenas must be greater than 0");
+    TKIT_ASSERT(specs.Frames != 0, "[TOOLKIT][FRAME-ALLOC] There must be at least one frame");
+    TKIT_ASSERT(specs.Threads != 0, "[TOOLKIT][FRAME-ALLOC] There must be at least one thread");
+    TKIT_ASSERT(IsPowerOfTwo(specs.Alignment),
+                "[TOOLKIT][FRAME-ALLOC] Alignment must be a power of 2, but the value is {}", specs.Alignment);
+
+    // Every arena starts at a cache line boundary so that threads never share one
+    const usize alignment = specs.Alignment > TKIT_CACHE_LINE_SIZE ? specs.Alignment : usize(TKIT_CACHE_LINE_SIZE);
+    m_Capacity = NextAlignedSize(specs.Capacity, alignment);
+
+    const usize count = m_Frames * m_Threads;
+    m_Buffer = scast<std::byte *>(AllocateAligned(count * m_Capacity, alignment));
+    TKIT_ASSERT(m_Buffer, "[TOOLKIT][FRAME-ALLOC] Failed to allocate {:L} bytes of memory", count * m_Capacity);
+
+    m_Arenas = scast<ArenaAllocator *>(AllocateAligned(count * sizeof(ArenaAllocator), alignof(ArenaAllocator)));
+    TKIT_ASSERT(m_Arenas, "[TOOLKIT][FRAME-ALLOC] Failed to allocate memory for the arenas");
+    for (usize i = 0; i < count; ++i)
+        Construct(m_Arenas + i, m_Buffer + i * m_Capacity, m_Capacity, specs.Alignment);
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    deallocateBuffer();
+}
+
+FrameAllocator::FrameAllocator(FrameAllocator &&other)
+    : m_Arenas(other.m_Arenas), m_Buffer(other.m_Buffer), m_FrameIndex(other.m_FrameIndex),
+      m_Capacity(other.m_Capacity), m_Frames(other.m_Frames), m_Threads(other.m_Threads)
+{
+    other.m_Arenas = nullptr;
+    other.m_Buffer = nullptr;
+    other.m_FrameIndex = 0;
+    other.m_Capacity = 0;
+    other.m_Frames = 0;
+    other.m_Threads = 0;
+}
+
+FrameAllocator &FrameAllocator::operator=(FrameAllocator &&other)
+{
+    if (this != &other)
+    {
+        deallocateBuffer();
+        m_Arenas = other.m_Arenas;
+        m_Buffer = other.m_Buffer;
+        m_FrameIndex = other.m_FrameIndex;
+        m_Capacity = other.m_Capacity;
+        m_Frames = other.m_Frames;
+        m_Threads = other.m_Threads;
+
+        other.m_Arenas = nullptr;
+        other.m_Buffer = nullptr;
+        other.m_FrameIndex = 0;
+        other.m_Capacity = 0;
+        other.m_Frames = 0;
+        other.m_Threads = 0;
+    }
+    return *this;
+}
+
+void FrameAllocator::BeginFrame()
+{
+    // Arenas of a thread are sorted from newest to oldest. The oldest is recycled as the new active arena, and moving
+    // arenas around (instead of pointers to them) keeps the address of the active one stable
+    for (usize i = 0; i < m_Threads; ++i)
+    {
+        ArenaAllocator *arenas = m_Arenas + i * m_Frames;
+        ArenaAllocator oldest = std::move(arenas[m_Frames - 1]);
+        for (usize j = m_Frames - 1; j > 0; --j)
+            arenas[j] = std::move(arenas[j - 1]);
+        arenas[0] = std::move(oldest);
+        arenas[0].Reset();
+    }
+    ++m_FrameIndex;
+}
+
+#ifdef TKIT_ENABLE_MULTIPROCESSING
+ArenaAllocator *FrameAllocator::GetArena()
+{
+    return GetArena(Topology::GetThreadIndex());
+}
+#endif
+
+void FrameAllocator::deallocateBuffer()
+{
+    if (!m_Buffer)
+        return;
+    DestructRange(m_Arenas, m_Arenas + m_Frames * m_Threads);
+    DeallocateAligned(m_Arenas);
+    DeallocateAligned(m_Buffer);
+}
+} // namespace TKit
@@ -0,0 +1,127 @@
+#pragma once
+
+#ifndef TKIT_ENABLE_ARENA_ALLOCATOR
+#    error                                                                                                             \
+        "[TOOLKIT][FRAME-ALLOC] To include this file, the corresponding feature must be enabled in CMake with TOOLKIT_ENABLE_ARENA_ALLOCATOR"
+#endif
+
+#include "tkit/memory/arena_allocator.hpp"
+#include "tkit/utils/debug.hpp"
+
+namespace TKit
+{
+struct FrameSpecs
+{
+    // Capacity of every arena, in bytes
+    usz Capacity = 0;
+    // How many frames an allocation survives. 2 means double buffering
+    usize Frames = 2;
+    // How many threads will allocate concurrently, each one getting its own arena. Threads are identified by their
+    // thread index, so this is usually the amount of threads of the thread pool (workers plus the main thread)
+    usize Threads = 1;
+    usize Alignment = alignof(std::max_align_t);
+};
+
+/**
+ * @brief An N-buffered arena allocator meant for transient data that lives for a fixed amount of frames.
+ *
+ * Every thread owns a set of `Frames` arenas. At any given time, one of them is the active arena, where the thread
+ * bump-allocates without contention, and the rest hold the allocations of the previous frames. Calling `BeginFrame()`
+ * rotates the arenas of every thread: the oldest one is reset and becomes the active arena, so an allocation made
+ * during a frame remains valid for the following `Frames - 1` calls to `BeginFrame()`.
+ *
+ * The address of the active arena of a thread never changes, as rotating the frames swaps the contents of the arenas
+ * instead. This means `PushArena(frame.GetArena())` only needs to be called once, and containers such as `ArenaArray`
+ * will pick up the arena of the current frame automatically from then on.
+ *
+ * All arenas are carved out of a single buffer, and every arena starts at a cache line boundary.
+ *
+ * @note Thread safety considerations: Each thread may allocate from its own arena concurrently. `BeginFrame()` must be
+ * called while no other thread is allocating, usually from the main thread between frames.
+ */
+class alignas(TKIT_CACHE_LINE_SIZE) FrameAllocator
+{
+    TKIT_NON_COPYABLE(FrameAllocator)
+  public:
+    explicit FrameAllocator(const FrameSpecs &specs);
+    ~FrameAllocator();
+
+    FrameAllocator(FrameAllocator &&other);
+    FrameAllocator &operator=(FrameAllocator &&other);
+
+    /**
+     * @brief Begin a new frame, resetting the oldest arena of every thread and making it the active one.
+     *
+     * Allocations made `Frames` frames ago are invalidated.
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Get the active arena of a thread.
+     *
+     * The returned pointer remains valid and keeps referring to the active arena across frames.
+     *
+     * @param threadIndex The index of the thread.
+     */
+    ArenaAllocator *GetArena(const usize threadIndex)
+    {
+        TKIT_ASSERT(threadIndex < m_Threads,
+                    "[TOOLKIT][FRAME-ALLOC] Thread index {} is out of bounds. The allocator was created for {} threads",
+                    threadIndex, m_Threads);
+        return &m_Arenas[threadIndex * m_Frames];
+    }
+
+#ifdef TKIT_ENABLE_MULTIPROCESSING
+    /**
+     * @brief Get the active arena of the calling thread, identified by `Topology::GetThreadIndex()`.
+     */
+    ArenaAllocator *GetArena();
+
+    void *Allocate(const usz size)
+    {
+        return GetArena()->Allocate(size);
+    }
+    template <typename T> T *Allocate(const usize count = 1)
+    {
+        return GetArena()->Allocate<T>(count);
+    }
+    template <typename T, typename... Args> T *Create(Args &&...args)
+    {
+        return GetArena()->Create<T>(std::forward<Args>(args)...);
+    }
+    template <typename T, typename... Args> T *NCreate(const usize count, Args &&...args)
+    {
+        return GetArena()->NCreate<T>(count, std::forward<Args>(args)...);
+    }
+#endif
+
+    // Counts how many times BeginFrame() has been called
+    u64 GetFrameIndex() const
+    {
+        return m_FrameIndex;
+    }
+    usize GetFrameCount() const
+    {
+        return m_Frames;
+    }
+    usize GetThreadCount() const
+    {
+        return m_Threads;
+    }
+    // Capacity of every individual arena
+    usz GetCapacity() const
+    {
+        return m_Capacity;
+    }
+
+  private:
+    void deallocateBuffer();
+
+    ArenaAllocator *m_Arenas = nullptr;
+    std::byte *m_Buffer = nullptr;
+    u64 m_FrameIndex = 0;
+    usz m_Capacity = 0;
+    usize m_Frames = 0;
+    usize m_Threads = 0;
+};
+} // namespace TKit
@@ -0,0 +1,322 @@
+#include "tkit/core/pch.hpp"
+#include "tkit/memory/mapped_file.hpp"
+#include "tkit/memory/memory.hpp"
+#include <cstring>
+#ifdef TKIT_OS_WINDOWS
+#    include "tkit/core/windows.hpp"
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace TKit
+{
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile &&other)
+    : m_Data(other.m_Data), m_Size(other.m_Size), m_Capacity(other.m_Capacity), m_File(other.m_File),
+#ifdef TKIT_OS_WINDOWS
+      m_Mapping(other.m_Mapping),
+#endif
+      m_Mode(other.m_Mode)
+{
+    other.m_Data = nullptr;
+    other.m_Size = 0;
+    other.m_Capacity = 0;
+    other.m_File = InvalidFile;
+#ifdef TKIT_OS_WINDOWS
+    other.m_Mapping = nullptr;
+#endif
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other)
+{
+    if (this != &other)
+    {
+        Close();
+        m_Data = other.m_Data;
+        m_Size = other.m_Size;
+        m_Capacity = other.m_Capacity;
+        m_File = other.m_File;
+#ifdef TKIT_OS_WINDOWS
+        m_Mapping = other.m_Mapping;
+#endif
+        m_Mode = other.m_Mode;
+
+        other.m_Data = nullptr;
+        other.m_Size = 0;
+        other.m_Capacity = 0;
+        other.m_File = InvalidFile;
+#ifdef TKIT_OS_WINDOWS
+        other.m_Mapping = nullptr;
+#endif
+    }
+    return *this;
+}
+
+Result<MappedFile> MappedFile::Open(const char *path, const MapMode mode)
+{
+    MappedFile file{};
+    file.m_Mode = mode;
+#ifdef TKIT_OS_WINDOWS
+    const DWORD access = mode == Map_ReadWrite ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+    file.m_File = CreateFileA(path, access, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file.m_File == InvalidFile)
+        return Result<MappedFile>::Error("[TOOLKIT][MAPPED-FILE] Failed to open the file");
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file.m_File, &size))
+        return Result<MappedFile>::Error("[TOOLKIT][MAPPED-FILE] Failed to query the size of the file");
+    file.m_Size = usz(size.QuadPart);
+#else
+    file.m_File = open(path, mode == Map_ReadWrite ? O_RDWR : O_RDONLY);
+    if (file.m_File == InvalidFile)
+        return Result<MappedFile>::Error("[TOOLKIT][MAPPED-FILE] Failed to open the file");
+
+    struct stat info;
+    if (fstat(file.m_File, &info) != 0)
+        return Result<MappedFile>::Error("[TOOLKIT][MAPPED-FILE] Failed to query the size of the file");
+    file.m_Size = usz(info.st_size);
+#endif
+    if (!file.map(file.m_Size))
+        return Result<MappedFile>::Error("[TOOLKIT][MAPPED-FILE] Failed to map the file");
+    return Result<MappedFile>::Ok(std::move(file));
+}
+
+Result<MappedFile> MappedFile::Create(const char *path, const usz size)
+{
+    MappedFile file{};
+    file.m_Mode = Map_ReadWrite;
+#ifdef TKIT_OS_WINDOWS
+    file.m_File = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+#else
+    file.m_File = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+#endif
+    if (file.m_File == InvalidFile)
+        return Result<MappedFile>::Error("[TOOLKIT][MAPPED-FILE] Failed to create the file");
+
+    if (!file.Resize(size))
+        return Result<MappedFile>::Error("[TOOLKIT][MAPPED-FILE] Failed to map the file");
+    return Result<MappedFile>::Ok(std::move(file));
+}
+
+void MappedFile::Close()
+{
+    if (!IsOpen())
+        return;
+    unmap();
+#ifdef TKIT_OS_WINDOWS
+    if (IsWritable())
+    {
+        LARGE_INTEGER size;
+        size.QuadPart = LONGLONG(m_Size);
+        SetFilePointerEx(m_File, size, nullptr, FILE_BEGIN);
+        SetEndOfFile(m_File);
+    }
+    CloseHandle(m_File);
+#else
+    if (IsWritable() && m_Capacity != m_Size)
+    {
+        const int result = ftruncate(m_File, off_t(m_Size));
+        TKIT_LOG_WARNING_IF(result != 0, "[TOOLKIT][MAPPED-FILE] Failed to truncate the file to its final size");
+    }
+    close(m_File);
+#endif
+    m_File = InvalidFile;
+    m_Size = 0;
+    m_Capacity = 0;
+}
+
+bool MappedFile::Advise(const MapAdvice advice, const usz offset, usz size) const
+{
+    if (!m_Data || offset >= m_Capacity)
+        return false;
+    if (size == 0 || offset + size > m_Capacity)
+        size = m_Capacity - offset;
+#ifdef TKIT_OS_WINDOWS
+    if (advice != MapAdvice_WillNeed)
+        return false;
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = scast<std::byte *>(m_Data) + offset;
+    range.NumberOfBytes = size;
+    return PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    // madvise requires a page aligned address
+    const usz page = usz(sysconf(_SC_PAGESIZE));
+    const usz begin = offset & ~(page - 1);
+    std::byte *ptr = scast<std::byte *>(m_Data) + begin;
+    size += offset - begin;
+
+    int flag;
+    switch (advice)
+    {
+    case MapAdvice_Normal:
+        flag = MADV_NORMAL;
+        break;
+    case MapAdvice_Sequential:
+        flag = MADV_SEQUENTIAL;
+        break;
+    case MapAdvice_Random:
+        flag = MADV_RANDOM;
+        break;
+    case MapAdvice_WillNeed:
+        flag = MADV_WILLNEED;
+        break;
+    case MapAdvice_HugePage:
+#    ifdef MADV_HUGEPAGE
+        flag = MADV_HUGEPAGE;
+        break;
+#    else
+        return false;
+#    endif
+    default:
+        return false;
+    }
+    return madvise(ptr, size, flag) == 0;
+#endif
+}
+
+bool MappedFile::Flush() const
+{
+    if (!m_Data || !IsWritable())
+        return !m_Data;
+#ifdef TKIT_OS_WINDOWS
+    return FlushViewOfFile(m_Data, m_Size) && FlushFileBuffers(m_File);
+#else
+    return msync(m_Data, m_Capacity, MS_SYNC) == 0;
+#endif
+}
+
+bool MappedFile::Resize(const usz size)
+{
+    TKIT_ASSERT(IsWritable(), "[TOOLKIT][MAPPED-FILE] Only writable files can be resized");
+    if (size > m_Capacity && !Reserve(size))
+        return false;
+
+    // Bytes past the logical size may hold stale content from a previous shrink
+    if (size > m_Size)
+        std::memset(scast<std::byte *>(m_Data) + m_Size, 0, size - m_Size);
+    m_Size = size;
+    return true;
+}
+
+bool MappedFile::Reserve(const usz capacity)
+{
+    TKIT_ASSERT(IsWritable(), "[TOOLKIT][MAPPED-FILE] Only writable files can reserve space");
+    if (capacity <= m_Capacity)
+        return true;
+    return remap(capacity);
+}
+
+void *MappedFile::Append(const void *data, const usz size)
+{
+    TKIT_ASSERT(IsWritable(), "[TOOLKIT][MAPPED-FILE] Only writable files can be appended to");
+    const usz offset = m_Size;
+    if (offset + size > m_Capacity)
+    {
+        const usz capacity = 2 * m_Capacity;
+        if (!Reserve(capacity > offset + size ? capacity : offset + size))
+            return nullptr;
+    }
+    std::byte *dst = scast<std::byte *>(m_Data) + offset;
+    ForwardCopy(dst, data, size);
+    m_Size += size;
+    return dst;
+}
+
+bool MappedFile::map(const usz capacity)
+{
+    // Empty files cannot be mapped
+    if (capacity == 0)
+    {
+        m_Capacity = 0;
+        return true;
+    }
+#ifdef TKIT_OS_WINDOWS
+    const DWORD protection = IsWritable() ? PAGE_READWRITE : PAGE_READONLY;
+    m_Mapping = CreateFileMappingA(m_File, nullptr, protection, DWORD(u64(capacity) >> 32),
+                                   DWORD(u64(capacity) & 0xFFFFFFFF), nullptr);
+    if (!m_Mapping)
+        return false;
+    m_Data = MapViewOfFile(m_Mapping, IsWritable() ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, capacity);
+    if (!m_Data)
+    {
+        CloseHandle(m_Mapping);
+        m_Mapping = nullptr;
+        return false;
+    }
+#else
+    const int protection = IsWritable() ? PROT_READ | PROT_WRITE : PROT_READ;
+    void *data = mmap(nullptr, capacity, protection, MAP_SHARED, m_File, 0);
+    if (data == MAP_FAILED)
+        return false;
+    m_Data = data;
+#endif
+    m_Capacity = capacity;
+    return true;
+}
+
+void MappedFile::unmap()
+{
+    if (!m_Data)
+        return;
+#ifdef TKIT_OS_WINDOWS
+    UnmapViewOfFile(m_Data);
+    CloseHandle(m_Mapping);
+    m_Mapping = nullptr;
+#else
+    munmap(m_Data, m_Capacity);
+#endif
+    m_Data = nullptr;
+}
+
+bool MappedFile::remap(const usz capacity)
+{
+#ifndef TKIT_OS_WINDOWS
+    if (ftruncate(m_File, off_t(capacity)) != 0)
+        return false;
+#    ifdef TKIT_OS_LINUX
+    if (m_Data)
+    {
+        void *data = mremap(m_Data, m_Capacity, capacity, MREMAP_MAYMOVE);
+        if (data == MAP_FAILED)
+            return false;
+        m_Data = data;
+        m_Capacity = capacity;
+        return true;
+    }
+#    endif
+#endif
+    // The new view is mapped before the old one is released, so that a failure leaves the current mapping untouched.
+    // On Windows, the new mapping object grows the file on its own
+    void *data = m_Data;
+    const usz oldCapacity = m_Capacity;
+#ifdef TKIT_OS_WINDOWS
+    const FileHandle mapping = m_Mapping;
+#endif
+    if (!map(capacity))
+    {
+        m_Data = data;
+        m_Capacity = oldCapacity;
+#ifdef TKIT_OS_WINDOWS
+        m_Mapping = mapping;
+#endif
+        return false;
+    }
+    if (!data)
+        return true;
+#ifdef TKIT_OS_WINDOWS
+    UnmapViewOfFile(data);
+    CloseHandle(mapping);
+#else
+    munmap(data, oldCapacity);
+#endif
+    return true;
+}
+} // namespace TKit
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "tkit/container/span.hpp"
+#include "tkit/utils/non_copyable.hpp"
+#include "tkit/utils/result.hpp"
+#include "tkit/utils/debug.hpp"
+
+namespace TKit
+{
+enum MapMode : u8
+{
+    Map_Read = 0,
+    Map_ReadWrite = 1
+};
+
+/**
+ * @brief Access pattern hints for the operating system, which it may use to tune read-ahead and page placement.
+ */
+enum MapAdvice : u8
+{
+    MapAdvice_Normal = 0,
+    MapAdvice_Sequential = 1,
+    MapAdvice_Random = 2,
+    // Start reading the pages in the background, as they will be needed soon
+    MapAdvice_WillNeed = 3,
+    // Back the mapping with huge pages if possible, reducing TLB pressure on big files. Linux only
+    MapAdvice_HugePage = 4
+};
+
+/**
+ * @brief A file mapped into memory, whose content can be used in place without reading or parsing it into a separate
+ * buffer.
+ *
+ * Files opened with `Map_Read` are read-only views of their content. Files opened with `Map_ReadWrite` or created with
+ * `Create()` can also be modified through the mapping, and changes are written back to the file by the operating
+ * system, or explicitly with `Flush()`.
+ *
+ * Writable files are growable: `Append()` and `Resize()` grow the file and its mapping as needed, reserving extra room
+ * geometrically to amortize remapping. Because of that, the file may be bigger than its logical size while it is open,
+ * and it is truncated back to it when closed. Growing may move the mapping, which invalidates every pointer and span
+ * previously obtained from it.
+ */
+class MappedFile
+{
+    TKIT_NON_COPYABLE(MappedFile)
+  public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile &&other);
+    MappedFile &operator=(MappedFile &&other);
+
+    /**
+     * @brief Map an existing file.
+     *
+     * @param path The path of the file.
+     * @param mode Whether the file is mapped as read-only or read-write.
+     * @return The mapped file, or an error if the file could not be opened or mapped.
+     */
+    static Result<MappedFile> Open(const char *path, MapMode mode = Map_Read);
+
+    /**
+     * @brief Create a new file (or truncate an existing one) and map it as read-write.
+     *
+     * @param path The path of the file.
+     * @param size The initial size of the file, which will be zero-filled.
+     * @return The mapped file, or an error if the file could not be created or mapped.
+     */
+    static Result<MappedFile> Create(const char *path, usz size = 0);
+
+    /**
+     * @brief Unmap and close the file. Writable files are truncated to their logical size.
+     */
+    void Close();
+
+    /**
+     * @brief Hint the operating system about how a range of the file is going to be accessed.
+     *
+     * @param advice The access pattern.
+     * @param offset The beginning of the range, in bytes. It is rounded down to the page size.
+     * @param size The size of the range, in bytes. A value of 0 covers the rest of the file.
+     * @return Whether the hint was accepted.
+     */
+    bool Advise(MapAdvice advice, usz offset = 0, usz size = 0) const;
+
+    /**
+     * @brief Write the modified pages back to the file, blocking until it is done.
+     */
+    bool Flush() const;
+
+    /**
+     * @brief Change the logical size of a writable file, growing the mapping if needed.
+     *
+     * New bytes are zero-filled.
+     */
+    bool Resize(usz size);
+
+    /**
+     * @brief Grow the mapping of a writable file so that it can hold at least `capacity` bytes without remapping.
+     */
+    bool Reserve(usz capacity);
+
+    /**
+     * @brief Append raw bytes at the end of a writable file.
+     *
+     * @return A pointer to the copied bytes inside of the mapping, or `nullptr` if the file could not grow.
+     */
+    void *Append(const void *data, usz size);
+
+    template <typename T> T *Append(const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "[TOOLKIT][MAPPED-FILE] Only trivially copyable types can be "
+                                                       "written to a mapped file");
+        return scast<T *>(Append(&value, sizeof(T)));
+    }
+
+    Span<const std::byte> GetBytes() const
+    {
+        return Span<const std::byte>{scast<const std::byte *>(m_Data), usize(m_Size)};
+    }
+    Span<std::byte> GetBytes()
+    {
+        TKIT_ASSERT(IsWritable(), "[TOOLKIT][MAPPED-FILE] Cannot get a mutable view of a read-only file");
+        return Span<std::byte>{scast<std::byte *>(m_Data), usize(m_Size)};
+    }
+
+    /**
+     * @brief View the content of the file as an array of `T`.
+     *
+     * The mapping is page aligned, so `T` is properly aligned as long as the file was laid out accordingly. Trailing
+     * bytes that do not make up a whole `T` are not part of the view.
+     */
+    template <typename T> Span<const T> As() const
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "[TOOLKIT][MAPPED-FILE] Only trivially copyable types can be viewed from a mapped file");
+        return Span<const T>{scast<const T *>(m_Data), usize(m_Size / sizeof(T))};
+    }
+    template <typename T> Span<T> As()
+    {
+        static_assert(std::is_trivially_copyable_v<T>,
+                      "[TOOLKIT][MAPPED-FILE] Only trivially copyable types can be viewed from a mapped file");
+        TKIT_ASSERT(IsWritable(), "[TOOLKIT][MAPPED-FILE] Cannot get a mutable view of a read-only file");
+        return Span<T>{scast<T *>(m_Data), usize(m_Size / sizeof(T))};
+    }
+
+    const void *GetData() const
+    {
+        return m_Data;
+    }
+    void *GetData()
+    {
+        return m_Data;
+    }
+    usz GetSize() const
+    {
+        return m_Size;
+    }
+    // Size of the mapping, which may exceed the logical size of writable files
+    usz GetCapacity() const
+    {
+        return m_Capacity;
+    }
+    bool IsOpen() const
+    {
+        return m_File != InvalidFile;
+    }
+    bool IsWritable() const
+    {
+        return m_Mode == Map_ReadWrite;
+    }
+
+  private:
+#ifdef TKIT_OS_WINDOWS
+    using FileHandle = void *;
+    static inline const FileHandle InvalidFile = rcast<FileHandle>(~uptr(0));
+#else
+    using FileHandle = i32;
+    static constexpr FileHandle InvalidFile = -1;
+#endif
+
+    bool map(usz capacity);
+    void unmap();
+    bool remap(usz capacity);
+
+    void *m_Data = nullptr;
+    usz m_Size = 0;
+    usz m_Capacity = 0;
+    FileHandle m_File = InvalidFile;
+#ifdef TKIT_OS_WINDOWS
+    FileHandle m_Mapping = nullptr;
+#endif
+    MapMode m_Mode = Map_Read;
+};
+} // namespace TKit
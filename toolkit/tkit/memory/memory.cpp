@@ -4,12 +4,32 @@
 #include "tkit/preprocessor/utils.hpp"
 #include "tkit/utils/limits.hpp"
 #include "tkit/container/fixed_array.hpp"
-#include "tkit/multiprocessing/topology.hpp"
+#ifdef TKIT_ENABLE_MULTIPROCESSING
+#    include "tkit/multiprocessing/topology.hpp"
+#endif
 #ifdef TKIT_ENABLE_MIMALLOC
 #    include <mimalloc-new-delete.h>
 #    include <mimalloc-override.h>
 #endif
 #include <cstring>
+#ifdef TKIT_OS_WINDOWS
+#    include "tkit/core/windows.hpp"
+#else
+#    include <sys/mman.h>
+#endif
+
+#if defined(TKIT_SIMD_AVX512F)
+#    define TKIT_MEMORY_LANE_SIZE 64
+#elif defined(TKIT_SIMD_AVX)
+#    define TKIT_MEMORY_LANE_SIZE 32
+#elif defined(TKIT_SIMD_SSE2) || defined(TKIT_SIMD_NEON)
+#    define TKIT_MEMORY_LANE_SIZE 16
+#endif
+#if defined(TKIT_SIMD_SSE2)
+#    include <immintrin.h>
+#elif defined(TKIT_SIMD_NEON)
+#    include <arm_neon.h>
+#endif
 
 namespace TKit
 {
@@ -97,14 +117,434 @@ void DeallocateAligned(void *ptr)
 #endif
 }
 
-void *ForwardCopy(void *dst, const void *src, usz size)
+void *AllocatePages(const usz size)
+{
+#ifdef TKIT_OS_WINDOWS
+    void *ptr = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED)
+        ptr = nullptr;
+#endif
+    TKIT_PROFILE_MARK_HEAP_ALLOCATION(ptr, size);
+    return ptr;
+}
+
+void DeallocatePages(void *ptr, const usz size)
+{
+    TKIT_PROFILE_MARK_HEAP_DEALLOCATION(ptr);
+    // Allocators may leave their pages poisoned, and the sanitizer would otherwise keep flagging whatever gets mapped
+    // at the same address later on
+    TKIT_UNPOISON_MEMORY_REGION(ptr, size);
+#ifdef TKIT_OS_WINDOWS
+    TKIT_UNUSED(size);
+    VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    munmap(ptr, size);
+#endif
+}
+
+void *ReallocatePages(void *ptr, const usz oldSize, const usz newSize)
+{
+#ifdef TKIT_OS_LINUX
+    TKIT_UNPOISON_MEMORY_REGION(ptr, oldSize);
+    void *newPtr = mremap(ptr, oldSize, newSize, MREMAP_MAYMOVE);
+    if (newPtr == MAP_FAILED)
+        return nullptr;
+    TKIT_PROFILE_MARK_HEAP_DEALLOCATION(ptr);
+    TKIT_PROFILE_MARK_HEAP_ALLOCATION(newPtr, newSize);
+    return newPtr;
+#else
+    void *newPtr = AllocatePages(newSize);
+    if (!newPtr)
+        return nullptr;
+    ForwardCopy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+    DeallocatePages(ptr, oldSize);
+    return newPtr;
+#endif
+}
+
+void *AllocateOnNode(const usz size, const u32 node)
+{
+    void *ptr = AllocatePages(size);
+#ifdef TKIT_ENABLE_MULTIPROCESSING
+    if (ptr)
+        Topology::BindMemory(ptr, size, node);
+#else
+    TKIT_UNUSED(node);
+#endif
+    return ptr;
+}
+
+void *AllocateLocal(const usz size)
+{
+    void *ptr = AllocatePages(size);
+#ifdef TKIT_ENABLE_MULTIPROCESSING
+    if (ptr)
+        Topology::BindMemoryLocal(ptr, size);
+#endif
+    return ptr;
+}
+
+void *AllocateAligned(const usz size, const usize alignment, const NumaSpecs &numa)
+{
+    if (numa.Policy == Numa_Default)
+        return AllocateAligned(size, alignment);
+
+    TKIT_ASSERT(alignment <= 4096,
+                "[TOOLKIT][MEMORY] NUMA allocations are aligned to the page size, which may not satisfy an alignment "
+                "of {} bytes",
+                alignment);
+    return numa.Policy == Numa_Local ? AllocateLocal(size) : AllocateOnNode(size, numa.Node);
+}
+
+void DeallocateAligned(void *ptr, const usz size, const NumaSpecs &numa)
+{
+    if (numa.Policy == Numa_Default)
+        DeallocateAligned(ptr);
+    else
+        DeallocatePages(ptr, size);
+}
+
+#ifdef TKIT_MEMORY_LANE_SIZE
+// A lane is the unit the copy and fill kernels move at once. Scalar lanes cover the smallest sizes, and vector lanes
+// use the widest register set available
+template <usz Size> struct Lane;
+
+template <typename T> struct ScalarLane
+{
+    using Type = T;
+    static TKIT_FORCE_INLINE T Load(const std::byte *src)
+    {
+        T value;
+        std::memcpy(&value, src, sizeof(T));
+        return value;
+    }
+    static TKIT_FORCE_INLINE void Store(std::byte *dst, const T value)
+    {
+        std::memcpy(dst, &value, sizeof(T));
+    }
+    static TKIT_FORCE_INLINE T Splat(const u8 value)
+    {
+        return T(T(value) * T(T(-1) / 0xFF));
+    }
+};
+
+template <> struct Lane<2> : ScalarLane<u16>
+{
+};
+template <> struct Lane<4> : ScalarLane<u32>
+{
+};
+template <> struct Lane<8> : ScalarLane<u64>
+{
+};
+
+#    ifdef TKIT_SIMD_SSE2
+template <> struct Lane<16>
+{
+    using Type = __m128i;
+    static TKIT_FORCE_INLINE Type Load(const std::byte *src)
+    {
+        return _mm_loadu_si128(rcast<const Type *>(src));
+    }
+    static TKIT_FORCE_INLINE void Store(std::byte *dst, const Type value)
+    {
+        _mm_storeu_si128(rcast<Type *>(dst), value);
+    }
+    static TKIT_FORCE_INLINE void Stream(std::byte *dst, const Type value)
+    {
+        _mm_stream_si128(rcast<Type *>(dst), value);
+    }
+    static TKIT_FORCE_INLINE Type Splat(const u8 value)
+    {
+        return _mm_set1_epi8(char(value));
+    }
+};
+#    else
+template <> struct Lane<16>
+{
+    using Type = uint8x16_t;
+    static TKIT_FORCE_INLINE Type Load(const std::byte *src)
+    {
+        return vld1q_u8(rcast<const u8 *>(src));
+    }
+    static TKIT_FORCE_INLINE void Store(std::byte *dst, const Type value)
+    {
+        vst1q_u8(rcast<u8 *>(dst), value);
+    }
+    // NEON has no non-temporal store intrinsic
+    static TKIT_FORCE_INLINE void Stream(std::byte *dst, const Type value)
+    {
+        vst1q_u8(rcast<u8 *>(dst), value);
+    }
+    static TKIT_FORCE_INLINE Type Splat(const u8 value)
+    {
+        return vdupq_n_u8(value);
+    }
+};
+#    endif
+
+#    if TKIT_MEMORY_LANE_SIZE >= 32
+template <> struct Lane<32>
+{
+    using Type = __m256i;
+    static TKIT_FORCE_INLINE Type Load(const std::byte *src)
+    {
+        return _mm256_loadu_si256(rcast<const Type *>(src));
+    }
+    static TKIT_FORCE_INLINE void Store(std::byte *dst, const Type value)
+    {
+        _mm256_storeu_si256(rcast<Type *>(dst), value);
+    }
+    static TKIT_FORCE_INLINE void Stream(std::byte *dst, const Type value)
+    {
+        _mm256_stream_si256(rcast<Type *>(dst), value);
+    }
+    static TKIT_FORCE_INLINE Type Splat(const u8 value)
+    {
+        return _mm256_set1_epi8(char(value));
+    }
+};
+#    endif
+
+#    if TKIT_MEMORY_LANE_SIZE >= 64
+template <> struct Lane<64>
+{
+    using Type = __m512i;
+    static TKIT_FORCE_INLINE Type Load(const std::byte *src)
+    {
+        return _mm512_loadu_si512(src);
+    }
+    static TKIT_FORCE_INLINE void Store(std::byte *dst, const Type value)
+    {
+        _mm512_storeu_si512(dst, value);
+    }
+    static TKIT_FORCE_INLINE void Stream(std::byte *dst, const Type value)
+    {
+        _mm512_stream_si512(rcast<Type *>(dst), value);
+    }
+    static TKIT_FORCE_INLINE Type Splat(const u8 value)
+    {
+        return _mm512_set1_epi8(char(value));
+    }
+};
+#    endif
+
+using Vector = Lane<TKIT_MEMORY_LANE_SIZE>;
+constexpr usz VectorSize = TKIT_MEMORY_LANE_SIZE;
+
+// Copy between Size and 2 * Size bytes with two lanes that may overlap. Both are loaded before storing anything, so it
+// also works for overlapping ranges
+template <usz Size> static TKIT_FORCE_INLINE void copyEnds(std::byte *dst, const std::byte *src, const usz size)
+{
+    const auto head = Lane<Size>::Load(src);
+    const auto tail = Lane<Size>::Load(src + size - Size);
+    Lane<Size>::Store(dst, head);
+    Lane<Size>::Store(dst + size - Size, tail);
+}
+template <usz Size> static TKIT_FORCE_INLINE void fillEnds(std::byte *dst, const u8 value, const usz size)
+{
+    const auto lane = Lane<Size>::Splat(value);
+    Lane<Size>::Store(dst, lane);
+    Lane<Size>::Store(dst + size - Size, lane);
+}
+
+// Sizes up to 2 * VectorSize are handled without loops
+static TKIT_FORCE_INLINE void copySmall(std::byte *dst, const std::byte *src, const usz size)
+{
+#    if TKIT_MEMORY_LANE_SIZE >= 64
+    if (size >= 64)
+        return copyEnds<64>(dst, src, size);
+#    endif
+#    if TKIT_MEMORY_LANE_SIZE >= 32
+    if (size >= 32)
+        return copyEnds<32>(dst, src, size);
+#    endif
+    if (size >= 16)
+        return copyEnds<16>(dst, src, size);
+    if (size >= 8)
+        return copyEnds<8>(dst, src, size);
+    if (size >= 4)
+        return copyEnds<4>(dst, src, size);
+    if (size >= 2)
+        return copyEnds<2>(dst, src, size);
+    if (size == 1)
+        *dst = *src;
+}
+static TKIT_FORCE_INLINE void fillSmall(std::byte *dst, const u8 value, const usz size)
+{
+#    if TKIT_MEMORY_LANE_SIZE >= 64
+    if (size >= 64)
+        return fillEnds<64>(dst, value, size);
+#    endif
+#    if TKIT_MEMORY_LANE_SIZE >= 32
+    if (size >= 32)
+        return fillEnds<32>(dst, value, size);
+#    endif
+    if (size >= 16)
+        return fillEnds<16>(dst, value, size);
+    if (size >= 8)
+        return fillEnds<8>(dst, value, size);
+    if (size >= 4)
+        return fillEnds<4>(dst, value, size);
+    if (size >= 2)
+        return fillEnds<2>(dst, value, size);
+    if (size == 1)
+        *dst = std::byte(value);
+}
+
+// Copy more than 2 * VectorSize bytes. The unaligned head and tail are loaded first and stored at the end, and the loop
+// stores to aligned addresses only, which is also what streaming stores require
+template <bool Streaming> static void copyAligned(std::byte *dst, const std::byte *src, const usz size)
+{
+    const auto head = Vector::Load(src);
+    const auto tail = Vector::Load(src + size - VectorSize);
+
+    const usz skew = VectorSize - (rcast<uptr>(dst) & (VectorSize - 1));
+    const usz end = size - VectorSize;
+    usz offset = skew;
+    for (; offset + 4 * VectorSize <= end; offset += 4 * VectorSize)
+    {
+        const auto v0 = Vector::Load(src + offset);
+        const auto v1 = Vector::Load(src + offset + VectorSize);
+        const auto v2 = Vector::Load(src + offset + 2 * VectorSize);
+        const auto v3 = Vector::Load(src + offset + 3 * VectorSize);
+        if constexpr (Streaming)
+        {
+            Vector::Stream(dst + offset, v0);
+            Vector::Stream(dst + offset + VectorSize, v1);
+            Vector::Stream(dst + offset + 2 * VectorSize, v2);
+            Vector::Stream(dst + offset + 3 * VectorSize, v3);
+        }
+        else
+        {
+            Vector::Store(dst + offset, v0);
+            Vector::Store(dst + offset + VectorSize, v1);
+            Vector::Store(dst + offset + 2 * VectorSize, v2);
+            Vector::Store(dst + offset + 3 * VectorSize, v3);
+        }
+    }
+    for (; offset < end; offset += VectorSize)
+        if constexpr (Streaming)
+            Vector::Stream(dst + offset, Vector::Load(src + offset));
+        else
+            Vector::Store(dst + offset, Vector::Load(src + offset));
+
+#    ifdef TKIT_SIMD_SSE2
+    // Streaming stores are weakly ordered, and must be fenced before the copy can be observed by other threads
+    if constexpr (Streaming)
+        _mm_sfence();
+#    endif
+    Vector::Store(dst, head);
+    Vector::Store(dst + end, tail);
+}
+
+template <bool Streaming> static void fillAligned(std::byte *dst, const u8 value, const usz size)
+{
+    const auto lane = Vector::Splat(value);
+    const usz skew = VectorSize - (rcast<uptr>(dst) & (VectorSize - 1));
+    const usz end = size - VectorSize;
+
+    Vector::Store(dst, lane);
+    usz offset = skew;
+    for (; offset + 4 * VectorSize <= end; offset += 4 * VectorSize)
+        for (usz i = 0; i < 4; ++i)
+            if constexpr (Streaming)
+                Vector::Stream(dst + offset + i * VectorSize, lane);
+            else
+                Vector::Store(dst + offset + i * VectorSize, lane);
+    for (; offset < end; offset += VectorSize)
+        if constexpr (Streaming)
+            Vector::Stream(dst + offset, lane);
+        else
+            Vector::Store(dst + offset, lane);
+
+#    ifdef TKIT_SIMD_SSE2
+    if constexpr (Streaming)
+        _mm_sfence();
+#    endif
+    Vector::Store(dst + end, lane);
+}
+
+// Copy more than 2 * VectorSize bytes to a higher, overlapping address. It mirrors `copyAligned()`, going from the end
+// of the range to its beginning so that every lane is loaded before the loop overwrites it
+static void moveBackward(std::byte *dst, const std::byte *src, const usz size)
+{
+    const auto head = Vector::Load(src);
+    const auto tail = Vector::Load(src + size - VectorSize);
+
+    usz offset = size - (rcast<uptr>(dst + size) & (VectorSize - 1));
+    for (; offset >= 4 * VectorSize; offset -= 4 * VectorSize)
+    {
+        const auto v0 = Vector::Load(src + offset - VectorSize);
+        const auto v1 = Vector::Load(src + offset - 2 * VectorSize);
+        const auto v2 = Vector::Load(src + offset - 3 * VectorSize);
+        const auto v3 = Vector::Load(src + offset - 4 * VectorSize);
+        Vector::Store(dst + offset - VectorSize, v0);
+        Vector::Store(dst + offset - 2 * VectorSize, v1);
+        Vector::Store(dst + offset - 3 * VectorSize, v2);
+        Vector::Store(dst + offset - 4 * VectorSize, v3);
+    }
+    for (; offset > VectorSize; offset -= VectorSize)
+        Vector::Store(dst + offset - VectorSize, Vector::Load(src + offset - VectorSize));
+
+    Vector::Store(dst, head);
+    Vector::Store(dst + size - VectorSize, tail);
+}
+
+void *ForwardCopy(void *dst, const void *src, const usz size)
+{
+    std::byte *d = scast<std::byte *>(dst);
+    const std::byte *s = scast<const std::byte *>(src);
+    if (size <= 2 * VectorSize)
+        copySmall(d, s, size);
+    else if (size < NonTemporalThreshold)
+        copyAligned<false>(d, s, size);
+    else
+        copyAligned<true>(d, s, size);
+    return dst;
+}
+void *BackwardCopy(void *dst, const void *src, const usz size)
+{
+    std::byte *d = scast<std::byte *>(dst);
+    const std::byte *s = scast<const std::byte *>(src);
+    if (size <= 2 * VectorSize)
+        copySmall(d, s, size);
+    else if (s + size <= d || d + size <= s)
+        return ForwardCopy(dst, src, size);
+    // Moving to a lower address is safe with the forward kernel, as it only stores behind what it has already loaded
+    else if (d < s)
+        copyAligned<false>(d, s, size);
+    else if (d > s)
+        moveBackward(d, s, size);
+    return dst;
+}
+void *Fill(void *dst, const u8 value, const usz size)
+{
+    std::byte *d = scast<std::byte *>(dst);
+    if (size <= 2 * VectorSize)
+        fillSmall(d, value, size);
+    else if (size < NonTemporalThreshold)
+        fillAligned<false>(d, value, size);
+    else
+        fillAligned<true>(d, value, size);
+    return dst;
+}
+#else
+void *ForwardCopy(void *dst, const void *src, const usz size)
 {
     return std::memcpy(dst, src, size);
 }
-void *BackwardCopy(void *dst, const void *src, usz size)
+void *BackwardCopy(void *dst, const void *src, const usz size)
 {
     return std::memmove(dst, src, size);
 }
+void *Fill(void *dst, const u8 value, const usz size)
+{
+    return std::memset(dst, value, size);
+}
+#endif
 
 } // namespace TKit
 
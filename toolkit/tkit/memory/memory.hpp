@@ -103,27 +103,143 @@ void *AllocateAligned(usz size, usize alignment);
 void DeallocateAligned(void *ptr);
 
 /**
- * @brief Copy a chunk of memory from one location to another.
+ * @brief Allocate a chunk of memory of a given size directly from the operating system, bypassing the heap.
  *
- * Uses the default `::memcpy()`. It is here as a placeholder for future custom global memory management.
+ * Uses `mmap()` or `VirtualAlloc()`. The memory is always aligned to the page size and zero-initialized. Intended for
+ * big allocations only, as the size is rounded up to a multiple of the page size.
+ *
+ * @param size The size of the memory to allocate.
+ * @return A pointer to the allocated memory, or `nullptr` if the allocation fails.
+ */
+void *AllocatePages(usz size);
+
+/**
+ * @brief Deallocate a chunk of memory allocated with `AllocatePages()`.
+ *
+ * @param ptr A pointer to the memory to deallocate.
+ * @param size The size the memory was allocated with.
+ */
+void DeallocatePages(void *ptr, usz size);
+
+/**
+ * @brief Resize a chunk of memory allocated with `AllocatePages()`.
+ *
+ * On Linux, this uses `mremap()`, which grows the mapping in place if possible and otherwise moves the pages to a new
+ * address without copying them. On other platforms, a new chunk is allocated and the contents are copied. Either way,
+ * the contents must be trivially relocatable.
+ *
+ * @param ptr A pointer to the memory to resize.
+ * @param oldSize The size the memory was allocated with.
+ * @param newSize The new size of the memory.
+ * @return A pointer to the resized memory. If the reallocation fails, `nullptr` will be returned and the original
+ * memory will remain valid.
+ */
+void *ReallocatePages(void *ptr, usz oldSize, usz newSize);
+
+/**
+ * @brief Where the memory of an allocation should be physically placed in systems with multiple NUMA nodes.
+ */
+enum NumaPolicy : u8
+{
+    Numa_Default = 0, // Let the operating system decide. Usually the node of the thread that first touches the memory
+    Numa_Local = 1,   // The node of the calling thread
+    Numa_Node = 2     // A specific node
+};
+
+struct NumaSpecs
+{
+    NumaPolicy Policy = Numa_Default;
+    // Logical index of the node. Only used with the `Numa_Node` policy
+    u32 Node = 0;
+};
+
+/**
+ * @brief Allocate a chunk of memory with `AllocatePages()` and bind it to a NUMA node.
+ *
+ * Binding requires the multiprocessing feature, the HWLOC library and an initialized topology (see
+ * `Topology::Initialize()`, which a `ThreadPool` already calls). If any of those is missing, or if the binding fails,
+ * the memory is still allocated, but its placement is left to the operating system.
+ *
+ * The memory must be deallocated with `DeallocatePages()`.
+ *
+ * @param size The size of the memory to allocate.
+ * @param node The logical index of the NUMA node.
+ * @return A pointer to the allocated memory, or `nullptr` if the allocation fails.
+ */
+void *AllocateOnNode(usz size, u32 node);
+
+/**
+ * @brief Allocate a chunk of memory with `AllocatePages()` and bind it to the NUMA node of the calling thread.
+ *
+ * The same considerations of `AllocateOnNode()` apply.
+ *
+ * @param size The size of the memory to allocate.
+ * @return A pointer to the allocated memory, or `nullptr` if the allocation fails.
+ */
+void *AllocateLocal(usz size);
+
+/**
+ * @brief Allocate a chunk of memory following a NUMA policy.
+ *
+ * With the `Numa_Default` policy, this is equivalent to `AllocateAligned()`. Otherwise, the memory is allocated with
+ * `AllocateOnNode()` or `AllocateLocal()`, so it is always aligned to the page size. The memory must be deallocated
+ * with the `DeallocateAligned()` overload that takes the same policy.
+ *
+ * @param size The size of the memory to allocate.
+ * @param alignment The alignment of the memory to allocate.
+ * @param numa The NUMA policy.
+ * @return A pointer to the allocated memory.
+ */
+void *AllocateAligned(usz size, usize alignment, const NumaSpecs &numa);
+
+/**
+ * @brief Deallocate a chunk of memory allocated with the `AllocateAligned()` overload that takes a NUMA policy.
+ *
+ * @param ptr A pointer to the memory to deallocate.
+ * @param size The size the memory was allocated with.
+ * @param numa The NUMA policy the memory was allocated with.
+ */
+void DeallocateAligned(void *ptr, usz size, const NumaSpecs &numa);
+
+/**
+ * @brief Copy a chunk of memory from one location to another. The ranges must not overlap.
+ *
+ * Equivalent to `::memcpy()`, but specialized by size when SIMD is available. Copies of up to two vector registers are
+ * done with a couple of overlapping loads and stores without any loop, bigger copies are done with a loop that only
+ * stores to aligned addresses, and copies of at least `TKIT_MEMORY_NON_TEMPORAL_THRESHOLD` bytes use non-temporal
+ * stores so that the destination does not evict the whole cache. Without SIMD support, `::memcpy()` is used instead.
  *
  * @param dst A pointer to the destination memory.
  * @param src A pointer to the source memory.
  * @param size The size of the memory to copy, in bytes.
+ * @return `dst`.
  */
 void *ForwardCopy(void *dst, const void *src, usz size);
 
 /**
- * @brief Copy a chunk of memory from one location to another in reverse order.
+ * @brief Copy a chunk of memory from one location to another. The ranges may overlap.
  *
- * Uses the default `::memmove()`. It is here as a placeholder for future custom global memory management.
+ * Equivalent to `::memmove()`, and uses the same kernels as `ForwardCopy()` when the ranges do not overlap.
  *
  * @param dst A pointer to the destination memory.
  * @param src A pointer to the source memory.
  * @param size The size of the memory to copy, in bytes.
+ * @return `dst`.
  */
 void *BackwardCopy(void *dst, const void *src, usz size);
 
+/**
+ * @brief Set every byte of a chunk of memory to a value.
+ *
+ * Equivalent to `::memset()`, and specialized by size in the same way as `ForwardCopy()`.
+ *
+ * @param dst A pointer to the memory to fill.
+ * @param value The value of each byte.
+ * @param size The size of the memory to fill, in bytes.
+ * @return `dst`.
+ */
+void *Fill(void *dst, u8 value, usz size);
+
 /**
  * @brief Copy a range of elements from one iterator to another.
  *
@@ -250,6 +366,22 @@ template <typename T> class STLAllocator
     }
 };
 
+/**
+ * @brief Tells whether objects of type `T` are trivially relocatable: moving one to a new location and destroying the
+ * original is equivalent to copying its bytes and forgetting about the original.
+ *
+ * Every trivially copyable type is trivially relocatable. Types that are not, but that never point to themselves nor
+ * register their address anywhere (smart pointers, handles or containers that own a heap buffer, for instance), can opt
+ * in by specializing this trait. Containers then relocate them in bulk with a single copy instead of moving and
+ * destroying them one by one.
+ */
+template <typename T> struct IsTriviallyRelocatable : std::is_trivially_copyable<T>
+{
+};
+
+template <typename T>
+concept TriviallyRelocatable = IsTriviallyRelocatable<std::remove_cv_t<T>>::value;
+
 /**
  * @brief Construct an object of type `T` in the given memory location.
  *
@@ -347,8 +479,16 @@ template <typename It, typename... Args> void ConstructRange(const It begin, con
  */
 template <typename It1, typename It2> void ConstructRangeCopy(It1 dst, const It2 begin, const It2 end)
 {
-    for (auto it = begin; it != end; ++it, ++dst)
-        ConstructFromIterator(dst, *it);
+    using T = std::remove_cvref_t<decltype(*dst)>;
+    if constexpr (std::is_pointer_v<It1> && std::is_pointer_v<It2> &&
+                  std::is_same_v<T, std::remove_cvref_t<decltype(*begin)>> && std::is_trivially_copyable_v<T>)
+    {
+        if (begin != end)
+            ForwardCopy(scast<void *>(dst), scast<const void *>(begin), usz(end - begin) * sizeof(T));
+    }
+    else
+        for (auto it = begin; it != end; ++it, ++dst)
+            ConstructFromIterator(dst, *it);
 }
 
 /**
@@ -362,8 +502,16 @@ template <typename It1, typename It2> void ConstructRangeCopy(It1 dst, const It2
  */
 template <typename It1, typename It2> void ConstructRangeMove(It1 dst, const It2 begin, const It2 end)
 {
-    for (auto it = begin; it != end; ++it, ++dst)
-        ConstructFromIterator(dst, std::move(*it));
+    using T = std::remove_cvref_t<decltype(*dst)>;
+    if constexpr (std::is_pointer_v<It1> && std::is_pointer_v<It2> &&
+                  std::is_same_v<T, std::remove_cvref_t<decltype(*begin)>> && std::is_trivially_copyable_v<T>)
+    {
+        if (begin != end)
+            ForwardCopy(scast<void *>(dst), scast<const void *>(begin), usz(end - begin) * sizeof(T));
+    }
+    else
+        for (auto it = begin; it != end; ++it, ++dst)
+            ConstructFromIterator(dst, std::move(*it));
 }
 
 /**
@@ -376,14 +524,42 @@ template <typename It1, typename It2> void ConstructRangeMove(It1 dst, const It2
  */
 template <typename It> void DestructRange(const It begin, const It end)
 {
-    for (auto it = begin; it != end; ++it)
-        DestructFromIterator(it);
+    if constexpr (!std::is_trivially_destructible_v<std::remove_cvref_t<decltype(*begin)>>)
+        for (auto it = begin; it != end; ++it)
+            DestructFromIterator(it);
 }
 
 template <typename It> void DestructRangeReverse(const It begin, const It end)
 {
-    for (auto it = end - 1; it != begin - 1; --it)
-        DestructFromIterator(it);
+    if constexpr (!std::is_trivially_destructible_v<std::remove_cvref_t<decltype(*begin)>>)
+        for (auto it = end - 1; it != begin - 1; --it)
+            DestructFromIterator(it);
+}
+
+/**
+ * @brief Relocate a range of objects of type `T` to uninitialized memory, leaving the source range uninitialized.
+ *
+ * Trivially relocatable types are relocated with a single copy. Otherwise, every object is move constructed into its
+ * new location and then destroyed.
+ *
+ * @note This function does not allocate nor deallocate memory. The ranges must not overlap.
+ *
+ * @param dst A pointer to the beginning of the destination range.
+ * @param begin A pointer to the beginning of the source range.
+ * @param end A pointer to the end of the source range.
+ */
+template <typename T> void RelocateRange(T *dst, T *begin, T *end)
+{
+    if constexpr (TriviallyRelocatable<T>)
+    {
+        if (begin != end)
+            ForwardCopy(scast<void *>(dst), scast<const void *>(begin), usz(end - begin) * sizeof(T));
+    }
+    else
+    {
+        ConstructRangeMove(dst, begin, end);
+        DestructRange(begin, end);
+    }
 }
 
 } // namespace TKit
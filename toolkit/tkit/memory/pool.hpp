@@ -0,0 +1,341 @@
+#pragma once
+
+#ifndef TKIT_ENABLE_BLOCK_ALLOCATOR
+#    error                                                                                                             \
+        "[TOOLKIT][POOL] To include this file, the corresponding feature must be enabled in CMake with TOOLKIT_ENABLE_BLOCK_ALLOCATOR"
+#endif
+
+#include "tkit/memory/block_allocator.hpp"
+#include "tkit/container/dynamic_array.hpp"
+#include "tkit/container/bitset.hpp"
+#include "tkit/utils/debug.hpp"
+#include "tkit/utils/bit.hpp"
+
+namespace TKit
+{
+/**
+ * @brief A typed object pool that hands out compact, generational handles instead of raw pointers.
+ *
+ * A handle is a 32-bit value that packs the index of a slot (the lower `IndexBits` bits) and the generation of that
+ * slot when the object was created (the remaining bits). Every time an object is destroyed, the generation of its slot
+ * is increased, so any handle still referring to it becomes stale and can be detected in O(1) with `IsValid()` or
+ * `Get()`.
+ *
+ * Slots are grouped in chunks of 64, which are allocated from a growable `BlockAllocator`. This means objects are never
+ * moved and pointers to them remain valid until they are destroyed. An occupancy bit set with one lane per chunk keeps
+ * track of live objects, so iterating them with `ForEach()` skips empty slots 64 at a time and visits memory in order.
+ *
+ * Once the generation of a slot reaches its maximum value, the slot is retired and never reused, so a handle can only
+ * be mistaken for a live one if the user forges it.
+ *
+ * @tparam T The type of the objects.
+ * @tparam IndexBits The amount of bits of the handle dedicated to the slot index. The rest of the bits are used for the
+ * generation.
+ */
+template <typename T, usize IndexBits = 20> class Pool
+{
+    static_assert(IndexBits >= 6 && IndexBits < 32, "[TOOLKIT][POOL] Index bits must be in the range [6, 32)");
+    TKIT_NON_COPYABLE(Pool)
+
+  public:
+    using ValueType = T;
+
+    static constexpr usize ChunkSlots = 64;
+    static constexpr u32 IndexMask = (1u << IndexBits) - 1;
+    static constexpr u32 GenerationMask = ~u32(0) >> IndexBits;
+    static constexpr usize MaxSlots = usize(1) << IndexBits;
+
+    struct Handle
+    {
+        static constexpr u32 NullValue = ~u32(0);
+
+        usize GetIndex() const
+        {
+            return Value & IndexMask;
+        }
+        u32 GetGeneration() const
+        {
+            return Value >> IndexBits;
+        }
+        bool IsNull() const
+        {
+            return Value == NullValue;
+        }
+        explicit operator bool() const
+        {
+            return !IsNull();
+        }
+
+        bool operator==(const Handle &other) const = default;
+
+        u32 Value = NullValue;
+    };
+
+    /**
+     * @param chunksPerSlab How many chunks of 64 slots the underlying block allocator requests at once.
+     */
+    explicit Pool(const usize chunksPerSlab = 4)
+        : m_Allocator(BlockAllocator::CreateFromType<Chunk>(chunksPerSlab, BlockSlabSpecs{}))
+    {
+    }
+
+    ~Pool()
+    {
+        destroyAll();
+    }
+
+    Pool(Pool &&other)
+        : m_Allocator(std::move(other.m_Allocator)), m_Chunks(std::move(other.m_Chunks)),
+          m_FreeSlots(std::move(other.m_FreeSlots)), m_Occupancy(std::move(other.m_Occupancy)), m_Size(other.m_Size)
+    {
+        other.m_Size = 0;
+    }
+
+    Pool &operator=(Pool &&other)
+    {
+        if (this != &other)
+        {
+            destroyAll();
+            m_Allocator = std::move(other.m_Allocator);
+            m_Chunks = std::move(other.m_Chunks);
+            m_FreeSlots = std::move(other.m_FreeSlots);
+            m_Occupancy = std::move(other.m_Occupancy);
+            m_Size = other.m_Size;
+            other.m_Size = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Create a new object in the pool.
+     *
+     * @return A handle to the new object, or a null handle if the pool has run out of indices.
+     */
+    template <typename... Args>
+        requires std::constructible_from<T, Args...>
+    Handle Create(Args &&...args)
+    {
+        if (m_FreeSlots.IsEmpty() && !addChunk())
+            return Handle{};
+
+        const u32 index = m_FreeSlots.GetBack();
+        m_FreeSlots.Pop();
+
+        Chunk *chunk = m_Chunks[index / ChunkSlots];
+        const usize slot = index % ChunkSlots;
+        Construct(chunk->Get(slot), std::forward<Args>(args)...);
+        m_Occupancy.Set(index);
+        ++m_Size;
+        return Handle{index | (chunk->Generations[slot] << IndexBits)};
+    }
+
+    /**
+     * @brief Destroy the object a handle refers to, invalidating every handle to it.
+     *
+     * @param handle A valid handle.
+     */
+    void Destroy(const Handle handle)
+    {
+        TKIT_ASSERT(IsValid(handle), "[TOOLKIT][POOL] Cannot destroy an object through an invalid or stale handle");
+        const usize index = handle.GetIndex();
+        Chunk *chunk = m_Chunks[index / ChunkSlots];
+        const usize slot = index % ChunkSlots;
+
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            Destruct(chunk->Get(slot));
+        m_Occupancy.Clear(index);
+        --m_Size;
+        release(chunk, index);
+    }
+
+    /**
+     * @brief Check if a handle refers to a live object.
+     */
+    bool IsValid(const Handle handle) const
+    {
+        const usize index = handle.GetIndex();
+        if (index >= m_Chunks.GetSize() * ChunkSlots)
+            return false;
+        const Chunk *chunk = m_Chunks[index / ChunkSlots];
+        return chunk->Generations[index % ChunkSlots] == handle.GetGeneration() && m_Occupancy[index];
+    }
+
+    /**
+     * @brief Get the object a handle refers to.
+     *
+     * @return A pointer to the object, or `nullptr` if the handle is invalid or stale.
+     */
+    const T *Get(const Handle handle) const
+    {
+        return IsValid(handle) ? m_Chunks[handle.GetIndex() / ChunkSlots]->Get(handle.GetIndex() % ChunkSlots)
+                               : nullptr;
+    }
+    T *Get(const Handle handle)
+    {
+        return IsValid(handle) ? m_Chunks[handle.GetIndex() / ChunkSlots]->Get(handle.GetIndex() % ChunkSlots)
+                               : nullptr;
+    }
+
+    const T &At(const Handle handle) const
+    {
+        TKIT_ASSERT(IsValid(handle), "[TOOLKIT][POOL] Cannot access an object through an invalid or stale handle");
+        return *m_Chunks[handle.GetIndex() / ChunkSlots]->Get(handle.GetIndex() % ChunkSlots);
+    }
+    T &At(const Handle handle)
+    {
+        TKIT_ASSERT(IsValid(handle), "[TOOLKIT][POOL] Cannot access an object through an invalid or stale handle");
+        return *m_Chunks[handle.GetIndex() / ChunkSlots]->Get(handle.GetIndex() % ChunkSlots);
+    }
+
+    const T &operator[](const Handle handle) const
+    {
+        return At(handle);
+    }
+    T &operator[](const Handle handle)
+    {
+        return At(handle);
+    }
+
+    /**
+     * @brief Call a function for every live object, in slot order.
+     *
+     * The function may take either a reference to the object or its handle and a reference to the object. Destroying
+     * the object being visited is allowed, but creating new objects during the iteration is not.
+     */
+    template <typename F> void ForEach(F &&fun)
+    {
+        const u64 *lanes = m_Occupancy.GetData();
+        for (usize i = 0; i < m_Chunks.GetSize(); ++i)
+        {
+            Chunk *chunk = m_Chunks[i];
+            for (u64 bits = lanes[i]; bits != 0; bits &= bits - 1)
+            {
+                const usize slot = usize(std::countr_zero(bits));
+                if constexpr (std::invocable<F, Handle, T &>)
+                {
+                    const u32 index = u32(i * ChunkSlots + slot);
+                    fun(Handle{index | (chunk->Generations[slot] << IndexBits)}, *chunk->Get(slot));
+                }
+                else
+                    fun(*chunk->Get(slot));
+            }
+        }
+    }
+    template <typename F> void ForEach(F &&fun) const
+    {
+        const u64 *lanes = m_Occupancy.GetData();
+        for (usize i = 0; i < m_Chunks.GetSize(); ++i)
+        {
+            const Chunk *chunk = m_Chunks[i];
+            for (u64 bits = lanes[i]; bits != 0; bits &= bits - 1)
+            {
+                const usize slot = usize(std::countr_zero(bits));
+                if constexpr (std::invocable<F, Handle, const T &>)
+                {
+                    const u32 index = u32(i * ChunkSlots + slot);
+                    fun(Handle{index | (chunk->Generations[slot] << IndexBits)}, *chunk->Get(slot));
+                }
+                else
+                    fun(*chunk->Get(slot));
+            }
+        }
+    }
+
+    /**
+     * @brief Destroy all objects, invalidating every handle. The memory is kept for future objects.
+     */
+    void Clear()
+    {
+        const u64 *lanes = m_Occupancy.GetData();
+        for (usize i = 0; i < m_Chunks.GetSize(); ++i)
+        {
+            Chunk *chunk = m_Chunks[i];
+            for (u64 bits = lanes[i]; bits != 0; bits &= bits - 1)
+            {
+                const usize slot = usize(std::countr_zero(bits));
+                if constexpr (!std::is_trivially_destructible_v<T>)
+                    Destruct(chunk->Get(slot));
+                release(chunk, u32(i * ChunkSlots + slot));
+            }
+        }
+        m_Occupancy.ClearAll();
+        m_Size = 0;
+    }
+
+    usize GetSize() const
+    {
+        return m_Size;
+    }
+    // Amount of slots currently allocated, including the ones that have been retired
+    usize GetCapacity() const
+    {
+        return m_Chunks.GetSize() * ChunkSlots;
+    }
+    bool IsEmpty() const
+    {
+        return m_Size == 0;
+    }
+
+  private:
+    struct Chunk
+    {
+        T *Get(const usize slot)
+        {
+            return rcast<T *>(Slots) + slot;
+        }
+        const T *Get(const usize slot) const
+        {
+            return rcast<const T *>(Slots) + slot;
+        }
+
+        alignas(T) std::byte Slots[ChunkSlots * sizeof(T)];
+        u32 Generations[ChunkSlots];
+    };
+
+    bool addChunk()
+    {
+        const usize first = m_Chunks.GetSize() * ChunkSlots;
+        if (first + ChunkSlots > MaxSlots)
+        {
+            TKIT_LOG_ERROR("[TOOLKIT][POOL] The pool has run out of indices. Consider using more index bits");
+            return false;
+        }
+
+        Chunk *chunk = m_Allocator.Allocate<Chunk>();
+        TKIT_LOG_ERROR_IF(!chunk, "[TOOLKIT][POOL] Failed to allocate a new chunk");
+        if (!chunk)
+            return false;
+
+        for (usize i = 0; i < ChunkSlots; ++i)
+            chunk->Generations[i] = 0;
+        m_Chunks.Append(chunk);
+        m_Occupancy.Resize(m_Chunks.GetSize() * ChunkSlots);
+
+        // Reversed so that lower slots are handed out first
+        for (usize i = ChunkSlots - 1; i < ChunkSlots; --i)
+            m_FreeSlots.Append(u32(first + i));
+        return true;
+    }
+
+    void release(Chunk *chunk, const u32 index)
+    {
+        u32 &generation = chunk->Generations[index % ChunkSlots];
+        // Retired slots keep the maximum generation, which a null handle also has, but are never marked as occupied
+        if (++generation != GenerationMask)
+            m_FreeSlots.Append(index);
+    }
+
+    void destroyAll()
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            if (m_Size != 0)
+                Clear();
+    }
+
+    BlockAllocator m_Allocator;
+    DynamicArray<Chunk *> m_Chunks{};
+    DynamicArray<u32> m_FreeSlots{};
+    DynamicBitSet m_Occupancy{};
+    usize m_Size = 0;
+};
+} // namespace TKit
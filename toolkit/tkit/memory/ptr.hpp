@@ -1,24 +1,64 @@
 #pragma once
 
+#include "tkit/memory/memory.hpp"
 #include "tkit/utils/debug.hpp"
 #include "tkit/utils/non_copyable.hpp"
+#ifdef TKIT_ENABLE_BLOCK_ALLOCATOR
+#    include "tkit/memory/block_allocator.hpp"
+#endif
+#ifdef TKIT_ENABLE_TIER_ALLOCATOR
+#    include "tkit/memory/tier_allocator.hpp"
+#endif
 #include <atomic>
+#include <new>
 
 namespace TKit
 {
+enum RefAllocator : u8
+{
+    RefAllocator_Heap = 0,
+    RefAllocator_Block = 1,
+    RefAllocator_Tier = 2
+};
+
 /**
- * @brief A special base class to prepare a type `T` to be reference counted, granting it with an atomic counter.
+ * @brief A special base class to prepare a type `T` to be reference counted, granting it with an intrusive counter.
  *
- * As of right now, it does not support stack allocated objects. All objects inheriting from this class should be
- * dynamically allocated in some way with the new/delete operators (which may or may not be overloaded).
+ * As of right now, it does not support stack allocated objects. Objects inheriting from this class must be dynamically
+ * allocated, either with the new/delete operators or from a `BlockAllocator` or `TierAllocator` through the
+ * corresponding `Ref<T>::Create()` overloads. In the latter case, the object remembers its allocator and returns its
+ * memory to it when the last reference is released.
  *
- * @tparam T The type of the object to be reference counted.
+ * The counters live in a small header placed right before the object, which is why this class provides its own
+ * new/delete operators and why types deriving from it must not overload them. Besides the strong count, a weak count is
+ * kept to support `WeakRef<T>`. When the last strong reference is released, the object is destroyed, but if weak
+ * references remain, the header and the object's memory are only released once they are gone, so that they can still
+ * query the counters safely.
+ *
+ * @tparam T The type of the object to be reference counted. It must sit at the start of any object derived from it.
+ * @tparam Atomic Whether the counters are atomic. Objects only shared within a single thread may disable it to avoid
+ * atomic read-modify-write operations every time a reference is copied or destroyed.
  */
-template <typename T> class RefCounted
+template <typename T, bool Atomic = true> class RefCounted
 {
+    using Counter = std::conditional_t<Atomic, std::atomic<u32>, u32>;
+
+    struct Control
+    {
+        Counter RefCount{0};
+        // Weak references plus one while any strong reference exists
+        Counter WeakCount{1};
+        // Allocator the object was created from, with its kind packed in the lower bits
+        uptr Allocator = 0;
+        // Size of the whole allocation, header included
+        usz Size = 0;
+    };
+
   public:
     using CountedType = T;
-    // No initialization of refcount. Refcount adds/removes are handled by Ref
+    using RefCountedBase = RefCounted;
+
+    // Refcount adds/removes are handled by Ref and WeakRef
     RefCounted() = default;
 
     /* COPY-MOVE OPERATIONS */
@@ -39,55 +79,274 @@ template <typename T> class RefCounted
         return *this;
     }
 
-    TKIT_COMPILER_WARNING_IGNORE_PUSH()
-    TKIT_CLANG_WARNING_IGNORE("-Wexceptions")
-    TKIT_GCC_WARNING_IGNORE("-Wterminate")
-    TKIT_MSVC_WARNING_IGNORE(4297)
-    ~RefCounted()
+    static void *operator new(const std::size_t size)
+    {
+        const usz allocationSize = GetHeaderSize() + size;
+        void *memory;
+        if constexpr (GetAllocationAlignment() > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            memory = ::operator new(allocationSize, std::align_val_t{GetAllocationAlignment()});
+        else
+            memory = ::operator new(allocationSize);
+        return initialize(memory, RefAllocator_Heap, allocationSize);
+    }
+    static void *operator new(const std::size_t size, const std::align_val_t alignment)
+    {
+        TKIT_ASSERT(usz(alignment) <= GetAllocationAlignment(),
+                    "[TOOLKIT][REF] Types derived from a reference counted type cannot be more aligned than {}",
+                    GetAllocationAlignment());
+        return operator new(size);
+    }
+
+    static void operator delete(void *ptr)
+    {
+        if (ptr)
+            release(getControl(ptr));
+    }
+    static void operator delete(void *ptr, std::align_val_t)
     {
-        TKIT_ASSERT(m_RefCount.load(std::memory_order_relaxed) == 0,
-                    "[TOOLKIT] RefCounted object deleted with non-zero refcount: {}",
-                    m_RefCount.load(std::memory_order_relaxed));
+        operator delete(ptr);
     }
-    TKIT_COMPILER_WARNING_IGNORE_POP()
 
     u32 RefCount() const
     {
-        return m_RefCount.load(std::memory_order_relaxed);
+        return load(getControl()->RefCount);
+    }
+    // Amount of weak references
+    u32 WeakRefCount() const
+    {
+        const Control *control = getControl();
+        const u32 count = load(control->WeakCount);
+        return load(control->RefCount) != 0 ? count - 1 : count;
+    }
+
+    RefAllocator GetAllocatorKind() const
+    {
+        return RefAllocator(getControl()->Allocator & AllocatorKindMask);
+    }
+
+    /**
+     * @brief Get the alignment every allocation holding a reference counted object of this type must have.
+     */
+    static constexpr usz GetAllocationAlignment()
+    {
+        return alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? alignof(T) : __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    }
+
+    /**
+     * @brief Get the size of the header holding the counters, which sits right before the object.
+     */
+    static constexpr usz GetHeaderSize()
+    {
+        return (sizeof(Control) + GetAllocationAlignment() - 1) & ~(GetAllocationAlignment() - 1);
+    }
+
+    /**
+     * @brief Get the amount of memory an object of type `U` takes when created from an allocator, header included.
+     *
+     * Block allocators used to create reference counted objects must be able to fit this size in a single block.
+     *
+     * @tparam U The type of the object, which may be `T` or any type derived from it.
+     */
+    template <typename U = T> static constexpr usz GetAllocationSize()
+    {
+        return (GetHeaderSize() + sizeof(U) + GetAllocationAlignment() - 1) & ~(GetAllocationAlignment() - 1);
     }
 
   protected:
     // User may want to have control over the objects's destruction, so they can implement this method instead of using
-    // the default
+    // the default. Such types should not be used with weak references, as those need to destroy the object and release
+    // its memory in two separate steps
     void selfDestruct() const
     {
-        delete scast<const T *>(this);
+        Control *control = getControl();
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            scast<const T *>(this)->~T();
+        release(control);
     }
 
   private:
+    static constexpr uptr AllocatorKindMask = 3;
+
+    static u32 load(const Counter &counter)
+    {
+        if constexpr (Atomic)
+            return counter.load(std::memory_order_relaxed);
+        else
+            return counter;
+    }
+    static void increase(Counter &counter)
+    {
+        if constexpr (Atomic)
+            counter.fetch_add(1, std::memory_order_relaxed);
+        else
+            ++counter;
+    }
+    // Returns the previous value
+    static u32 decrease(Counter &counter)
+    {
+        if constexpr (Atomic)
+            return counter.fetch_sub(1, std::memory_order_acq_rel);
+        else
+            return counter--;
+    }
+
+    static Control *getControl(const void *object)
+    {
+        return rcast<Control *>(ccast<std::byte *>(scast<const std::byte *>(object)) - GetHeaderSize());
+    }
+    Control *getControl() const
+    {
+        return getControl(scast<const T *>(this));
+    }
+
+    // Constructs the header at the start of the allocation and returns where the object must be constructed
+    static void *initialize(void *memory, const uptr allocator, const usz size)
+    {
+        ::new (memory) Control{.Allocator = allocator, .Size = size};
+        return scast<std::byte *>(memory) + GetHeaderSize();
+    }
+
+    template <typename Allocator> static uptr packAllocator(Allocator *allocator, const RefAllocator kind)
+    {
+        static_assert(alignof(Allocator) > AllocatorKindMask,
+                      "[TOOLKIT] The allocator alignment must leave room for the allocator kind bits");
+        return rcast<uptr>(allocator) | uptr(kind);
+    }
+
+#ifdef TKIT_ENABLE_BLOCK_ALLOCATOR
+    template <typename U> static void *allocate(BlockAllocator *allocator)
+    {
+        static_assert(alignof(U) <= GetAllocationAlignment(),
+                      "[TOOLKIT][REF] Types derived from a reference counted type cannot be more aligned than it");
+        constexpr usz size = GetAllocationSize<U>();
+        TKIT_ASSERT(size <= allocator->GetAllocationSize(),
+                    "[TOOLKIT][REF] Block allocator allocation size is {:L}, but the object and its header take {:L} "
+                    "bytes, which does not fit into an allocation",
+                    allocator->GetAllocationSize(), size);
+        void *memory = allocator->Allocate();
+        if (!memory)
+            return nullptr;
+        TKIT_ASSERT(IsAligned(memory, GetAllocationAlignment()),
+                    "[TOOLKIT][REF] Reference counted objects require an alignment of {}. Bump the alignment of the "
+                    "allocator or prevent using it to allocate objects of such type",
+                    GetAllocationAlignment());
+        return initialize(memory, packAllocator(allocator, RefAllocator_Block), size);
+    }
+#endif
+
+#ifdef TKIT_ENABLE_TIER_ALLOCATOR
+    template <typename U> static void *allocate(TierAllocator *allocator)
+    {
+        static_assert(alignof(U) <= GetAllocationAlignment(),
+                      "[TOOLKIT][REF] Types derived from a reference counted type cannot be more aligned than it");
+        constexpr usz size = GetAllocationSize<U>();
+        void *memory = allocator->Allocate(size);
+        if (!memory)
+            return nullptr;
+        TKIT_ASSERT(IsAligned(memory, GetAllocationAlignment()),
+                    "[TOOLKIT][REF] Reference counted objects require an alignment of {}. Bump the alignment of the "
+                    "allocator or prevent using it to allocate objects of such type",
+                    GetAllocationAlignment());
+        return initialize(memory, packAllocator(allocator, RefAllocator_Tier), size);
+    }
+#endif
+
+    // Releases the whole allocation, header included. The object must have already been destroyed
+    static void release(Control *control)
+    {
+        const uptr allocator = control->Allocator;
+        switch (RefAllocator(allocator & AllocatorKindMask))
+        {
+#ifdef TKIT_ENABLE_BLOCK_ALLOCATOR
+        case RefAllocator_Block:
+            rcast<BlockAllocator *>(allocator & ~AllocatorKindMask)->Deallocate(control);
+            return;
+#endif
+#ifdef TKIT_ENABLE_TIER_ALLOCATOR
+        case RefAllocator_Tier:
+            rcast<TierAllocator *>(allocator & ~AllocatorKindMask)->Deallocate(scast<void *>(control), control->Size);
+            return;
+#endif
+        default:
+            if constexpr (GetAllocationAlignment() > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                ::operator delete(control, std::align_val_t{GetAllocationAlignment()});
+            else
+                ::operator delete(control);
+            return;
+        }
+    }
+
     void increaseRef() const
     {
-        m_RefCount.fetch_add(1, std::memory_order_relaxed);
+        increase(getControl()->RefCount);
     }
 
     void decreaseRef() const
     {
-        if (m_RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        Control *control = getControl();
+        if (decrease(control->RefCount) != 1)
+            return;
+
+        // With no weak references around, nobody else can observe the object anymore
+        if (load(control->WeakCount) == 1)
+        {
             scast<const T *>(this)->selfDestruct();
+            return;
+        }
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            scast<const T *>(this)->~T();
+        decreaseWeakRef(control);
+    }
+
+    // Weak references only hold on to the header, as the object may be gone already. Locking only succeeds if the
+    // object is still alive
+    static bool tryIncreaseRef(Control *control)
+    {
+        if constexpr (Atomic)
+        {
+            u32 count = control->RefCount.load(std::memory_order_relaxed);
+            while (count != 0)
+                if (control->RefCount.compare_exchange_weak(count, count + 1, std::memory_order_acq_rel,
+                                                            std::memory_order_relaxed))
+                    return true;
+            return false;
+        }
+        else
+        {
+            if (control->RefCount == 0)
+                return false;
+            ++control->RefCount;
+            return true;
+        }
+    }
+    static bool isExpired(const Control *control)
+    {
+        return load(control->RefCount) == 0;
     }
 
-    mutable std::atomic_uint32_t m_RefCount;
+    static void increaseWeakRef(Control *control)
+    {
+        increase(control->WeakCount);
+    }
+    static void decreaseWeakRef(Control *control)
+    {
+        if (decrease(control->WeakCount) == 1)
+            release(control);
+    }
 
     template <typename U> friend class Ref;
+    template <typename U> friend class WeakRef;
 };
 
+template <typename T> using LocalRefCounted = RefCounted<T, false>;
+
 // To use const, Ref<const T> should be enough
 
 /**
  * @brief A small homemade implementation of a reference counter to avoid some of the shared_ptr's allocations overhead.
  *
- * The reference counter is stored in the object itself. Any object that wishes to be reference counted should inherit
- * from the RefCounted class.
+ * The reference counter is stored in a small header right before the object, which is allocated along with it. Any
+ * object that wishes to be reference counted should inherit from the RefCounted class.
  *
  * @tparam T The type of the pointer.
  */
@@ -225,22 +484,182 @@ template <typename T> class Ref
         return Ref(new T(std::forward<Args>(args)...));
     }
 
+#ifdef TKIT_ENABLE_BLOCK_ALLOCATOR
+    /**
+     * @brief Create a new object of type `T` from a block allocator.
+     *
+     * The memory is returned to the allocator once the object is no longer referenced, so the allocator must outlive
+     * every reference to it.
+     *
+     * @param allocator The block allocator to allocate the object from.
+     * @param args The arguments to pass to the constructor of `T`.
+     * @return A new `Ref<T>` object, or a null one if the allocation fails.
+     */
+    template <typename... Args>
+        requires std::constructible_from<T, Args...>
+    static Ref Create(BlockAllocator *allocator, Args &&...args)
+    {
+        void *memory = T::RefCountedBase::template allocate<T>(allocator);
+        return Ref(memory ? Construct(scast<T *>(memory), std::forward<Args>(args)...) : nullptr);
+    }
+#endif
+
+#ifdef TKIT_ENABLE_TIER_ALLOCATOR
+    /**
+     * @brief Create a new object of type `T` from a tier allocator.
+     *
+     * The memory is returned to the allocator once the object is no longer referenced, so the allocator must outlive
+     * every reference to it.
+     *
+     * @param allocator The tier allocator to allocate the object from.
+     * @param args The arguments to pass to the constructor of `T`.
+     * @return A new `Ref<T>` object, or a null one if the allocation fails.
+     */
+    template <typename... Args>
+        requires std::constructible_from<T, Args...>
+    static Ref Create(TierAllocator *allocator, Args &&...args)
+    {
+        void *memory = T::RefCountedBase::template allocate<T>(allocator);
+        return Ref(memory ? Construct(scast<T *>(memory), std::forward<Args>(args)...) : nullptr);
+    }
+#endif
+
     std::strong_ordering operator<=>(const Ref &other) const = default;
 
   private:
     void increaseRef() const
     {
         if (m_Ptr)
-            scast<const RefCounted<typename T::CountedType> *>(m_Ptr)->increaseRef();
+            scast<const typename T::RefCountedBase *>(m_Ptr)->increaseRef();
     }
     void decreaseRef() const
     {
         if (m_Ptr)
-            scast<const RefCounted<typename T::CountedType> *>(m_Ptr)->decreaseRef();
+            scast<const typename T::RefCountedBase *>(m_Ptr)->decreaseRef();
     }
 
     T *m_Ptr = nullptr;
     template <typename U> friend class Ref;
+    template <typename U> friend class WeakRef;
+};
+
+/**
+ * @brief A weak reference to a reference counted object, which does not keep it alive.
+ *
+ * It must be converted to a `Ref<T>` with `Lock()` to access the object, which will be null if the object has already
+ * been destroyed. The memory of the object is kept around until the last weak reference is gone.
+ *
+ * @tparam T The type of the pointer.
+ */
+template <typename T> class WeakRef
+{
+  public:
+    WeakRef() = default;
+
+    WeakRef(const Ref<T> &ref) : m_Ptr(ref.Get()), m_Control(getControl(ref.Get()))
+    {
+        increaseWeakRef();
+    }
+    WeakRef(const WeakRef &other) : m_Ptr(other.m_Ptr), m_Control(other.m_Control)
+    {
+        increaseWeakRef();
+    }
+    WeakRef(WeakRef &&other) : m_Ptr(other.m_Ptr), m_Control(other.m_Control)
+    {
+        other.m_Ptr = nullptr;
+        other.m_Control = nullptr;
+    }
+
+    WeakRef &operator=(const Ref<T> &ref)
+    {
+        if (m_Ptr != ref.Get())
+        {
+            decreaseWeakRef();
+            m_Ptr = ref.Get();
+            m_Control = getControl(ref.Get());
+            increaseWeakRef();
+        }
+        return *this;
+    }
+    WeakRef &operator=(const WeakRef &other)
+    {
+        if (m_Control != other.m_Control)
+        {
+            decreaseWeakRef();
+            m_Ptr = other.m_Ptr;
+            m_Control = other.m_Control;
+            increaseWeakRef();
+        }
+        return *this;
+    }
+    WeakRef &operator=(WeakRef &&other)
+    {
+        if (this != &other)
+        {
+            decreaseWeakRef();
+            m_Ptr = other.m_Ptr;
+            m_Control = other.m_Control;
+            other.m_Ptr = nullptr;
+            other.m_Control = nullptr;
+        }
+        return *this;
+    }
+
+    ~WeakRef()
+    {
+        decreaseWeakRef();
+    }
+
+    /**
+     * @brief Get a strong reference to the object.
+     *
+     * @return A `Ref<T>` to the object, or a null one if the object has already been destroyed.
+     */
+    Ref<T> Lock() const
+    {
+        Ref<T> ref;
+        if (m_Control && T::RefCountedBase::tryIncreaseRef(control()))
+            ref.m_Ptr = m_Ptr;
+        return ref;
+    }
+
+    bool IsExpired() const
+    {
+        return !m_Control || T::RefCountedBase::isExpired(control());
+    }
+
+    void Reset()
+    {
+        decreaseWeakRef();
+        m_Ptr = nullptr;
+        m_Control = nullptr;
+    }
+
+  private:
+    // The header is fetched while the object is still alive, as the pointer cannot be used once it is destroyed
+    static void *getControl(const T *ptr)
+    {
+        return ptr ? scast<const typename T::RefCountedBase *>(ptr)->getControl() : nullptr;
+    }
+    auto *control() const
+    {
+        return scast<typename T::RefCountedBase::Control *>(m_Control);
+    }
+
+    void increaseWeakRef() const
+    {
+        if (m_Control)
+            T::RefCountedBase::increaseWeakRef(control());
+    }
+    void decreaseWeakRef() const
+    {
+        if (m_Control)
+            T::RefCountedBase::decreaseWeakRef(control());
+    }
+
+    T *m_Ptr = nullptr;
+    // Kept type-erased so that a type can hold weak references to itself
+    void *m_Control = nullptr;
 };
 
 /**
@@ -376,6 +795,17 @@ template <typename T> class Scope
 
     template <typename U> friend class Scope;
 };
+
+// Smart pointers are just a pointer to an object that does not know where they live
+template <typename T> struct IsTriviallyRelocatable<Ref<T>> : std::true_type
+{
+};
+template <typename T> struct IsTriviallyRelocatable<WeakRef<T>> : std::true_type
+{
+};
+template <typename T> struct IsTriviallyRelocatable<Scope<T>> : std::true_type
+{
+};
 } // namespace TKit
 
 template <typename T> struct std::hash<TKit::Ref<T>>
@@ -16,12 +16,12 @@ StackAllocator::StackAllocator(void *buffer, const usz capacity, const usize ali
     TKIT_POISON_MEMORY_REGION(buffer, capacity);
 }
 
-StackAllocator::StackAllocator(const usz capacity, const usize alignment)
-    : m_Capacity(capacity), m_Alignment(alignment), m_Provided(false)
+StackAllocator::StackAllocator(const usz capacity, const usize alignment, const NumaSpecs &numa)
+    : m_Capacity(capacity), m_Alignment(alignment), m_Numa(numa), m_Provided(false)
 {
     TKIT_ASSERT(IsPowerOfTwo(alignment), "[TOOLKIT][STACK-ALLOC] Alignment must be a power of 2, but the value is {}",
                 alignment);
-    m_Buffer = scast<std::byte *>(AllocateAligned(capacity, alignment));
+    m_Buffer = scast<std::byte *>(AllocateAligned(capacity, alignment, numa));
     TKIT_ASSERT(m_Buffer, "[TOOLKIT][STACK-ALLOC] Failed to allocate {:L} bytes of memory aligned to {:L} bytes",
                 capacity, alignment);
     TKIT_POISON_MEMORY_REGION(m_Buffer, capacity);
@@ -34,7 +34,7 @@ StackAllocator::~StackAllocator()
 
 StackAllocator::StackAllocator(StackAllocator &&other)
     : m_Buffer(other.m_Buffer), m_Top(other.m_Top), m_Capacity(other.m_Capacity), m_Alignment(other.m_Alignment),
-      m_Provided(other.m_Provided)
+      m_Numa(other.m_Numa), m_Provided(other.m_Provided)
 
 {
     other.m_Buffer = nullptr;
@@ -53,6 +53,7 @@ StackAllocator &StackAllocator::operator=(StackAllocator &&other)
         m_Top = other.m_Top;
         m_Capacity = other.m_Capacity;
         m_Alignment = other.m_Alignment;
+        m_Numa = other.m_Numa;
         m_Provided = other.m_Provided;
 
         other.m_Buffer = nullptr;
@@ -105,6 +106,6 @@ void StackAllocator::deallocateBuffer()
         "[TOOLKIT][STACK-ALLOC] Deallocating a stack allocator with active allocations. If the elements are not "
         "trivially destructible, you will have to call "
         "Destroy() for each element to avoid undefined behaviour (this deallocation will not call the destructor)");
-    DeallocateAligned(m_Buffer);
+    DeallocateAligned(m_Buffer, m_Capacity, m_Numa);
 }
 } // namespace TKit
@@ -31,7 +31,8 @@ class alignas(TKIT_CACHE_LINE_SIZE) StackAllocator
 {
     TKIT_NON_COPYABLE(StackAllocator)
   public:
-    explicit StackAllocator(usz capacity, usize alignment = alignof(std::max_align_t));
+    // A NUMA policy other than the default one allocates the buffer with page granularity
+    explicit StackAllocator(usz capacity, usize alignment = alignof(std::max_align_t), const NumaSpecs &numa = {});
 
     // This constructor is NOT owning the buffer, so it will not deallocate it. Up to the user to manage the memory
     StackAllocator(void *buffer, usz capacity, usize alignment = alignof(std::max_align_t));
@@ -194,6 +195,7 @@ class alignas(TKIT_CACHE_LINE_SIZE) StackAllocator
     usz m_Top = 0;
     usz m_Capacity = 0;
     usize m_Alignment = 0;
+    NumaSpecs m_Numa{};
     bool m_Provided;
 };
 } // namespace TKit
@@ -4,6 +4,7 @@
 #include "tkit/utils/debug.hpp"
 #include "tkit/profiling/macros.hpp"
 #include "tkit/math/math.hpp"
+#include "tkit/utils/limits.hpp"
 
 namespace TKit
 {
@@ -71,6 +72,18 @@ static usize getTierIndex(const usz size, const usz minAllocation, const usize g
     // return lastIndex + ((offset - incIndex) << (grIndex - 1)) + (reference >> incIndex);
 }
 
+static usz getTierSize(usize slots, const usz allocationSize)
+{
+    const usize alignment = usize(PrevPowerOfTwo(allocationSize));
+    usz size = slots * allocationSize;
+    while (size % alignment != 0)
+    {
+        ++slots;
+        size += allocationSize;
+    }
+    return size;
+}
+
 static void createDefaultSlotRequests(ArenaArray<usize> &slots, const f32 tierSlotDecay)
 {
     const usize capacity = slots.GetCapacity();
@@ -116,6 +129,22 @@ usize TierDescriptions::GetTierIndex(const usz size) const
     return TKit::getTierIndex(size, m_MinAllocation, m_Granularity, m_Tiers.GetSize() - 1);
 }
 
+bool TierDescriptions::IsValidLayout(const usz maxAllocation, const usz minAllocation, const usize granularity) const
+{
+    if (!IsPowerOfTwo(maxAllocation) || !IsPowerOfTwo(minAllocation) || !IsPowerOfTwo(granularity))
+        return false;
+    if (granularity < 2 || granularity > minAllocation || minAllocation > maxAllocation ||
+        2 * minAllocation < sizeof(void *) * granularity)
+        return false;
+
+    // With powers of two, the allocation sizes always land on the minimum allocation, so only the count is checked
+    usize tiers = 1;
+    for (usz alloc = maxAllocation; alloc != minAllocation; alloc -= NextPowerOfTwo(alloc) / granularity)
+        if (++tiers > m_Tiers.GetCapacity())
+            return false;
+    return true;
+}
+
 void TierDescriptions::buildTierLayout()
 {
     m_Tiers.Clear();
@@ -130,21 +159,14 @@ void TierDescriptions::buildTierLayout()
         return currentAlloc - increment;
     };
 
-    m_BufferSize = m_MaxAllocation;
+    m_BufferSize = getTierSize(m_MinSlots[0], m_MaxAllocation);
     usz currentAlloc = nextAlloc(m_MaxAllocation);
 
-    m_Tiers.Append(TierInfo{.Size = m_MaxAllocation, .AllocationSize = m_MaxAllocation, .Slots = 1});
+    m_Tiers.Append(TierInfo{
+        .Size = m_BufferSize, .AllocationSize = m_MaxAllocation, .Slots = usize(m_BufferSize / m_MaxAllocation)});
     for (;;)
     {
-        const usize alignment = usize(PrevPowerOfTwo(currentAlloc));
-
-        usize slots = m_MinSlots[m_Tiers.GetSize()];
-        usz size = slots * currentAlloc;
-        while (size % alignment != 0)
-        {
-            ++slots;
-            size += currentAlloc;
-        }
+        const usz size = getTierSize(m_MinSlots[m_Tiers.GetSize()], currentAlloc);
 
         TierInfo tier{};
         tier.AllocationSize = currentAlloc;
@@ -188,14 +210,120 @@ void TierDescriptions::buildTierLayout()
 #endif
 }
 
-TierAllocator::TierAllocator(const TierDescriptions &tiers, const usize maxAlignment, const usize headerAllocsAlignment)
+void TierRecording::RecordAllocation(const usize tierIndex, const usz size)
+{
+    if (size >= m_Sizes.GetSize())
+        m_Sizes.Resize(usize(size + 1));
+    if (tierIndex >= m_Tiers.GetSize())
+        m_Tiers.Resize(tierIndex + 1);
+
+    const auto record = [](Record &rec) {
+        ++rec.Requests;
+        if (++rec.Live > rec.PeakLive)
+            rec.PeakLive = rec.Live;
+    };
+    record(m_Sizes[usize(size)]);
+    record(m_Tiers[tierIndex].Allocations);
+}
+
+void TierRecording::RecordDeallocation(const usize tierIndex, const usz size)
+{
+    // Allocations performed before the recording started are not tracked
+    if (size < m_Sizes.GetSize() && m_Sizes[usize(size)].Live != 0)
+        --m_Sizes[usize(size)].Live;
+    if (tierIndex < m_Tiers.GetSize() && m_Tiers[tierIndex].Allocations.Live != 0)
+        --m_Tiers[tierIndex].Allocations.Live;
+}
+
+void TierRecording::RecordLargeAllocation()
+{
+    ++m_Large.Requests;
+    if (++m_Large.Live > m_Large.PeakLive)
+        m_Large.PeakLive = m_Large.Live;
+}
+
+void TierRecording::RecordLargeDeallocation()
+{
+    if (m_Large.Live != 0)
+        --m_Large.Live;
+}
+
+void TierRecording::RecordSteal(const usize tierIndex)
+{
+    if (tierIndex >= m_Tiers.GetSize())
+        m_Tiers.Resize(tierIndex + 1);
+    ++m_Tiers[tierIndex].Steals;
+}
+
+TierDescriptions TierRecording::Solve(const TierSpecs &specs) const
+{
+    usz maxSize = 0;
+    for (usize i = 0; i < m_Sizes.GetSize(); ++i)
+        if (m_Sizes[i].PeakLive != 0)
+            maxSize = i;
+
+    TKIT_LOG_WARNING_IF(maxSize == 0, "[TOOLKIT][TIER-ALLOC] Solving tier descriptions from an empty recording");
+
+    // The maximum allocation must leave room for at least one tier below it with the smallest valid minimum allocation
+    const usz maxAllocation = Math::Max(NextPowerOfTwo(Math::Max(maxSize, usz(1))), usz(2 * sizeof(void *)));
+
+    DynamicArray<usize> slots{};
+    DynamicArray<usize> bestSlots{};
+    usz bestSize = Limits<usz>::Max();
+    usz bestMinAllocation = 0;
+    usize bestGranularity = 0;
+
+    for (usize granularity = 2; granularity <= maxAllocation / 2; granularity *= 2)
+        for (usz minAllocation = granularity * sizeof(void *) / 2; minAllocation < maxAllocation; minAllocation *= 2)
+        {
+            const usize tierCount = (logp2(maxAllocation) - logp2(minAllocation)) * (granularity >> 1) + 1;
+            if (tierCount > specs.MaxTiers)
+                continue;
+
+            slots.Clear();
+            slots.Resize(tierCount, usize(0));
+            for (usize size = 0; size < m_Sizes.GetSize(); ++size)
+                if (m_Sizes[size].PeakLive != 0)
+                    slots[getTierIndex(size, minAllocation, granularity, tierCount - 1)] += m_Sizes[size].PeakLive;
+
+            usz bufferSize = 0;
+            usz allocationSize = maxAllocation;
+            for (usize i = 0; i < tierCount; ++i)
+            {
+                bufferSize += getTierSize(slots[i], allocationSize);
+                allocationSize -= NextPowerOfTwo(allocationSize) / granularity;
+            }
+
+            if (bufferSize < bestSize)
+            {
+                bestSize = bufferSize;
+                bestMinAllocation = minAllocation;
+                bestGranularity = granularity;
+                bestSlots = slots;
+            }
+        }
+
+    TKIT_ASSERT(bestGranularity != 0,
+                "[TOOLKIT][TIER-ALLOC] Failed to find a valid tier layout with at most {} tiers for the recording",
+                specs.MaxTiers);
+
+    TierSpecs solved = specs;
+    solved.MaxAllocation = maxAllocation;
+    solved.MinAllocation = bestMinAllocation;
+    solved.Granularity = bestGranularity;
+
+    TierDescriptions tiers{solved};
+    for (usize i = 0; i < bestSlots.GetSize(); ++i)
+        tiers.SetMinSlotsForIndex(i, bestSlots[i]);
+    return tiers;
+}
+
+TierAllocator::TierAllocator(const TierDescriptions &tiers, const usize maxAlignment, const usize headerAllocsAlignment,
+                             const NumaSpecs &numa)
     : m_Tiers(tiers.GetTiers().GetAllocator(), tiers.GetTiers().GetCapacity()), m_BufferSize(tiers.GetBufferSize()),
-      m_MinAllocation(tiers.GetMinAllocation()), m_Granularity(tiers.GetGranularity()),
-      m_HeaderAllocationsAlignment(headerAllocsAlignment)
+      m_MinAllocation(tiers.GetMinAllocation()), m_MaxAllocation(tiers.GetMaxAllocation()),
+      m_Granularity(tiers.GetGranularity()), m_HeaderAllocationsAlignment(headerAllocsAlignment), m_Numa(numa)
 {
-#ifdef TKIT_ENABLE_ENSURE
-    m_MaxAllocation = tiers.GetMaxAllocation();
-#endif
     TKIT_ASSERT(IsPowerOfTwo(maxAlignment),
                 "[TOOLKIT][TIER-ALLOC] Maximum alignment must be a power of 2, but {} is not", maxAlignment);
     TKIT_ASSERT(maxAlignment >= alignof(std::max_align_t),
@@ -206,7 +334,7 @@ TierAllocator::TierAllocator(const TierDescriptions &tiers, const usize maxAlign
     TKIT_ASSERT(
         headerAllocsAlignment >= alignof(std::max_align_t),
         "[TOOLKIT][TIER-ALLOC] Header allocations alignment must be greater or equal than alignof(std::max_align_t)");
-    m_Buffer = scast<std::byte *>(AllocateAligned(m_BufferSize, maxAlignment));
+    m_Buffer = scast<std::byte *>(AllocateAligned(m_BufferSize, maxAlignment, numa));
 #ifdef TKIT_ENABLE_ENSURE
     setupMemoryLayout(tiers, maxAlignment);
 #else
@@ -214,8 +342,9 @@ TierAllocator::TierAllocator(const TierDescriptions &tiers, const usize maxAlign
 #endif
 }
 
-TierAllocator::TierAllocator(const TierSpecs &specs, const usize maxAlignment, const usize headerAllocsAlignment)
-    : TierAllocator(TierDescriptions{specs}, maxAlignment, headerAllocsAlignment)
+TierAllocator::TierAllocator(const TierSpecs &specs, const usize maxAlignment, const usize headerAllocsAlignment,
+                             const NumaSpecs &numa)
+    : TierAllocator(TierDescriptions{specs}, maxAlignment, headerAllocsAlignment, numa)
 {
 }
 
@@ -226,13 +355,22 @@ TierAllocator::~TierAllocator()
 
 TierAllocator::TierAllocator(TierAllocator &&other)
     : m_Tiers(std::move(other.m_Tiers)), m_Buffer(other.m_Buffer), m_BufferSize(other.m_BufferSize),
-      m_MinAllocation(other.m_MinAllocation), m_Granularity(other.m_Granularity)
+      m_MinAllocation(other.m_MinAllocation), m_MaxAllocation(other.m_MaxAllocation),
+      m_Granularity(other.m_Granularity), m_HeaderAllocationsAlignment(other.m_HeaderAllocationsAlignment),
+      m_Numa(other.m_Numa), m_LargeAllocations(other.m_LargeAllocations),
+      m_LargeAllocationSize(other.m_LargeAllocationSize), m_Recording(other.m_Recording)
 {
+#ifdef TKIT_ENABLE_ENSURE
+    m_LiveLargeAllocations = std::move(other.m_LiveLargeAllocations);
+#endif
     other.m_Tiers.Clear();
     other.m_Buffer = nullptr;
     other.m_BufferSize = 0;
     other.m_MinAllocation = 0;
+    other.m_MaxAllocation = 0;
     other.m_Granularity = 0;
+    other.m_LargeAllocations = 0;
+    other.m_LargeAllocationSize = 0;
 }
 
 TierAllocator &TierAllocator::operator=(TierAllocator &&other)
@@ -244,13 +382,25 @@ TierAllocator &TierAllocator::operator=(TierAllocator &&other)
         m_Buffer = other.m_Buffer;
         m_BufferSize = other.m_BufferSize;
         m_MinAllocation = other.m_MinAllocation;
+        m_MaxAllocation = other.m_MaxAllocation;
         m_Granularity = other.m_Granularity;
+        m_HeaderAllocationsAlignment = other.m_HeaderAllocationsAlignment;
+        m_Numa = other.m_Numa;
+        m_LargeAllocations = other.m_LargeAllocations;
+        m_LargeAllocationSize = other.m_LargeAllocationSize;
+        m_Recording = other.m_Recording;
+#ifdef TKIT_ENABLE_ENSURE
+        m_LiveLargeAllocations = std::move(other.m_LiveLargeAllocations);
+#endif
 
         other.m_Tiers.Clear();
         other.m_Buffer = nullptr;
         other.m_BufferSize = 0;
         other.m_MinAllocation = 0;
+        other.m_MaxAllocation = 0;
         other.m_Granularity = 0;
+        other.m_LargeAllocations = 0;
+        other.m_LargeAllocationSize = 0;
     }
     return *this;
 }
@@ -266,8 +416,8 @@ void TierAllocator::setupMemoryLayout(const TierDescriptions &tiers)
     {
         Tier tier{};
         tier.Buffer = m_Buffer + size;
-        tier.FreeList = rcast<Allocation *>(tier.Buffer);
         const usize count = usize(tinfo.Size / tinfo.AllocationSize);
+        tier.FreeList = count != 0 ? rcast<Allocation *>(tier.Buffer) : nullptr;
 
         TKIT_ENSURE(IsAligned(tier.Buffer, Math::Min(usz(maxAlignment), PrevPowerOfTwo(tinfo.AllocationSize))),
                     "[TOOLKIT][TIER-ALLOC] Tier with size {:L} and buffer {} failed alignment check: it is not aligned "
@@ -315,8 +465,12 @@ void TierAllocator::deallocateBuffer()
                         "{} active allocations remain when destroying this allocator",
                         i, tier.Allocations, tier.Deallocations, tier.Allocations - tier.Deallocations);
         }
+        TKIT_ENSURE(m_LargeAllocations == 0,
+                    "[TOOLKIT][TIER-ALLOC] Found {} active large allocations ({:L} bytes) when destroying this "
+                    "allocator",
+                    m_LargeAllocations, m_LargeAllocationSize);
 #endif
-        DeallocateAligned(m_Buffer);
+        DeallocateAligned(m_Buffer, m_BufferSize, m_Numa);
     }
 }
 
@@ -326,6 +480,8 @@ void *TierAllocator::allocate(const usize tierIndex, const usz size)
     if (!tier.FreeList)
     {
         void *ptr = tierIndex != 0 ? allocate(tierIndex - 1, size) : nullptr;
+        if (m_Recording && ptr && getTierIndex(size) == tierIndex)
+            m_Recording->RecordSteal(tierIndex);
 #ifdef TKIT_ENABLE_ENSURE
         if (ptr)
         {
@@ -349,10 +505,10 @@ void *TierAllocator::allocate(const usize tierIndex, const usz size)
                             "[TOOLKIT][TIER-ALLOC] Allocator ran out of slots when trying to perform an allocation for "
                             "tier index {} and size {:L}. A slot was stolen from tier index {}",
                             tierIndex, size, tierIndex - 1);
-        TKIT_LOG_ERROR_IF(tierIndex == 0 && !ptr,
-                          "[TOOLKIT][TIER-ALLOC] Allocator ran out of memory when trying to perform an allocation for "
-                          "tier index {} and size {:L}",
-                          tierIndex, size);
+        TKIT_LOG_WARNING_IF(tierIndex == 0 && !ptr,
+                            "[TOOLKIT][TIER-ALLOC] Allocator ran out of slots when trying to perform an allocation for "
+                            "tier index {} and size {:L}. It will fall back to a large allocation",
+                            tierIndex, size);
         return ptr;
     }
 #ifdef TKIT_ENABLE_ENSURE
@@ -388,20 +544,98 @@ void *TierAllocator::allocate(const usize tierIndex, const usz size)
 #endif
     return alloc;
 }
+void *TierAllocator::allocateLarge(const usz size)
+{
+    void *ptr;
+    if (m_Numa.Policy == Numa_Local)
+        ptr = AllocateLocal(size);
+    else if (m_Numa.Policy == Numa_Node)
+        ptr = AllocateOnNode(size, m_Numa.Node);
+    else
+        ptr = AllocatePages(size);
+    TKIT_LOG_ERROR_IF(!ptr, "[TOOLKIT][TIER-ALLOC] Failed to perform a large allocation of {:L} bytes", size);
+    if (ptr)
+    {
+        ++m_LargeAllocations;
+        m_LargeAllocationSize += size;
+#ifdef TKIT_ENABLE_ENSURE
+        m_LiveLargeAllocations.Append(LargeAllocation{.Pointer = ptr, .Size = size});
+#endif
+    }
+    return ptr;
+}
+
+void TierAllocator::deallocateLarge(const void *ptr, const usz size)
+{
+#ifdef TKIT_ENABLE_ENSURE
+    const usize index = findLargeAllocation(ptr);
+    TKIT_ENSURE(index != m_LiveLargeAllocations.GetSize(),
+                "[TOOLKIT][TIER-ALLOC] Cannot deallocate a pointer that does not belong to the allocator. It is "
+                "neither in the buffer nor a live large allocation");
+    TKIT_ENSURE(m_LiveLargeAllocations[index].Size == size,
+                "[TOOLKIT][TIER-ALLOC] Large allocation of {:L} bytes is being deallocated with a size of {:L} bytes",
+                m_LiveLargeAllocations[index].Size, size);
+    m_LiveLargeAllocations.RemoveUnordered(m_LiveLargeAllocations.begin() + index);
+#endif
+    --m_LargeAllocations;
+    m_LargeAllocationSize -= size;
+    DeallocatePages(ccast<void *>(ptr), size);
+}
+
+void TierAllocator::recordAllocation(const usz size)
+{
+    if (!m_Recording)
+        return;
+    if (size <= m_MaxAllocation)
+        m_Recording->RecordAllocation(getTierIndex(size), size);
+    else
+        m_Recording->RecordLargeAllocation();
+}
+
+void TierAllocator::recordDeallocation(const usz size)
+{
+    if (!m_Recording)
+        return;
+    if (size <= m_MaxAllocation)
+        m_Recording->RecordDeallocation(getTierIndex(size), size);
+    else
+        m_Recording->RecordLargeDeallocation();
+}
+
+#ifdef TKIT_ENABLE_ENSURE
+usize TierAllocator::findLargeAllocation(const void *ptr) const
+{
+    for (usize i = 0; i < m_LiveLargeAllocations.GetSize(); ++i)
+        if (m_LiveLargeAllocations[i].Pointer == ptr)
+            return i;
+    return m_LiveLargeAllocations.GetSize();
+}
+#endif
+
 void *TierAllocator::Allocate(const usz size)
 {
-    TKIT_ENSURE(size <= m_MaxAllocation,
-                "[TOOLKIT][TIER-ALLOC] Allocation of size {:L} bytes exceeds max allocation size of {:L}", size,
-                m_MaxAllocation);
-    const usize index = getTierIndex(size);
-    return allocate(index, size);
+    void *ptr = size <= m_MaxAllocation ? allocate(getTierIndex(size), size) : nullptr;
+    if (!ptr)
+        ptr = allocateLarge(size);
+    if (ptr)
+        recordAllocation(size);
+    return ptr;
 }
 
 void TierAllocator::Deallocate(const void *ptr, const usz size)
 {
     TKIT_ASSERT(ptr, "[TOOLKIT][TIER-ALLOC] Cannot deallocate a null pointer");
-    TKIT_ASSERT(Belongs(ptr),
-                "[TOOLKIT][TIER-ALLOC] Cannot deallocate a pointer that does not belong to the allocator");
+    recordDeallocation(size);
+
+    if (!Belongs(ptr))
+    {
+        deallocateLarge(ptr, size);
+        return;
+    }
+    TKIT_ASSERT(size <= m_MaxAllocation,
+                "[TOOLKIT][TIER-ALLOC] A tier allocation cannot have a size of {:L} bytes, which exceeds the max "
+                "allocation size of {:L}",
+                size, m_MaxAllocation);
 
     const usize index = getTierIndex(size);
     Tier &tier = m_Tiers[index];
@@ -420,6 +654,61 @@ void TierAllocator::Deallocate(const void *ptr, const usz size)
 #endif
 }
 
+void *TierAllocator::Reallocate(void *ptr, const usz oldSize, const usz newSize)
+{
+    TKIT_ASSERT(ptr, "[TOOLKIT][TIER-ALLOC] Cannot reallocate a null pointer");
+    if (!Belongs(ptr))
+    {
+        // Large allocations that stay large can be remapped without copying
+        if (newSize > m_MaxAllocation)
+        {
+#ifdef TKIT_ENABLE_ENSURE
+            const usize index = findLargeAllocation(ptr);
+            TKIT_ENSURE(index != m_LiveLargeAllocations.GetSize(),
+                        "[TOOLKIT][TIER-ALLOC] Cannot reallocate a pointer that does not belong to the allocator. It "
+                        "is neither in the buffer nor a live large allocation");
+            TKIT_ENSURE(m_LiveLargeAllocations[index].Size == oldSize,
+                        "[TOOLKIT][TIER-ALLOC] Large allocation of {:L} bytes is being reallocated with an old size "
+                        "of {:L} bytes",
+                        m_LiveLargeAllocations[index].Size, oldSize);
+#endif
+            void *newPtr = ReallocatePages(ptr, oldSize, newSize);
+            TKIT_LOG_ERROR_IF(!newPtr, "[TOOLKIT][TIER-ALLOC] Failed to reallocate a large allocation to {:L} bytes",
+                              newSize);
+            if (!newPtr)
+                return nullptr;
+#ifdef TKIT_ENABLE_ENSURE
+            m_LiveLargeAllocations[index] = LargeAllocation{.Pointer = newPtr, .Size = newSize};
+#endif
+            recordDeallocation(oldSize);
+            recordAllocation(newSize);
+            m_LargeAllocationSize = m_LargeAllocationSize - oldSize + newSize;
+            return newPtr;
+        }
+    }
+    else if (IsSameTier(oldSize, newSize))
+    {
+        recordDeallocation(oldSize);
+        recordAllocation(newSize);
+#ifdef TKIT_ASAN_ENABLED
+        // The first bytes must remain accessible, as they will hold the free list link once deallocated
+        const usz keep = Math::Max(newSize, sizeof(Allocation));
+        if (newSize > oldSize)
+            TKIT_UNPOISON_MEMORY_REGION(ptr, newSize);
+        else if (oldSize > keep)
+            TKIT_POISON_MEMORY_REGION(scast<std::byte *>(ptr) + keep, oldSize - keep);
+#endif
+        return ptr;
+    }
+
+    void *newPtr = Allocate(newSize);
+    if (!newPtr)
+        return nullptr;
+    ForwardCopy(newPtr, ptr, Math::Min(oldSize, newSize));
+    Deallocate(ptr, oldSize);
+    return newPtr;
+}
+
 void *TierAllocator::AllocateWithHeader(const usz size)
 {
     const usz headerSize = GetHeaderSize();
@@ -6,6 +6,7 @@
 #endif
 
 #include "tkit/container/arena_array.hpp"
+#include "tkit/container/dynamic_array.hpp"
 #include "tkit/memory/memory.hpp"
 #include "tkit/utils/non_copyable.hpp"
 #include "tkit/utils/debug.hpp"
@@ -26,14 +27,14 @@ namespace TKit
  * the allocator will respect alignment requirements (including the ones set by `alignas`) up to the specified
  * maximum alignment.
  *
- * @param maxAllocation The maximum allocation size the allocator will support. This also equals to the size of
- * the first tier (which is the one with the largest allocation size), meaning only one allocation of
- * `maxAllocation` bytes can be made.
+ * @param maxAllocation The maximum allocation size the allocator will support. This is also the allocation size of
+ * the first tier (which is the one with the largest allocation size), which holds as many allocations of
+ * `maxAllocation` bytes as slots are requested for it, one by default.
  *
  * @param tierSlotDecay A value between 0 and 1 that controls how the amount of slots scales when creating tiers
  * with smaller allocation sizes. A tier with index i + 1 will have at least the amount of slots tier i has divided
- * by this value. The tier with index 0 has always exactly one slot. Setting this value too low may cause the buffer
- * size to explode.
+ * by this value. The tier with index 0 starts from a single slot, but gets at least as many slots as requested with
+ * `TierDescriptions::SetMinSlotsForIndex()`. Setting this value too low may cause the buffer size to explode.
  *
  * @param granularity It controls how the size difference between tiers evolves, such that the difference between
  * the allocation sizes of tiers i and i + 1 is the next power of 2 from the allocation size i, divided by the
@@ -119,6 +120,33 @@ class TierDescriptions
         buildTierLayout();
     }
 
+    /**
+     * @brief Set the maximum allocation, the minimum allocation and the granularity at once, rebuilding the layout only
+     * once.
+     *
+     * Useful when the three parameters change together and intermediate combinations would not form a valid layout.
+     */
+    void SetLayout(const usz maxAllocation, const usz minAllocation, const usize granularity)
+    {
+        TKIT_ASSERT(IsValidLayout(maxAllocation, minAllocation, granularity),
+                    "[TOOLKIT][TIER-ALLOC] The layout with a maximum allocation of {:L}, a minimum allocation of {:L} "
+                    "and a granularity of {} is not valid",
+                    maxAllocation, minAllocation, granularity);
+        m_MaxAllocation = maxAllocation;
+        m_MinAllocation = minAllocation;
+        m_Granularity = granularity;
+        buildTierLayout();
+    }
+
+    /**
+     * @brief Check if a maximum allocation, a minimum allocation and a granularity form a valid layout that fits in the
+     * tier capacity of this description.
+     *
+     * Unlike the assertions in `SetLayout()`, this check is always performed, so it can be used to validate layouts
+     * that come from untrusted sources, such as a file.
+     */
+    bool IsValidLayout(usz maxAllocation, usz minAllocation, usize granularity) const;
+
   private:
     void buildTierLayout();
 
@@ -130,6 +158,82 @@ class TierDescriptions
     usize m_Granularity;
 };
 
+/**
+ * @brief Records the allocation pattern of a workload running on a `TierAllocator`.
+ *
+ * Once attached to an allocator with `TierAllocator::SetRecording()`, it keeps a histogram of the requested sizes, with
+ * the amount of requests and the peak amount of simultaneously live allocations for every size, as well as the same
+ * statistics (plus the amount of stolen slots) for every tier of the recorded allocator.
+ *
+ * The recording can then be used to create a `TierDescriptions` tailored to the workload with `Solve()`.
+ */
+class TierRecording
+{
+  public:
+    struct Record
+    {
+        u64 Requests = 0;
+        usize Live = 0;
+        usize PeakLive = 0;
+    };
+    struct TierRecord
+    {
+        Record Allocations{};
+        u64 Steals = 0;
+    };
+
+    void RecordAllocation(usize tierIndex, usz size);
+    void RecordDeallocation(usize tierIndex, usz size);
+    void RecordSteal(usize tierIndex);
+
+    // Allocations bigger than the maximum allocation never reach the tiers and are not taken into account by `Solve()`
+    void RecordLargeAllocation();
+    void RecordLargeDeallocation();
+
+    void Clear()
+    {
+        m_Sizes.Clear();
+        m_Tiers.Clear();
+        m_Large = Record{};
+    }
+
+    /**
+     * @brief Find the tier layout that minimizes the total buffer size while guaranteeing that the recorded workload
+     * does not need to steal slots.
+     *
+     * Every valid combination of granularity and minimum allocation is evaluated, with the maximum allocation set to
+     * the next power of two of the biggest recorded size. The slots of each tier are the sum of the peak live
+     * allocations of all the sizes that map to it. This is an upper bound of the real peak of the tier (they are equal
+     * if all those peaks happened at the same time), so the resulting layout never runs out of slots for the recorded
+     * workload.
+     *
+     * @param specs Only the `Allocator` and `MaxTiers` fields are used, and layouts with more than `MaxTiers` tiers are
+     * discarded.
+     * @return The tier descriptions with the smallest buffer size.
+     */
+    TierDescriptions Solve(const TierSpecs &specs = {}) const;
+
+    // Indexed by size
+    const DynamicArray<Record> &GetSizes() const
+    {
+        return m_Sizes;
+    }
+    // Indexed by tier index of the recorded allocator
+    const DynamicArray<TierRecord> &GetTiers() const
+    {
+        return m_Tiers;
+    }
+    const Record &GetLargeAllocations() const
+    {
+        return m_Large;
+    }
+
+  private:
+    DynamicArray<Record> m_Sizes{};
+    DynamicArray<TierRecord> m_Tiers{};
+    Record m_Large{};
+};
+
 /**
  * @brief A fast general purpose allocator consisting of multiple tiers that allow for different, fixed allocation
  * sizes.
@@ -143,15 +247,25 @@ class TierDescriptions
  * indices reference bigger allocation size tiers. Note that a low index total tier size may be smaller than a high
  * index total tier size.
  *
+ * A `TierRecording` may be attached to the allocator to capture the allocation pattern of a workload, which can then be
+ * used to create tier descriptions that fit it without any slot stealing.
+ *
+ * Requests bigger than the maximum allocation, or requests that find every tier they could use exhausted, are served
+ * directly from the operating system with `AllocatePages()`. Those large allocations live outside of the buffer, which
+ * is how `Deallocate()` tells them apart, and their memory is returned to the operating system as soon as they are
+ * deallocated. When `TKIT_ENABLE_ENSURE` is defined, live large allocations are tracked so that pointers that do not
+ * belong to the allocator are caught before being unmapped.
+ *
+ * A NUMA policy may be provided so that both the buffer and the large allocations are bound to a specific node.
  */
 class alignas(TKIT_CACHE_LINE_SIZE) TierAllocator
 {
     TKIT_NON_COPYABLE(TierAllocator)
   public:
     explicit TierAllocator(const TierDescriptions &tiers, usize maxAlignment = alignof(std::max_align_t),
-                           usize headerAllocsAlignment = alignof(std::max_align_t));
+                           usize headerAllocsAlignment = alignof(std::max_align_t), const NumaSpecs &numa = {});
     explicit TierAllocator(const TierSpecs &specs = {}, usize maxAlignment = alignof(std::max_align_t),
-                           usize headerAllocsAlignment = alignof(std::max_align_t));
+                           usize headerAllocsAlignment = alignof(std::max_align_t), const NumaSpecs &numa = {});
 
     ~TierAllocator();
 
@@ -161,6 +275,33 @@ class alignas(TKIT_CACHE_LINE_SIZE) TierAllocator
     void *Allocate(usz size);
     void Deallocate(const void *ptr, usz size);
 
+    /**
+     * @brief Resize an allocation, keeping it in place whenever possible.
+     *
+     * If both sizes map to the same tier, the slot is already big enough to hold the new size and the same pointer is
+     * returned. Otherwise, a new slot is allocated, the first `min(oldSize, newSize)` bytes are copied to it with
+     * `ForwardCopy()` and the old slot is deallocated. Because of this, the contents of the allocation must be
+     * trivially relocatable.
+     *
+     * @param ptr The allocation to resize.
+     * @param oldSize The size the allocation was requested with.
+     * @param newSize The new size of the allocation.
+     * @return A pointer to the resized allocation. If the allocation fails, `nullptr` will be returned and the original
+     * allocation will remain valid.
+     */
+    void *Reallocate(void *ptr, usz oldSize, usz newSize);
+
+    /**
+     * @brief Check if two allocation sizes map to the same tier.
+     *
+     * If they do, a slot allocated for one of the sizes can be reused as a slot for the other without moving it. Sizes
+     * bigger than the maximum allocation do not map to any tier.
+     */
+    bool IsSameTier(const usz size1, const usz size2) const
+    {
+        return size1 <= m_MaxAllocation && size2 <= m_MaxAllocation && getTierIndex(size1) == getTierIndex(size2);
+    }
+
     void *AllocateWithHeader(usz size);
     void DeallocateWithHeader(const void *ptr);
 
@@ -196,6 +337,11 @@ class alignas(TKIT_CACHE_LINE_SIZE) TierAllocator
         Deallocate(scast<const void *>(ptr), count * sizeof(T));
     }
 
+    template <typename T> T *Reallocate(T *ptr, const usize oldCount, const usize newCount)
+    {
+        return scast<T *>(Reallocate(scast<void *>(ptr), oldCount * sizeof(T), newCount * sizeof(T)));
+    }
+
     template <typename T, typename... Args> T *Create(Args &&...args)
     {
         T *ptr = Allocate<T>();
@@ -225,8 +371,6 @@ class alignas(TKIT_CACHE_LINE_SIZE) TierAllocator
     template <typename T> void NDestroy(T *ptr, const usize count)
     {
         TKIT_ASSERT(ptr, "[TOOLKIT][TIER-ALLOC] Cannot deallocate a null pointer");
-        TKIT_ASSERT(Belongs(ptr),
-                    "[TOOLKIT][TIER-ALLOC] Cannot deallocate a pointer that does not belong to the allocator");
         if constexpr (!std::is_trivially_destructible_v<T>)
             for (usize i = 0; i < count; ++i)
                 ptr[i].~T();
@@ -237,7 +381,7 @@ class alignas(TKIT_CACHE_LINE_SIZE) TierAllocator
      * @brief Check if a pointer belongs to the tier allocator.
      *
      * @note This is a simple check to see if the provided pointer lies within the boundaries of the buffer. It will not
-     * be able to determine if the pointer is currently allocated or free.
+     * be able to determine if the pointer is currently allocated or free. Large allocations never belong to the buffer.
      *
      * @param ptr The pointer to check.
      * @return Whether the pointer belongs to the tier allocator.
@@ -252,6 +396,37 @@ class alignas(TKIT_CACHE_LINE_SIZE) TierAllocator
     {
         return m_BufferSize;
     }
+    usz GetMaxAllocation() const
+    {
+        return m_MaxAllocation;
+    }
+
+    usize GetLargeAllocationCount() const
+    {
+        return m_LargeAllocations;
+    }
+    // In bytes, as requested by the user
+    usz GetLargeAllocationSize() const
+    {
+        return m_LargeAllocationSize;
+    }
+
+    /**
+     * @brief Attach a recording to the allocator, which will record every allocation and deallocation from now on.
+     *
+     * Pass `nullptr` to stop recording. Allocations that were alive when the recording started should not be
+     * deallocated while recording.
+     *
+     * @param recording The recording to attach.
+     */
+    void SetRecording(TierRecording *recording)
+    {
+        m_Recording = recording;
+    }
+    TierRecording *GetRecording() const
+    {
+        return m_Recording;
+    }
 
   private:
     struct Allocation
@@ -275,6 +450,13 @@ class alignas(TKIT_CACHE_LINE_SIZE) TierAllocator
     };
 
     void *allocate(usize tierIndex, usz size);
+    void *allocateLarge(usz size);
+    void deallocateLarge(const void *ptr, usz size);
+    void recordAllocation(usz size);
+    void recordDeallocation(usz size);
+#ifdef TKIT_ENABLE_ENSURE
+    usize findLargeAllocation(const void *ptr) const;
+#endif
     usize getTierIndex(usz size) const;
 #ifdef TKIT_ENABLE_ENSURE
     void setupMemoryLayout(const TierDescriptions &tiers, usize maxAlignment);
@@ -287,12 +469,25 @@ class alignas(TKIT_CACHE_LINE_SIZE) TierAllocator
     std::byte *m_Buffer;
     usz m_BufferSize;
     usz m_MinAllocation;
+    usz m_MaxAllocation;
     usize m_Granularity;
     usize m_HeaderAllocationsAlignment;
+    NumaSpecs m_Numa{};
+    usize m_LargeAllocations = 0;
+    usz m_LargeAllocationSize = 0;
+    TierRecording *m_Recording = nullptr;
 #ifdef TKIT_ENABLE_ENSURE
-    usz m_MaxAllocation;
+    struct LargeAllocation
+    {
+        const void *Pointer;
+        usz Size;
+    };
+
     u64 m_Allocations = 0;
     u64 m_Deallocations = 0;
+    // Live large allocations, so that pointers outside of the buffer are checked before being returned to the system.
+    // Each entry stands for a system call, so there are never too many of them to search linearly
+    DynamicArray<LargeAllocation> m_LiveLargeAllocations{};
 #endif
   public:
 #ifdef TKIT_ENABLE_ENSURE
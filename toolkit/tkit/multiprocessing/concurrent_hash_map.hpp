@@ -0,0 +1,611 @@
+#pragma once
+
+#ifndef TKIT_ENABLE_MULTIPROCESSING
+#    error                                                                                                             \
+        "[TOOLKIT][MULTIPROC] To include this file, the corresponding feature must be enabled in CMake with TOOLKIT_ENABLE_MULTIPROCESSING"
+#endif
+
+#include "tkit/container/dynamic_array.hpp"
+#include "tkit/container/span.hpp"
+#include "tkit/preprocessor/system.hpp"
+#include "tkit/utils/hash.hpp"
+#include "tkit/utils/optional.hpp"
+#include "tkit/utils/non_copyable.hpp"
+#include "tkit/utils/debug.hpp"
+#ifdef TKIT_ENABLE_TIER_ALLOCATOR
+#    include "tkit/memory/tier_allocator.hpp"
+#endif
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <bit>
+
+namespace TKit
+{
+namespace Detail
+{
+/**
+ * @brief A reader-writer spin lock meant for very short critical sections.
+ *
+ * Readers only pay for a single atomic increment when there is no writer. Writers flag themselves before waiting for
+ * the readers to leave, so that a steady stream of readers cannot starve them. Waiting threads yield after a few
+ * spins, which keeps them from burning the time slice of a preempted lock holder.
+ */
+class SharedSpinLock
+{
+    TKIT_NON_COPYABLE(SharedSpinLock)
+  public:
+    class SharedGuard
+    {
+        TKIT_NON_COPYABLE(SharedGuard)
+      public:
+        SharedGuard(SharedSpinLock &lock) : m_Lock(lock)
+        {
+            m_Lock.LockShared();
+        }
+        ~SharedGuard()
+        {
+            m_Lock.UnlockShared();
+        }
+
+      private:
+        SharedSpinLock &m_Lock;
+    };
+
+    class Guard
+    {
+        TKIT_NON_COPYABLE(Guard)
+      public:
+        Guard(SharedSpinLock &lock) : m_Lock(lock)
+        {
+            m_Lock.Lock();
+        }
+        ~Guard()
+        {
+            m_Lock.Unlock();
+        }
+
+      private:
+        SharedSpinLock &m_Lock;
+    };
+
+    SharedSpinLock() = default;
+
+    void LockShared()
+    {
+        while (m_State.fetch_add(1, std::memory_order_acquire) & WriterBit)
+        {
+            m_State.fetch_sub(1, std::memory_order_relaxed);
+            waitWhile(WriterBit);
+        }
+    }
+    void UnlockShared()
+    {
+        m_State.fetch_sub(1, std::memory_order_release);
+    }
+
+    void Lock()
+    {
+        while (m_State.fetch_or(WriterBit, std::memory_order_acquire) & WriterBit)
+            waitWhile(WriterBit);
+        waitWhile(ReaderMask);
+    }
+    void Unlock()
+    {
+        m_State.fetch_and(~WriterBit, std::memory_order_release);
+    }
+
+  private:
+    static constexpr u32 WriterBit = 1u << 31;
+    static constexpr u32 ReaderMask = WriterBit - 1;
+    static constexpr u32 MaxSpins = 64;
+
+    void waitWhile(const u32 bits) const
+    {
+        for (u32 spins = 0; m_State.load(std::memory_order_acquire) & bits; ++spins)
+            if (spins >= MaxSpins)
+                std::this_thread::yield();
+    }
+
+    std::atomic<u32> m_State{0};
+};
+} // namespace Detail
+
+struct ConcurrentHashMapSpecs
+{
+    // Must be a power of 2. It caps the amount of writers that can make progress at the same time
+    usize Shards = 64;
+    // Initial bucket count of the whole map, split evenly among the shards
+    usize Buckets = 0;
+#ifdef TKIT_ENABLE_TIER_ALLOCATOR
+    // Either empty, to allocate nodes with `new`, or exactly one allocator per shard. A shard only uses its allocator
+    // while holding its lock, so allocators need not be thread safe, but they must not be shared between shards
+    Span<TierAllocator *const> Allocators{};
+#endif
+};
+
+/**
+ * @brief A hash map that may be accessed concurrently by any amount of threads.
+ *
+ * Keys are distributed among a fixed amount of shards by the highest bits of their hash. Every shard is an independent
+ * chained hash table guarded by its own reader-writer spin lock: lookups in a shard never block each other, and writes
+ * only contend with operations on the same shard.
+ *
+ * Shards grow incrementally. Once a shard exceeds its load factor, a table twice as big is allocated, and every
+ * following write to the shard moves a few buckets from the old table to the new one. Lookups search whichever table
+ * currently holds the bucket of their key, so a resize never keeps a shard locked for longer than a single write does.
+ *
+ * Elements cannot be referenced once the lock of their shard is released, so lookups return copies of the values.
+ * `Visit()`, `Update()` and `Upsert()` access a value in place instead, calling the provided function with the shard
+ * locked. Such functions must be short and must not access the map.
+ *
+ * @tparam K The key type.
+ * @tparam V The value type.
+ * @tparam Hasher The hash function, same as for `HashMap`.
+ * @tparam KeyEqual The key equality predicate, same as for `HashMap`.
+ */
+template <typename K, typename V, typename Hasher = DefaultHasher<K>, typename KeyEqual = DefaultKeyEqual<K>>
+class ConcurrentHashMap
+{
+    TKIT_NON_COPYABLE(ConcurrentHashMap)
+
+    template <typename Q>
+    static constexpr bool IsLookupKey =
+        TransparentHasher<Hasher> && TransparentHasher<KeyEqual> && std::invocable<const Hasher &, const Q &> &&
+        std::predicate<const KeyEqual &, const Q &, const K &>;
+
+  public:
+    using KeyType = K;
+    using ValueType = V;
+
+    struct Node
+    {
+        template <typename... Args>
+        Node(Node *next, const usz hash, const K &key, Args &&...args)
+            : Next(next), Hash(hash), Key(key), Value(std::forward<Args>(args)...)
+        {
+        }
+
+        Node *Next;
+        usz Hash;
+        K Key;
+        V Value;
+    };
+
+    explicit ConcurrentHashMap(const ConcurrentHashMapSpecs &specs = {}, const Hasher &hasher = Hasher{},
+                               const KeyEqual &equal = KeyEqual{})
+        : m_ShardBits(usize(std::countr_zero(specs.Shards))), m_Hasher(hasher), m_KeyEqual(equal)
+    {
+        TKIT_ASSERT(std::has_single_bit(specs.Shards),
+                    "[TOOLKIT][CONC-HASH-MAP] The shard count must be a power of 2, but it is {}", specs.Shards);
+#ifdef TKIT_ENABLE_TIER_ALLOCATOR
+        TKIT_ASSERT(specs.Allocators.IsEmpty() || specs.Allocators.GetSize() == specs.Shards,
+                    "[TOOLKIT][CONC-HASH-MAP] There must be either no allocators or one per shard, but there are {} "
+                    "allocators for {} shards",
+                    specs.Allocators.GetSize(), specs.Shards);
+#endif
+        const usize requested = (specs.Buckets + specs.Shards - 1) / specs.Shards;
+        const usize buckets = requested <= MinBuckets ? MinBuckets : usize(std::bit_ceil(requested));
+
+        m_Shards = new Shard[specs.Shards];
+        for (usize i = 0; i < specs.Shards; ++i)
+        {
+            m_Shards[i].Buckets.Resize(buckets, nullptr);
+#ifdef TKIT_ENABLE_TIER_ALLOCATOR
+            if (!specs.Allocators.IsEmpty())
+                m_Shards[i].Allocator = specs.Allocators[i];
+#endif
+        }
+    }
+
+    ~ConcurrentHashMap()
+    {
+        for (usize i = 0; i < GetShardCount(); ++i)
+            clear(m_Shards[i]);
+        delete[] m_Shards;
+    }
+
+    /**
+     * @brief Insert a new element if the key is not present already.
+     *
+     * The value is constructed in place with the provided arguments only if the element is inserted.
+     *
+     * @return Whether the element was inserted.
+     */
+    template <typename... Args> bool Insert(const K &key, Args &&...args)
+    {
+        return insert(key, [](V &) {}, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Insert a new element, or assign the value to the existing one if the key is present already.
+     *
+     * @return Whether the element was inserted.
+     */
+    bool InsertOrAssign(const K &key, const V &value)
+    {
+        return insert(key, [&value](V &existing) { existing = value; }, value);
+    }
+
+    /**
+     * @brief Call `fun` with the value of the key if it exists, or insert a new element with a value constructed from
+     * the provided arguments otherwise.
+     *
+     * The whole operation is atomic, which makes it suitable for counters and accumulators.
+     *
+     * @return Whether the element was inserted.
+     */
+    template <typename F, typename... Args>
+        requires std::invocable<F &, V &>
+    bool Upsert(const K &key, F &&fun, Args &&...args)
+    {
+        return insert(key, fun, std::forward<Args>(args)...);
+    }
+
+    Optional<V> Find(const K &key) const
+    {
+        return find<K>(key);
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    Optional<V> Find(const Q &key) const
+    {
+        return find<Q>(key);
+    }
+
+    bool Contains(const K &key) const
+    {
+        return visit<K>(key, [](const V &) {});
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    bool Contains(const Q &key) const
+    {
+        return visit<Q>(key, [](const V &) {});
+    }
+
+    /**
+     * @brief Call `fun` with a read-only reference to the value of the key, without copying it.
+     *
+     * @return Whether the key was found.
+     */
+    template <typename F>
+        requires std::invocable<F &, const V &>
+    bool Visit(const K &key, F &&fun) const
+    {
+        return visit<K>(key, fun);
+    }
+    template <typename Q, typename F>
+        requires(IsLookupKey<Q> && std::invocable<F &, const V &>)
+    bool Visit(const Q &key, F &&fun) const
+    {
+        return visit<Q>(key, fun);
+    }
+
+    /**
+     * @brief Call `fun` with a mutable reference to the value of the key.
+     *
+     * @return Whether the key was found.
+     */
+    template <typename F>
+        requires std::invocable<F &, V &>
+    bool Update(const K &key, F &&fun)
+    {
+        const usz hash = hashKey(key);
+        Shard &shard = getShard(hash);
+        const Detail::SharedSpinLock::Guard guard{shard.Lock};
+        Node *node = find(shard, key, hash);
+        if (node)
+            fun(node->Value);
+        return node;
+    }
+
+    bool Remove(const K &key)
+    {
+        return remove<K>(key);
+    }
+    template <typename Q>
+        requires IsLookupKey<Q>
+    bool Remove(const Q &key)
+    {
+        return remove<Q>(key);
+    }
+
+    /**
+     * @brief Call `fun` with every element of the map, locking one shard at a time.
+     *
+     * Elements inserted or removed concurrently in shards that have not been visited yet may or may not be seen.
+     */
+    template <typename F>
+        requires std::invocable<F &, const K &, const V &>
+    void ForEach(F &&fun) const
+    {
+        for (usize i = 0; i < GetShardCount(); ++i)
+        {
+            Shard &shard = m_Shards[i];
+            const Detail::SharedSpinLock::SharedGuard guard{shard.Lock};
+            for (const Node *head : shard.Buckets)
+                for (const Node *node = head; node; node = node->Next)
+                    fun(node->Key, node->Value);
+            for (usize j = shard.Migrated; j < shard.OldBuckets.GetSize(); ++j)
+                for (const Node *node = shard.OldBuckets[j]; node; node = node->Next)
+                    fun(node->Key, node->Value);
+        }
+    }
+
+    void Clear()
+    {
+        for (usize i = 0; i < GetShardCount(); ++i)
+        {
+            Shard &shard = m_Shards[i];
+            const Detail::SharedSpinLock::Guard guard{shard.Lock};
+            clear(shard);
+        }
+    }
+
+    /**
+     * @brief Get the amount of elements in the map.
+     *
+     * Shard sizes are read one after another without locking, so the result is only exact if no thread is writing.
+     */
+    usize GetSize() const
+    {
+        usize size = 0;
+        for (usize i = 0; i < GetShardCount(); ++i)
+            size += m_Shards[i].Size.load(std::memory_order_relaxed);
+        return size;
+    }
+    bool IsEmpty() const
+    {
+        return GetSize() == 0;
+    }
+
+    usize GetShardCount() const
+    {
+        return usize(1) << m_ShardBits;
+    }
+    usize GetBucketCount() const
+    {
+        usize buckets = 0;
+        for (usize i = 0; i < GetShardCount(); ++i)
+        {
+            Shard &shard = m_Shards[i];
+            const Detail::SharedSpinLock::SharedGuard guard{shard.Lock};
+            buckets += shard.Buckets.GetSize();
+        }
+        return buckets;
+    }
+
+    const Hasher &GetHasher() const
+    {
+        return m_Hasher;
+    }
+    const KeyEqual &GetKeyEqual() const
+    {
+        return m_KeyEqual;
+    }
+
+  private:
+    static constexpr usize MinBuckets = 4;
+    // Buckets moved from the old table to the new one on every write while a shard is growing. Anything above 1 is
+    // enough for a migration to finish before the next one is due, as a shard only doubles again after as many
+    // insertions as buckets it had before growing
+    static constexpr usize MigrationStep = 8;
+    static constexpr f32 MaxLoadFactor = 1.f;
+
+    struct alignas(TKIT_CACHE_LINE_SIZE) Shard
+    {
+        mutable Detail::SharedSpinLock Lock{};
+        DynamicArray<Node *> Buckets{};
+        // The table being migrated away from while the shard grows. Buckets below `Migrated` have already been moved
+        DynamicArray<Node *> OldBuckets{};
+        usize Migrated = 0;
+        std::atomic<usize> Size{0};
+#ifdef TKIT_ENABLE_TIER_ALLOCATOR
+        TierAllocator *Allocator = nullptr;
+#endif
+    };
+
+    template <typename Q> usz hashKey(const Q &key) const
+    {
+        if constexpr (AvalanchingHasher<Hasher>)
+            return usz(m_Hasher(key));
+        else
+            return MixHash(usz(m_Hasher(key)));
+    }
+
+    // The highest bits pick the shard so that the lowest ones stay independent to pick the bucket. The shift is split
+    // in two to stay defined when there is a single shard
+    Shard &getShard(const usz hash) const
+    {
+        constexpr usize bits = 8 * sizeof(usz);
+        return m_Shards[usize((hash >> (bits - 1 - m_ShardBits)) >> 1)];
+    }
+
+    // The chain of a key lives in the old table as long as its bucket has not been migrated yet
+    template <typename S> static auto *getChain(S &shard, const usz hash)
+    {
+        const usize oldSize = shard.OldBuckets.GetSize();
+        if (oldSize != 0)
+        {
+            const usize index = usize(hash) & (oldSize - 1);
+            if (index >= shard.Migrated)
+                return &shard.OldBuckets[index];
+        }
+        return &shard.Buckets[usize(hash) & (shard.Buckets.GetSize() - 1)];
+    }
+
+    template <typename Q> Node *find(const Shard &shard, const Q &key, const usz hash) const
+    {
+        for (Node *node = *getChain(shard, hash); node; node = node->Next)
+            if (node->Hash == hash && m_KeyEqual(key, node->Key))
+                return node;
+        return nullptr;
+    }
+
+    template <typename Q> Optional<V> find(const Q &key) const
+    {
+        const usz hash = hashKey(key);
+        const Shard &shard = getShard(hash);
+        const Detail::SharedSpinLock::SharedGuard guard{shard.Lock};
+        const Node *node = find(shard, key, hash);
+        if (node)
+            return Optional<V>::Some(node->Value);
+        return Optional<V>::None();
+    }
+
+    template <typename Q, typename F> bool visit(const Q &key, F &&fun) const
+    {
+        const usz hash = hashKey(key);
+        const Shard &shard = getShard(hash);
+        const Detail::SharedSpinLock::SharedGuard guard{shard.Lock};
+        const Node *node = find(shard, key, hash);
+        if (node)
+            fun(std::as_const(node->Value));
+        return node;
+    }
+
+    template <typename F, typename... Args> bool insert(const K &key, F &&onExisting, Args &&...args)
+    {
+        const usz hash = hashKey(key);
+        Shard &shard = getShard(hash);
+        const Detail::SharedSpinLock::Guard guard{shard.Lock};
+
+        Node **chain = getChain(shard, hash);
+        for (Node *node = *chain; node; node = node->Next)
+            if (node->Hash == hash && m_KeyEqual(key, node->Key))
+            {
+                onExisting(node->Value);
+                return false;
+            }
+
+        *chain = createNode(shard, *chain, hash, key, std::forward<Args>(args)...);
+        const usize size = shard.Size.load(std::memory_order_relaxed) + 1;
+        shard.Size.store(size, std::memory_order_relaxed);
+
+        migrate(shard);
+        if (shard.OldBuckets.IsEmpty() && f32(size) > MaxLoadFactor * f32(shard.Buckets.GetSize()))
+            grow(shard);
+        return true;
+    }
+
+    template <typename Q> bool remove(const Q &key)
+    {
+        const usz hash = hashKey(key);
+        Shard &shard = getShard(hash);
+        const Detail::SharedSpinLock::Guard guard{shard.Lock};
+
+        for (Node **link = getChain(shard, hash); *link; link = &(*link)->Next)
+        {
+            Node *node = *link;
+            if (node->Hash == hash && m_KeyEqual(key, node->Key))
+            {
+                *link = node->Next;
+                destroyNode(shard, node);
+                shard.Size.store(shard.Size.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+                migrate(shard);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Only allocates the new table. Elements are moved lazily by the following writes
+    static void grow(Shard &shard)
+    {
+        const usize buckets = 2 * shard.Buckets.GetSize();
+        shard.OldBuckets = std::move(shard.Buckets);
+        shard.Buckets = DynamicArray<Node *>{};
+        shard.Buckets.Resize(buckets, nullptr);
+        shard.Migrated = 0;
+    }
+
+    static void migrate(Shard &shard)
+    {
+        const usize oldSize = shard.OldBuckets.GetSize();
+        if (oldSize == 0)
+            return;
+
+        const usize mask = shard.Buckets.GetSize() - 1;
+        const usize end = shard.Migrated + MigrationStep < oldSize ? shard.Migrated + MigrationStep : oldSize;
+        for (usize i = shard.Migrated; i < end; ++i)
+        {
+            Node *node = shard.OldBuckets[i];
+            while (node)
+            {
+                Node *next = node->Next;
+                Node *&head = shard.Buckets[usize(node->Hash) & mask];
+                node->Next = head;
+                head = node;
+                node = next;
+            }
+            shard.OldBuckets[i] = nullptr;
+        }
+
+        shard.Migrated = end;
+        if (end == oldSize)
+        {
+            shard.OldBuckets = DynamicArray<Node *>{};
+            shard.Migrated = 0;
+        }
+    }
+
+    static void clear(Shard &shard)
+    {
+        for (Node *&head : shard.Buckets)
+        {
+            destroyChain(shard, head);
+            head = nullptr;
+        }
+        for (Node *head : shard.OldBuckets)
+            destroyChain(shard, head);
+        shard.OldBuckets = DynamicArray<Node *>{};
+        shard.Migrated = 0;
+        shard.Size.store(0, std::memory_order_relaxed);
+    }
+
+    template <typename... Args> static Node *createNode(Shard &shard, Args &&...args)
+    {
+#ifdef TKIT_ENABLE_TIER_ALLOCATOR
+        if (shard.Allocator)
+        {
+            Node *node = shard.Allocator->template Create<Node>(std::forward<Args>(args)...);
+            TKIT_ASSERT(node, "[TOOLKIT][CONC-HASH-MAP] The tier allocator of the shard ran out of memory");
+            return node;
+        }
+#else
+        (void)shard;
+#endif
+        return new Node{std::forward<Args>(args)...};
+    }
+
+    static void destroyNode(Shard &shard, Node *node)
+    {
+#ifdef TKIT_ENABLE_TIER_ALLOCATOR
+        if (shard.Allocator)
+        {
+            shard.Allocator->Destroy(node);
+            return;
+        }
+#else
+        (void)shard;
+#endif
+        delete node;
+    }
+
+    static void destroyChain(Shard &shard, Node *node)
+    {
+        while (node)
+        {
+            Node *next = node->Next;
+            destroyNode(shard, node);
+            node = next;
+        }
+    }
+
+    Shard *m_Shards = nullptr;
+    usize m_ShardBits;
+    TKIT_NO_UNIQUE_ADDRESS Hasher m_Hasher{};
+    TKIT_NO_UNIQUE_ADDRESS KeyEqual m_KeyEqual{};
+};
+} // namespace TKit
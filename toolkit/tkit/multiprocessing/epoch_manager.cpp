@@ -0,0 +1,122 @@
+#include "tkit/core/pch.hpp"
+#include "tkit/multiprocessing/epoch_manager.hpp"
+#include "tkit/multiprocessing/topology.hpp"
+#include "tkit/utils/debug.hpp"
+
+namespace TKit
+{
+EpochManager::EpochManager(const usize batchSize) : m_BatchSize(batchSize)
+{
+    TKIT_ASSERT(batchSize != 0, "[TOOLKIT][EPOCH] The batch size must be greater than 0");
+}
+
+EpochManager::~EpochManager()
+{
+    for (Slot &slot : m_Slots)
+    {
+        TKIT_ASSERT(slot.Nesting == 0,
+                    "[TOOLKIT][EPOCH] Destroying an epoch manager while a thread is inside a critical section");
+        for (Bag &bag : slot.Bags)
+            reclaim(bag);
+    }
+}
+
+void EpochManager::Enter()
+{
+    Slot &slot = getSlot();
+    if (slot.Nesting++ != 0)
+        return;
+
+    const u64 epoch = m_Epoch.load(std::memory_order_relaxed);
+    slot.State.store((epoch << 1) | 1, std::memory_order_relaxed);
+    // The announcement must be visible before any shared node is read
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void EpochManager::Leave()
+{
+    Slot &slot = getSlot();
+    TKIT_ASSERT(slot.Nesting != 0, "[TOOLKIT][EPOCH] Leaving a critical section that was never entered");
+    if (--slot.Nesting == 0)
+        slot.State.store(slot.State.load(std::memory_order_relaxed) & ~u64(1), std::memory_order_release);
+}
+
+void EpochManager::Retire(void *ptr, const Deleter deleter)
+{
+    TKIT_ASSERT(ptr, "[TOOLKIT][EPOCH] Cannot retire a null pointer");
+    Slot &slot = getSlot();
+
+    // Read after the node was unlinked, so any thread that may still hold it has entered at this epoch or before
+    const u64 epoch = m_Epoch.load(std::memory_order_seq_cst);
+    Bag &bag = slot.Bags[epoch % 3];
+    if (bag.Epoch != epoch)
+    {
+        // The bag belongs to an epoch at least 3 steps behind, so it is safe to empty
+        slot.Pending -= reclaim(bag);
+        bag.Epoch = epoch;
+    }
+    bag.Nodes.Append(Retired{ptr, deleter});
+    if (++slot.Pending >= m_BatchSize)
+        Collect();
+}
+
+usize EpochManager::Collect()
+{
+    tryAdvance();
+    const u64 epoch = m_Epoch.load(std::memory_order_acquire);
+
+    Slot &slot = getSlot();
+    usize reclaimed = 0;
+    for (Bag &bag : slot.Bags)
+        if (bag.Epoch + 2 <= epoch)
+            reclaimed += reclaim(bag);
+    slot.Pending -= reclaimed;
+    return reclaimed;
+}
+
+usize EpochManager::GetPendingCount() const
+{
+    return getSlot().Pending;
+}
+
+EpochManager::Slot &EpochManager::getSlot()
+{
+    const usize index = Topology::GetThreadIndex();
+    TKIT_ASSERT(index < MaxThreads,
+                "[TOOLKIT][EPOCH] The thread index {} exceeds the maximum amount of threads ({}). Consider increasing "
+                "TKIT_MAX_THREADS",
+                index, MaxThreads);
+    return m_Slots[index];
+}
+const EpochManager::Slot &EpochManager::getSlot() const
+{
+    const usize index = Topology::GetThreadIndex();
+    TKIT_ASSERT(index < MaxThreads,
+                "[TOOLKIT][EPOCH] The thread index {} exceeds the maximum amount of threads ({}). Consider increasing "
+                "TKIT_MAX_THREADS",
+                index, MaxThreads);
+    return m_Slots[index];
+}
+
+bool EpochManager::tryAdvance()
+{
+    u64 epoch = m_Epoch.load(std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (const Slot &slot : m_Slots)
+    {
+        const u64 state = slot.State.load(std::memory_order_acquire);
+        if ((state & 1) && (state >> 1) != epoch)
+            return false;
+    }
+    return m_Epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+usize EpochManager::reclaim(Bag &bag)
+{
+    const usize count = bag.Nodes.GetSize();
+    for (const Retired &node : bag.Nodes)
+        node.Delete(node.Ptr);
+    bag.Nodes.Clear();
+    return count;
+}
+} // namespace TKit
@@ -0,0 +1,155 @@
+#pragma once
+
+#ifndef TKIT_ENABLE_MULTIPROCESSING
+#    error                                                                                                             \
+        "[TOOLKIT][MULTIPROC] To include this file, the corresponding feature must be enabled in CMake with TOOLKIT_ENABLE_MULTIPROCESSING"
+#endif
+
+#include "tkit/container/dynamic_array.hpp"
+#include "tkit/preprocessor/system.hpp"
+#include "tkit/utils/non_copyable.hpp"
+#include "tkit/utils/limits.hpp"
+#include <atomic>
+
+namespace TKit
+{
+/**
+ * @brief Epoch based memory reclamation for lock-free data structures.
+ *
+ * Lock-free containers cannot free a node as soon as it is unlinked, because other threads may still be reading it.
+ * Instead, threads access shared nodes inside a critical section delimited by `Enter()` and `Leave()` (or an
+ * `EpochManager::Guard`), and unlinked nodes are handed to `Retire()` along with a deleter. Retired nodes are only
+ * deleted once every thread that could have seen them has left its critical section.
+ *
+ * To do so, the manager keeps a global epoch that can only advance once all threads inside a critical section have
+ * observed its current value. A node retired during epoch `e` can then be safely deleted once the global epoch reaches
+ * `e + 2`. Every thread keeps three bags of retired nodes, one per epoch modulo 3, and nodes are reclaimed in batches:
+ * every `BatchSize` retirements, the calling thread tries to advance the epoch and empties the bags that have become
+ * safe.
+ *
+ * Threads are identified by their `Topology` thread index, which must be unique among the threads using the manager
+ * and smaller than `TKIT_MAX_THREADS`. The threads of a `ThreadPool` already satisfy this.
+ *
+ * @note Retired nodes are reclaimed by the thread that retired them. Nodes that are still pending when the manager is
+ * destroyed are deleted by its destructor, at which point no thread may be inside a critical section.
+ */
+class EpochManager
+{
+    TKIT_NON_COPYABLE(EpochManager)
+  public:
+    using Deleter = void (*)(void *);
+
+    /**
+     * @brief A scoped critical section.
+     */
+    class Guard
+    {
+        TKIT_NON_COPYABLE(Guard)
+      public:
+        Guard(EpochManager &manager) : m_Manager(manager)
+        {
+            m_Manager.Enter();
+        }
+        ~Guard()
+        {
+            m_Manager.Leave();
+        }
+
+      private:
+        EpochManager &m_Manager;
+    };
+
+    /**
+     * @param batchSize The amount of retirements a thread accumulates before attempting to reclaim them.
+     */
+    explicit EpochManager(usize batchSize = 64);
+    ~EpochManager();
+
+    /**
+     * @brief Enter a critical section, in which shared nodes may be safely accessed.
+     *
+     * Critical sections may be nested.
+     */
+    void Enter();
+
+    /**
+     * @brief Leave a critical section. Pointers to shared nodes must not be used afterwards.
+     */
+    void Leave();
+
+    /**
+     * @brief Schedule a node that is no longer reachable from the data structure for deletion.
+     *
+     * It may be called from inside or outside a critical section.
+     *
+     * @param ptr The node to delete.
+     * @param deleter The function that will delete the node once it is safe to do so.
+     */
+    void Retire(void *ptr, Deleter deleter);
+
+    /**
+     * @brief Schedule a node allocated with new for deletion.
+     *
+     * @param ptr The node to delete.
+     */
+    template <typename T> void Retire(T *ptr)
+    {
+        Retire(ptr, [](void *p) { delete scast<T *>(p); });
+    }
+
+    /**
+     * @brief Try to advance the global epoch and reclaim the nodes the calling thread retired that have become safe
+     * to delete.
+     *
+     * It is called automatically every `BatchSize` retirements.
+     *
+     * @return The amount of reclaimed nodes.
+     */
+    usize Collect();
+
+    /**
+     * @brief Get the amount of nodes retired by the calling thread that are still pending reclamation.
+     */
+    usize GetPendingCount() const;
+
+    u64 GetEpoch() const
+    {
+        return m_Epoch.load(std::memory_order_relaxed);
+    }
+    usize GetBatchSize() const
+    {
+        return m_BatchSize;
+    }
+
+  private:
+    struct Retired
+    {
+        void *Ptr;
+        Deleter Delete;
+    };
+    struct Bag
+    {
+        DynamicArray<Retired> Nodes{};
+        u64 Epoch = 0;
+    };
+    struct alignas(TKIT_CACHE_LINE_SIZE) Slot
+    {
+        // The epoch the thread observed when entering, shifted one bit to the left. The lowest bit is set while the
+        // thread is inside a critical section
+        std::atomic<u64> State{0};
+        u32 Nesting = 0;
+        usize Pending = 0;
+        Bag Bags[3];
+    };
+
+    Slot &getSlot();
+    const Slot &getSlot() const;
+
+    bool tryAdvance();
+    static usize reclaim(Bag &bag);
+
+    alignas(TKIT_CACHE_LINE_SIZE) std::atomic<u64> m_Epoch{0};
+    usize m_BatchSize;
+    Slot m_Slots[MaxThreads];
+};
+} // namespace TKit
@@ -1,5 +1,9 @@
 #include "tkit/core/pch.hpp"
 #include "tkit/multiprocessing/thread_pool.hpp"
+#include "tkit/container/storage.hpp"
+#ifdef TKIT_ENABLE_STACK_ALLOCATOR
+#    include "tkit/memory/stack_allocator.hpp"
+#endif
 
 namespace TKit
 {
@@ -67,16 +71,22 @@ bool ThreadPool::trySteal(const usize victim)
     return false;
 }
 
-ThreadPool::ThreadPool(const usize workerCount, const usize maxTasksPerQueue)
-    : ThreadPool(TKit::GetArena(), workerCount, maxTasksPerQueue)
+ThreadPool::ThreadPool(const usize workerCount, const usize maxTasksPerQueue, const WorkerScratchSpecs &scratch)
+    : ThreadPool(TKit::GetArena(), workerCount, maxTasksPerQueue, scratch)
 {
 }
 
-ThreadPool::ThreadPool(ArenaAllocator *allocator, const usize workerCount, const usize maxTasksPerQueue)
-    : ITaskManager(workerCount), m_Workers{allocator, workerCount}
+ThreadPool::ThreadPool(ArenaAllocator *allocator, const usize workerCount, const usize maxTasksPerQueue,
+                       const WorkerScratchSpecs &scratch)
+    : ITaskManager(workerCount), m_Workers{allocator, workerCount}, m_Scratch(scratch)
 {
     TKIT_ASSERT(allocator, "[TOOLKIT][MULTIPROC] An arena allocator must be provided, but passed value was null");
     TKIT_ASSERT(workerCount > 1, "[TOOLKIT][MULTIPROC] At least 2 workers are required to create a thread pool");
+#ifndef TKIT_ENABLE_STACK_ALLOCATOR
+    TKIT_LOG_WARNING_IF(scratch.StackCapacity != 0,
+                        "[TOOLKIT][MULTIPROC] Worker stack allocators require the stack allocator feature to be "
+                        "enabled with TOOLKIT_ENABLE_STACK_ALLOCATOR. They will not be created");
+#endif
     m_Handle = Topology::Initialize();
     Topology::SetThreadIndex(0);
     Topology::BuildAffinityOrder(m_Handle);
@@ -88,6 +98,16 @@ ThreadPool::ThreadPool(ArenaAllocator *allocator, const usize workerCount, const
         Topology::PinThread(m_Handle, threadIndex);
         Topology::SetThreadName(threadIndex);
 
+        // Created after pinning the thread so that the memory lives in the worker's NUMA node
+        Storage<ArenaAllocator> arena;
+        if (m_Scratch.ArenaCapacity != 0)
+            PushArena(arena.Construct(m_Scratch.ArenaCapacity, alignof(std::max_align_t), m_Scratch.Numa));
+#ifdef TKIT_ENABLE_STACK_ALLOCATOR
+        Storage<StackAllocator> stack;
+        if (m_Scratch.StackCapacity != 0)
+            PushStack(stack.Construct(m_Scratch.StackCapacity, alignof(std::max_align_t), m_Scratch.Numa));
+#endif
+
         const usize workerIndex = threadIndex - 1;
 
         m_ReadySignal.wait(false, std::memory_order_acquire);
@@ -103,10 +123,25 @@ ThreadPool::ThreadPool(ArenaAllocator *allocator, const usize workerCount, const
             epoch = myself.Epochs.load(std::memory_order_relaxed);
 
             drainTasks(workerIndex, nworkers);
+            if (m_Scratch.ArenaCapacity != 0)
+                arena->Reset();
 
             if (myself.TerminateSignal.test(std::memory_order_relaxed))
                 break;
         }
+
+#ifdef TKIT_ENABLE_STACK_ALLOCATOR
+        if (m_Scratch.StackCapacity != 0)
+        {
+            PopStack();
+            stack.Destruct();
+        }
+#endif
+        if (m_Scratch.ArenaCapacity != 0)
+        {
+            PopArena();
+            arena.Destruct();
+        }
     };
     for (usize i = 0; i < workerCount; ++i)
         m_Workers.Append(allocator, maxTasksPerQueue, worker, i + 1);
@@ -16,6 +16,25 @@ namespace TKit
 {
 // TODO: Consider adding task dependencies
 
+/**
+ * @brief Scratch allocators every worker of a `ThreadPool` may create and push on start-up.
+ *
+ * Each worker creates its own allocators once it has been pinned to its core, so that their memory is local to the
+ * NUMA node of the worker. Tasks can then use `ArenaArray` and `StackArray` with no setup at all.
+ *
+ * The arena is reset every time the worker runs out of tasks, so memory allocated from it must not outlive the task
+ * that allocated it.
+ */
+struct WorkerScratchSpecs
+{
+    // Capacity of the arena allocator of each worker. 0 disables it
+    usz ArenaCapacity = 0;
+    // Capacity of the stack allocator of each worker. 0 disables it
+    usz StackCapacity = 0;
+    // Where the scratch buffers are placed. By default, on the NUMA node of each worker
+    NumaSpecs Numa = {.Policy = Numa_Local};
+};
+
 /**
  * @brief A thread pool that manages tasks and executes them in parallel.
  *
@@ -51,8 +70,9 @@ class ThreadPool final : public ITaskManager
         std::atomic_flag TerminateSignal = ATOMIC_FLAG_INIT;
     };
 
-    ThreadPool(ArenaAllocator *allocator, usize wokerCount, usize maxTasksPerQueue = 32);
-    explicit ThreadPool(usize wokerCount, usize maxTasksPerQueue = 32);
+    ThreadPool(ArenaAllocator *allocator, usize wokerCount, usize maxTasksPerQueue = 32,
+               const WorkerScratchSpecs &scratch = {});
+    explicit ThreadPool(usize wokerCount, usize maxTasksPerQueue = 32, const WorkerScratchSpecs &scratch = {});
     ~ThreadPool() override;
 
     /**
@@ -91,6 +111,7 @@ class ThreadPool final : public ITaskManager
     bool trySteal(usize victim);
 
     ArenaArray<Worker> m_Workers;
+    WorkerScratchSpecs m_Scratch;
 
     alignas(TKIT_CACHE_LINE_SIZE) std::atomic_flag m_ReadySignal = ATOMIC_FLAG_INIT;
     const Topology::Handle *m_Handle;
@@ -5,6 +5,8 @@
 
 #ifdef TKIT_HWLOC_INSTALLED
 #    include <hwloc.h>
+#    include <mutex>
+#    include <shared_mutex>
 #endif
 
 #ifdef TKIT_OS_WINDOWS
@@ -61,6 +63,12 @@ struct Handle
 
 static DynamicArray<u32> s_BuildOrder{};
 
+// Every handle shares the same topology, which is loaded by the first Initialize() and destroyed by the last
+// Terminate(). NUMA queries hold the lock in shared mode so that the topology cannot be destroyed under them
+static std::shared_mutex s_TopologyMutex{};
+static hwloc_topology_t s_Topology = nullptr;
+static usize s_TopologyReferences = 0;
+
 struct KindInfo
 {
     enum CoreType
@@ -282,18 +290,68 @@ void PinThread(const Handle *handle, const u32 threadIndex)
     bindCurrentThread(handle->Topology, pindex);
 }
 
+usize GetNumaNodeCount()
+{
+    const std::shared_lock lock{s_TopologyMutex};
+    if (!s_Topology)
+        return 1;
+    const i32 count = hwloc_get_nbobjs_by_type(s_Topology, HWLOC_OBJ_NUMANODE);
+    return count > 0 ? usize(count) : 1;
+}
+
+bool BindMemory(void *ptr, const usz size, const u32 node)
+{
+    const std::shared_lock lock{s_TopologyMutex};
+    if (!s_Topology)
+        return false;
+    const hwloc_obj_t numa = hwloc_get_obj_by_type(s_Topology, HWLOC_OBJ_NUMANODE, node);
+    if (!numa)
+    {
+        TKIT_LOG_WARNING("[TOOLKIT][TOPOLOGY] Failed to bind memory to NUMA node {}: node was NULL", node);
+        return false;
+    }
+    return hwloc_set_area_membind(s_Topology, ptr, size, numa->nodeset, HWLOC_MEMBIND_BIND,
+                                  HWLOC_MEMBIND_BYNODESET) == 0;
+}
+
+bool BindMemoryLocal(void *ptr, const usz size)
+{
+    const std::shared_lock lock{s_TopologyMutex};
+    if (!s_Topology)
+        return false;
+    const hwloc_cpuset_t set = hwloc_bitmap_alloc();
+    bool bound = hwloc_get_last_cpu_location(s_Topology, set, HWLOC_CPUBIND_THREAD) == 0;
+    // The memory is bound to the nodes near the given cpu set
+    if (bound)
+        bound = hwloc_set_area_membind(s_Topology, ptr, size, set, HWLOC_MEMBIND_BIND, 0) == 0;
+    hwloc_bitmap_free(set);
+    return bound;
+}
+
 const Handle *Initialize()
 {
+    const std::unique_lock lock{s_TopologyMutex};
+    if (s_TopologyReferences++ == 0)
+    {
+        hwloc_topology_init(&s_Topology);
+        hwloc_topology_set_flags(s_Topology, HWLOC_TOPOLOGY_FLAG_IS_THISSYSTEM);
+        hwloc_topology_load(s_Topology);
+    }
     Handle *handle = new Handle;
-    hwloc_topology_init(&handle->Topology);
-    hwloc_topology_set_flags(handle->Topology, HWLOC_TOPOLOGY_FLAG_IS_THISSYSTEM);
-    hwloc_topology_load(handle->Topology);
+    handle->Topology = s_Topology;
     return handle;
 }
 
 void Terminate(const Handle *handle)
 {
-    hwloc_topology_destroy(handle->Topology);
+    const std::unique_lock lock{s_TopologyMutex};
+    TKIT_ASSERT(s_TopologyReferences != 0 && handle->Topology == s_Topology,
+                "[TOOLKIT][TOPOLOGY] Cannot terminate a topology handle that is not alive");
+    if (--s_TopologyReferences == 0)
+    {
+        hwloc_topology_destroy(s_Topology);
+        s_Topology = nullptr;
+    }
     delete handle;
 }
 #else
@@ -319,5 +377,18 @@ const Handle *Initialize()
 void Terminate(const Handle *)
 {
 }
+
+usize GetNumaNodeCount()
+{
+    return 1;
+}
+bool BindMemory(void *, usz, u32)
+{
+    return false;
+}
+bool BindMemoryLocal(void *, usz)
+{
+    return false;
+}
 #endif
 } // namespace TKit::Topology
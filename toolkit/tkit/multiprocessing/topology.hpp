@@ -23,6 +23,34 @@ void PinThread(const Handle *handle, usize threadIndex);
 
 void SetThreadName(usize threadIndex, const char *name = nullptr);
 
+// All handles share a single topology, which stays alive until the last handle is terminated. NUMA queries and memory
+// binding work on it. Without HWLOC or a live handle, the system is treated as a single node and binding always fails
+
+usize GetNumaNodeCount();
+
+/**
+ * @brief Bind a page-aligned memory region to a NUMA node.
+ *
+ * Pages that have already been touched may not be migrated, so the region should be bound right after allocating it.
+ *
+ * @param ptr The beginning of the region.
+ * @param size The size of the region.
+ * @param node The logical index of the NUMA node.
+ * @return Whether the binding succeeded.
+ */
+bool BindMemory(void *ptr, usz size, u32 node);
+
+/**
+ * @brief Bind a page-aligned memory region to the NUMA node of the core the calling thread is running on.
+ *
+ * Meant to be called from pinned threads. The same considerations of `BindMemory()` apply.
+ *
+ * @param ptr The beginning of the region.
+ * @param size The size of the region.
+ * @return Whether the binding succeeded.
+ */
+bool BindMemoryLocal(void *ptr, usz size);
+
 void Terminate(const Handle *handle);
 
 } // namespace TKit::Topology
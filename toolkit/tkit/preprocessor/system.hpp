@@ -98,6 +98,12 @@
 #    define TKIT_CONSTEVAL constexpr
 #endif
 
+#if defined(TKIT_COMPILER_MSVC)
+#    define TKIT_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#    define TKIT_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
 #if defined(TKIT_COMPILER_GCC) || defined(TKIT_COMPILER_CLANG)
 #    define TKIT_UNREACHABLE() __builtin_unreachable()
 #    define TKIT_FORCE_INLINE inline __attribute__((always_inline))
@@ -112,6 +118,16 @@
 #    define TKIT_NO_INLINE
 #endif
 
+// Hint the processor to bring the cache line of an address closer. It never faults, even on invalid addresses
+#if defined(TKIT_COMPILER_GCC) || defined(TKIT_COMPILER_CLANG)
+#    define TKIT_PREFETCH(ptr) __builtin_prefetch(ptr)
+#elif defined(TKIT_COMPILER_MSVC_CL) && !defined(TKIT_ARM)
+#    include <xmmintrin.h>
+#    define TKIT_PREFETCH(ptr) _mm_prefetch(reinterpret_cast<const char *>(ptr), _MM_HINT_T0)
+#else
+#    define TKIT_PREFETCH(ptr) ((void)(ptr))
+#endif
+
 #ifndef TKIT_CACHE_LINE_SIZE
 #    define TKIT_CACHE_LINE_SIZE 64
 #endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "tkit/serialization/yaml/codec.hpp"
+#include "tkit/memory/tier_allocator.hpp"
+
+namespace TKit::Yaml
+{
+// Only the parameters needed to rebuild the layout are stored. The slots of every tier are the actual slots of the
+// layout, which may be slightly higher than the ones originally requested due to alignment
+template <> struct Codec<TierDescriptions>
+{
+    static Node Encode(const TierDescriptions &instance)
+    {
+        Node node;
+        node["MaxAllocation"] = instance.GetMaxAllocation();
+        node["MinAllocation"] = instance.GetMinAllocation();
+        node["Granularity"] = instance.GetGranularity();
+
+        Node slots;
+        for (const TierInfo &tier : instance.GetTiers())
+            slots.push_back(tier.Slots);
+        slots.SetStyle(YAML::EmitterStyle::Flow);
+        node["Slots"] = slots;
+        return node;
+    }
+
+    static bool Decode(const Node &node, TierDescriptions &instance)
+    {
+        if (!node.IsMap() || !node["MaxAllocation"] || !node["MinAllocation"] || !node["Granularity"])
+            return false;
+
+        const Node slots = node["Slots"];
+        if (!slots || !slots.IsSequence() || slots.size() > instance.GetTiers().GetCapacity())
+            return false;
+
+        const usz maxAllocation = node["MaxAllocation"].as<usz>();
+        const usz minAllocation = node["MinAllocation"].as<usz>();
+        const usize granularity = node["Granularity"].as<usize>();
+        if (!instance.IsValidLayout(maxAllocation, minAllocation, granularity))
+            return false;
+
+        instance.SetLayout(maxAllocation, minAllocation, granularity);
+        if (instance.GetTiers().GetSize() != slots.size())
+            return false;
+
+        for (usize i = 0; i < usize(slots.size()); ++i)
+            instance.SetMinSlotsForIndex(i, slots[i].as<usize>());
+        return true;
+    }
+};
+} // namespace TKit::Yaml
@@ -883,4 +883,5 @@ TKIT_COMPILER_WARNING_IGNORE_POP()
 #    undef CREATE_EQ_CMP
 #    undef CREATE_INT_CMP
 #    undef CREATE_SELF_OP
+#    undef CREATE_SCALAR_OP
 #endif
@@ -0,0 +1,83 @@
+#include "tkit/core/pch.hpp"
+#include "tkit/utils/hash.hpp"
+#include <cstring>
+
+namespace TKit
+{
+static u64 read8(const u8 *data)
+{
+    u64 value;
+    std::memcpy(&value, data, 8);
+    return value;
+}
+static u64 read4(const u8 *data)
+{
+    u32 value;
+    std::memcpy(&value, data, 4);
+    return value;
+}
+// Reads 1 to 3 bytes, touching each of them at most twice
+static u64 read3(const u8 *data, const usz size)
+{
+    return (u64(data[0]) << 16) | (u64(data[size >> 1]) << 8) | u64(data[size - 1]);
+}
+
+usz HashBytes(const void *pdata, const usz size, u64 seed)
+{
+    using Detail::HashSecret;
+    using Detail::MultiplyMix;
+
+    const u8 *data = scast<const u8 *>(pdata);
+    seed ^= MultiplyMix(seed ^ HashSecret[0], HashSecret[1]);
+
+    u64 a;
+    u64 b;
+    if (size <= 16)
+    {
+        if (size >= 4)
+        {
+            // Two possibly overlapping pairs of 4 byte reads cover any size between 4 and 16
+            const usz offset = (size >> 3) << 2;
+            a = (read4(data) << 32) | read4(data + offset);
+            b = (read4(data + size - 4) << 32) | read4(data + size - 4 - offset);
+        }
+        else if (size > 0)
+        {
+            a = read3(data, size);
+            b = 0;
+        }
+        else
+            a = b = 0;
+    }
+    else
+    {
+        usz left = size;
+        if (left > 48)
+        {
+            // Three independent lanes keep the multipliers busy on long inputs
+            u64 seed1 = seed;
+            u64 seed2 = seed;
+            do
+            {
+                seed = MultiplyMix(read8(data) ^ HashSecret[1], read8(data + 8) ^ seed);
+                seed1 = MultiplyMix(read8(data + 16) ^ HashSecret[2], read8(data + 24) ^ seed1);
+                seed2 = MultiplyMix(read8(data + 32) ^ HashSecret[3], read8(data + 40) ^ seed2);
+                data += 48;
+                left -= 48;
+            } while (left > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (left > 16)
+        {
+            seed = MultiplyMix(read8(data) ^ HashSecret[1], read8(data + 8) ^ seed);
+            data += 16;
+            left -= 16;
+        }
+        a = read8(data + left - 16);
+        b = read8(data + left - 8);
+    }
+
+    Detail::Multiply128(a ^ HashSecret[1], b ^ seed, a, b);
+    return usz(MultiplyMix(a ^ HashSecret[0] ^ u64(size), b ^ HashSecret[1]));
+}
+} // namespace TKit
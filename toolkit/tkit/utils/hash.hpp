@@ -3,6 +3,7 @@
 #include "tkit/utils/alias.hpp"
 #include <concepts>
 #include <functional>
+#include <string_view>
 
 #ifndef TKIT_HASH_SEED
 #    define TKIT_HASH_SEED 0x517cc1b7
@@ -53,11 +54,158 @@ template <Hashable... H> constexpr void HashCombine(usz &seed, H &&...hashables)
     (Detail::CombineHashes(seed, std::forward<H>(hashables)), ...);
 }
 
-enum HashNodeState : u8
+namespace Detail
 {
-    HashNode_Free,
-    HashNode_Occupied,
-    HashNode_Tombstone
+constexpr u64 HashSecret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull,
+                               0x4d5a2da51de1aa47ull};
+
+constexpr void Multiply128(const u64 a, const u64 b, u64 &lo, u64 &hi)
+{
+#ifdef __SIZEOF_INT128__
+    __extension__ using u128 = unsigned __int128;
+    const u128 r = u128(a) * b;
+    lo = u64(r);
+    hi = u64(r >> 64);
+#else
+    const u64 alo = a & 0xFFFFFFFF;
+    const u64 ahi = a >> 32;
+    const u64 blo = b & 0xFFFFFFFF;
+    const u64 bhi = b >> 32;
+
+    const u64 ll = alo * blo;
+    const u64 lh = alo * bhi;
+    const u64 hl = ahi * blo;
+    const u64 hh = ahi * bhi;
+
+    const u64 mid = (ll >> 32) + (lh & 0xFFFFFFFF) + (hl & 0xFFFFFFFF);
+    lo = (mid << 32) | (ll & 0xFFFFFFFF);
+    hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+// Fold the 128 bit product of two 64 bit integers into 64 bits
+constexpr u64 MultiplyMix(const u64 a, const u64 b)
+{
+    u64 lo = 0;
+    u64 hi = 0;
+    Multiply128(a, b, lo, hi);
+    return lo ^ hi;
+}
+} // namespace Detail
+
+/**
+ * @brief Scramble a hash so that all of its bits depend on all bits of the input.
+ *
+ * `std::hash` is the identity for integers in most standard libraries. Use this before relying on the high or low bits
+ * of such a hash alone.
+ */
+constexpr usz MixHash(usz hash)
+{
+    if constexpr (sizeof(usz) == 8)
+    {
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ull;
+        hash ^= hash >> 33;
+    }
+    else
+    {
+        hash ^= hash >> 16;
+        hash *= 0x85ebca6bu;
+        hash ^= hash >> 13;
+        hash *= 0xc2b2ae35u;
+        hash ^= hash >> 16;
+    }
+    return hash;
+}
+
+/**
+ * @brief Hash an integer with a single wide multiplication. The result is well distributed across all of its bits.
+ */
+constexpr usz HashInteger(const u64 value, const u64 seed = TKIT_HASH_SEED)
+{
+    return usz(Detail::MultiplyMix(value ^ Detail::HashSecret[0], seed ^ Detail::HashSecret[1]));
+}
+
+/**
+ * @brief Hash a sequence of bytes with a wyhash style function. The result is well distributed across all of its bits.
+ *
+ * It is much faster than `std::hash` for strings, especially short ones, and it is not cryptographically secure.
+ */
+usz HashBytes(const void *data, usz size, u64 seed = TKIT_HASH_SEED);
+
+/**
+ * @brief A hasher whose results are already well distributed across all of their bits, so that hash containers do not
+ * need to scramble them again.
+ */
+template <typename H>
+concept AvalanchingHasher = requires { typename H::is_avalanching; };
+
+/**
+ * @brief A hasher and a key equality that accept other types than the key itself, so that hash containers can be
+ * queried without building a key.
+ */
+template <typename H>
+concept TransparentHasher = requires { typename H::is_transparent; };
+
+template <typename T>
+concept StringLike = std::is_class_v<T> && std::convertible_to<const T &, std::string_view>;
+
+/**
+ * @brief The default hasher of hash containers.
+ *
+ * Integers, enums and pointers go through `HashInteger()`. Other types go through `std::hash` and `MixHash()`.
+ */
+template <typename T> struct DefaultHasher
+{
+    using is_avalanching = void;
+
+    constexpr usz operator()(const T &value) const
+    {
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+            return HashInteger(u64(value));
+        else if constexpr (std::is_pointer_v<T>)
+            return HashInteger(u64(rcast<uptr>(value)));
+        else
+            return MixHash(Hash(value));
+    }
+};
+
+/**
+ * @brief The default hasher for strings. It hashes their characters with `HashBytes()`, and it accepts anything that
+ * converts to a `std::string_view`.
+ */
+template <StringLike T> struct DefaultHasher<T>
+{
+    using is_avalanching = void;
+    using is_transparent = void;
+
+    usz operator()(const std::string_view str) const
+    {
+        return HashBytes(str.data(), str.size());
+    }
+};
+
+template <typename T> struct DefaultKeyEqual
+{
+    using is_transparent = void;
+
+    template <typename U, typename W> constexpr bool operator()(const U &lhs, const W &rhs) const
+    {
+        return lhs == rhs;
+    }
+};
+
+// Strings are compared as views, so that comparing different string types never builds a temporary
+template <StringLike T> struct DefaultKeyEqual<T>
+{
+    using is_transparent = void;
+
+    constexpr bool operator()(const std::string_view lhs, const std::string_view rhs) const
+    {
+        return lhs == rhs;
+    }
 };
 
 #ifndef TKIT_HASH_LOAD_FACTOR_THRESHOLD
@@ -75,6 +75,16 @@ template <typename T> struct Limits
 #    define TKIT_MEMORY_MAX_STACK_ALLOCATION 1024
 #endif
 
+#ifndef TKIT_MEMORY_PAGE_ALLOCATION_THRESHOLD
+#    define TKIT_MEMORY_PAGE_ALLOCATION_THRESHOLD (256 * 1024)
+#endif
+
+// Copies and fills of at least this size bypass the cache with non-temporal stores, as the destination would evict
+// most of it anyway
+#ifndef TKIT_MEMORY_NON_TEMPORAL_THRESHOLD
+#    define TKIT_MEMORY_NON_TEMPORAL_THRESHOLD (4 * 1024 * 1024)
+#endif
+
 #ifndef TKIT_MAX_THREADS
 #    define TKIT_MAX_THREADS 16
 #endif
@@ -88,6 +98,8 @@ template <typename T> struct Limits
 #endif
 
 constexpr usize MaxStackAlloc = TKIT_MEMORY_MAX_STACK_ALLOCATION;
+constexpr usz PageAllocationThreshold = TKIT_MEMORY_PAGE_ALLOCATION_THRESHOLD;
+constexpr usz NonTemporalThreshold = TKIT_MEMORY_NON_TEMPORAL_THRESHOLD;
 constexpr usize MaxThreads = TKIT_MAX_THREADS;
 constexpr usize MaxAllocatorPushDepth = TKIT_MAX_ALLOCATOR_PUSH_DEPTH;
 } // namespace TKit
@@ -555,6 +555,7 @@ template <typename T> class Result<T, void>
         Result result{};
         result.m_Flags = ResultFlag_Engaged | ResultFlag_Some;
         result.m_Value.Construct(std::forward<ValueArgs>(args)...);
+        return result;
     }
     static constexpr Result None()
     {